@@ -0,0 +1,224 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include "benchmark.h"
+
+#include <yarp/os/Bottle.h>
+#include <yarp/os/Portable.h>
+#include <yarp/os/Property.h>
+
+#include <string>
+#include <vector>
+
+using yarp::os::Bottle;
+using yarp::os::Portable;
+using yarp::os::Property;
+
+namespace {
+
+// A bottle with n elements of mixed types, similar to the ones sent by the
+// devices
+Bottle makeBottle(int64_t n)
+{
+    Bottle b;
+    for (int64_t i = 0; i < n; i++) {
+        switch (i % 4) {
+        case 0: b.addInt32(static_cast<int32_t>(i)); break;
+        case 1: b.addFloat64(i * 0.5); break;
+        case 2: b.addString("element" + std::to_string(i)); break;
+        case 3: b.addList().addFloat64(i * 0.25); break;
+        }
+    }
+    return b;
+}
+
+// A bottle with n float64 elements, like an encoder reading
+Bottle makeVectorBottle(int64_t n)
+{
+    Bottle b;
+    for (int64_t i = 0; i < n; i++) {
+        b.addFloat64(i * 0.1);
+    }
+    return b;
+}
+
+Property makeProperty(int64_t n)
+{
+    Property p;
+    for (int64_t i = 0; i < n; i++) {
+        p.put("key" + std::to_string(i), static_cast<int>(i));
+    }
+    return p;
+}
+
+} // namespace
+
+
+void Bottle_toBinary(benchmark::State& state)
+{
+    Bottle b = makeBottle(state.arg());
+    size_t size = 0;
+    while (state.keepRunning()) {
+        // Edit the bottle, as when it is prepared again before being
+        // written, otherwise the cached binary representation is returned
+        b.addInt32(0);
+        b.pop();
+        benchmark::doNotOptimize(b.toBinary(&size));
+    }
+    state.setBytesProcessed(state.iterations() * static_cast<int64_t>(size));
+}
+YARP_BENCHMARK(Bottle_toBinary)->args({8, 64, 1024});
+
+void Bottle_fromBinary(benchmark::State& state)
+{
+    Bottle b = makeBottle(state.arg());
+    size_t size = 0;
+    const char* data = b.toBinary(&size);
+    std::string buf(data, size);
+    Bottle b2;
+    while (state.keepRunning()) {
+        b2.fromBinary(buf.data(), buf.size());
+        benchmark::doNotOptimize(b2.size());
+    }
+    state.setBytesProcessed(state.iterations() * static_cast<int64_t>(size));
+}
+YARP_BENCHMARK(Bottle_fromBinary)->args({8, 64, 1024});
+
+void Bottle_toString(benchmark::State& state)
+{
+    Bottle b = makeBottle(state.arg());
+    size_t size = 0;
+    while (state.keepRunning()) {
+        std::string s = b.toString();
+        size = s.size();
+        benchmark::doNotOptimize(s);
+    }
+    state.setBytesProcessed(state.iterations() * static_cast<int64_t>(size));
+}
+YARP_BENCHMARK(Bottle_toString)->args({8, 64, 1024});
+
+void Bottle_fromString(benchmark::State& state)
+{
+    std::string s = makeBottle(state.arg()).toString();
+    Bottle b;
+    while (state.keepRunning()) {
+        b.fromString(s);
+        benchmark::doNotOptimize(b.size());
+    }
+    state.setBytesProcessed(state.iterations() * static_cast<int64_t>(s.size()));
+}
+YARP_BENCHMARK(Bottle_fromString)->args({8, 64, 1024});
+
+// Write and read through the connection machinery used by the ports
+void Bottle_copyPortable(benchmark::State& state)
+{
+    Bottle b = makeVectorBottle(state.arg());
+    Bottle b2;
+    while (state.keepRunning()) {
+        Portable::copyPortable(b, b2);
+        benchmark::doNotOptimize(b2.size());
+    }
+    state.setItemsProcessed(state.iterations() * state.arg());
+}
+YARP_BENCHMARK(Bottle_copyPortable)->args({8, 64, 1024});
+
+
+void Property_fromString(benchmark::State& state)
+{
+    std::string s = makeProperty(state.arg()).toString();
+    Property p;
+    while (state.keepRunning()) {
+        p.fromString(s);
+        benchmark::doNotOptimize(p);
+    }
+    state.setBytesProcessed(state.iterations() * static_cast<int64_t>(s.size()));
+}
+YARP_BENCHMARK(Property_fromString)->args({8, 64, 1024});
+
+void Property_toString(benchmark::State& state)
+{
+    Property p = makeProperty(state.arg());
+    size_t size = 0;
+    while (state.keepRunning()) {
+        std::string s = p.toString();
+        size = s.size();
+        benchmark::doNotOptimize(s);
+    }
+    state.setBytesProcessed(state.iterations() * static_cast<int64_t>(size));
+}
+YARP_BENCHMARK(Property_toString)->args({8, 64, 1024});
+
+void Property_find(benchmark::State& state)
+{
+    Property p = makeProperty(state.arg());
+    std::string key = "key" + std::to_string(state.arg() / 2);
+    while (state.keepRunning()) {
+        benchmark::doNotOptimize(p.find(key).asInt32());
+    }
+    state.setItemsProcessed(state.iterations());
+}
+YARP_BENCHMARK(Property_find)->args({8, 64, 1024});
+
+void Property_findKey(benchmark::State& state)
+{
+    Property p = makeProperty(state.arg());
+    const Property::Key key("key" + std::to_string(state.arg() / 2));
+    while (state.keepRunning()) {
+        benchmark::doNotOptimize(p.find(key).asInt32());
+    }
+    state.setItemsProcessed(state.iterations());
+}
+YARP_BENCHMARK(Property_findKey)->args({8, 64, 1024});
+
+// Look up all the keys, and as many missing keys, like the open() of a
+// device checking its optional parameters
+void Property_check(benchmark::State& state)
+{
+    Property p = makeProperty(state.arg());
+    std::vector<std::string> keys;
+    for (int64_t i = 0; i < state.arg(); i++) {
+        keys.push_back("key" + std::to_string(i));
+        keys.push_back("missing" + std::to_string(i));
+    }
+    while (state.keepRunning()) {
+        for (const auto& key : keys) {
+            benchmark::doNotOptimize(p.check(key));
+        }
+    }
+    state.setItemsProcessed(state.iterations() * static_cast<int64_t>(keys.size()));
+}
+YARP_BENCHMARK(Property_check)->args({8, 64, 1024});
+
+void Property_put(benchmark::State& state)
+{
+    std::vector<std::string> keys;
+    for (int64_t i = 0; i < state.arg(); i++) {
+        keys.push_back("key" + std::to_string(i));
+    }
+    while (state.keepRunning()) {
+        Property p;
+        for (const auto& key : keys) {
+            p.put(key, 1);
+        }
+        benchmark::doNotOptimize(p);
+    }
+    state.setItemsProcessed(state.iterations() * state.arg());
+}
+YARP_BENCHMARK(Property_put)->args({8, 64, 1024});
+
+void Property_copyPortable(benchmark::State& state)
+{
+    Property p = makeProperty(state.arg());
+    Property p2;
+    while (state.keepRunning()) {
+        Portable::copyPortable(p, p2);
+        benchmark::doNotOptimize(p2);
+    }
+    state.setItemsProcessed(state.iterations() * state.arg());
+}
+YARP_BENCHMARK(Property_copyPortable)->args({8, 64, 1024});
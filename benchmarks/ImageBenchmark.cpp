@@ -0,0 +1,81 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include "benchmark.h"
+
+#include <yarp/sig/Image.h>
+
+#include <cstring>
+
+using namespace yarp::sig;
+
+namespace {
+
+// The argument is the width of the image, with a 4:3 aspect ratio
+template <typename Src, typename Dest>
+void copyImage(benchmark::State& state)
+{
+    const size_t width = static_cast<size_t>(state.arg());
+    const size_t height = width * 3 / 4;
+
+    ImageOf<Src> src;
+    src.resize(width, height);
+    unsigned char* raw = src.getRawImage();
+    for (size_t i = 0; i < src.getRawImageSize(); i++) {
+        raw[i] = static_cast<unsigned char>(i * 7);
+    }
+
+    ImageOf<Dest> dest;
+    dest.resize(width, height);
+
+    while (state.keepRunning()) {
+        dest.copy(src);
+        benchmark::doNotOptimize(dest.getRawImage()[0]);
+    }
+    state.setBytesProcessed(state.iterations() * static_cast<int64_t>(src.getRawImageSize()));
+    state.setItemsProcessed(state.iterations() * static_cast<int64_t>(width * height));
+}
+
+// Copy with a scaling to half the size
+void Image_copyScaled(benchmark::State& state)
+{
+    const size_t width = static_cast<size_t>(state.arg());
+    const size_t height = width * 3 / 4;
+
+    ImageOf<PixelRgb> src;
+    src.resize(width, height);
+    std::memset(src.getRawImage(), 128, src.getRawImageSize());
+
+    ImageOf<PixelRgb> dest;
+    while (state.keepRunning()) {
+        dest.copy(src, width / 2, height / 2);
+        benchmark::doNotOptimize(dest.getRawImage()[0]);
+    }
+    state.setBytesProcessed(state.iterations() * static_cast<int64_t>(src.getRawImageSize()));
+}
+
+#define IMAGE_BENCHMARK(name, Src, Dest) \
+    benchmark::registerBenchmark(name, copyImage<Src, Dest>)->args({320, 640, 1280, 1920})
+
+const bool registered = []() {
+    IMAGE_BENCHMARK("Image_copy/rgb_rgb", PixelRgb, PixelRgb);
+    IMAGE_BENCHMARK("Image_copy/rgb_bgr", PixelRgb, PixelBgr);
+    IMAGE_BENCHMARK("Image_copy/rgb_rgba", PixelRgb, PixelRgba);
+    IMAGE_BENCHMARK("Image_copy/rgba_rgb", PixelRgba, PixelRgb);
+    IMAGE_BENCHMARK("Image_copy/rgb_mono", PixelRgb, PixelMono);
+    IMAGE_BENCHMARK("Image_copy/mono_rgb", PixelMono, PixelRgb);
+    IMAGE_BENCHMARK("Image_copy/bgr_mono", PixelBgr, PixelMono);
+    IMAGE_BENCHMARK("Image_copy/mono_float", PixelMono, PixelFloat);
+    IMAGE_BENCHMARK("Image_copy/rgb_rgbfloat", PixelRgb, PixelRgbFloat);
+    benchmark::registerBenchmark("Image_copyScaled/rgb", Image_copyScaled)->args({320, 640, 1280, 1920});
+    return true;
+}();
+
+#undef IMAGE_BENCHMARK
+
+} // namespace
@@ -0,0 +1,39 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include "benchmark.h"
+
+#include <yarp/os/NetType.h>
+
+#include <vector>
+
+using yarp::os::NetType;
+
+namespace {
+
+// Checksum of the datagrams sent by the udp and mcast carriers. The
+// argument is the size of the datagram.
+void NetType_getCrc(benchmark::State& state)
+{
+    std::vector<char> data(static_cast<size_t>(state.arg()));
+    for (size_t i = 0; i < data.size(); i++) {
+        data[i] = static_cast<char>(i * 13);
+    }
+
+    while (state.keepRunning()) {
+        benchmark::doNotOptimize(NetType::getCrc(data.data(), data.size()));
+    }
+    state.setBytesProcessed(state.iterations() * state.arg());
+}
+
+const bool registered = []() {
+    benchmark::registerBenchmark("NetType_getCrc", NetType_getCrc)->args({64, 1464, 65499, 1048576});
+    return true;
+}();
+
+} // namespace
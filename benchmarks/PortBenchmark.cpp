@@ -0,0 +1,250 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include "benchmark.h"
+
+#include <yarp/os/Bottle.h>
+#include <yarp/os/BufferedPort.h>
+#include <yarp/os/Network.h>
+#include <yarp/os/TypedReaderCallback.h>
+#include <yarp/os/Value.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <initializer_list>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using yarp::os::Bottle;
+using yarp::os::BufferedPort;
+using yarp::os::Network;
+
+namespace {
+
+const char* const carriers[] = {"local", "tcp", "fast_tcp", "udp", "mcast", "shmem"};
+
+// How long to wait for a message, before considering it lost
+constexpr double timeout = 1.0;
+
+// Stop a benchmark on a lossy carrier after too many messages were lost
+constexpr int64_t max_lost = 10;
+
+// Counts the messages received
+class Receiver : public yarp::os::TypedReaderCallback<Bottle>
+{
+public:
+    using yarp::os::TypedReaderCallback<Bottle>::onRead;
+
+    void onRead(Bottle& datum) override
+    {
+        YARP_UNUSED(datum);
+        std::lock_guard<std::mutex> lock(mutex);
+        received++;
+        cond.notify_all();
+    }
+
+    size_t count()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return received;
+    }
+
+    bool waitFor(size_t n)
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        return cond.wait_for(lock, std::chrono::duration<double>(timeout), [&]() { return received >= n; });
+    }
+
+private:
+    std::mutex mutex;
+    std::condition_variable cond;
+    size_t received {0};
+};
+
+// Writes back each message received
+class Echo : public yarp::os::TypedReaderCallback<Bottle>
+{
+public:
+    using yarp::os::TypedReaderCallback<Bottle>::onRead;
+
+    explicit Echo(BufferedPort<Bottle>& out) :
+            out(out)
+    {
+    }
+
+    void onRead(Bottle& datum) override
+    {
+        out.prepare() = datum;
+        out.writeStrict();
+    }
+
+private:
+    BufferedPort<Bottle>& out;
+};
+
+// A message with a blob of the requested size
+Bottle makePayload(int64_t size)
+{
+    std::vector<char> data(static_cast<size_t>(size), 'x');
+    Bottle b;
+    b.add(yarp::os::Value(data.data(), static_cast<int>(data.size())));
+    return b;
+}
+
+bool connect(const std::string& src, const std::string& dest, const std::string& carrier)
+{
+    return Network::connect(src, dest, carrier, true);
+}
+
+// Round trip of a message, through a port that writes it back
+void BufferedPort_roundTrip(benchmark::State& state, const std::string& carrier)
+{
+    // The callbacks must outlive the ports using them
+    BufferedPort<Bottle> echoOut;
+    Echo echo(echoOut);
+    Receiver receiver;
+    BufferedPort<Bottle> ping;
+    BufferedPort<Bottle> echoIn;
+    BufferedPort<Bottle> pong;
+    echoIn.useCallback(echo);
+    pong.useCallback(receiver);
+    echoIn.setStrict();
+    pong.setStrict();
+
+    if (!ping.open("/benchmark/ping:o") || !echoIn.open("/benchmark/echo:i") || !echoOut.open("/benchmark/echo:o") || !pong.open("/benchmark/pong:i")) {
+        state.skip("cannot open the ports");
+        return;
+    }
+    if (!connect(ping.getName(), echoIn.getName(), carrier) || !connect(echoOut.getName(), pong.getName(), carrier)) {
+        state.skip("cannot connect with carrier " + carrier);
+        return;
+    }
+
+    const Bottle payload = makePayload(state.arg());
+
+    // The first messages may be lost while the connections are set up
+    bool ready = false;
+    for (int i = 0; i < 10 && !ready; i++) {
+        size_t expected = receiver.count() + 1;
+        ping.prepare() = payload;
+        ping.writeStrict();
+        ready = receiver.waitFor(expected);
+    }
+    if (!ready) {
+        state.skip("no reply with carrier " + carrier);
+        return;
+    }
+
+    int64_t lost = 0;
+    while (state.keepRunning()) {
+        size_t expected = receiver.count() + 1;
+        ping.prepare() = payload;
+        ping.writeStrict();
+        if (!receiver.waitFor(expected) && ++lost > max_lost) {
+            state.skip("too many messages lost with carrier " + carrier);
+            break;
+        }
+    }
+
+    state.setBytesProcessed(2 * state.iterations() * state.arg());
+    state.setCounter("lost", static_cast<double>(lost));
+}
+
+// Messages written back to back, as fast as the connection allows
+void BufferedPort_throughput(benchmark::State& state, const std::string& carrier)
+{
+    Receiver receiver;
+    BufferedPort<Bottle> out;
+    BufferedPort<Bottle> in;
+    in.useCallback(receiver);
+    // Do not drop the messages received while the callback is running
+    in.setStrict();
+
+    if (!out.open("/benchmark/out:o") || !in.open("/benchmark/in:i")) {
+        state.skip("cannot open the ports");
+        return;
+    }
+    if (!connect(out.getName(), in.getName(), carrier)) {
+        state.skip("cannot connect with carrier " + carrier);
+        return;
+    }
+
+    const Bottle payload = makePayload(state.arg());
+
+    bool ready = false;
+    for (int i = 0; i < 10 && !ready; i++) {
+        size_t expected = receiver.count() + 1;
+        out.prepare() = payload;
+        out.writeStrict();
+        ready = receiver.waitFor(expected);
+    }
+    if (!ready) {
+        state.skip("nothing received with carrier " + carrier);
+        return;
+    }
+
+    const size_t first = receiver.count();
+    int64_t sent = 0;
+    while (state.keepRunning()) {
+        out.prepare() = payload;
+        out.writeStrict();
+        // Wait for the last message, before the timer is stopped
+        if (++sent == state.iterations()) {
+            receiver.waitFor(first + static_cast<size_t>(sent));
+        }
+    }
+
+    int64_t received = static_cast<int64_t>(receiver.count() - first);
+    state.setBytesProcessed(received * state.arg());
+    state.setItemsProcessed(received);
+    state.setCounter("lost", static_cast<double>(sent - received));
+}
+
+// Throughput of the datagram carriers, with datagrams that fit in the
+// ethernet frames, as they are usually configured on a real network.
+// With scaledDelay the delay between the datagrams is proportional to their
+// size.
+void BufferedPort_throughputMtu(benchmark::State& state, const std::string& carrier, bool scaledDelay)
+{
+    const std::string key = (carrier == "mcast") ? "YARP_MCAST_SIZE" : "YARP_UDP_SIZE";
+    Network::setEnvironment(key, "1472");
+    if (scaledDelay) {
+        Network::setEnvironment("YARP_DGRAM_SCALED_DELAY", "1");
+    }
+    BufferedPort_throughput(state, carrier);
+    Network::unsetEnvironment("YARP_DGRAM_SCALED_DELAY");
+    Network::unsetEnvironment(key);
+}
+
+const bool registered = []() {
+    for (const char* carrier : carriers) {
+        std::string name(carrier);
+        benchmark::registerBenchmark("BufferedPort_roundTrip/" + name,
+                                     [name](benchmark::State& state) { BufferedPort_roundTrip(state, name); })
+            ->args({64, 4096, 65536, 1048576});
+    }
+    for (const char* carrier : carriers) {
+        std::string name(carrier);
+        benchmark::registerBenchmark("BufferedPort_throughput/" + name,
+                                     [name](benchmark::State& state) { BufferedPort_throughput(state, name); })
+            ->args({64, 4096, 65536, 1048576});
+    }
+    for (const char* carrier : {"udp", "mcast"}) {
+        std::string name(carrier);
+        benchmark::registerBenchmark("BufferedPort_throughput/" + name + "_mtu",
+                                     [name](benchmark::State& state) { BufferedPort_throughputMtu(state, name, false); })
+            ->args({64, 4096, 65536, 1048576});
+        benchmark::registerBenchmark("BufferedPort_throughput/" + name + "_mtu_scaled",
+                                     [name](benchmark::State& state) { BufferedPort_throughputMtu(state, name, true); })
+            ->args({64, 4096, 65536, 1048576, 4194304});
+    }
+    return true;
+}();
+
+} // namespace
@@ -0,0 +1,529 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include "benchmark.h"
+
+#include <yarp/conf/version.h>
+#include <yarp/os/Network.h>
+#include <yarp/os/Os.h>
+#include <yarp/os/Property.h>
+#include <yarp/os/SystemInfo.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <regex>
+#include <sstream>
+#include <tuple>
+
+using benchmark::Registration;
+using benchmark::State;
+
+namespace {
+
+constexpr int64_t max_iterations = 1000000000;
+
+std::vector<std::unique_ptr<Registration>>& registry()
+{
+    static std::vector<std::unique_ptr<Registration>> benchmarks;
+    return benchmarks;
+}
+
+struct Statistics
+{
+    double mean {0.0};
+    double median {0.0};
+    double stddev {0.0};
+    double min {0.0};
+};
+
+Statistics computeStatistics(std::vector<double> values)
+{
+    Statistics s;
+    if (values.empty()) {
+        return s;
+    }
+    std::sort(values.begin(), values.end());
+    double sum = 0.0;
+    for (double v : values) {
+        sum += v;
+    }
+    s.mean = sum / values.size();
+    size_t n = values.size();
+    s.median = (n % 2 == 1) ? values[n / 2] : (values[n / 2 - 1] + values[n / 2]) / 2;
+    s.min = values.front();
+    if (n > 1) {
+        double var = 0.0;
+        for (double v : values) {
+            var += (v - s.mean) * (v - s.mean);
+        }
+        s.stddev = std::sqrt(var / (n - 1));
+    }
+    return s;
+}
+
+// The results of one benchmark, for one argument
+struct Result
+{
+    std::string name;
+    std::string label;
+    bool skipped {false};
+    std::string skip_reason;
+    int64_t iterations {0};
+    size_t repetitions {0};
+    Statistics real_time;       // ns per iteration
+    Statistics cpu_time;        // ns per iteration
+    double bytes_per_second {0.0};
+    double items_per_second {0.0};
+    std::map<std::string, double> counters;
+};
+
+struct Options
+{
+    std::string filter {".*"};
+    double min_time {0.5};
+    size_t repetitions {3};
+    std::string format {"console"};
+    std::string out;
+};
+
+Result runBenchmark(const Registration& reg, const std::string& name, int64_t arg, const Options& options)
+{
+    Result result;
+    result.name = name;
+
+    int64_t limit = reg.getMaxIterations() > 0 ? reg.getMaxIterations() : max_iterations;
+
+    // Find the number of iterations that lasts at least min_time
+    int64_t iterations = 1;
+    while (true) {
+        State state(arg, iterations);
+        reg.run(state);
+        if (state.isSkipped()) {
+            result.skipped = true;
+            result.skip_reason = state.getSkipReason();
+            return result;
+        }
+        double elapsed = state.getRealTime();
+        if (elapsed >= options.min_time || iterations >= limit) {
+            break;
+        }
+        double multiplier = (elapsed < options.min_time / 10) ? 10.0 : options.min_time * 1.4 / elapsed;
+        iterations = std::min(limit, std::max(iterations + 1, static_cast<int64_t>(iterations * multiplier)));
+    }
+
+    std::vector<double> real_times;
+    std::vector<double> cpu_times;
+    double bytes = 0.0;
+    double items = 0.0;
+    double total_time = 0.0;
+    for (size_t r = 0; r < options.repetitions; r++) {
+        State state(arg, iterations);
+        reg.run(state);
+        if (state.isSkipped()) {
+            result.skipped = true;
+            result.skip_reason = state.getSkipReason();
+            return result;
+        }
+        real_times.push_back(state.getRealTime() * 1e9 / iterations);
+        cpu_times.push_back(state.getCpuTime() * 1e9 / iterations);
+        bytes += state.getBytesProcessed();
+        items += state.getItemsProcessed();
+        total_time += state.getRealTime();
+        for (const auto& counter : state.getCounters()) {
+            result.counters[counter.first] += counter.second / options.repetitions;
+        }
+        result.label = state.getLabel();
+    }
+
+    result.iterations = iterations;
+    result.repetitions = options.repetitions;
+    result.real_time = computeStatistics(real_times);
+    result.cpu_time = computeStatistics(cpu_times);
+    if (total_time > 0.0) {
+        result.bytes_per_second = bytes / total_time;
+        result.items_per_second = items / total_time;
+    }
+    return result;
+}
+
+
+std::string escapeJson(const std::string& text)
+{
+    std::string ret;
+    for (char c : text) {
+        switch (c) {
+        case '"': ret += "\\\""; break;
+        case '\\': ret += "\\\\"; break;
+        case '\n': ret += "\\n"; break;
+        case '\t': ret += "\\t"; break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                char buf[8];
+                std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                ret += buf;
+            } else {
+                ret += c;
+            }
+        }
+    }
+    return ret;
+}
+
+std::string currentDate()
+{
+    std::time_t now = std::time(nullptr);
+    char buf[64];
+    std::strftime(buf, sizeof(buf), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+    return buf;
+}
+
+std::string humanReadable(double value, const char* unit)
+{
+    const char* prefixes[] = {"", "k", "M", "G", "T"};
+    size_t i = 0;
+    while (value >= 1024.0 && i < 4) {
+        value /= 1024.0;
+        i++;
+    }
+    std::ostringstream os;
+    os << std::fixed << std::setprecision(2) << value << prefixes[i] << unit;
+    return os.str();
+}
+
+// Console output, one line per benchmark
+void reportConsole(std::ostream& os, const std::vector<Result>& results)
+{
+    size_t width = 10;
+    for (const auto& r : results) {
+        width = std::max(width, r.name.size());
+    }
+
+    os << std::left << std::setw(width + 2) << "Benchmark"
+       << std::right << std::setw(14) << "Time (ns)"
+       << std::setw(14) << "CPU (ns)"
+       << std::setw(12) << "StdDev %"
+       << std::setw(14) << "Iterations"
+       << "  Notes\n";
+    os << std::string(width + 2 + 14 + 14 + 12 + 14 + 7, '-') << '\n';
+
+    for (const auto& r : results) {
+        os << std::left << std::setw(width + 2) << r.name << std::right;
+        if (r.skipped) {
+            os << "  SKIPPED: " << r.skip_reason << '\n';
+            continue;
+        }
+        double rel = r.real_time.mean > 0.0 ? 100.0 * r.real_time.stddev / r.real_time.mean : 0.0;
+        os << std::fixed << std::setprecision(1)
+           << std::setw(14) << r.real_time.mean
+           << std::setw(14) << r.cpu_time.mean
+           << std::setw(12) << rel
+           << std::setw(14) << r.iterations
+           << " ";
+        if (r.bytes_per_second > 0.0) {
+            os << ' ' << humanReadable(r.bytes_per_second, "B/s");
+        }
+        if (r.items_per_second > 0.0) {
+            os << ' ' << humanReadable(r.items_per_second, " items/s");
+        }
+        for (const auto& c : r.counters) {
+            os << ' ' << c.first << '=' << std::setprecision(2) << c.second;
+        }
+        if (!r.label.empty()) {
+            os << ' ' << r.label;
+        }
+        os << '\n';
+    }
+}
+
+// JSON output, using the same schema as Google Benchmark, so that its tools
+// can be used to compare two runs
+void reportJson(std::ostream& os, const std::vector<Result>& results)
+{
+    os << "{\n";
+    os << "  \"context\": {\n";
+    os << "    \"date\": \"" << currentDate() << "\",\n";
+    os << "    \"host_name\": \"" << escapeJson(yarp::os::gethostname()) << "\",\n";
+    os << "    \"executable\": \"yarp-benchmark\",\n";
+    os << "    \"platform\": \"" << escapeJson(yarp::os::SystemInfo::getPlatformInfo().name) << "\",\n";
+    os << "    \"num_cpus\": " << yarp::os::SystemInfo::getProcessorInfo().cores << ",\n";
+    os << "    \"yarp_version\": \"" << YARP_VERSION << "\",\n";
+#ifdef NDEBUG
+    os << "    \"library_build_type\": \"release\"\n";
+#else
+    os << "    \"library_build_type\": \"debug\"\n";
+#endif
+    os << "  },\n";
+    os << "  \"benchmarks\": [";
+
+    const char* separator = "\n";
+    for (const auto& r : results) {
+        if (r.skipped) {
+            os << separator;
+            os << "    {\n";
+            os << "      \"name\": \"" << escapeJson(r.name) << "\",\n";
+            os << "      \"run_name\": \"" << escapeJson(r.name) << "\",\n";
+            os << "      \"run_type\": \"iteration\",\n";
+            os << "      \"error_occurred\": true,\n";
+            os << "      \"error_message\": \"" << escapeJson(r.skip_reason) << "\"\n";
+            os << "    }";
+            separator = ",\n";
+            continue;
+        }
+
+        const std::pair<const char*, double Statistics::*> aggregates[] = {
+            {"mean", &Statistics::mean},
+            {"median", &Statistics::median},
+            {"stddev", &Statistics::stddev},
+            {"min", &Statistics::min},
+        };
+        for (const auto& aggregate : aggregates) {
+            os << separator;
+            os << "    {\n";
+            os << "      \"name\": \"" << escapeJson(r.name) << "_" << aggregate.first << "\",\n";
+            os << "      \"run_name\": \"" << escapeJson(r.name) << "\",\n";
+            os << "      \"run_type\": \"aggregate\",\n";
+            os << "      \"repetitions\": " << r.repetitions << ",\n";
+            os << "      \"aggregate_name\": \"" << aggregate.first << "\",\n";
+            os << "      \"iterations\": " << r.iterations << ",\n";
+            os << std::setprecision(10);
+            os << "      \"real_time\": " << r.real_time.*aggregate.second << ",\n";
+            os << "      \"cpu_time\": " << r.cpu_time.*aggregate.second << ",\n";
+            os << "      \"time_unit\": \"ns\"";
+            if (aggregate.second == &Statistics::mean) {
+                if (r.bytes_per_second > 0.0) {
+                    os << ",\n      \"bytes_per_second\": " << r.bytes_per_second;
+                }
+                if (r.items_per_second > 0.0) {
+                    os << ",\n      \"items_per_second\": " << r.items_per_second;
+                }
+                for (const auto& c : r.counters) {
+                    os << ",\n      \"" << escapeJson(c.first) << "\": " << c.second;
+                }
+                if (!r.label.empty()) {
+                    os << ",\n      \"label\": \"" << escapeJson(r.label) << "\"";
+                }
+            }
+            os << "\n    }";
+            separator = ",\n";
+        }
+    }
+    os << "\n  ]\n";
+    os << "}\n";
+}
+
+// CSV output, one row per benchmark
+void reportCsv(std::ostream& os, const std::vector<Result>& results)
+{
+    os << "name,iterations,repetitions,real_time_mean,real_time_median,real_time_stddev,real_time_min,"
+          "cpu_time_mean,time_unit,bytes_per_second,items_per_second,label,error_occurred,error_message\n";
+    os << std::setprecision(10);
+    for (const auto& r : results) {
+        os << '"' << r.name << "\",";
+        if (r.skipped) {
+            os << ",,,,,,,,,,,true,\"" << r.skip_reason << "\"\n";
+            continue;
+        }
+        os << r.iterations << ','
+           << r.repetitions << ','
+           << r.real_time.mean << ','
+           << r.real_time.median << ','
+           << r.real_time.stddev << ','
+           << r.real_time.min << ','
+           << r.cpu_time.mean << ','
+           << "ns,"
+           << r.bytes_per_second << ','
+           << r.items_per_second << ','
+           << '"' << r.label << "\","
+           << "false,\n";
+    }
+}
+
+void printHelp()
+{
+    std::cout << "Usage: yarp-benchmark [options]\n"
+              << "\n"
+              << "Options:\n"
+              << "  --list                  list the benchmarks and exit\n"
+              << "  --filter <regex>        run only the benchmarks matching the regex\n"
+              << "  --min-time <s>          minimum duration of each repetition (default 0.5)\n"
+              << "  --repetitions <n>       number of repetitions (default 3)\n"
+              << "  --format <format>       console, json or csv (default console)\n"
+              << "  --out <file>            write the results to a file instead of stdout\n"
+              << "  --network               use the name server, instead of running in local mode\n"
+              << "\n"
+              << "Set YARP_QUIET=1 in the environment to hide the messages printed by the ports.\n";
+}
+
+} // namespace
+
+
+State::State(int64_t arg, int64_t max_iterations) :
+        argument(arg),
+        max_iterations(max_iterations)
+{
+}
+
+void State::start()
+{
+    running = true;
+    real_start = std::chrono::steady_clock::now();
+    cpu_start = std::clock();
+}
+
+void State::stop()
+{
+    if (!running) {
+        return;
+    }
+    running = false;
+    real_time += std::chrono::duration<double>(std::chrono::steady_clock::now() - real_start).count();
+    cpu_time += static_cast<double>(std::clock() - cpu_start) / CLOCKS_PER_SEC;
+}
+
+void State::pauseTiming()
+{
+    stop();
+}
+
+void State::resumeTiming()
+{
+    start();
+}
+
+void State::skip(const std::string& reason)
+{
+    stop();
+    skipped = true;
+    skip_reason = reason;
+    count = max_iterations;
+}
+
+
+Registration::Registration(std::string name, std::function<void(State&)> function) :
+        name(std::move(name)),
+        function(std::move(function))
+{
+}
+
+Registration* Registration::args(std::initializer_list<int64_t> values)
+{
+    arguments.insert(arguments.end(), values.begin(), values.end());
+    return this;
+}
+
+Registration* Registration::maxIterations(int64_t n)
+{
+    max_iterations = n;
+    return this;
+}
+
+Registration* benchmark::registerBenchmark(const std::string& name, std::function<void(State&)> function)
+{
+    registry().emplace_back(new Registration(name, std::move(function)));
+    return registry().back().get();
+}
+
+#if !defined(__GNUC__) && !defined(__clang__)
+void benchmark::useCharPointer(const volatile char*)
+{
+}
+#endif
+
+
+int main(int argc, char* argv[])
+{
+    yarp::os::Property config;
+    config.fromCommand(argc, argv);
+
+    if (config.check("help")) {
+        printHelp();
+        return 0;
+    }
+
+    Options options;
+    options.filter = config.check("filter", yarp::os::Value(".*")).asString();
+    options.min_time = config.check("min-time", yarp::os::Value(0.5)).asFloat64();
+    options.repetitions = static_cast<size_t>(std::max(1, config.check("repetitions", yarp::os::Value(3)).asInt32()));
+    options.format = config.check("format", yarp::os::Value("console")).asString();
+    options.out = config.check("out", yarp::os::Value("")).asString();
+
+    if (options.format != "console" && options.format != "json" && options.format != "csv") {
+        std::cerr << "Unknown format " << options.format << '\n';
+        return 1;
+    }
+
+    std::regex filter;
+    try {
+        filter = std::regex(options.filter);
+    } catch (const std::regex_error&) {
+        std::cerr << "Invalid filter " << options.filter << '\n';
+        return 1;
+    }
+
+    // The names of all the benchmarks, with their arguments
+    std::vector<std::tuple<const Registration*, std::string, int64_t>> selected;
+    for (const auto& reg : registry()) {
+        if (reg->getArgs().empty()) {
+            if (std::regex_search(reg->getName(), filter)) {
+                selected.emplace_back(reg.get(), reg->getName(), 0);
+            }
+            continue;
+        }
+        for (int64_t arg : reg->getArgs()) {
+            std::string name = reg->getName() + "/" + std::to_string(arg);
+            if (std::regex_search(name, filter)) {
+                selected.emplace_back(reg.get(), name, arg);
+            }
+        }
+    }
+
+    if (config.check("list")) {
+        for (const auto& s : selected) {
+            std::cout << std::get<1>(s) << '\n';
+        }
+        return 0;
+    }
+
+    yarp::os::Network yarp;
+    if (!config.check("network")) {
+        yarp::os::Network::setLocalMode(true);
+    }
+
+    std::vector<Result> results;
+    for (const auto& s : selected) {
+        if (options.format == "console" && options.out.empty()) {
+            std::cerr << "Running " << std::get<1>(s) << "...\n";
+        }
+        results.push_back(runBenchmark(*std::get<0>(s), std::get<1>(s), std::get<2>(s), options));
+    }
+
+    std::ofstream file;
+    if (!options.out.empty()) {
+        file.open(options.out);
+        if (!file.is_open()) {
+            std::cerr << "Cannot open " << options.out << '\n';
+            return 1;
+        }
+    }
+    std::ostream& os = options.out.empty() ? std::cout : file;
+
+    if (options.format == "json") {
+        reportJson(os, results);
+    } else if (options.format == "csv") {
+        reportCsv(os, results);
+    } else {
+        reportConsole(os, results);
+    }
+
+    return 0;
+}
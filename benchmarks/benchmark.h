@@ -0,0 +1,189 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef YARP_BENCHMARKS_BENCHMARK_H
+#define YARP_BENCHMARKS_BENCHMARK_H
+
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <functional>
+#include <initializer_list>
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * A minimal micro-benchmark framework, modelled after Google Benchmark.
+ *
+ * A benchmark is a function taking a State, that runs the code to measure in
+ * a `while (state.keepRunning())` loop.
+ * The number of iterations is chosen by the runner, so that each repetition
+ * lasts at least `--min-time` seconds, and the results of all the repetitions
+ * are reported as mean, median, standard deviation and minimum.
+ *
+ * \code
+ * void BM_something(benchmark::State& state)
+ * {
+ *     // Setup, not measured
+ *     while (state.keepRunning()) {
+ *         // Measured
+ *     }
+ *     state.setBytesProcessed(state.iterations() * state.arg());
+ * }
+ * YARP_BENCHMARK(BM_something)->args({64, 1024});
+ * \endcode
+ */
+namespace benchmark {
+
+class State
+{
+public:
+    State(int64_t arg, int64_t max_iterations);
+
+    /**
+     * @return true until the requested number of iterations was executed.
+     * The timer is started by the first call.
+     */
+    bool keepRunning()
+    {
+        if (count == 0) {
+            start();
+        }
+        if (count < max_iterations) {
+            count++;
+            return true;
+        }
+        stop();
+        return false;
+    }
+
+    /**
+     * Stop the timer, e.g. to prepare the data for the next iteration.
+     */
+    void pauseTiming();
+
+    /**
+     * Restart the timer after pauseTiming().
+     */
+    void resumeTiming();
+
+    /**
+     * Abort the benchmark, and report it as skipped.
+     */
+    void skip(const std::string& reason);
+
+    int64_t arg() const { return argument; }
+    int64_t iterations() const { return max_iterations; }
+
+    void setBytesProcessed(int64_t bytes) { bytes_processed = bytes; }
+    void setItemsProcessed(int64_t items) { items_processed = items; }
+
+    /**
+     * Report a custom value (e.g. the number of messages lost), averaged
+     * over the repetitions.
+     */
+    void setCounter(const std::string& name, double value) { counters[name] = value; }
+
+    void setLabel(const std::string& text) { label = text; }
+
+    // Used by the runner
+    bool isSkipped() const { return skipped; }
+    const std::string& getSkipReason() const { return skip_reason; }
+    double getRealTime() const { return real_time; }
+    double getCpuTime() const { return cpu_time; }
+    int64_t getBytesProcessed() const { return bytes_processed; }
+    int64_t getItemsProcessed() const { return items_processed; }
+    const std::map<std::string, double>& getCounters() const { return counters; }
+    const std::string& getLabel() const { return label; }
+
+private:
+    void start();
+    void stop();
+
+    int64_t argument;
+    int64_t max_iterations;
+    int64_t count {0};
+    bool running {false};
+    bool skipped {false};
+    std::string skip_reason;
+    std::chrono::steady_clock::time_point real_start;
+    std::clock_t cpu_start {0};
+    double real_time {0.0};
+    double cpu_time {0.0};
+    int64_t bytes_processed {0};
+    int64_t items_processed {0};
+    std::map<std::string, double> counters;
+    std::string label;
+};
+
+
+class Registration
+{
+public:
+    Registration(std::string name, std::function<void(State&)> function);
+
+    /**
+     * Run the benchmark once for each argument.
+     */
+    Registration* args(std::initializer_list<int64_t> values);
+
+    /**
+     * Do not run more than \c n iterations per repetition (e.g. for
+     * benchmarks with an expensive setup).
+     */
+    Registration* maxIterations(int64_t n);
+
+    const std::string& getName() const { return name; }
+    const std::vector<int64_t>& getArgs() const { return arguments; }
+    int64_t getMaxIterations() const { return max_iterations; }
+    void run(State& state) const { function(state); }
+
+private:
+    std::string name;
+    std::function<void(State&)> function;
+    std::vector<int64_t> arguments;
+    int64_t max_iterations {0};
+};
+
+/**
+ * Register a benchmark.
+ * The registration is owned by the framework.
+ */
+Registration* registerBenchmark(const std::string& name, std::function<void(State&)> function);
+
+
+/**
+ * Prevent the compiler from optimizing away the computation of \c value.
+ */
+#if defined(__GNUC__) || defined(__clang__)
+template <typename T>
+inline void doNotOptimize(const T& value)
+{
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+#else
+void useCharPointer(const volatile char*);
+
+template <typename T>
+inline void doNotOptimize(const T& value)
+{
+    useCharPointer(&reinterpret_cast<const volatile char&>(value));
+}
+#endif
+
+} // namespace benchmark
+
+#define YARP_BENCHMARK_CONCAT_(a, b) a##b
+#define YARP_BENCHMARK_CONCAT(a, b) YARP_BENCHMARK_CONCAT_(a, b)
+
+#define YARP_BENCHMARK(function)                                                 \
+    static benchmark::Registration* YARP_BENCHMARK_CONCAT(yarp_benchmark_, __LINE__) = \
+        benchmark::registerBenchmark(#function, function)
+
+#endif // YARP_BENCHMARKS_BENCHMARK_H
@@ -666,6 +666,8 @@ yarp_print_feature(YARP_ENABLE_BROKEN_TESTS 1 "Enable broken tests")
 yarp_print_feature(YARP_ENABLE_INTEGRATION_TESTS 1 "Run integration tests")
 yarp_print_feature(YARP_VALGRIND_TESTS 1 "Run YARP tests under Valgrind")
 
+yarp_print_feature(YARP_COMPILE_BENCHMARKS 0 "Compile YARP benchmarks")
+
 
 ################################################################################
 # Check options consistency
@@ -161,6 +161,12 @@ mark_as_advanced(YARP_ENABLE_INTEGRATION_TESTS)
 yarp_renamed_option(YARP_TEST_INTEGRATION YARP_ENABLE_INTEGRATION_TESTS) # since YARP 3.2.0
 
 
+#########################################################################
+# Benchmarks
+
+option(YARP_COMPILE_BENCHMARKS "Enable YARP benchmarks" OFF)
+
+
 #########################################################################
 # Run tests under Valgrind
 
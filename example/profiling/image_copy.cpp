@@ -0,0 +1,97 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/os/SystemClock.h>
+#include <yarp/sig/Image.h>
+
+#include <cstdio>
+
+using yarp::os::SystemClock;
+using namespace yarp::sig;
+
+// Compare ImageOf::copy() with a plain per pixel conversion loop, similar to
+// the one used by copyPixels() for the formats without a vectorized
+// implementation.
+
+constexpr size_t width = 640;
+constexpr size_t height = 480;
+constexpr int rounds = 500;
+
+template <class T1, class T2, class Convert>
+void benchmark(const char* name, Convert convert)
+{
+    ImageOf<T1> src;
+    src.resize(width, height);
+    for (size_t i = 0; i < src.getRawImageSize(); i++) {
+        src.getRawImage()[i] = static_cast<unsigned char>(i * 37);
+    }
+    ImageOf<T2> dest;
+    dest.resize(width, height);
+
+    double start = SystemClock::nowSystem();
+    for (int k = 0; k < rounds; k++) {
+        for (size_t y = 0; y < height; y++) {
+            const T1* s = reinterpret_cast<const T1*>(src.getRow(y));
+            T2* d = reinterpret_cast<T2*>(dest.getRow(y));
+            for (size_t x = 0; x < width; x++) {
+                convert(s[x], d[x]);
+            }
+        }
+    }
+    double loop = (SystemClock::nowSystem() - start) / rounds;
+
+    start = SystemClock::nowSystem();
+    for (int k = 0; k < rounds; k++) {
+        dest.copy(src);
+    }
+    double copy = (SystemClock::nowSystem() - start) / rounds;
+
+    printf("%-20s loop %8.1f us   copy() %8.1f us   speedup %5.2fx\n",
+           name, loop * 1e6, copy * 1e6, loop / copy);
+}
+
+int main()
+{
+    printf("Converting %zux%zu images, average of %d rounds\n", width, height, rounds);
+
+    benchmark<PixelRgb, PixelBgr>("rgb -> bgr", [](const PixelRgb& s, PixelBgr& d) {
+        d.r = s.r;
+        d.g = s.g;
+        d.b = s.b;
+    });
+    benchmark<PixelRgb, PixelMono>("rgb -> mono", [](const PixelRgb& s, PixelMono& d) {
+        d = static_cast<PixelMono>((s.r + s.g + s.b) / 3);
+    });
+    benchmark<PixelMono, PixelRgb>("mono -> rgb", [](const PixelMono& s, PixelRgb& d) {
+        d.r = s;
+        d.g = s;
+        d.b = s;
+    });
+    benchmark<PixelRgb, PixelRgba>("rgb -> rgba", [](const PixelRgb& s, PixelRgba& d) {
+        d.r = s.r;
+        d.g = s.g;
+        d.b = s.b;
+        d.a = 255;
+    });
+    benchmark<PixelRgb, PixelBgra>("rgb -> bgra", [](const PixelRgb& s, PixelBgra& d) {
+        d.r = s.r;
+        d.g = s.g;
+        d.b = s.b;
+        d.a = 255;
+    });
+    benchmark<PixelRgba, PixelRgb>("rgba -> rgb", [](const PixelRgba& s, PixelRgb& d) {
+        d.r = s.r;
+        d.g = s.g;
+        d.b = s.b;
+    });
+    benchmark<PixelMono16, PixelFloat>("mono16 -> float", [](const PixelMono16& s, PixelFloat& d) {
+        d = static_cast<float>(s);
+    });
+
+    return 0;
+}
@@ -12,13 +12,21 @@
 #include <yarp/os/Contact.h>
 #include <yarp/os/impl/FakeFace.h>
 #include <yarp/os/Name.h>
+#include <yarp/os/NetInt32.h>
+#include <yarp/os/Property.h>
+#include <yarp/os/Route.h>
 #include <yarp/os/ConnectionState.h>
+#include <yarp/wire_rep_utils/WireImage.h>
 #include <cstdio>
+#include <cstring>
 
 
 using namespace yarp::os;
 using namespace yarp::sig;
 
+// Sent by the receiver when the stream comes from a yarp port
+static constexpr const char* h264_header = "H264YARP";
+
 
 
 std::string H264Carrier::getName() const
@@ -84,11 +92,17 @@ std::string H264Carrier::toString() const
 
 void H264Carrier::getHeader(Bytes& header) const
 {
+    for (size_t i = 0; i < 8 && i < header.length(); i++) {
+        header.get()[i] = h264_header[i];
+    }
 }
 
 bool H264Carrier::checkHeader(const Bytes& header)
 {
-    return true;
+    if (header.length() != 8) {
+        return false;
+    }
+    return memcmp(header.get(), h264_header, 8) == 0;
 }
 
 void H264Carrier::setParameters(const Bytes& header)
@@ -98,12 +112,12 @@ void H264Carrier::setParameters(const Bytes& header)
 }
 
 
-static int getIntParam(Name &n, const char *param)
+static int getIntParam(Name &n, const char *param, int defaultValue = 0)
 {
     bool hasField;
     std::string strValue = n.getCarrierModifier(param, &hasField);
     Value *v = Value::makeValue(strValue);
-    int intvalue = 0;
+    int intvalue = defaultValue;
     if((hasField) && v->isInt32())
     {
         intvalue = v->asInt32();
@@ -125,37 +139,104 @@ bool H264Carrier::prepareSend(ConnectionState& proto)
     cfgParams.crop.bottom = getIntParam(n, "cropBottom");
     cfgParams.fps_max = getIntParam(n, "max_fps");
     cfgParams.removeJitter = (getIntParam(n, "removeJitter") > 0) ? true : false;
+
+    // parameters of the encoder, sent to the port in sendHeader
+    encoderParams.bitrate = getIntParam(n, "bitrate", encoderParams.bitrate);
+    encoderParams.keyint = getIntParam(n, "keyint", encoderParams.keyint);
+    encoderParams.lowLatency = getIntParam(n, "lowLatency", encoderParams.lowLatency ? 1 : 0) > 0;
+
+    // The ports registered by hand (see the documentation) are external
+    // streamers, otherwise the stream is requested to the yarp port
+    cfgParams.fromPort = (proto.getRoute().getToContact().getCarrier() != getName());
     return true;
 }
 
 bool H264Carrier::sendHeader(ConnectionState& proto)
 {
     yCTrace(H264CARRIER, "sendHeader");
-    return true;
+    if (!cfgParams.fromPort) {
+        return true;
+    }
+
+    // header, name of the receiver and parameters of the encoder
+    Property params;
+    params.put("bitrate", encoderParams.bitrate);
+    params.put("keyint", encoderParams.keyint);
+    params.put("lowLatency", encoderParams.lowLatency ? 1 : 0);
+    std::string request = std::string(h264_header, 8) +
+                          proto.getRoute().getFromName() + "\n" +
+                          params.toString() + "\n";
+    Bytes b(const_cast<char*>(request.c_str()), request.length());
+    proto.os().write(b);
+    proto.os().flush();
+    return proto.os().isOk();
 }
 
 bool H264Carrier::expectSenderSpecifier(ConnectionState& proto)
 {
     yCTrace(H264CARRIER, "expectSenderSpecifier");
+    bool ok = false;
+    std::string name = proto.is().readLine('\n', &ok);
+    if (!ok) {
+        return false;
+    }
+    Route route = proto.getRoute();
+    route.setFromName(name);
+    proto.setRoute(route);
     return true;
 }
 
 bool H264Carrier::expectExtraHeader(ConnectionState& proto)
 {
     yCTrace(H264CARRIER, "expectExtraHeader");
+    bool ok = false;
+    std::string line = proto.is().readLine('\n', &ok);
+    if (!ok) {
+        return false;
+    }
+    Property params;
+    params.fromString(line);
+    encoderParams.bitrate = params.check("bitrate", Value(encoderParams.bitrate)).asInt32();
+    encoderParams.keyint = params.check("keyint", Value(encoderParams.keyint)).asInt32();
+    encoderParams.lowLatency = params.check("lowLatency", Value(encoderParams.lowLatency ? 1 : 0)).asInt32() > 0;
+    if (encoderParams.bitrate <= 0 || encoderParams.keyint <= 0) {
+        yCError(H264CARRIER, "Invalid encoder parameters %s", line.c_str());
+        return false;
+    }
+    encoder.configure(encoderParams);
     return true;
 }
 
 bool H264Carrier::respondToHeader(ConnectionState& proto)
 {
     yCTrace(H264CARRIER, "respondToHeader");
-    return true;
+    std::string reply = "ok\n";
+    Bytes b(const_cast<char*>(reply.c_str()), reply.length());
+    proto.os().write(b);
+    proto.os().flush();
+    sender = true; // this is a pull connection, not a push
+    return proto.os().isOk();
 }
 
 bool H264Carrier::expectReplyToHeader(ConnectionState& proto)
 {
     // I'm the receiver...
 
+    if (cfgParams.fromPort) {
+        bool ok = false;
+        std::string reply = proto.is().readLine('\n', &ok);
+        if (!ok || reply != "ok") {
+            yCError(H264CARRIER, "%s cannot send the h264 stream", proto.getRoute().getToName().c_str());
+            return false;
+        }
+
+        auto* stream = new H264Stream(cfgParams);
+        stream->setStream(proto.giveStreams());
+        stream->start();
+        proto.takeStreams(stream);
+        return true;
+    }
+
     cfgParams.remotePort = proto.getRoute().getToContact().getPort();
 
     auto* stream = new H264Stream(cfgParams);
@@ -183,8 +264,35 @@ bool H264Carrier::isActive() const
 
 bool H264Carrier::write(ConnectionState& proto, SizedWriter& writer)
 {
-    //I should not be here: the carried doesn't perform writing
-    return false;
+    if (!sender) {
+        //I should not be here: the receiver doesn't perform writing
+        return false;
+    }
+
+    yarp::wire_rep_utils::WireImage rep;
+    FlexImage *img = rep.checkForImage(writer);
+    if (img == nullptr) {
+        return false;
+    }
+
+    if (!encoder.encode(*img, units)) {
+        return false;
+    }
+
+    // each access unit is preceded by its length
+    for (auto& unit : units) {
+        if (unit.size() > h264_max_unit_size) {
+            yCError(H264CARRIER, "The access unit is too large (%zu bytes)", unit.size());
+            return false;
+        }
+        NetInt32 len = static_cast<NetInt32>(unit.size());
+        Bytes header(reinterpret_cast<char*>(&len), sizeof(len));
+        proto.os().write(header);
+        Bytes data(unit.data(), unit.size());
+        proto.os().write(data);
+    }
+    proto.os().flush();
+    return proto.os().isOk();
 }
 
 bool H264Carrier::reply(ConnectionState& proto, SizedWriter& writer)
@@ -12,12 +12,17 @@
 #include <yarp/os/Carrier.h>
 #include <yarp/os/Face.h>
 #include "H264Decoder.h"
+#include "H264Encoder.h"
+
+#include <vector>
 
 
 /**
  *
- * A carrier for receiving frames compressed in h264 over rtp.
+ * A carrier for receiving frames compressed in h264 over rtp, or for sending
+ * the images written to a yarp port compressed in h264.
  * This carrier uses gstreamer libraries (libgstreamer1.0-dev and libgstreamer-plugins-base1.0-dev) to read rtp packets and to decode the h264 stream.
+ * The encoder on the sender side uses the x264enc element (gstreamer1.0-plugins-ugly).
  *
  * Use this carrier in the following way:
  * - suppose there is a server that streams video frames to IP x.x.x.x and to port p:
@@ -31,6 +36,19 @@
  *  - +cropBottom.100  ==> the carrier crops 100 pxel from bottom side
  *  - +removeJitter.1  ==> the carrier removes the jitter. If you put 0, the jitter is not removed (default behaviour).
  *  - +verbose.1       ==> enables verbose mode (default is not verbose) (+verbose.0 disables it.)
+ *
+ * The same carrier can be used between two yarp ports, for example:
+ *   yarp connect /grabber /yarpview/img:i h264+bitrate.1000
+ * In this case the receiver opens a tcp connection to the sender port,
+ * and the sender compresses the images (mono, rgb, bgr, rgba and bgra)
+ * and sends the h264 stream on that connection.
+ * Each connection has its own encoder, so a new reader always starts
+ * from a keyframe. The encoder is configured with these parameters:
+ *  - +bitrate.2000    ==> the target bitrate in kbit/s (default 2000)
+ *  - +keyint.30       ==> the maximum number of frames between two keyframes (default 30)
+ *  - +lowLatency.1    ==> tune the encoder for zero latency (default behaviour). If you put 0, the encoder
+ *                         uses a lookahead to get a better quality, and the images are delayed.
+ * The crop parameters are applied by the receiver also in this case.
  */
 
 class H264Carrier :
@@ -39,6 +57,10 @@ class H264Carrier :
 private:
     std::string envelope;
     h264Decoder_cfgParamters cfgParams;
+    h264Encoder_cfgParamters encoderParams;
+    H264Encoder encoder;
+    std::vector<std::vector<char>> units;
+    bool sender{false};
 public:
     H264Carrier()
     {}
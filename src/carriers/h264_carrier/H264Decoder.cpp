@@ -16,6 +16,7 @@
 #include <glib.h>
 
 #include <gst/app/gstappsink.h>
+#include <gst/app/gstappsrc.h>
 #include <cstdio>
 #include <cstring>
 #include <mutex>
@@ -124,6 +125,33 @@ static gboolean link_videosrc2nextWithCaps(GstElement *e1, GstElement *e2)
 
 
 
+static gboolean link_appsrc2parser(GstElement *e1, GstElement *e2)
+{
+    gboolean link_ok;
+    GstCaps *caps;
+
+// each buffer pushed by the carrier is a whole access unit
+    caps = gst_caps_new_simple("video/x-h264",
+                               "stream-format", G_TYPE_STRING, "byte-stream",
+                               "alignment", G_TYPE_STRING, "au",
+                               NULL);
+
+    link_ok = gst_element_link_filtered(e1, e2, caps);
+    gst_caps_unref(caps);
+    if(!link_ok)
+    {
+         yCError(H264CARRIER) << "H264Decoder-GSTREAMER: link_appsrc2parser failed";
+    }
+    else
+    {
+        yCTrace(H264CARRIER) << "H264Decoder-GSTREAMER: link_appsrc2parser OK";
+    }
+
+    return (link_ok);
+}
+
+
+
 static gboolean link_convert2next(GstElement *e1, GstElement *e2)
 {
     gboolean link_ok;
@@ -224,8 +252,13 @@ GstFlowReturn new_sample(GstAppSink *appsink, gpointer user_data)
     dec_data->isNew = true;
     dec_data->img->resize(width, height);
 
-    unsigned char *ydata_ptr = dec_data->img->getRawImage();
-    memcpy(ydata_ptr, map.data, width*height*3);
+    // the rows of the gstreamer buffer are aligned to 4 bytes
+    size_t rowSize = width*3;
+    size_t stride = GST_ROUND_UP_4(rowSize);
+    for (int r = 0; r < height; r++)
+    {
+        memcpy(dec_data->img->getRow(r), map.data + r*stride, rowSize);
+    }
 
     dec_data->m->unlock();
     gst_buffer_unmap(buffer, &map);
@@ -323,20 +356,27 @@ public:
     {
         gst_init(nullptr, nullptr);
         pipeline = gst_pipeline_new ("video-player");
-        source   = gst_element_factory_make ("udpsrc",       "video-source");
-        rtpDepay = gst_element_factory_make ("rtph264depay", "rtp-depay");
+        if (cfgParams.fromPort)
+        {
+            source   = gst_element_factory_make ("appsrc",       "video-source");
+        }
+        else
+        {
+            source   = gst_element_factory_make ("udpsrc",       "video-source");
+            rtpDepay = gst_element_factory_make ("rtph264depay", "rtp-depay");
+        }
         parser   = gst_element_factory_make ("h264parse",    "parser");
         decoder  = gst_element_factory_make ("avdec_h264",   "decoder");
         sizeChanger  = gst_element_factory_make ("videocrop",    "cropper");
         convert  = gst_element_factory_make ("videoconvert", "convert"); //because use RGB space
         sink     = gst_element_factory_make ("appsink",      "video-output");
 
-        if (!pipeline || !source || !rtpDepay || !parser || !decoder || !convert || !sink || !sizeChanger)
+        if (!pipeline || !source || (!rtpDepay && !cfgParams.fromPort) || !parser || !decoder || !convert || !sink || !sizeChanger)
         {
             yCError(H264CARRIER) << "H264Decoder-GSTREAMER: one element could not be created. Exiting.";
             return false;
         }
-        if (cfgParams.removeJitter)
+        if (cfgParams.removeJitter && !cfgParams.fromPort)
         {
             jitterBuff = gst_element_factory_make("rtpjitterbuffer", "jitterBuffer");
             if (!jitterBuff)
@@ -354,9 +394,20 @@ public:
     bool configureElements(h264Decoder_cfgParamters &cfgParams) //maybe i can make callbak configurable in the future.....
     {
         // 1) configure source port
-        yCTrace(H264CARRIER) << "H264Decoder-GSTREAMER: try to configure source port with value" << cfgParams.remotePort;
-        g_object_set(source, "port", cfgParams.remotePort, NULL);
-        yCDebug(H264CARRIER) << "H264Decoder-GSTREAMER: configured source port with" << cfgParams.remotePort;
+        if (cfgParams.fromPort)
+        {
+            // The access units are pushed as they are read from the connection
+            g_object_set(source, "is-live", TRUE, "format", GST_FORMAT_TIME, "do-timestamp", TRUE, NULL);
+            // frame threading would keep some frames in the decoder
+            g_object_set(decoder, "max-threads", 1, NULL);
+            yCDebug(H264CARRIER) << "H264Decoder-GSTREAMER: configured source for the stream of a port";
+        }
+        else
+        {
+            yCTrace(H264CARRIER) << "H264Decoder-GSTREAMER: try to configure source port with value" << cfgParams.remotePort;
+            g_object_set(source, "port", cfgParams.remotePort, NULL);
+            yCDebug(H264CARRIER) << "H264Decoder-GSTREAMER: configured source port with" << cfgParams.remotePort;
+        }
 
         // 2) configure callback on new frame
         yCTrace(H264CARRIER) << "H264Decoder-GSTREAMER: try to configure appsink.... ";
@@ -396,10 +447,16 @@ public:
         yCTrace(H264CARRIER) << "H264Decoder-GSTREAMER: try to add elements to pipeline..... ";
         /* we add all elements into the pipeline */
         gst_bin_add_many (GST_BIN (pipeline),
-                            source, rtpDepay, parser, decoder, sizeChanger, convert, sink, NULL);
+                            source, parser, decoder, sizeChanger, convert, sink, NULL);
 
         gboolean result;
 
+        if (rtpDepay != nullptr)
+        {
+            result = gst_bin_add(GST_BIN(pipeline), rtpDepay);
+            if (!result) { yCError(H264CARRIER) << "H264Decoder: Error adding rtpDepay to the bin"; return false; }
+        }
+
         if (jitterBuff != nullptr)
         {
             result = gst_bin_add(GST_BIN(pipeline), jitterBuff);
@@ -414,6 +471,19 @@ public:
 
         /* autovideosrc ! "video/x-raw, width=640, height=480, format=(string)I420" ! videoconvert ! 'video/x-raw, format=(string)RGB'  ! yarpdevice ! glimagesink */
 
+        if (rtpDepay == nullptr)
+        {
+            yCTrace(H264CARRIER) << "H264Decoder-GSTREAMER: try to link videosrc to parser";
+            result = link_appsrc2parser(source, parser);
+            if (!result) { yCError(H264CARRIER) << "H264Decoder: Error linking videosrc to parser "; return false; }
+
+            yCTrace(H264CARRIER) << "H264Decoder-GSTREAMER: try to link all other elements.....";
+            gst_element_link_many(parser, decoder, sizeChanger, convert, NULL);
+
+            yCTrace(H264CARRIER) << "H264Decoder-GSTREAMER: linkElements OK";
+            return true;
+        }
+
         if (jitterBuff)
         {
             yCTrace(H264CARRIER) << "H264Decoder-GSTREAMER: try to link videosrc to rtpjitterBuffer.....";
@@ -500,6 +570,20 @@ bool H264Decoder::stop()
     return true;
 }
 
+bool H264Decoder::pushData(const char *data, size_t length)
+{
+    H264DecoderHelper &helper = GET_HELPER(sysResource);
+    GstBuffer *buffer = gst_buffer_new_allocate(nullptr, length, nullptr);
+    gst_buffer_fill(buffer, 0, data, length);
+    // the buffer is owned by appsrc from now on
+    if (gst_app_src_push_buffer(GST_APP_SRC(helper.source), buffer) != GST_FLOW_OK)
+    {
+        yCError(H264CARRIER) << "H264Decoder: could not push the data";
+        return false;
+    }
+    return true;
+}
+
 H264Decoder::~H264Decoder()
 {
     stop();
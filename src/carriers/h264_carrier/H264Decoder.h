@@ -18,7 +18,9 @@ struct h264Decoder_cfgParamters
     h264Decoder_cfgParamters() :
         crop{0,0,0,0},
         fps_max(0),
-        remotePort(-1)
+        remotePort(-1),
+        removeJitter(false),
+        fromPort(false)
     {}
 
     struct
@@ -32,6 +34,7 @@ struct h264Decoder_cfgParamters
     int fps_max;    //max value of fps. it is imposed by gstreamer
     int remotePort; // the port on which the server send data
     bool removeJitter; //If true, the carrier reorders and removes duplicate RTP packets as they are received from a network source.
+    bool fromPort;  //If true, the stream is sent by a yarp port on the connection and is pushed with pushData, instead of being received by udp.
 };
 
 class H264Decoder
@@ -49,6 +52,7 @@ public:
     bool init(void);
     bool start();
     bool stop();
+    bool pushData(const char *data, size_t length);
     yarp::sig::ImageOf<yarp::sig::PixelRgb> & getLastFrame(void);
     int getLastFrameSize(void);
     bool newFrameIsAvailable(void);
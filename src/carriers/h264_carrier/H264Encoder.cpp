@@ -0,0 +1,301 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include "H264Encoder.h"
+#include "H264LogComponent.h"
+
+#include <yarp/os/LogStream.h>
+#include <yarp/os/Vocab.h>
+
+
+#include <gst/gst.h>
+#include <glib.h>
+
+#include <gst/app/gstappsrc.h>
+#include <gst/app/gstappsink.h>
+#include <cstring>
+#include <initializer_list>
+#include <map>
+#include <utility>
+
+using namespace yarp::sig;
+using namespace yarp::os;
+
+
+// gstreamer format and bytes per pixel of the supported images
+static const std::map<int, std::pair<const char*, size_t>> yarpCode2GstFormat { {VOCAB_PIXEL_MONO, {"GRAY8", 1}},
+                                                                              {VOCAB_PIXEL_RGB, {"RGB", 3}},
+                                                                              {VOCAB_PIXEL_BGR, {"BGR", 3}},
+                                                                              {VOCAB_PIXEL_RGBA, {"RGBA", 4}},
+                                                                              {VOCAB_PIXEL_BGRA, {"BGRA", 4}} };
+
+
+static gboolean link_withCaps(GstElement *e1, GstElement *e2, GstCaps *caps)
+{
+    gboolean link_ok = gst_element_link_filtered(e1, e2, caps);
+    gst_caps_unref(caps);
+    if(!link_ok)
+    {
+        yCError(H264CARRIER) << "H264Encoder-GSTREAMER: failed to link" << GST_ELEMENT_NAME(e1) << "to" << GST_ELEMENT_NAME(e2);
+    }
+    return link_ok;
+}
+
+
+class H264EncoderHelper
+{
+public:
+    GstElement *pipeline;
+    GstElement *source;
+    GstElement *convert;
+    GstElement *encoder;
+    GstElement *sink;
+
+    // Format of the images the pipeline has been created for
+    size_t width;
+    size_t height;
+    int pixelCode;
+
+    H264EncoderHelper() :
+        pipeline(nullptr),
+        source(nullptr),
+        convert(nullptr),
+        encoder(nullptr),
+        sink(nullptr),
+        width(0),
+        height(0),
+        pixelCode(0)
+    {}
+
+    ~H264EncoderHelper()
+    {
+        close();
+    }
+
+    bool open(const h264Encoder_cfgParamters &cfg, const Image &img, const char *format)
+    {
+        gst_init(nullptr, nullptr);
+        pipeline = gst_pipeline_new ("video-encoder");
+        source   = gst_element_factory_make ("appsrc",       "video-source");
+        convert  = gst_element_factory_make ("videoconvert", "convert");
+        encoder  = gst_element_factory_make ("x264enc",      "encoder");
+        sink     = gst_element_factory_make ("appsink",      "video-output");
+
+        if (!pipeline || !source || !convert || !encoder || !sink)
+        {
+            yCError(H264CARRIER) << "H264Encoder-GSTREAMER: one element could not be created.";
+            for (GstElement *e : {source, convert, encoder, sink})
+            {
+                if (e) { gst_object_unref(gst_object_ref_sink(e)); }
+            }
+            source = convert = encoder = sink = nullptr;
+            return false;
+        }
+        gst_bin_add_many (GST_BIN (pipeline), source, convert, encoder, sink, NULL);
+
+        // The images are pushed as they are written to the port
+        GstCaps *caps = gst_caps_new_simple("video/x-raw",
+                                            "format", G_TYPE_STRING, format,
+                                            "width", G_TYPE_INT, static_cast<int>(img.width()),
+                                            "height", G_TYPE_INT, static_cast<int>(img.height()),
+                                            "framerate", GST_TYPE_FRACTION, 0, 1,
+                                            NULL);
+        g_object_set(source, "caps", caps, "is-live", TRUE, "format", GST_FORMAT_TIME, "do-timestamp", TRUE, NULL);
+        gst_caps_unref(caps);
+
+        // No B-frames, so that the receiver gets a frame for each access unit
+        g_object_set(encoder,
+                     "bitrate", static_cast<guint>(cfg.bitrate),
+                     "key-int-max", static_cast<guint>(cfg.keyint),
+                     "bframes", 0u,
+                     "byte-stream", TRUE,
+                     NULL);
+        if (cfg.lowLatency)
+        {
+            gst_util_set_object_arg(G_OBJECT(encoder), "tune", "zerolatency");
+            gst_util_set_object_arg(G_OBJECT(encoder), "speed-preset", "ultrafast");
+        }
+        yCDebug(H264CARRIER) << "H264Encoder-GSTREAMER: encoding" << img.width() << "x" << img.height() << format
+                             << "at" << cfg.bitrate << "kbit/s, keyframe every" << cfg.keyint << "frames"
+                             << (cfg.lowLatency ? "(low latency)" : "");
+
+        g_object_set(sink, "sync", FALSE, "emit-signals", FALSE, NULL);
+
+        // 4:2:0 is the format every decoder can handle, otherwise
+        // videoconvert would choose 4:4:4 for the rgb images
+        if (!gst_element_link(source, convert) ||
+            !link_withCaps(convert, encoder, gst_caps_new_simple("video/x-raw",
+                                                                 "format", G_TYPE_STRING, "I420",
+                                                                 NULL)) ||
+            !link_withCaps(encoder, sink, gst_caps_new_simple("video/x-h264",
+                                                              "stream-format", G_TYPE_STRING, "byte-stream",
+                                                              "alignment", G_TYPE_STRING, "au",
+                                                              NULL)))
+        {
+            yCError(H264CARRIER) << "H264Encoder-GSTREAMER: error linking the elements";
+            return false;
+        }
+
+        if (gst_element_set_state(pipeline, GST_STATE_PLAYING) == GST_STATE_CHANGE_FAILURE)
+        {
+            yCError(H264CARRIER) << "H264Encoder-GSTREAMER: the pipeline could not be started";
+            return false;
+        }
+
+        width = img.width();
+        height = img.height();
+        pixelCode = img.getPixelCode();
+        return true;
+    }
+
+    // Errors of the elements (e.g. caps that x264 does not accept) are
+    // only posted on the bus, the pipeline is not usable after them
+    bool checkBus()
+    {
+        GstBus *bus = gst_pipeline_get_bus(GST_PIPELINE(pipeline));
+        GstMessage *msg = gst_bus_pop_filtered(bus, GST_MESSAGE_ERROR);
+        gst_object_unref(bus);
+        if (msg == nullptr)
+        {
+            return true;
+        }
+
+        GError *error = nullptr;
+        gchar *debug = nullptr;
+        gst_message_parse_error(msg, &error, &debug);
+        yCError(H264CARRIER) << "H264Encoder-GSTREAMER: error from" << GST_OBJECT_NAME(msg->src) << ":" << error->message;
+        yCDebug(H264CARRIER) << "H264Encoder-GSTREAMER: debug info:" << (debug ? debug : "none");
+        g_error_free(error);
+        g_free(debug);
+        gst_message_unref(msg);
+        return false;
+    }
+
+    void close()
+    {
+        if (pipeline)
+        {
+            gst_element_set_state (pipeline, GST_STATE_NULL);
+            gst_object_unref (GST_OBJECT (pipeline));
+        }
+        pipeline = source = convert = encoder = sink = nullptr;
+        width = 0;
+        height = 0;
+        pixelCode = 0;
+    }
+
+    bool encode(const h264Encoder_cfgParamters &cfg, const Image &img, std::vector<std::vector<char>> &units)
+    {
+        units.clear();
+
+        auto format = yarpCode2GstFormat.find(img.getPixelCode());
+        if (format == yarpCode2GstFormat.end())
+        {
+            yCError(H264CARRIER) << "H264Encoder: unsupported pixel code" << Vocab::decode(img.getPixelCode());
+            return false;
+        }
+
+        // x264 only encodes 4:2:0 images with even sizes
+        if (img.width() % 2 != 0 || img.height() % 2 != 0)
+        {
+            yCError(H264CARRIER) << "H264Encoder: the size of the images must be even, got" << img.width() << "x" << img.height();
+            return false;
+        }
+
+        if (!pipeline || img.width() != width || img.height() != height || img.getPixelCode() != pixelCode)
+        {
+            close();
+            if (!open(cfg, img, format->second.first))
+            {
+                close();
+                return false;
+            }
+        }
+
+        // gstreamer expects the rows aligned to 4 bytes
+        size_t rowSize = img.width() * format->second.second;
+        size_t stride = GST_ROUND_UP_4(rowSize);
+        GstBuffer *buffer = gst_buffer_new_allocate(nullptr, stride * img.height(), nullptr);
+        GstMapInfo map;
+        if (!gst_buffer_map(buffer, &map, GST_MAP_WRITE))
+        {
+            yCError(H264CARRIER) << "H264Encoder-GSTREAMER: could not map the buffer";
+            gst_buffer_unref(buffer);
+            return false;
+        }
+        for (size_t r = 0; r < img.height(); r++)
+        {
+            memcpy(map.data + r * stride, img.getRow(r), rowSize);
+        }
+        gst_buffer_unmap(buffer, &map);
+
+        // The buffer is owned by appsrc from now on
+        if (gst_app_src_push_buffer(GST_APP_SRC(source), buffer) != GST_FLOW_OK)
+        {
+            yCError(H264CARRIER) << "H264Encoder-GSTREAMER: could not push the image";
+            checkBus();
+            close();
+            return false;
+        }
+
+        // With the low latency tuning each image gives an access unit,
+        // otherwise we just take what the encoder has already produced
+        GstClockTime timeout = cfg.lowLatency ? GST_SECOND : 0;
+        GstSample *sample = nullptr;
+        while ((sample = gst_app_sink_try_pull_sample(GST_APP_SINK(sink), timeout)) != nullptr)
+        {
+            GstBuffer *out = gst_sample_get_buffer(sample);
+            GstMapInfo outMap;
+            if (out && gst_buffer_map(out, &outMap, GST_MAP_READ))
+            {
+                units.emplace_back(outMap.data, outMap.data + outMap.size);
+                gst_buffer_unmap(out, &outMap);
+            }
+            gst_sample_unref(sample);
+            timeout = 0;
+        }
+
+        // The pipeline is created again with the next image
+        if (!checkBus())
+        {
+            close();
+            return false;
+        }
+        if (cfg.lowLatency && units.empty())
+        {
+            yCError(H264CARRIER) << "H264Encoder-GSTREAMER: the encoder did not produce the image in time";
+            return false;
+        }
+        yCTrace(H264CARRIER, "H264Encoder: %zu access units ready", units.size());
+        return true;
+    }
+};
+
+
+#define GET_HELPER(x) (*((H264EncoderHelper*)(x)))
+
+H264Encoder::H264Encoder() :
+    sysResource(new H264EncoderHelper)
+{
+}
+
+H264Encoder::~H264Encoder()
+{
+    delete &GET_HELPER(sysResource);
+}
+
+void H264Encoder::configure(const h264Encoder_cfgParamters &config)
+{
+    cfg = config;
+    GET_HELPER(sysResource).close();
+}
+
+bool H264Encoder::encode(const Image &image, std::vector<std::vector<char>> &units)
+{
+    return GET_HELPER(sysResource).encode(cfg, image, units);
+}
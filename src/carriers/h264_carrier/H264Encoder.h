@@ -0,0 +1,67 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef H264ENCODER_INC
+#define H264ENCODER_INC
+
+#include <yarp/sig/Image.h>
+
+#include <vector>
+
+struct h264Encoder_cfgParamters
+{
+    h264Encoder_cfgParamters() :
+        bitrate(2000),
+        keyint(30),
+        lowLatency(true)
+    {}
+
+    int bitrate;     //target bitrate in kbit/s
+    int keyint;      //max number of frames between two keyframes
+    bool lowLatency; //If true, the encoder has no lookahead, so that each image is sent as soon as it is encoded
+};
+
+/**
+ * Software h264 encoder (x264 through gstreamer) for the images sent on a
+ * connection.
+ * The pipeline is created with the first image, and created again when the
+ * size or the format of the images change, so a new connection always
+ * starts with a keyframe and with the stream headers.
+ */
+class H264Encoder
+{
+private:
+    void *sysResource;
+    h264Encoder_cfgParamters cfg;
+
+public:
+    H264Encoder();
+    ~H264Encoder();
+
+    /**
+     * Set the parameters of the encoder. The pipeline is created again
+     * with the next image.
+     */
+    void configure(const h264Encoder_cfgParamters &config);
+
+    /**
+     * Encode an image.
+     *
+     * @param image the image
+     * @param[out] units the access units (in byte-stream format) that are
+     *             ready. With lowLatency there is one for each image,
+     *             otherwise the first ones are delayed by the lookahead
+     *             of the encoder
+     * @return true on success, false if the width or the height of the
+     *         image are odd, or if the pipeline reported an error
+     *         (with lowLatency, also when the image was not encoded in time)
+     */
+    bool encode(const yarp::sig::Image &image, std::vector<std::vector<char>> &units);
+};
+
+#endif
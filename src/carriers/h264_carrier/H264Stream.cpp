@@ -10,6 +10,7 @@
 #include "H264LogComponent.h"
 
 #include <yarp/os/LogStream.h>
+#include <yarp/os/NetInt32.h>
 #include <yarp/sig/Image.h>
 #include <yarp/sig/ImageNetworkHeader.h>
 
@@ -47,7 +48,7 @@ H264Stream::~H264Stream()
 
 
 
-bool H264Stream::setStream(yarp::os::impl::DgramTwoWayStream *stream)
+bool H264Stream::setStream(yarp::os::TwoWayStream *stream)
 {
     delegate = stream;
     if(nullptr == delegate)
@@ -79,6 +80,59 @@ OutputStream& H264Stream::getOutputStream()
 
 //using yarp::os::InputStream::read;
 
+bool H264Stream::isOk() const
+{
+    if (delegate != nullptr)
+    {
+        return delegate->isOk();
+    }
+    return DgramTwoWayStream::isOk();
+}
+
+void H264Stream::interrupt()
+{
+    if (delegate != nullptr)
+    {
+        delegate->getInputStream().interrupt();
+    }
+    DgramTwoWayStream::interrupt();
+}
+
+void H264Stream::close()
+{
+    if (delegate != nullptr)
+    {
+        delegate->close();
+    }
+    DgramTwoWayStream::close();
+}
+
+// Read an access unit sent by H264Carrier::write and pass it to the decoder
+bool H264Stream::readUnit()
+{
+    NetInt32 len = 0;
+    Bytes header((char*)&len, sizeof(len));
+    if (delegate->getInputStream().readFull(header) != (yarp::conf::ssize_t)header.length())
+    {
+        yCDebug(H264CARRIER, "The connection with the sender has been closed");
+        return false;
+    }
+    if (len <= 0 || static_cast<size_t>(len) > h264_max_unit_size)
+    {
+        yCError(H264CARRIER, "Invalid access unit length %d", (int)len);
+        return false;
+    }
+    unit.resize(len);
+    Bytes data(unit.data(), unit.size());
+    if (delegate->getInputStream().readFull(data) != (yarp::conf::ssize_t)data.length())
+    {
+        yCDebug(H264CARRIER, "The connection with the sender has been closed");
+        return false;
+    }
+    yCTrace(H264CARRIER, "Received an access unit of %d bytes", (int)len);
+    return decoder->pushData(unit.data(), unit.size());
+}
+
 bool H264Stream::setReadEnvelopeCallback(InputStream::readEnvelopeCallbackType callback, void* data)
 {
     return true;
@@ -172,6 +226,19 @@ yarp::conf::ssize_t H264Stream::read(Bytes& b)
             #endif
 
         }
+        else if (delegate != nullptr)
+        {
+            // The stream comes from a port: decode the next access unit
+            decoder->setReq();
+            decoder->mutex.unlock();
+            if (!readUnit())
+            {
+                delegate->close();
+                return -1;
+            }
+            decoder->semaphore.waitWithTimeout(1);
+            continue;
+        }
         else
         {
             yCTrace(H264CARRIER, "h264Stream::read has been called but no frame is available!!");
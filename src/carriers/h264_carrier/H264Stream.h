@@ -15,14 +15,23 @@
 #include <yarp/wire_rep_utils/BlobNetworkHeader.h>
 #include "H264Decoder.h"
 #include <yarp/os/InputStream.h>
+#include <yarp/os/TwoWayStream.h>
 
+#include <cstddef>
+#include <vector>
+
+
+// The largest access unit accepted from a port. A compressed frame is
+// much smaller than the uncompressed one, even at 8K.
+constexpr size_t h264_max_unit_size = 32 * 1024 * 1024;
 
 class H264Stream :
         public yarp::os::impl::DgramTwoWayStream
 {
 private:
 
-    DgramTwoWayStream *delegate;
+    yarp::os::TwoWayStream *delegate; // the connection to the port sending the stream, if any
+    std::vector<char> unit;
     yarp::sig::ImageOf<yarp::sig::PixelRgb> img;
     yarp::sig::ImageNetworkHeader imgHeader;
     yarp::wire_rep_utils::BlobNetworkHeader blobHeader;
@@ -36,7 +45,7 @@ public:
 
     virtual ~H264Stream();
 
-    bool setStream(yarp::os::impl::DgramTwoWayStream *stream);
+    bool setStream(yarp::os::TwoWayStream *stream);
 
     void start (void);
 
@@ -49,8 +58,16 @@ public:
     using yarp::os::InputStream::read;
     yarp::conf::ssize_t read(yarp::os::Bytes& b) override;
 
+    bool isOk() const override;
+
+    void interrupt() override;
+
+    void close() override;
+
     bool setReadEnvelopeCallback(InputStream::readEnvelopeCallbackType callback, void* data) override;
 
+private:
+    bool readUnit();
 };
 
 #endif
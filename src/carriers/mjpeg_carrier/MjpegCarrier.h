@@ -14,6 +14,7 @@
 #include <yarp/os/NetType.h>
 #include <yarp/os/ConnectionState.h>
 #include "MjpegStream.h"
+#include "MjpegCompression.h"
 #include "MjpegLogComponent.h"
 
 #include <cstring>
@@ -35,6 +36,16 @@
  * You can also view yarp image ports from a browser.  Do a "yarp name query /portname" to find their port number NNN, then go to:
  *   http://localhost:NNN/?output=stream
  *
+ * The images are compressed by the sender with a jpeg compressor kept for
+ * the whole connection. The quality (1-100, 75 by default) and the chroma
+ * subsampling (444, 422 or 420, the default) can be chosen by the receiver:
+ *   yarp connect /src /dest mjpeg+quality.80+subsampling.444
+ * or, from a browser:
+ *   http://localhost:NNN/?action=stream&quality=80&subsampling=444
+ * The receiver can also decompress the images at 1/2, 1/4 or 1/8 of their
+ * size, that is much faster than decompressing them at full size:
+ *   yarp connect /src /dest mjpeg+scale.2
+ *
  */
 class MjpegCarrier :
         public yarp::os::Carrier
@@ -43,6 +54,7 @@ private:
     bool firstRound;
     bool sender;
     std::string envelope;
+    MjpegCompression compression;
 public:
     MjpegCarrier() {
         firstRound = true;
@@ -142,13 +154,7 @@ public:
         return true;
     }
 
-    bool expectExtraHeader(yarp::os::ConnectionState& proto) override {
-        std::string txt;
-        do {
-            txt = proto.is().readLine();
-        } while (txt!="");
-        return true;
-    }
+    bool expectExtraHeader(yarp::os::ConnectionState& proto) override;
 
     bool respondToHeader(yarp::os::ConnectionState& proto) override {
         std::string target = "HTTP/1.0 200 OK\r\n\
@@ -169,19 +175,7 @@ Content-Type: multipart/x-mixed-replace;boundary=boundarydonotcross\r\n\
         return true;
     }
 
-    bool expectReplyToHeader(yarp::os::ConnectionState& proto) override {
-        std::string txt;
-        do {
-            txt = proto.is().readLine();
-        } while (txt!="");
-
-        sender = false;
-        MjpegStream *stream = new MjpegStream(proto.giveStreams(),
-                                              autoCompression());
-        if (stream==NULL) { return false; }
-        proto.takeStreams(stream);
-        return true;
-    }
+    bool expectReplyToHeader(yarp::os::ConnectionState& proto) override;
 
     bool isActive() const override {
         return true;
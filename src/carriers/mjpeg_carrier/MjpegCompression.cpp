@@ -0,0 +1,283 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include "MjpegCompression.h"
+#include "MjpegLogComponent.h"
+
+#include <yarp/os/Log.h>
+#include <yarp/os/Vocab.h>
+#include <yarp/sig/Image.h>
+
+#include <csetjmp>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <vector>
+
+/*
+  On Windows, libjpeg does some slightly odd-ball stuff, including
+  unconditionally defining INT32 to be "long".  This needs to
+  be worked around.  Work around begins...
+ */
+#if defined(_WIN32)
+#define INT32 long  // jpeg's definition
+#define QGLOBAL_H 1
+#endif
+
+#ifdef _MSC_VER
+#pragma warning (push)
+#pragma warning (disable : 4091)
+#endif
+
+extern "C" {
+#include <jpeglib.h>
+}
+
+#ifdef _MSC_VER
+#pragma warning (pop)
+#endif
+
+#if defined(_WIN32)
+#undef INT32
+#undef QGLOBAL_H
+#endif
+/*
+  work around ends.
+ */
+
+using namespace yarp::os;
+using namespace yarp::sig;
+
+static const std::map<int, J_COLOR_SPACE> yarpCode2Mjpeg { {VOCAB_PIXEL_MONO, JCS_GRAYSCALE},
+                                                           {VOCAB_PIXEL_MONO16, JCS_GRAYSCALE},
+                                                           {VOCAB_PIXEL_RGB , JCS_RGB},
+                                                           {VOCAB_PIXEL_RGBA , JCS_EXT_RGBA},
+                                                           {VOCAB_PIXEL_BGRA , JCS_EXT_BGRA},
+                                                           {VOCAB_PIXEL_BGR , JCS_EXT_BGR} };
+
+static const std::map<int, int> yarpCode2Channels { {VOCAB_PIXEL_MONO, 1},
+                                                    {VOCAB_PIXEL_MONO16, 2},
+                                                    {VOCAB_PIXEL_RGB , 3},
+                                                    {VOCAB_PIXEL_RGBA , 4},
+                                                    {VOCAB_PIXEL_BGRA , 4},
+                                                    {VOCAB_PIXEL_BGR , 3} };
+
+// Horizontal and vertical sampling factors of the luminance
+static const std::map<std::string, std::pair<int, int>> subsampling2Factors { {"444", {1, 1}},
+                                                                              {"422", {2, 1}},
+                                                                              {"420", {2, 2}} };
+
+namespace {
+
+struct compress_error_mgr {
+    struct jpeg_error_mgr pub;
+    jmp_buf setjmp_buffer;
+};
+
+void compress_error_exit(j_common_ptr cinfo)
+{
+    auto myerr = reinterpret_cast<compress_error_mgr*>(cinfo->err);
+    (*cinfo->err->output_message) (cinfo);
+    longjmp(myerr->setjmp_buffer, 1);
+}
+
+/*
+ * Destination writing in a buffer that grows as needed, and that is kept
+ * for the next frames, so that each frame is sent in one piece.
+ */
+struct buffer_destination_mgr {
+    struct jpeg_destination_mgr pub;
+    std::vector<JOCTET> buffer;
+    size_t length {0};
+};
+
+constexpr size_t initial_buffer_size = 65536;
+
+void init_buffer_destination(j_compress_ptr cinfo)
+{
+    auto dest = reinterpret_cast<buffer_destination_mgr*>(cinfo->dest);
+    if (dest->buffer.size() < initial_buffer_size) {
+        dest->buffer.resize(initial_buffer_size);
+    }
+    dest->pub.next_output_byte = dest->buffer.data();
+    dest->pub.free_in_buffer = dest->buffer.size();
+    dest->length = 0;
+}
+
+boolean empty_buffer_output(j_compress_ptr cinfo)
+{
+    // Called when the buffer is full
+    auto dest = reinterpret_cast<buffer_destination_mgr*>(cinfo->dest);
+    size_t used = dest->buffer.size();
+    yCDebug(MJPEGCARRIER, "Growing the jpeg buffer to %zu bytes", used * 2);
+    dest->buffer.resize(used * 2);
+    dest->pub.next_output_byte = dest->buffer.data() + used;
+    dest->pub.free_in_buffer = dest->buffer.size() - used;
+    return TRUE;
+}
+
+void term_buffer_destination(j_compress_ptr cinfo)
+{
+    auto dest = reinterpret_cast<buffer_destination_mgr*>(cinfo->dest);
+    dest->length = dest->buffer.size() - dest->pub.free_in_buffer;
+}
+
+} // namespace
+
+
+class MjpegCompressionHelper {
+public:
+    bool active{false};
+    bool configured{false};
+    struct jpeg_compress_struct cinfo;
+    struct compress_error_mgr jerr;
+    struct buffer_destination_mgr dest;
+    std::vector<JSAMPROW> rows;
+    int quality{75};
+    std::pair<int, int> factors{2, 2};
+
+    // Format of the last image compressed
+    size_t width{0};
+    size_t height{0};
+    int pixelCode{0};
+
+    MjpegCompressionHelper()
+    {
+        memset(&cinfo, 0, sizeof(jpeg_compress_struct));
+        memset(&jerr, 0, sizeof(compress_error_mgr));
+        memset(&dest.pub, 0, sizeof(jpeg_destination_mgr));
+    }
+
+    void init() {
+        cinfo.err = jpeg_std_error(&jerr.pub);
+        jerr.pub.error_exit = compress_error_exit;
+        jpeg_create_compress(&cinfo);
+        dest.pub.init_destination = init_buffer_destination;
+        dest.pub.empty_output_buffer = empty_buffer_output;
+        dest.pub.term_destination = term_buffer_destination;
+        cinfo.dest = &dest.pub;
+    }
+
+    void configure(const Image& img, J_COLOR_SPACE colorSpace, int components) {
+        cinfo.image_width = static_cast<JDIMENSION>(img.width());
+        cinfo.image_height = static_cast<JDIMENSION>(img.height());
+        cinfo.in_color_space = colorSpace;
+        cinfo.input_components = components;
+        jpeg_set_defaults(&cinfo);
+        jpeg_set_quality(&cinfo, quality, TRUE);
+        if (cinfo.jpeg_color_space == JCS_YCbCr) {
+            cinfo.comp_info[0].h_samp_factor = factors.first;
+            cinfo.comp_info[0].v_samp_factor = factors.second;
+        }
+        width = img.width();
+        height = img.height();
+        pixelCode = img.getPixelCode();
+        configured = true;
+    }
+
+    bool compress(const Image& img, const std::string& comment) {
+        auto colorSpace = yarpCode2Mjpeg.find(img.getPixelCode());
+        if (colorSpace == yarpCode2Mjpeg.end()) {
+            yCError(MJPEGCARRIER, "Unsupported pixel code %s", Vocab::decode(img.getPixelCode()).c_str());
+            return false;
+        }
+        if (!active) {
+            init();
+            active = true;
+        }
+
+        if (setjmp(jerr.setjmp_buffer)) {
+            jpeg_abort_compress(&cinfo);
+            configured = false;
+            return false;
+        }
+
+        // The parameters are kept by libjpeg between the images
+        if (!configured || img.width() != width || img.height() != height || img.getPixelCode() != pixelCode) {
+            configure(img, colorSpace->second, yarpCode2Channels.at(img.getPixelCode()));
+        }
+
+        jpeg_start_compress(&cinfo, TRUE);
+        if (!comment.empty()) {
+            jpeg_write_marker(&cinfo, JPEG_COM, reinterpret_cast<const JOCTET*>(comment.c_str()), comment.length() + 1);
+        }
+
+        rows.resize(height);
+        unsigned char* data = img.getRawImage();
+        for (size_t r = 0; r < height; r++) {
+            rows[r] = data + r * img.getRowSize();
+        }
+        while (cinfo.next_scanline < cinfo.image_height) {
+            jpeg_write_scanlines(&cinfo, &rows[cinfo.next_scanline], cinfo.image_height - cinfo.next_scanline);
+        }
+        jpeg_finish_compress(&cinfo);
+        yCTrace(MJPEGCARRIER, "Compressed image %zux%zu in %zu bytes", width, height, dest.length);
+        return true;
+    }
+
+    void fini() {
+        jpeg_destroy_compress(&cinfo);
+    }
+
+    ~MjpegCompressionHelper() {
+        if (active) {
+            fini();
+            active = false;
+        }
+    }
+};
+
+#define HELPER(x) (*((MjpegCompressionHelper*)(x)))
+
+MjpegCompression::MjpegCompression() {
+    system_resource = new MjpegCompressionHelper;
+    yCAssert(MJPEGCARRIER, system_resource!=nullptr);
+}
+
+MjpegCompression::~MjpegCompression() {
+    if (system_resource!=nullptr) {
+        delete &HELPER(system_resource);
+        system_resource = nullptr;
+    }
+}
+
+bool MjpegCompression::setQuality(int quality) {
+    if (quality < 1 || quality > 100) {
+        yCError(MJPEGCARRIER, "Invalid jpeg quality %d, it should be between 1 and 100", quality);
+        return false;
+    }
+    MjpegCompressionHelper& helper = HELPER(system_resource);
+    helper.quality = quality;
+    helper.configured = false;
+    return true;
+}
+
+bool MjpegCompression::setSubsampling(const std::string& subsampling) {
+    auto it = subsampling2Factors.find(subsampling);
+    if (it == subsampling2Factors.end()) {
+        yCError(MJPEGCARRIER, "Invalid chroma subsampling \"%s\", it should be 444, 422 or 420", subsampling.c_str());
+        return false;
+    }
+    MjpegCompressionHelper& helper = HELPER(system_resource);
+    helper.factors = it->second;
+    helper.configured = false;
+    return true;
+}
+
+bool MjpegCompression::compress(const Image& image,
+                                const std::string& comment,
+                                const char*& data,
+                                size_t& length) {
+    MjpegCompressionHelper& helper = HELPER(system_resource);
+    if (!helper.compress(image, comment)) {
+        return false;
+    }
+    data = reinterpret_cast<const char*>(helper.dest.buffer.data());
+    length = helper.dest.length;
+    return true;
+}
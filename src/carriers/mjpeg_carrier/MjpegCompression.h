@@ -0,0 +1,58 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef YARP2_MJPEGCOMPRESSION_INC
+#define YARP2_MJPEGCOMPRESSION_INC
+
+#include <yarp/sig/Image.h>
+
+#include <cstddef>
+#include <string>
+
+/**
+ * Jpeg compressor for the frames sent on a connection.
+ * The compressor, its settings and its output buffer are kept between the
+ * frames, and are set up again only when the format of the images changes.
+ */
+class MjpegCompression
+{
+private:
+    void *system_resource;
+public:
+    MjpegCompression();
+
+    virtual ~MjpegCompression();
+
+    /**
+     * Set the jpeg quality, from 1 to 100 (75 by default).
+     */
+    bool setQuality(int quality);
+
+    /**
+     * Set the chroma subsampling of the color images, "444", "422" or
+     * "420" (the default).
+     */
+    bool setSubsampling(const std::string& subsampling);
+
+    /**
+     * Compress an image.
+     * The compressed data is valid until the next call.
+     *
+     * @param image the image
+     * @param comment if not empty, added to the jpeg as a comment marker
+     * @param[out] data the compressed data
+     * @param[out] length the length of the compressed data
+     * @return true on success
+     */
+    bool compress(const yarp::sig::Image& image,
+                  const std::string& comment,
+                  const char*& data,
+                  size_t& length);
+};
+
+#endif
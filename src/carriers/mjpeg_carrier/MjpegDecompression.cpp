@@ -15,6 +15,7 @@
 #include <csetjmp>
 #include <cstdio>
 #include <cstring>
+#include <vector>
 
 #if defined(_WIN32)
 #define INT32 long  // jpeg's definition
@@ -121,6 +122,8 @@ public:
     JOCTET error_buffer[4];
     yarp::os::InputStream::readEnvelopeCallbackType readEnvelopeCallback{nullptr};
     void* readEnvelopeCallbackData{nullptr};
+    unsigned int scale{1};
+    std::vector<JSAMPROW> rows;
 
     MjpegDecompressionHelper()
     {
@@ -137,25 +140,28 @@ public:
     }
 
     void init() {
+        cinfo.err = jpeg_std_error(&jerr.pub);
+        jerr.pub.error_exit = net_error_exit;
         jpeg_create_decompress(&cinfo);
+        cinfo.client_data = &error_buffer;
     }
     bool decompress(const Bytes& cimg, FlexImage& img) {
         if (!active) {
             init();
             active = true;
         }
-        cinfo.client_data = &error_buffer;
-        cinfo.err = jpeg_std_error(&jerr.pub);
-        jerr.pub.error_exit = net_error_exit;
 
         if (setjmp(jerr.setjmp_buffer)) {
-            jpeg_finish_decompress(&cinfo);
+            jpeg_abort_decompress(&cinfo);
             return false;
         }
 
         jpeg_net_src(&cinfo,(char*)cimg.get(),cimg.length());
         jpeg_save_markers(&cinfo, JPEG_COM, 0xFFFF);
         jpeg_read_header(&cinfo, TRUE);
+        // Scale in the DCT domain, set after jpeg_read_header() that resets it
+        cinfo.scale_num = 1;
+        cinfo.scale_denom = scale;
         jpeg_calc_output_dimensions(&cinfo);
 
         if(cinfo.jpeg_color_space == JCS_GRAYSCALE) {
@@ -169,14 +175,13 @@ public:
         yCTrace(MJPEGCARRIER, "Got image %dx%d", cinfo.output_width, cinfo.output_height);
         img.resize(cinfo.output_width,cinfo.output_height);
         jpeg_start_decompress(&cinfo);
-        //int row_stride = cinfo.output_width * cinfo.output_components;
 
-        int at = 0;
+        rows.resize(cinfo.output_height);
+        for (size_t r = 0; r < rows.size(); r++) {
+            rows[r] = (JSAMPLE*)(img.getRow(r));
+        }
         while (cinfo.output_scanline < cinfo.output_height) {
-            JSAMPLE *lines[1];
-            lines[0] = (JSAMPLE*)(img.getPixelAddress(0,at));
-            jpeg_read_scanlines(&cinfo, lines, 1);
-            at++;
+            jpeg_read_scanlines(&cinfo, &rows[cinfo.output_scanline], cinfo.output_height - cinfo.output_scanline);
         }
         if(readEnvelopeCallback && cinfo.marker_list && cinfo.marker_list->data_length > 0) {
             Bytes envelope(reinterpret_cast<char*>(cinfo.marker_list->data), cinfo.marker_list->data_length);
@@ -228,6 +233,18 @@ bool MjpegDecompression::setReadEnvelopeCallback(InputStream::readEnvelopeCallba
 }
 
 
+bool MjpegDecompression::setScale(int scale)
+{
+    if (scale != 1 && scale != 2 && scale != 4 && scale != 8) {
+        yCError(MJPEGCARRIER, "Invalid scale %d, it should be 1, 2, 4 or 8", scale);
+        return false;
+    }
+    MjpegDecompressionHelper& helper = HELPER(system_resource);
+    helper.scale = static_cast<unsigned int>(scale);
+    return true;
+}
+
+
 bool MjpegDecompression::isAutomatic() const {
 #ifdef MJPEG_AUTOCOMPRESS
     return true;
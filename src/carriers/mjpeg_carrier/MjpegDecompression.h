@@ -28,6 +28,13 @@ public:
 
     bool isAutomatic() const;
 
+    /**
+     * Decompress the images at 1/scale of their size (1, 2, 4 or 8).
+     * The image is scaled while decoding, that is much faster than
+     * decompressing it at full size.
+     */
+    bool setScale(int scale);
+
     bool setReadEnvelopeCallback(yarp::os::InputStream::readEnvelopeCallbackType callback,
                                  void* data);
 };
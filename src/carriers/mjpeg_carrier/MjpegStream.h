@@ -97,6 +97,10 @@ public:
         delegate->getInputStream().interrupt();
     }
 
+    bool setScale(int scale) {
+        return decompression.setScale(scale);
+    }
+
     bool setReadEnvelopeCallback(yarp::os::InputStream::readEnvelopeCallbackType callback, void* data) override {
         if (!autocompress) {
             return false;
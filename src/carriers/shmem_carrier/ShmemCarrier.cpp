@@ -10,13 +10,27 @@
 #include "ShmemCarrier.h"
 #include "ShmemHybridStream.h"
 #include "ShmemLogComponent.h"
+#if defined(__linux__)
+#    include "ShmemRingStream.h"
+#endif
 
 #include <yarp/os/ConnectionState.h>
 #include <yarp/os/Log.h>
+#include <yarp/os/ManagedBytes.h>
+#include <yarp/os/Name.h>
+#include <yarp/os/OutputStream.h>
+#include <yarp/os/Route.h>
 
 #include <string>
 #include <cstdlib>
 
+namespace {
+// Added to the specifier code when the ring mode is requested
+constexpr int ring_mode_flag = 16;
+// Longest accepted segment name
+constexpr int max_segment_name_length = 255;
+} // namespace
+
 
 ShmemCarrier::ShmemCarrier() = default;
 
@@ -56,12 +70,63 @@ bool ShmemCarrier::checkHeader(const yarp::os::Bytes& header)
 
 void ShmemCarrier::getHeader(yarp::os::Bytes& header) const
 {
-    createStandardHeader(getSpecifierCode(), header);
+    createStandardHeader(getSpecifierCode() + (ringMode ? ring_mode_flag : 0), header);
 }
 
 void ShmemCarrier::setParameters(const yarp::os::Bytes& header)
 {
-    YARP_UNUSED(header);
+    ringMode = (getSpecifier(header) & ring_mode_flag) != 0;
+}
+
+bool ShmemCarrier::prepareSend(yarp::os::ConnectionState& proto)
+{
+    yarp::os::Name n(proto.getRoute().getCarrierName() + "://test");
+    std::string ring = n.getCarrierModifier("ring");
+    std::string size = n.getCarrierModifier("size");
+    std::string zerocopy = n.getCarrierModifier("zerocopy");
+    ringMode = (!ring.empty() && ring != "0");
+    zeroCopy = (!zerocopy.empty() && zerocopy != "0");
+    if (zeroCopy && !ringMode) {
+        yCWarning(SHMEMCARRIER, "Zero copy is supported only in ring mode");
+        zeroCopy = false;
+    }
+#if !defined(__linux__)
+    if (ringMode) {
+        yCWarning(SHMEMCARRIER, "The shmem ring mode is not supported on this platform, using the default mode");
+        ringMode = false;
+    }
+#endif
+    if (!size.empty()) {
+        ringSize = atoi(size.c_str());
+        if (ringSize <= 0) {
+            yCWarning(SHMEMCARRIER, "Invalid shmem size %s, using %d", size.c_str(), SHMEM_RING_DEFAULT_SIZE);
+            ringSize = SHMEM_RING_DEFAULT_SIZE;
+        }
+    }
+    return true;
+}
+
+bool ShmemCarrier::sendHeader(yarp::os::ConnectionState& proto)
+{
+    if (!defaultSendHeader(proto)) {
+        return false;
+    }
+    if (ringMode) {
+        writeYarpInt(ringSize, proto);
+    }
+    return proto.os().isOk();
+}
+
+bool ShmemCarrier::expectExtraHeader(yarp::os::ConnectionState& proto)
+{
+    if (ringMode) {
+        ringSize = readYarpInt(proto);
+        if (ringSize <= 0) {
+            yCError(SHMEMCARRIER, "Invalid shmem ring size %d", ringSize);
+            return false;
+        }
+    }
+    return true;
 }
 
 bool ShmemCarrier::becomeShmemVersionHybridStream(yarp::os::ConnectionState& proto, bool sender)
@@ -103,8 +168,66 @@ bool ShmemCarrier::becomeShmemVersionHybridStream(yarp::os::ConnectionState& pro
     return true;
 }
 
+bool ShmemCarrier::becomeShmemVersionRingStream(yarp::os::ConnectionState& proto, bool sender)
+{
+#if defined(__linux__)
+    auto* stream = new ShmemRingStream();
+    stream->setAddresses(proto.getStreams().getLocalAddress(), proto.getStreams().getRemoteAddress());
+
+    bool ok = true;
+
+    if (!sender) {
+        // The receiver creates the segment, tells its name to the sender, and
+        // waits until the sender is attached before removing the name.
+        ok = stream->create(ringSize);
+        if (ok) {
+            const std::string& name = stream->getName();
+            writeYarpInt(static_cast<int>(name.length()), proto);
+            yarp::os::Bytes b(const_cast<char*>(name.c_str()), name.length());
+            proto.os().write(b);
+            proto.os().flush();
+            ok = (readYarpInt(proto) == 0);
+            stream->unlink();
+        }
+    } else {
+        int len = readYarpInt(proto);
+        ok = (len > 0 && len <= max_segment_name_length);
+        if (ok) {
+            yarp::os::ManagedBytes name(len + 1);
+            yarp::os::Bytes b(name.get(), len);
+            ok = (proto.is().readFull(b) == len);
+            if (ok) {
+                name.get()[len] = '\0';
+                ok = stream->attach(name.get());
+            }
+        }
+        writeYarpInt(ok ? 0 : -1, proto);
+        proto.os().flush();
+        stream->setZeroCopy(zeroCopy);
+    }
+
+    if (!ok) {
+        delete stream;
+        stream = nullptr;
+        return false;
+    }
+
+    proto.takeStreams(nullptr);
+    proto.takeStreams(stream);
+
+    return true;
+#else
+    YARP_UNUSED(proto);
+    YARP_UNUSED(sender);
+    return false;
+#endif
+}
+
 bool ShmemCarrier::becomeShmem(yarp::os::ConnectionState& proto, bool sender)
 {
+    if (ringMode) {
+        return becomeShmemVersionRingStream(proto, sender);
+    }
     return becomeShmemVersionHybridStream(proto, sender);
 }
 
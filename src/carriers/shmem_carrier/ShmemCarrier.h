@@ -10,11 +10,21 @@
 #ifndef YARP_SHMEM_SHMEMCARRIER_H
 #define YARP_SHMEM_SHMEMCARRIER_H
 
+#include "ShmemTypes.h"
+
 #include <yarp/os/AbstractCarrier.h>
 
 
 /**
  * Communicating between two ports via shared memory.
+ *
+ * On Linux, the "ring" mode ("shmem+ring.1") uses a pair of lock-free ring
+ * buffers in a POSIX shared memory segment instead of the default
+ * mutex-protected buffers. The size of each ring can be set using the "size"
+ * parameter (e.g. "shmem+ring.1+size.8388608").
+ * With the "zerocopy" parameter (e.g. "shmem+ring.1+zerocopy.1"), images
+ * allocated from a yarp::sig::SharedImagePool are not copied: only a
+ * reference to their slot is sent.
  */
 class ShmemCarrier : public yarp::os::AbstractCarrier
 {
@@ -32,12 +42,20 @@ public:
     bool checkHeader(const yarp::os::Bytes& header) override;
     void getHeader(yarp::os::Bytes& header) const override;
     void setParameters(const yarp::os::Bytes& header) override;
+    bool prepareSend(yarp::os::ConnectionState& proto) override;
+    bool sendHeader(yarp::os::ConnectionState& proto) override;
+    bool expectExtraHeader(yarp::os::ConnectionState& proto) override;
     bool respondToHeader(yarp::os::ConnectionState& proto) override;
     bool expectReplyToHeader(yarp::os::ConnectionState& proto) override;
 
 private:
     bool becomeShmemVersionHybridStream(yarp::os::ConnectionState& proto, bool sender);
+    bool becomeShmemVersionRingStream(yarp::os::ConnectionState& proto, bool sender);
     bool becomeShmem(yarp::os::ConnectionState& proto, bool sender);
+
+    bool ringMode {false};
+    int ringSize {SHMEM_RING_DEFAULT_SIZE};
+    bool zeroCopy {false};
 };
 
 #endif // YARP_SHMEM_SHMEMCARRIER_H
@@ -0,0 +1,509 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include "ShmemRingStream.h"
+#include "ShmemLogComponent.h"
+
+#include <yarp/os/Bytes.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdio>
+#include <cstring>
+#include <new>
+
+#include <fcntl.h>
+#include <linux/futex.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+
+namespace {
+
+// Blocked readers and writers wake up at least this often, to check
+// whether the other side of the connection is still alive.
+constexpr long liveness_check_period_ns = 100000000;
+
+std::atomic<int> segment_counter {0};
+
+// The segment is shared between processes, therefore the non-private futex
+// operations are used.
+void futexWait(std::atomic<std::uint32_t>& word, std::uint32_t expected)
+{
+    struct timespec timeout = {0, liveness_check_period_ns};
+    syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAIT, expected, &timeout, nullptr, 0);
+}
+
+void futexWake(std::atomic<std::uint32_t>& word)
+{
+    syscall(SYS_futex, reinterpret_cast<std::uint32_t*>(&word), FUTEX_WAKE, INT_MAX, nullptr, nullptr, 0);
+}
+
+} // namespace
+
+
+ShmemRingStream::ShmemRingStream() :
+        m_bOpen(false),
+        m_bLinked(false),
+        m_bZeroCopy(false),
+        m_pMap(nullptr),
+        m_MapSize(0),
+        m_pShared(nullptr),
+        m_SharedLeft(0)
+{
+}
+
+ShmemRingStream::~ShmemRingStream()
+{
+    close();
+    releasePendingRefs();
+    unlink();
+    unmap();
+}
+
+bool ShmemRingStream::create(int size)
+{
+    if (size <= 0) {
+        yCError(SHMEMCARRIER, "ShmemRingStream: invalid ring size %d", size);
+        return false;
+    }
+
+    char name[64];
+    snprintf(name, sizeof(name), "/yarp-shmem-%d-%d", static_cast<int>(getpid()), segment_counter++);
+    m_Name = name;
+
+    int fd = shm_open(m_Name.c_str(), O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+    if (fd < 0) {
+        yCError(SHMEMCARRIER, "ShmemRingStream: cannot create %s: %s", m_Name.c_str(), strerror(errno));
+        return false;
+    }
+    m_bLinked = true;
+
+    size_t total = 2 * sizeof(ShmemRingHeader_t) + 2 * static_cast<size_t>(size);
+    if (ftruncate(fd, static_cast<off_t>(total)) != 0) {
+        yCError(SHMEMCARRIER, "ShmemRingStream: cannot resize %s: %s", m_Name.c_str(), strerror(errno));
+        ::close(fd);
+        unlink();
+        return false;
+    }
+
+    bool ok = map(fd, total, true);
+    ::close(fd);
+    if (!ok) {
+        unlink();
+        return false;
+    }
+
+    // The creator is the receiving side: it consumes the first ring and
+    // produces in the second one.
+    for (Ring* ring : {&m_In, &m_Out}) {
+        auto* header = new (ring->header) ShmemRingHeader_t;
+        header->size = static_cast<std::uint32_t>(size);
+        header->closed = 0;
+        header->producerPid = 0;
+        header->consumerPid = 0;
+        header->head = 0;
+        header->dataSeq = 0;
+        header->consumerWaiting = 0;
+        header->refHead = 0;
+        header->tail = 0;
+        header->spaceSeq = 0;
+        header->producerWaiting = 0;
+        header->refTail = 0;
+    }
+    m_In.header->consumerPid = static_cast<std::int32_t>(getpid());
+    m_Out.header->producerPid = static_cast<std::int32_t>(getpid());
+
+    m_bOpen = true;
+    return true;
+}
+
+bool ShmemRingStream::attach(const std::string& name)
+{
+    m_Name = name;
+
+    int fd = shm_open(m_Name.c_str(), O_RDWR, 0);
+    if (fd < 0) {
+        yCError(SHMEMCARRIER, "ShmemRingStream: cannot open %s: %s", m_Name.c_str(), strerror(errno));
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) <= 2 * sizeof(ShmemRingHeader_t)) {
+        yCError(SHMEMCARRIER, "ShmemRingStream: %s is not a valid segment", m_Name.c_str());
+        ::close(fd);
+        return false;
+    }
+
+    bool ok = map(fd, static_cast<size_t>(st.st_size), false);
+    ::close(fd);
+    if (!ok) {
+        return false;
+    }
+
+    m_Out.header->producerPid = static_cast<std::int32_t>(getpid());
+    m_In.header->consumerPid = static_cast<std::int32_t>(getpid());
+
+    m_bOpen = true;
+    return true;
+}
+
+void ShmemRingStream::unlink()
+{
+    if (m_bLinked) {
+        shm_unlink(m_Name.c_str());
+        m_bLinked = false;
+    }
+}
+
+bool ShmemRingStream::map(int fd, size_t size, bool creator)
+{
+    void* ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (ptr == MAP_FAILED) {
+        yCError(SHMEMCARRIER, "ShmemRingStream: cannot map %s: %s", m_Name.c_str(), strerror(errno));
+        return false;
+    }
+    m_pMap = ptr;
+    m_MapSize = size;
+
+    size_t ringSize = (size - 2 * sizeof(ShmemRingHeader_t)) / 2;
+    auto* headers = static_cast<ShmemRingHeader_t*>(m_pMap);
+    char* data = static_cast<char*>(m_pMap) + 2 * sizeof(ShmemRingHeader_t);
+
+    // First ring: sender to receiver. Second ring: receiver to sender.
+    Ring& forward = creator ? m_In : m_Out;
+    Ring& backward = creator ? m_Out : m_In;
+    forward.header = &headers[0];
+    forward.data = data;
+    backward.header = &headers[1];
+    backward.data = data + ringSize;
+
+    return true;
+}
+
+void ShmemRingStream::unmap()
+{
+    if (m_pMap != nullptr) {
+        munmap(m_pMap, m_MapSize);
+        m_pMap = nullptr;
+        m_MapSize = 0;
+        m_In = Ring();
+        m_Out = Ring();
+    }
+}
+
+bool ShmemRingStream::isPeerAlive(int pid) const
+{
+    // pid is 0 until the peer attaches to the segment
+    return pid <= 0 || kill(pid, 0) == 0 || errno != ESRCH;
+}
+
+void ShmemRingStream::setAddresses(const yarp::os::Contact& local, const yarp::os::Contact& remote)
+{
+    m_LocalAddress = local;
+    m_RemoteAddress = remote;
+}
+
+void ShmemRingStream::setZeroCopy(bool zeroCopy)
+{
+    m_bZeroCopy = zeroCopy;
+}
+
+const std::string& ShmemRingStream::getName() const
+{
+    return m_Name;
+}
+
+void ShmemRingStream::close()
+{
+    if (!m_bOpen) {
+        return;
+    }
+    m_bOpen = false;
+
+    // The segment stays mapped until destruction, since other threads
+    // might still be waiting on it.
+    for (Ring* ring : {&m_In, &m_Out}) {
+        ring->header->closed = 1;
+        ring->header->dataSeq++;
+        ring->header->spaceSeq++;
+        futexWake(ring->header->dataSeq);
+        futexWake(ring->header->spaceSeq);
+    }
+}
+
+void ShmemRingStream::interrupt()
+{
+    yCDebug(SHMEMCARRIER, "INTERRUPT");
+    close();
+}
+
+void ShmemRingStream::write(const yarp::os::Bytes& b)
+{
+    if (!isOk()) {
+        return;
+    }
+
+    if (m_bZeroCopy && writeShared(b)) {
+        return;
+    }
+
+    ShmemRingHeader_t* header = m_Out.header;
+    const size_t size = header->size;
+    const char* src = b.get();
+    size_t remaining = b.length();
+    std::uint64_t head = header->head.load(std::memory_order_relaxed);
+
+    while (remaining > 0) {
+        std::uint64_t tail = header->tail.load(std::memory_order_acquire);
+        size_t space = size - static_cast<size_t>(head - tail);
+        if (space == 0) {
+            if (header->closed != 0 || !isPeerAlive(header->consumerPid)) {
+                yCDebug(SHMEMCARRIER, "STREAM IS BROKEN");
+                close();
+                return;
+            }
+            header->producerWaiting = 1;
+            std::uint32_t seq = header->spaceSeq;
+            if (header->tail.load(std::memory_order_acquire) == tail) {
+                futexWait(header->spaceSeq, seq);
+            }
+            header->producerWaiting = 0;
+            continue;
+        }
+
+        size_t len = std::min(space, remaining);
+        size_t offset = static_cast<size_t>(head % size);
+        size_t first = std::min(len, size - offset);
+        memcpy(m_Out.data + offset, src, first);
+        memcpy(m_Out.data, src + first, len - first);
+
+        head += len;
+        src += len;
+        remaining -= len;
+
+        header->head.store(head, std::memory_order_release);
+        header->dataSeq++;
+        if (header->consumerWaiting != 0) {
+            futexWake(header->dataSeq);
+        }
+    }
+}
+
+bool ShmemRingStream::writeShared(const yarp::os::Bytes& b)
+{
+    ShmemRingHeader_t* header = m_Out.header;
+    std::uint64_t refHead = header->refHead.load(std::memory_order_relaxed);
+    if (refHead - header->refTail.load(std::memory_order_acquire) >= SHMEM_RING_MAX_REFS) {
+        // Too many blocks in flight, copy this one
+        return false;
+    }
+
+    ShmemRingRef_t& ref = header->refs[refHead % SHMEM_RING_MAX_REFS];
+    if (!yarp::sig::SharedImagePool::acquire(b.get(), b.length(), ref.handle)) {
+        return false;
+    }
+    ref.position = header->head.load(std::memory_order_relaxed);
+
+    header->refHead.store(refHead + 1, std::memory_order_release);
+    header->dataSeq++;
+    if (header->consumerWaiting != 0) {
+        futexWake(header->dataSeq);
+    }
+    return true;
+}
+
+ShmemRingRef_t* ShmemRingStream::pendingRef()
+{
+    // The reference must be checked after loading head, since the producer
+    // queues it before writing the data that follows it.
+    ShmemRingHeader_t* header = m_In.header;
+    std::uint64_t refTail = header->refTail.load(std::memory_order_relaxed);
+    if (refTail == header->refHead.load(std::memory_order_acquire)) {
+        return nullptr;
+    }
+    return &header->refs[refTail % SHMEM_RING_MAX_REFS];
+}
+
+void ShmemRingStream::popRef()
+{
+    ShmemRingHeader_t* header = m_In.header;
+    header->refTail.store(header->refTail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+void ShmemRingStream::releasePendingRefs()
+{
+    m_SharedOwner.reset();
+    m_SharedLeft = 0;
+    if (m_In.header == nullptr) {
+        return;
+    }
+    ShmemRingRef_t* ref = nullptr;
+    while ((ref = pendingRef()) != nullptr) {
+        yarp::sig::SharedImagePool::release(ref->handle);
+        popRef();
+    }
+}
+
+bool ShmemRingStream::waitData()
+{
+    ShmemRingHeader_t* header = m_In.header;
+    std::uint64_t tail = header->tail.load(std::memory_order_relaxed);
+
+    auto available = [&]() {
+        if (header->head.load(std::memory_order_acquire) != tail) {
+            return true;
+        }
+        ShmemRingRef_t* ref = pendingRef();
+        return ref != nullptr && ref->position == tail;
+    };
+
+    while (!available()) {
+        // Data written before closing is still delivered
+        if (!m_bOpen || header->closed != 0 || !isPeerAlive(header->producerPid)) {
+            yCDebug(SHMEMCARRIER, "STREAM IS BROKEN");
+            close();
+            return false;
+        }
+        header->consumerWaiting = 1;
+        std::uint32_t seq = header->dataSeq;
+        if (!available()) {
+            futexWait(header->dataSeq, seq);
+        }
+        header->consumerWaiting = 0;
+    }
+    return true;
+}
+
+yarp::conf::ssize_t ShmemRingStream::read(yarp::os::Bytes& b)
+{
+    if (!m_bOpen) {
+        return -1;
+    }
+    if (b.length() == 0) {
+        return 0;
+    }
+
+    ShmemRingHeader_t* header = m_In.header;
+    const size_t size = header->size;
+    std::uint64_t tail = header->tail.load(std::memory_order_relaxed);
+
+    if (m_SharedLeft == 0) {
+        if (!waitData()) {
+            return -1;
+        }
+        ShmemRingRef_t* ref = pendingRef();
+        if (ref != nullptr && ref->position == tail) {
+            // Copy the shared block, since the caller wants its own copy
+            m_pShared = yarp::sig::SharedImagePool::attach(ref->handle, m_SharedOwner);
+            m_SharedLeft = static_cast<size_t>(ref->handle.length);
+            popRef();
+            if (m_pShared == nullptr) {
+                m_SharedLeft = 0;
+                close();
+                return -1;
+            }
+        }
+    }
+
+    if (m_SharedLeft > 0) {
+        size_t len = std::min(m_SharedLeft, b.length());
+        memcpy(b.get(), m_pShared, len);
+        m_pShared += len;
+        m_SharedLeft -= len;
+        if (m_SharedLeft == 0) {
+            m_SharedOwner.reset();
+        }
+        return static_cast<yarp::conf::ssize_t>(len);
+    }
+
+    // Read up to the next shared block
+    std::uint64_t limit = header->head.load(std::memory_order_acquire);
+    ShmemRingRef_t* ref = pendingRef();
+    if (ref != nullptr) {
+        limit = std::min(limit, ref->position);
+    }
+
+    size_t len = std::min(static_cast<size_t>(limit - tail), b.length());
+    size_t offset = static_cast<size_t>(tail % size);
+    size_t first = std::min(len, size - offset);
+    memcpy(b.get(), m_In.data + offset, first);
+    memcpy(b.get() + first, m_In.data, len - first);
+
+    header->tail.store(tail + len, std::memory_order_release);
+    header->spaceSeq++;
+    if (header->producerWaiting != 0) {
+        futexWake(header->spaceSeq);
+    }
+
+    return static_cast<yarp::conf::ssize_t>(len);
+}
+
+const char* ShmemRingStream::readShared(size_t len, std::shared_ptr<void>& owner)
+{
+    if (!m_bOpen || m_SharedLeft != 0 || !waitData()) {
+        return nullptr;
+    }
+
+    std::uint64_t tail = m_In.header->tail.load(std::memory_order_relaxed);
+    ShmemRingRef_t* ref = pendingRef();
+    if (ref == nullptr || ref->position != tail || ref->handle.length != len) {
+        return nullptr;
+    }
+
+    const char* data = yarp::sig::SharedImagePool::attach(ref->handle, owner);
+    popRef();
+    if (data == nullptr) {
+        close();
+    }
+    return data;
+}
+
+yarp::os::InputStream& ShmemRingStream::getInputStream()
+{
+    return *this;
+}
+
+yarp::os::OutputStream& ShmemRingStream::getOutputStream()
+{
+    return *this;
+}
+
+bool ShmemRingStream::isOk() const
+{
+    return m_bOpen && m_In.header->closed == 0 && m_Out.header->closed == 0;
+}
+
+void ShmemRingStream::reset()
+{
+    yCDebug(SHMEMCARRIER, "RECEIVED RESET COMMAND");
+    close();
+}
+
+void ShmemRingStream::beginPacket()
+{
+}
+
+void ShmemRingStream::endPacket()
+{
+}
+
+const yarp::os::Contact& ShmemRingStream::getLocalAddress() const
+{
+    return m_LocalAddress;
+}
+
+const yarp::os::Contact& ShmemRingStream::getRemoteAddress() const
+{
+    return m_RemoteAddress;
+}
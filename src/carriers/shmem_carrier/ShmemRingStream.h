@@ -0,0 +1,139 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef YARP_SHMEM_SHMEMRINGSTREAM_H
+#define YARP_SHMEM_SHMEMRINGSTREAM_H
+
+#include "ShmemTypes.h"
+
+#include <yarp/os/Contact.h>
+#include <yarp/os/InputStream.h>
+#include <yarp/os/OutputStream.h>
+#include <yarp/os/TwoWayStream.h>
+
+#include <memory>
+#include <string>
+
+
+/**
+ * A stream abstraction for shared memory communication, based on a pair of
+ * lock-free single-producer/single-consumer ring buffers (one for each
+ * direction) stored in a POSIX shared memory segment.
+ *
+ * The rings are allocated once, with a size chosen when the connection is
+ * created, and never resized: messages larger than the ring are streamed
+ * through it.  Blocked readers and writers are woken up using futexes.
+ *
+ * Both peers must share the PID namespace, since the peer process id is used
+ * to detect when the other side of the connection dies.
+ *
+ * When zero copy is enabled, blocks allocated from a
+ * yarp::sig::SharedImagePool are not copied into the ring: a reference to
+ * the slot is queued instead, and the reader can wrap the slot memory using
+ * readShared().
+ */
+class ShmemRingStream : public yarp::os::TwoWayStream,
+                        public yarp::os::InputStream,
+                        public yarp::os::OutputStream
+{
+public:
+    ShmemRingStream();
+    virtual ~ShmemRingStream();
+
+    /**
+     * Create a new shared memory segment, as receiving side.
+     *
+     * @param size the size of each ring buffer, in bytes
+     * @return true on success
+     */
+    bool create(int size);
+
+    /**
+     * Attach to a shared memory segment created by the receiving side.
+     *
+     * @param name the name of the segment
+     * @return true on success
+     */
+    bool attach(const std::string& name);
+
+    /**
+     * Remove the name of the segment, once both sides are attached.
+     */
+    void unlink();
+
+    const std::string& getName() const;
+
+    void setAddresses(const yarp::os::Contact& local, const yarp::os::Contact& remote);
+
+    /**
+     * Send references to blocks allocated from a shared memory pool, instead
+     * of copying them.
+     */
+    void setZeroCopy(bool zeroCopy);
+
+    void close() override;
+    void interrupt() override;
+
+    using yarp::os::OutputStream::write;
+    void write(const yarp::os::Bytes& b) override;
+
+    using yarp::os::InputStream::read;
+    yarp::conf::ssize_t read(yarp::os::Bytes& b) override;
+    const char* readShared(size_t len, std::shared_ptr<void>& owner) override;
+
+    // TwoWayStrem implementation
+    yarp::os::InputStream& getInputStream() override;
+    yarp::os::OutputStream& getOutputStream() override;
+    bool isOk() const override;
+
+    void reset() override;
+
+    void beginPacket() override;
+    void endPacket() override;
+
+    const yarp::os::Contact& getLocalAddress() const override;
+    const yarp::os::Contact& getRemoteAddress() const override;
+
+private:
+    struct Ring
+    {
+        ShmemRingHeader_t* header {nullptr};
+        char* data {nullptr};
+    };
+
+    bool map(int fd, size_t size, bool creator);
+    void unmap();
+    bool isPeerAlive(int pid) const;
+
+    bool writeShared(const yarp::os::Bytes& b);
+    bool waitData();
+    ShmemRingRef_t* pendingRef();
+    void popRef();
+    void releasePendingRefs();
+
+    bool m_bOpen;
+    bool m_bLinked;
+    bool m_bZeroCopy;
+    std::string m_Name;
+
+    void* m_pMap;
+    size_t m_MapSize;
+
+    Ring m_In;
+    Ring m_Out;
+
+    // The shared block being read
+    const char* m_pShared;
+    size_t m_SharedLeft;
+    std::shared_ptr<void> m_SharedOwner;
+
+    yarp::os::Contact m_LocalAddress;
+    yarp::os::Contact m_RemoteAddress;
+};
+
+#endif // YARP_SHMEM_SHMEMRINGSTREAM_H
@@ -10,7 +10,14 @@
 #ifndef YARP_SHMEM_SHMEMTYPES_H
 #define YARP_SHMEM_SHMEMTYPES_H
 
+#include <yarp/sig/SharedImagePool.h>
+
+#include <atomic>
+#include <cstdint>
+
 #define SHMEM_DEFAULT_SIZE 4096
+#define SHMEM_RING_DEFAULT_SIZE 1048576
+#define SHMEM_RING_MAX_REFS 64
 
 struct ShmemHeader_t
 {
@@ -32,4 +39,42 @@ struct ShmemPacket_t
     int size;
 };
 
+/**
+ * A block of a shared memory pool, inserted in the stream at the given
+ * position instead of copying its content into the ring.
+ */
+struct ShmemRingRef_t
+{
+    std::uint64_t position;
+    yarp::sig::SharedImagePool::Handle handle;
+};
+
+/**
+ * Control block of a single-producer/single-consumer ring buffer.
+ *
+ * head and tail are free running byte counters, only the producer moves
+ * head and only the consumer moves tail.  dataSeq and spaceSeq are futex
+ * words, bumped every time data or space becomes available.
+ * refHead and refTail are the counters of the queue of shared blocks.
+ */
+struct ShmemRingHeader_t
+{
+    std::uint32_t size;
+    std::atomic<std::uint32_t> closed;
+    std::int32_t producerPid;
+    std::int32_t consumerPid;
+
+    alignas(64) std::atomic<std::uint64_t> head;
+    std::atomic<std::uint32_t> dataSeq;
+    std::atomic<std::uint32_t> consumerWaiting;
+    std::atomic<std::uint64_t> refHead;
+
+    alignas(64) std::atomic<std::uint64_t> tail;
+    std::atomic<std::uint32_t> spaceSeq;
+    std::atomic<std::uint32_t> producerWaiting;
+    std::atomic<std::uint64_t> refTail;
+
+    ShmemRingRef_t refs[SHMEM_RING_MAX_REFS];
+};
+
 #endif // YARP_SHMEM_SHMEMTYPES_H
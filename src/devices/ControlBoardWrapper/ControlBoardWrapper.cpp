@@ -15,6 +15,7 @@
 #include <iostream>
 #include <yarp/os/LogComponent.h>
 #include <yarp/os/LogStream.h>
+#include <yarp/os/SystemClock.h>
 #include <sstream>
 #include <numeric>
 #include <algorithm>
@@ -35,6 +36,8 @@ ControlBoardWrapper::ControlBoardWrapper() :yarp::os::PeriodicThread(0.02),
     RPC_parser.init(this);
     controlledJoints = 0;
     period = 0.02; // s.
+    batchedState = false;
+    overruns = 0;
     base = 0;
     top = 0;
     subDeviceOwned = nullptr;
@@ -65,7 +68,11 @@ void ControlBoardWrapper::cleanup_yarpPorts()
     extendedOutputStatePort.interrupt();
     extendedOutputStatePort.close();
 
+    diagnosticsPort.interrupt();
+    diagnosticsPort.close();
+
     rpcData.destroy();
+    streamingData.destroy();
 }
 
 ControlBoardWrapper::~ControlBoardWrapper() = default;
@@ -378,6 +385,13 @@ bool ControlBoardWrapper::initialize_YARP(yarp::os::Searchable &prop)
                 break;
             }
             extendedOutputState_buffer.attach(extendedOutputStatePort);
+
+            if(!diagnosticsPort.open(rootName+"/diagnostics:o") )
+            {
+                yCError(CONTROLBOARDWRAPPER) <<"Error opening port "<< rootName+"/diagnostics:o";
+                success = false;
+                break;
+            }
             success = true;
         } break;
     }  // end switch
@@ -434,6 +448,10 @@ bool ControlBoardWrapper::open(Searchable& config)
         period = 0.02;
     }
 
+    batchedState = prop.check("batched_state", Value(false), "read the state of each subdevice in a single snapshot").asBool();
+    if (batchedState)
+        yCInfo(CONTROLBOARDWRAPPER) << "ControlBoardWrapper2: reading the state of the subdevices in batches";
+
     // check if we need to create subdevice or if they are
     // passed later on thorugh attachAll()
     if(prop.check("subdevice"))
@@ -455,6 +473,7 @@ bool ControlBoardWrapper::open(Searchable& config)
 
     // using controlledJoints here will allocate more memory than required, but not so much.
     rpcData.resize(device.subdevices.size(), controlledJoints, &device);
+    streamingData.resize(device.subdevices.size(), controlledJoints, &device);
 
      /* This must be after the openAndAttachSubDevice() or openDeferredAttach() in order to have the correct number of controlledJoints,
         but before the initialize_ROS and initialize_YARP */
@@ -873,8 +892,91 @@ bool ControlBoardWrapper::detachAll()
         return true;
 }
 
+namespace {
+
+// Copy a quantity from the snapshots of the subdevices to the wrapper joints
+template <typename T, typename U>
+bool gatherState(WrappedDevice& device, std::vector<T> SubDeviceState::*values, bool SubDeviceState::*isValid, U* dest)
+{
+    bool ret = true;
+    for(auto& p : device.subdevices)
+    {
+        const SubDeviceState& state = p.state;
+        if (!(state.*isValid))
+        {
+            ret = false;
+            continue;
+        }
+        const std::vector<T>& v = state.*values;
+        for(int juser= p.wbase, jdevice=p.base; juser<=p.wtop; juser++, jdevice++)
+        {
+            dest[juser] = static_cast<U>(v[jdevice]);
+        }
+    }
+    return ret;
+}
+
+} // namespace
+
+void ControlBoardWrapper::readSubDeviceStates()
+{
+    subDeviceReadTimes.resize(device.subdevices.size());
+    for(size_t d=0; d<device.subdevices.size(); d++)
+    {
+        double start = SystemClock::nowSystem();
+        device.subdevices[d].readState();
+        subDeviceReadTimes[d] = SystemClock::nowSystem() - start;
+    }
+}
+
+void ControlBoardWrapper::writeDiagnostics(double readTime, double yarpTime, double rosTime, double totalTime)
+{
+    if (totalTime > period)
+        overruns++;
+
+    // Avoid building the message if nobody is listening
+    if (diagnosticsPort.isClosed() || diagnosticsPort.getOutputCount() == 0)
+        return;
+
+    Bottle& b = diagnosticsPort.prepare();
+    b.clear();
+    Bottle& bPeriod = b.addList();
+    bPeriod.addString("period");
+    bPeriod.addFloat64(period);
+    Bottle& bTotal = b.addList();
+    bTotal.addString("total");
+    bTotal.addFloat64(totalTime);
+    Bottle& bRead = b.addList();
+    bRead.addString("read");
+    bRead.addFloat64(readTime);
+    Bottle& bYarp = b.addList();
+    bYarp.addString("yarp");
+    bYarp.addFloat64(yarpTime);
+    Bottle& bRos = b.addList();
+    bRos.addString("ros");
+    bRos.addFloat64(rosTime);
+    Bottle& bOverruns = b.addList();
+    bOverruns.addString("overruns");
+    bOverruns.addInt64(static_cast<std::int64_t>(overruns));
+    if (batchedState)
+    {
+        Bottle& bSubdevices = b.addList();
+        bSubdevices.addString("subdevices");
+        for(size_t d=0; d<subDeviceReadTimes.size() && d<device.subdevices.size(); d++)
+        {
+            Bottle& bSubdevice = bSubdevices.addList();
+            bSubdevice.addString(device.subdevices[d].id);
+            bSubdevice.addFloat64(subDeviceReadTimes[d]);
+        }
+    }
+    diagnosticsPort.setEnvelope(time);
+    diagnosticsPort.write();
+}
+
 void ControlBoardWrapper::run()
 {
+    double startTime = SystemClock::nowSystem();
+
     // check we are not overflowing with input messages
     if(inputStreamingPort.getPendingReads() >= 20)
     {
@@ -889,13 +991,30 @@ void ControlBoardWrapper::run()
     // it will be rewuired to call port.prepare, that it is something I should
     // not do if the wrapper is in ROS_only configuration.
 
-    bool positionsOk = getEncodersTimed(ros_struct.position.data(), times.data());
-    bool speedsOk    = getEncoderSpeeds(ros_struct.velocity.data());
-    bool torqueOk    = getTorques(ros_struct.effort.data());
+    bool positionsOk;
+    bool speedsOk;
+    bool torqueOk;
+    if (batchedState)
+    {
+        // A single snapshot of all the quantities for each subdevice
+        readSubDeviceStates();
+        positionsOk = gatherState(device, &SubDeviceState::jointPosition, &SubDeviceState::jointPosition_isValid, ros_struct.position.data());
+        gatherState(device, &SubDeviceState::jointTimes, &SubDeviceState::jointPosition_isValid, times.data());
+        speedsOk    = gatherState(device, &SubDeviceState::jointVelocity, &SubDeviceState::jointVelocity_isValid, ros_struct.velocity.data());
+        torqueOk    = gatherState(device, &SubDeviceState::torque, &SubDeviceState::torque_isValid, ros_struct.effort.data());
+    }
+    else
+    {
+        positionsOk = getEncodersTimed(ros_struct.position.data(), times.data());
+        speedsOk    = getEncoderSpeeds(ros_struct.velocity.data());
+        torqueOk    = getTorques(ros_struct.effort.data());
+    }
 
     // Update the port envelope time by averaging all timestamps
     time.update(std::accumulate(times.begin(), times.end(), 0.0) / controlledJoints);
 
+    double readEndTime = SystemClock::nowSystem();
+
     if(useROS != ROS_only)
     {
         // handle stateExt first
@@ -924,16 +1043,31 @@ void ControlBoardWrapper::run()
         yarp_struct.torque_isValid              = torqueOk;
         std::copy(ros_struct.effort.begin(), ros_struct.effort.end(),  yarp_struct.torque.begin());
 
-        // Get remaining data from HW
-        yarp_struct.jointAcceleration_isValid   = getEncoderAccelerations(yarp_struct.jointAcceleration.data());
-        yarp_struct.motorPosition_isValid       = getMotorEncoders(yarp_struct.motorPosition.data());
-        yarp_struct.motorVelocity_isValid       = getMotorEncoderSpeeds(yarp_struct.motorVelocity.data());
-        yarp_struct.motorAcceleration_isValid   = getMotorEncoderAccelerations(yarp_struct.motorAcceleration.data());
-        yarp_struct.torque_isValid              = getTorques(yarp_struct.torque.data());
-        yarp_struct.pwmDutycycle_isValid        = getDutyCycles(yarp_struct.pwmDutycycle.data());
-        yarp_struct.current_isValid             = getCurrents(yarp_struct.current.data());
-        yarp_struct.controlMode_isValid         = getControlModes(yarp_struct.controlMode.data());
-        yarp_struct.interactionMode_isValid     = getInteractionModes((yarp::dev::InteractionModeEnum* ) yarp_struct.interactionMode.data());
+        if (batchedState)
+        {
+            // Get remaining data from the snapshots
+            yarp_struct.jointAcceleration_isValid   = gatherState(device, &SubDeviceState::jointAcceleration, &SubDeviceState::jointAcceleration_isValid, yarp_struct.jointAcceleration.data());
+            yarp_struct.motorPosition_isValid       = gatherState(device, &SubDeviceState::motorPosition, &SubDeviceState::motorPosition_isValid, yarp_struct.motorPosition.data());
+            yarp_struct.motorVelocity_isValid       = gatherState(device, &SubDeviceState::motorVelocity, &SubDeviceState::motorVelocity_isValid, yarp_struct.motorVelocity.data());
+            yarp_struct.motorAcceleration_isValid   = gatherState(device, &SubDeviceState::motorAcceleration, &SubDeviceState::motorAcceleration_isValid, yarp_struct.motorAcceleration.data());
+            yarp_struct.pwmDutycycle_isValid        = gatherState(device, &SubDeviceState::pwmDutycycle, &SubDeviceState::pwmDutycycle_isValid, yarp_struct.pwmDutycycle.data());
+            yarp_struct.current_isValid             = gatherState(device, &SubDeviceState::current, &SubDeviceState::current_isValid, yarp_struct.current.data());
+            yarp_struct.controlMode_isValid         = gatherState(device, &SubDeviceState::controlMode, &SubDeviceState::controlMode_isValid, yarp_struct.controlMode.data());
+            yarp_struct.interactionMode_isValid     = gatherState(device, &SubDeviceState::interactionMode, &SubDeviceState::interactionMode_isValid, yarp_struct.interactionMode.data());
+        }
+        else
+        {
+            // Get remaining data from HW
+            yarp_struct.jointAcceleration_isValid   = getEncoderAccelerations(yarp_struct.jointAcceleration.data());
+            yarp_struct.motorPosition_isValid       = getMotorEncoders(yarp_struct.motorPosition.data());
+            yarp_struct.motorVelocity_isValid       = getMotorEncoderSpeeds(yarp_struct.motorVelocity.data());
+            yarp_struct.motorAcceleration_isValid   = getMotorEncoderAccelerations(yarp_struct.motorAcceleration.data());
+            yarp_struct.torque_isValid              = getTorques(yarp_struct.torque.data());
+            yarp_struct.pwmDutycycle_isValid        = getDutyCycles(yarp_struct.pwmDutycycle.data());
+            yarp_struct.current_isValid             = getCurrents(yarp_struct.current.data());
+            yarp_struct.controlMode_isValid         = getControlModes(yarp_struct.controlMode.data());
+            yarp_struct.interactionMode_isValid     = getInteractionModes((yarp::dev::InteractionModeEnum* ) yarp_struct.interactionMode.data());
+        }
 
         extendedOutputStatePort.setEnvelope(time);
         extendedOutputState_buffer.write();
@@ -947,6 +1081,8 @@ void ControlBoardWrapper::run()
         outputPositionStatePort.write();
     }
 
+    double yarpEndTime = SystemClock::nowSystem();
+
     if(useROS != ROS_disabled)
     {
         // Data from HW have been gathered few lines before
@@ -968,6 +1104,78 @@ void ControlBoardWrapper::run()
 
         rosPublisherPort.write(ros_struct);
     }
+
+    double endTime = SystemClock::nowSystem();
+    writeDiagnostics(readEndTime - startTime, yarpEndTime - readEndTime, endTime - yarpEndTime, endTime - startTime);
+}
+
+bool ControlBoardWrapper::applyStreamingCommand(const StreamingCommand& cmd)
+{
+    if ((int)cmd.getAxes() != controlledJoints)
+        return false;
+
+    //Reset subdev_jointsVectorLen vector
+    memset(streamingData.subdev_jointsVectorLen, 0x00, sizeof(int) * streamingData.deviceNum);
+
+    // Create a map of joints for each subDevice, the references are sorted by joint number
+    const double* refs = cmd.getReferences();
+    int subIndex = 0;
+    int k = 0;
+    for(int j=0; j<controlledJoints; j++)
+    {
+        if (!cmd.isSelected(j))
+            continue;
+        subIndex = device.lut[j].deviceEntry;
+        int &len = streamingData.subdev_jointsVectorLen[subIndex];
+        streamingData.jointNumbers[subIndex][len] = device.lut[j].offset + streamingData.subdevices_p[subIndex]->base;
+        streamingData.values[subIndex][len] = refs[k++];
+        len++;
+    }
+
+    bool ret = true;
+    for(subIndex=0; subIndex<streamingData.deviceNum; subIndex++)
+    {
+        int n = streamingData.subdev_jointsVectorLen[subIndex];
+        if (n == 0)
+            continue;
+
+        SubDevice *p = streamingData.subdevices_p[subIndex];
+        int *joints = streamingData.jointNumbers[subIndex];
+        double *values = streamingData.values[subIndex];
+        // single joint commands use the single joint methods, as the Bottle based commands do
+        switch (cmd.getCommand())
+        {
+            case VOCAB_POSITION_DIRECTS:
+                ret = p->posDir && (n == 1 ? p->posDir->setPosition(joints[0], values[0])
+                                           : p->posDir->setPositions(n, joints, values)) && ret;
+                break;
+            case VOCAB_VELOCITY_MOVES:
+                ret = p->vel && (n == 1 ? p->vel->velocityMove(joints[0], values[0])
+                                        : p->vel->velocityMove(n, joints, values)) && ret;
+                break;
+            case VOCAB_TORQUES_DIRECTS:
+                ret = p->iTorque && (n == 1 ? p->iTorque->setRefTorque(joints[0], values[0])
+                                            : p->iTorque->setRefTorques(n, joints, values)) && ret;
+                break;
+            case VOCAB_CURRENTCONTROL_INTERFACE:
+                ret = p->iCurr && (n == 1 ? p->iCurr->setRefCurrent(joints[0], values[0])
+                                          : p->iCurr->setRefCurrents(n, joints, values)) && ret;
+                break;
+            case VOCAB_PWMCONTROL_INTERFACE:
+                // IPWMControl has no method for a group of joints
+                if (!p->iPWM)
+                {
+                    ret = false;
+                    break;
+                }
+                for (int i = 0; i < n; i++)
+                    ret = p->iPWM->setRefDutyCycle(joints[i], values[i]) && ret;
+                break;
+            default:
+                return false;
+        }
+    }
+    return ret;
 }
 
 //
@@ -53,7 +53,7 @@
 
 #define PROTOCOL_VERSION_MAJOR 1
 #define PROTOCOL_VERSION_MINOR 9
-#define PROTOCOL_VERSION_TWEAK 0
+#define PROTOCOL_VERSION_TWEAK 1
 
 /*
  * To optimize memory allocation, for group of joints we can have one mem reserver for rpc port
@@ -138,6 +138,7 @@ public:
  * |:--------------:|:--------------:|:-------:|:--------------:|:-------------:|:--------------------------: |:-----------------------------------------------------------------:|:-----:|
  * | name           |      -         | string  | -              |   -           | Yes                         | full name of the port opened by the device, like /robotName/part/ | MUST start with a '/' character |
  * | period         |      -         | int     | ms             |   20          | No                          | refresh period of the broadcasted values in ms                    | optional, default 20ms |
+ * | batched_state  |      -         | bool    | -              |   false       | No                          | read the state of each subdevice in a single snapshot, instead of once for each quantity of the whole part | - |
  * | subdevice      |      -         | string  | -              |   -           | alternative to netwok group | name of the subdevice to instantiate                              | when used, parameters for the subdevice must be provided as well |
  * | networks       |      -         | group   | -              |   -           | alternative to subdevice    | this is expected to be a group parameter in xml format, a list in .ini file format. SubParameter are mandatory if this is used| - |
  * | -              | networkName_1  | 4 * int | joint number   |   -           |   if networks is used       | describe how to match subdevice_1 joints with the wrapper joints. First 2 numbers indicate first/last wrapper joint, last 2 numbers are subdevice first/last joint | The joints are intended to be consequent |
@@ -256,7 +257,7 @@ private:
     yarp::rosmsg::sensor_msgs::JointState ros_struct;
 
     yarp::os::BufferedPort<yarp::sig::Vector>  outputPositionStatePort;   // Port /state:o streaming out the encoder positions
-    yarp::os::BufferedPort<CommandMessage>     inputStreamingPort;        // Input streaming port for high frequency commands
+    yarp::os::BufferedPort<StreamingMessage>   inputStreamingPort;        // Input streaming port for high frequency commands
     yarp::os::Port inputRPCPort;                // Input RPC port for set/get remote calls
     yarp::os::Stamp time;                       // envelope to attach to the state port
     yarp::sig::Vector times;                    // time for each joint
@@ -267,6 +268,11 @@ private:
     yarp::os::PortWriterBuffer<yarp::dev::impl::jointData>           extendedOutputState_buffer;
     yarp::os::Port extendedOutputStatePort;         // Port /stateExt:o streaming out the struct with the robot data
 
+    // Port /diagnostics:o streaming out the time spent in each phase of the state thread, written only if connected
+    yarp::os::BufferedPort<yarp::os::Bottle>    diagnosticsPort;
+    std::vector<double>                         subDeviceReadTimes;         // time spent reading each subdevice state, if batched_state is used
+    size_t                                      overruns;                   // number of cycles longer than the period
+
     // ROS state publisher
     ROSTopicUsageType                                   useROS;                     // decide if open ROS topic or not
     std::vector<std::string>                            jointNames;                 // name of the joints
@@ -286,12 +292,16 @@ private:
     std::mutex                                 rpcDataMutex;                   // mutex to avoid concurrency between more clients using rppc port
     MultiJointData                 rpcData;                        // Structure used to re-arrange data from "multiple_joints" calls.
 
+    // Binary streaming commands are handled by the streaming port callback only, no mutex needed
+    MultiJointData                 streamingData;                  // Structure used to re-arrange data from binary streaming commands.
+
     std::string         partName;               // to open ports and print more detailed debug messages
 
     int               controlledJoints;
     int               base;         // to be removed
     int               top;          // to be removed
     double            period;       // thread rate for publishing data
+    bool              batchedState; // read the state with a SubDevice::readState() call for each subdevice
     bool              _verb;        // make it work and propagate to subdevice if --subdevice option is used
 
     yarp::os::Bottle getOptions();
@@ -323,6 +333,9 @@ private:
 
     void calculateMaxNumOfJointsInDevices();
 
+    void readSubDeviceStates();
+    void writeDiagnostics(double readTime, double yarpTime, double rosTime, double totalTime);
+
 public:
     ControlBoardWrapper();
     ControlBoardWrapper(const ControlBoardWrapper&) = delete;
@@ -374,6 +387,14 @@ public:
     */
     void run() override;
 
+    /**
+    * Forward a binary streaming command to the subdevices, with a single call
+    * for each of them.
+    * @param cmd the command, for all the axes controlled by the wrapper.
+    * @return true/false on success/failure.
+    */
+    bool applyStreamingCommand(const yarp::dev::impl::StreamingCommand& cmd);
+
     /* IPidControl
     These methods are documented by Doxygen in IPidControl.h*/
     bool setPid(const yarp::dev::PidControlTypeEnum& pidtype, int j, const yarp::dev::Pid &p) override;
@@ -11,6 +11,8 @@
 #include "ControlBoardWrapper.h"
 #include "ControlBoardWrapperLogComponent.h"
 #include <iostream>
+#include <yarp/os/ConnectionReader.h>
+#include <yarp/os/ConnectionWriter.h>
 #include <yarp/os/LogStream.h>
 
 using namespace yarp::os;
@@ -20,7 +22,36 @@ using namespace yarp::sig;
 using namespace std;
 
 
+bool StreamingMessage::read(yarp::os::ConnectionReader& connection)
+{
+    // if someone connects in text mode, use standard
+    // text-to-binary mapping
+    connection.convertTextMode();
+
+    std::int32_t header = connection.expectInt32();
+    isBinary = (header == StreamingCommand::tag);
+    if (isBinary) {
+        return command.readPayload(connection);
+    }
+
+    // same as PortablePair::read()
+    if (header != BOTTLE_TAG_LIST || connection.expectInt32() != 2) {
+        return false;
+    }
+    return message.head.read(connection) && message.body.read(connection);
+}
+
+bool StreamingMessage::write(yarp::os::ConnectionWriter& connection) const
+{
+    if (isBinary) {
+        return command.write(connection);
+    }
+    return message.write(connection);
+}
+
+
 StreamingMessagesParser::StreamingMessagesParser() :
+        stream_wrapper(nullptr),
         stream_IPosCtrl(nullptr),
         stream_IPosDirect(nullptr),
         stream_IVel(nullptr),
@@ -33,6 +64,7 @@ StreamingMessagesParser::StreamingMessagesParser() :
 
 void StreamingMessagesParser::init(ControlBoardWrapper *x) {
     stream_nJoints = 0;
+    stream_wrapper = x;
     stream_IPosCtrl  = dynamic_cast<yarp::dev::IPositionControl *> (x);
     stream_IPosDirect = dynamic_cast<yarp::dev::IPositionDirect *> (x);
     stream_IVel = dynamic_cast<yarp::dev::IVelocityControl *> (x);
@@ -52,6 +84,34 @@ bool StreamingMessagesParser::initialize()
 }
 
 // streaming port callback
+void StreamingMessagesParser::onRead(StreamingMessage& v)
+{
+    if (v.isBinary) {
+        onRead(v.command);
+    } else {
+        onRead(v.message);
+    }
+}
+
+void StreamingMessagesParser::onRead(const StreamingCommand& cmd)
+{
+    //Use the following only for debug, since it can heavily slow down the system
+    yCTrace(CONTROLBOARDWRAPPER, "Received binary command %s on %zu joints, timestamp %f\n", yarp::os::Vocab::decode(cmd.getCommand()).c_str(), cmd.getCount(), cmd.getTimestamp());
+
+    if ((int)cmd.getAxes() != stream_nJoints)
+    {
+        std::string str = yarp::os::Vocab::decode(cmd.getCommand());
+        yCError(CONTROLBOARDWRAPPER, "Received binary command for a different number of axes than the ones controlled by this wrapper (cmd: %s controlled jnts: %d received jnts: %zu)\n", str.c_str(), stream_nJoints, cmd.getAxes());
+        return;
+    }
+
+    if (!stream_wrapper->applyStreamingCommand(cmd))
+    {
+        std::string str = yarp::os::Vocab::decode(cmd.getCommand());
+        yCError(CONTROLBOARDWRAPPER, "Errors while trying to command a binary streaming message (%s)\n", str.c_str());
+    }
+}
+
 void StreamingMessagesParser::onRead(CommandMessage& v)
 {
     Bottle& b = v.head;
@@ -24,6 +24,7 @@
 #include <yarp/dev/PolyDriver.h>
 #include <yarp/dev/ControlBoardInterfacesImpl.h>
 #include <yarp/dev/IPreciselyTimed.h>
+#include <yarp/dev/impl/StreamingCommand.h>
 #include <yarp/sig/Vector.h>
 #include <yarp/os/Semaphore.h>
 
@@ -50,13 +51,30 @@ class ControlBoardWrapper;
 typedef yarp::os::PortablePair<yarp::os::Bottle, yarp::sig::Vector> CommandMessage;
 
 
+/* the message received on the streaming port, either a CommandMessage or a
+ * binary StreamingCommand (sent by remote_controlboard when the protocol
+ * version allows it), told apart by their first word.
+ */
+class StreamingMessage : public yarp::os::Portable
+{
+public:
+    bool isBinary{false};
+    CommandMessage message;
+    yarp::dev::impl::StreamingCommand command;
+
+    bool read(yarp::os::ConnectionReader& connection) override;
+    bool write(yarp::os::ConnectionWriter& connection) const override;
+};
+
+
 
 /**
 * Callback implementation after buffered input.
 */
-class StreamingMessagesParser : public yarp::os::TypedReaderCallback<CommandMessage>
+class StreamingMessagesParser : public yarp::os::TypedReaderCallback<StreamingMessage>
 {
 protected:
+    ControlBoardWrapper             *stream_wrapper;
     yarp::dev::IPositionControl     *stream_IPosCtrl;
     yarp::dev::IPositionDirect      *stream_IPosDirect;
     yarp::dev::IVelocityControl     *stream_IVel;
@@ -77,12 +95,23 @@ public:
     */
     void init(ControlBoardWrapper *x);
 
-    using yarp::os::TypedReaderCallback<CommandMessage>::onRead;
+    using yarp::os::TypedReaderCallback<StreamingMessage>::onRead;
     /**
     * Callback function.
-    * @param v is the Vector being received.
+    * @param v is the message being received.
+    */
+    void onRead(StreamingMessage& v) override;
+
+    /**
+    * Handle a command sent as a Bottle and a Vector.
+    */
+    void onRead(CommandMessage& v);
+
+    /**
+    * Handle a binary command, forwarded to the subdevices without any
+    * parsing.
     */
-    void onRead(CommandMessage& v) override;
+    void onRead(const yarp::dev::impl::StreamingCommand& cmd);
 
     bool initialize();
 };
@@ -22,6 +22,23 @@ using namespace yarp::sig;
 using namespace std;
 
 
+void SubDeviceState::resize(int axes)
+{
+    jointPosition.resize(axes);
+    jointTimes.resize(axes);
+    jointVelocity.resize(axes);
+    jointAcceleration.resize(axes);
+    motorPosition.resize(axes);
+    motorVelocity.resize(axes);
+    motorAcceleration.resize(axes);
+    torque.resize(axes);
+    pwmDutycycle.resize(axes);
+    current.resize(axes);
+    controlMode.resize(axes);
+    interactionMode.resize(axes);
+}
+
+
 SubDevice::SubDevice() :
     base(-1),
     top(-1),
@@ -268,6 +285,35 @@ bool SubDevice::attach(yarp::dev::PolyDriver *d, const std::string &k)
     }
 
     totalAxis = deviceJoints;
+    state.resize(totalAxis);
     attachedF=true;
     return true;
 }
+
+bool SubDevice::readState()
+{
+    if (!attachedF)
+    {
+        state.jointPosition_isValid = state.jointVelocity_isValid = state.jointAcceleration_isValid = false;
+        state.motorPosition_isValid = state.motorVelocity_isValid = state.motorAcceleration_isValid = false;
+        state.torque_isValid = state.pwmDutycycle_isValid = state.current_isValid = false;
+        state.controlMode_isValid = state.interactionMode_isValid = false;
+        return false;
+    }
+
+    state.jointPosition_isValid     = iJntEnc && iJntEnc->getEncodersTimed(state.jointPosition.data(), state.jointTimes.data());
+    state.jointVelocity_isValid     = iJntEnc && iJntEnc->getEncoderSpeeds(state.jointVelocity.data());
+    state.jointAcceleration_isValid = iJntEnc && iJntEnc->getEncoderAccelerations(state.jointAcceleration.data());
+    state.motorPosition_isValid     = iMotEnc && iMotEnc->getMotorEncoders(state.motorPosition.data());
+    state.motorVelocity_isValid     = iMotEnc && iMotEnc->getMotorEncoderSpeeds(state.motorVelocity.data());
+    state.motorAcceleration_isValid = iMotEnc && iMotEnc->getMotorEncoderAccelerations(state.motorAcceleration.data());
+    state.torque_isValid            = iTorque && iTorque->getTorques(state.torque.data());
+    state.pwmDutycycle_isValid      = iPWM && iPWM->getDutyCycles(state.pwmDutycycle.data());
+    if (iCurr)
+        state.current_isValid       = iCurr->getCurrents(state.current.data());
+    else
+        state.current_isValid       = amp && amp->getCurrents(state.current.data());
+    state.controlMode_isValid       = iMode && iMode->getControlModes(state.controlMode.data());
+    state.interactionMode_isValid   = iInteract && iInteract->getInteractionModes(state.interactionMode.data());
+    return true;
+}
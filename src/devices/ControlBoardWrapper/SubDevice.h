@@ -47,6 +47,41 @@
 
 class ControlBoardWrapper;
 
+/*
+* Snapshot of the state of all the joints of a subdevice, filled by
+* SubDevice::readState(). The vectors are allocated when the subdevice is
+* attached, and indexed as in the subdevice (i.e. from 0 to totalAxis-1).
+*/
+struct SubDeviceState
+{
+    std::vector<double> jointPosition;
+    std::vector<double> jointTimes;
+    std::vector<double> jointVelocity;
+    std::vector<double> jointAcceleration;
+    std::vector<double> motorPosition;
+    std::vector<double> motorVelocity;
+    std::vector<double> motorAcceleration;
+    std::vector<double> torque;
+    std::vector<double> pwmDutycycle;
+    std::vector<double> current;
+    std::vector<int> controlMode;
+    std::vector<yarp::dev::InteractionModeEnum> interactionMode;
+
+    bool jointPosition_isValid{false};
+    bool jointVelocity_isValid{false};
+    bool jointAcceleration_isValid{false};
+    bool motorPosition_isValid{false};
+    bool motorVelocity_isValid{false};
+    bool motorAcceleration_isValid{false};
+    bool torque_isValid{false};
+    bool pwmDutycycle_isValid{false};
+    bool current_isValid{false};
+    bool controlMode_isValid{false};
+    bool interactionMode_isValid{false};
+
+    void resize(int axes);
+};
+
 /*
 * An Helper class for the controlBoardWrapper
 * It maps only a subpart of the underlying device.
@@ -93,6 +128,8 @@ public:
     yarp::sig::Vector subDev_motor_encoders;
     yarp::sig::Vector motorEncodersTimes;
 
+    SubDeviceState state;
+
     SubDevice();
 
     bool attach(yarp::dev::PolyDriver *d, const std::string &id);
@@ -101,6 +138,13 @@ public:
 
     bool configure(int wbase, int wtop, int base, int top, int axes, const std::string &id, ControlBoardWrapper *_parent);
 
+    /*
+    * Read the state of all the joints of the subdevice in state, without
+    * allocating memory.
+    * Returns false if the subdevice is not attached.
+    */
+    bool readState();
+
     bool isAttached()
     { return attachedF; }
 
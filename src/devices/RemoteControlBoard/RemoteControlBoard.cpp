@@ -35,13 +35,14 @@
 
 using namespace yarp::os;
 using namespace yarp::dev;
+using namespace yarp::dev::impl;
 using namespace yarp::sig;
 
 namespace {
 
 constexpr int PROTOCOL_VERSION_MAJOR = 1;
 constexpr int PROTOCOL_VERSION_MINOR = 9;
-constexpr int PROTOCOL_VERSION_TWEAK = 0;
+constexpr int PROTOCOL_VERSION_TWEAK = 1;
 
 constexpr double DIAGNOSTIC_THREAD_PERIOD = 1.000;
 
@@ -341,6 +342,14 @@ bool RemoteControlBoard::open(Searchable& config)
         }
     }
 
+    // binary streaming commands are supported since protocol 1.9.1
+    binaryStreaming = (protocolVersion.major == PROTOCOL_VERSION_MAJOR &&
+                       protocolVersion.minor == PROTOCOL_VERSION_MINOR &&
+                       protocolVersion.tweak >= 1);
+    if (binaryStreaming) {
+        streaming_buffer.attach(command_p);
+    }
+
     if (config.check("diagnostic"))
     {
         diagnosticThread = new DiagnosticThread(DIAGNOSTIC_THREAD_PERIOD);
@@ -399,6 +408,35 @@ bool RemoteControlBoard::close()
 
 // BEGIN Helpers functions
 
+bool RemoteControlBoard::sendStreaming(int v, int j, double ref)
+{
+    if (j < 0 || static_cast<size_t>(j) >= nj) {
+        return false;
+    }
+    StreamingCommand& c = streaming_buffer.get();
+    c.setSingle(v, nj, j, ref, Time::now());
+    streaming_buffer.write(writeStrict_singleJoint);
+    return true;
+}
+
+bool RemoteControlBoard::sendStreaming(int v, const double* refs)
+{
+    StreamingCommand& c = streaming_buffer.get();
+    c.setAll(v, nj, refs, Time::now());
+    streaming_buffer.write(writeStrict_moreJoints);
+    return true;
+}
+
+bool RemoteControlBoard::sendStreaming(int v, const int n_joint, const int* joints, const double* refs)
+{
+    StreamingCommand& c = streaming_buffer.get();
+    if (!c.setGroup(v, nj, n_joint, joints, refs, Time::now())) {
+        return false;
+    }
+    streaming_buffer.write(writeStrict_moreJoints);
+    return true;
+}
+
 bool RemoteControlBoard::send1V(int v)
 {
     Bottle cmd, response;
@@ -1811,6 +1849,7 @@ bool RemoteControlBoard::velocityMove(int j, double v)
 {
  //   return set1V1I1D(VOCAB_VELOCITY_MOVE, j, v);
     if (!isLive()) return false;
+    if (binaryStreaming) return sendStreaming(VOCAB_VELOCITY_MOVES, j, v);
     CommandMessage& c = command_buffer.get();
     c.head.clear();
     c.head.addVocab(VOCAB_VELOCITY_MOVE);
@@ -1824,6 +1863,7 @@ bool RemoteControlBoard::velocityMove(int j, double v)
 bool RemoteControlBoard::velocityMove(const double *v)
 {
     if (!isLive()) return false;
+    if (binaryStreaming) return sendStreaming(VOCAB_VELOCITY_MOVES, v);
     CommandMessage& c = command_buffer.get();
     c.head.clear();
     c.head.addVocab(VOCAB_VELOCITY_MOVES);
@@ -2035,6 +2075,7 @@ bool RemoteControlBoard::setRefTorques(const double *t)
     //Now we use streaming instead of rpc
     //return set2V1DA(VOCAB_TORQUE, VOCAB_REFS, t);
     if (!isLive()) return false;
+    if (binaryStreaming) return sendStreaming(VOCAB_TORQUES_DIRECTS, t);
     CommandMessage& c = command_buffer.get();
     c.head.clear();
     c.head.addVocab(VOCAB_TORQUES_DIRECTS);
@@ -2052,6 +2093,7 @@ bool RemoteControlBoard::setRefTorque(int j, double v)
     //return set2V1I1D(VOCAB_TORQUE, VOCAB_REF, j, v);
     // use the streaming port!
     if (!isLive()) return false;
+    if (binaryStreaming) return sendStreaming(VOCAB_TORQUES_DIRECTS, j, v);
     CommandMessage& c = command_buffer.get();
     c.head.clear();
     // in streaming port only SET command can be sent, so it is implicit
@@ -2070,6 +2112,7 @@ bool RemoteControlBoard::setRefTorques(const int n_joint, const int *joints, con
     //return set2V1I1D(VOCAB_TORQUE, VOCAB_REF, j, v);
     // use the streaming port!
     if (!isLive()) return false;
+    if (binaryStreaming) return sendStreaming(VOCAB_TORQUES_DIRECTS, n_joint, joints, t);
     CommandMessage& c = command_buffer.get();
     c.head.clear();
     // in streaming port only SET command can be sent, so it is implicit
@@ -2349,6 +2392,7 @@ bool RemoteControlBoard::setControlModes(int *modes)
 bool RemoteControlBoard::setPosition(int j, double ref)
 {
     if (!isLive()) return false;
+    if (binaryStreaming) return sendStreaming(VOCAB_POSITION_DIRECTS, j, ref);
     CommandMessage& c = command_buffer.get();
     c.head.clear();
     c.head.addVocab(VOCAB_POSITION_DIRECT);
@@ -2362,6 +2406,7 @@ bool RemoteControlBoard::setPosition(int j, double ref)
 bool RemoteControlBoard::setPositions(const int n_joint, const int *joints, const double *refs)
 {
     if (!isLive()) return false;
+    if (binaryStreaming) return sendStreaming(VOCAB_POSITION_DIRECTS, n_joint, joints, refs);
     CommandMessage& c = command_buffer.get();
     c.head.clear();
     c.head.addVocab(VOCAB_POSITION_DIRECT_GROUP);
@@ -2378,6 +2423,7 @@ bool RemoteControlBoard::setPositions(const int n_joint, const int *joints, cons
 bool RemoteControlBoard::setPositions(const double *refs)
 {
     if (!isLive()) return false;
+    if (binaryStreaming) return sendStreaming(VOCAB_POSITION_DIRECTS, refs);
     CommandMessage& c = command_buffer.get();
     c.head.clear();
     c.head.addVocab(VOCAB_POSITION_DIRECTS);
@@ -2411,6 +2457,7 @@ bool RemoteControlBoard::velocityMove(const int n_joint, const int *joints, cons
     // streaming port
     if (!isLive())
         return false;
+    if (binaryStreaming) return sendStreaming(VOCAB_VELOCITY_MOVES, n_joint, joints, spds);
     CommandMessage& c = command_buffer.get();
     c.head.clear();
     c.head.addVocab(VOCAB_VELOCITY_MOVE_GROUP);
@@ -2636,6 +2683,7 @@ bool RemoteControlBoard::getRefCurrent(int j, double *t)
 bool RemoteControlBoard::setRefCurrents(const double *refs)
 {
     if (!isLive()) return false;
+    if (binaryStreaming) return sendStreaming(VOCAB_CURRENTCONTROL_INTERFACE, refs);
     CommandMessage& c = command_buffer.get();
     c.head.clear();
     c.head.addVocab(VOCAB_CURRENTCONTROL_INTERFACE);
@@ -2649,6 +2697,7 @@ bool RemoteControlBoard::setRefCurrents(const double *refs)
 bool RemoteControlBoard::setRefCurrent(int j, double ref)
 {
     if (!isLive()) return false;
+    if (binaryStreaming) return sendStreaming(VOCAB_CURRENTCONTROL_INTERFACE, j, ref);
     CommandMessage& c = command_buffer.get();
     c.head.clear();
     c.head.addVocab(VOCAB_CURRENTCONTROL_INTERFACE);
@@ -2663,6 +2712,7 @@ bool RemoteControlBoard::setRefCurrent(int j, double ref)
 bool RemoteControlBoard::setRefCurrents(const int n_joint, const int *joints, const double *refs)
 {
     if (!isLive()) return false;
+    if (binaryStreaming) return sendStreaming(VOCAB_CURRENTCONTROL_INTERFACE, n_joint, joints, refs);
     CommandMessage& c = command_buffer.get();
     c.head.clear();
     c.head.addVocab(VOCAB_CURRENTCONTROL_INTERFACE);
@@ -2712,6 +2762,7 @@ bool RemoteControlBoard::setRefDutyCycle(int j, double v)
 {
     // using the streaming port
     if (!isLive()) return false;
+    if (binaryStreaming) return sendStreaming(VOCAB_PWMCONTROL_INTERFACE, j, v);
     CommandMessage& c = command_buffer.get();
     c.head.clear();
     // in streaming port only SET command can be sent, so it is implicit
@@ -2730,6 +2781,7 @@ bool RemoteControlBoard::setRefDutyCycles(const double *v)
 {
     // using the streaming port
     if (!isLive()) return false;
+    if (binaryStreaming) return sendStreaming(VOCAB_PWMCONTROL_INTERFACE, v);
     CommandMessage& c = command_buffer.get();
     c.head.clear();
     c.head.addVocab(VOCAB_PWMCONTROL_INTERFACE);
@@ -34,6 +34,7 @@
 #include <yarp/dev/IPWMControl.h>
 #include <yarp/dev/ICurrentControl.h>
 #include <yarp/dev/ControlBoardHelpers.h>
+#include <yarp/dev/impl/StreamingCommand.h>
 
 #include "stateExtendedReader.h"
 
@@ -94,6 +95,8 @@ protected:
 
     yarp::os::PortReaderBuffer<yarp::sig::Vector> state_buffer;
     yarp::os::PortWriterBuffer<CommandMessage> command_buffer;
+    yarp::os::PortWriterBuffer<yarp::dev::impl::StreamingCommand> streaming_buffer;
+    bool binaryStreaming{false};  // send binary streaming commands, if supported by the wrapper
     bool writeStrict_singleJoint{true};
     bool writeStrict_moreJoints{false};
 
@@ -120,6 +123,14 @@ protected:
 
     bool checkProtocolVersion(bool ignore);
 
+    /**
+     * Send a binary streaming command for a single joint, all the joints or
+     * a group of joints.
+     */
+    bool sendStreaming(int v, int j, double ref);
+    bool sendStreaming(int v, const double* refs);
+    bool sendStreaming(int v, const int n_joint, const int* joints, const double* refs);
+
     bool send1V(int v);
     bool send2V(int v1, int v2);
     bool send2V1I(int v1, int v2, int axis);
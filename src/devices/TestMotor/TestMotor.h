@@ -274,7 +274,13 @@ public:
 
     bool velocityMove(const int n_joint, const int *joints, const double *spds) override
     {
-        return false;
+        posMode = false;
+        for (int i=0; i<n_joint; i++) {
+            if (joints[i]<njoints) {
+                vel[joints[i]] = spds[i];
+            }
+        }
+        return true;
     }
 
     bool close() override
@@ -56,6 +56,15 @@ bool Map2DClient::open(yarp::os::Searchable &config)
         return false;
     }
 
+    int tile_size = config.check("tile_size", Value(64)).asInt32();
+    if (tile_size <= 0)
+    {
+        yCError(MAP2DCLIENT, "open() error tile_size must be positive");
+        return false;
+    }
+    m_tile_size = tile_size;
+    m_compress_maps = config.check("compress_maps", Value(false)).asBool();
+
     std::string local_rpc1 = m_local_name;
     local_rpc1 += "/mapClient_rpc";
 
@@ -88,6 +97,7 @@ bool Map2DClient::store_map(const MapGrid2D& map)
     b.addVocab(VOCAB_IMAP_SET_MAP);
     yarp::os::Bottle& mapbot = b.addList();
     MapGrid2D maptemp = map;
+    maptemp.enable_map_compression_over_network(m_compress_maps);
     if (Property::copyPortable(maptemp, mapbot) == false)
     {
         yCError(MAP2DCLIENT) << "store_map() failed copyPortable()";
@@ -150,6 +160,121 @@ bool Map2DClient::get_map(std::string map_name, MapGrid2D& map)
     return true;
 }
 
+bool Map2DClient::get_map_region(std::string map_name, XYCell top_left, XYCell bottom_right, MapGrid2D& map)
+{
+    yarp::os::Bottle b;
+    yarp::os::Bottle resp;
+
+    b.addVocab(VOCAB_IMAP);
+    b.addVocab(VOCAB_IMAP_GET_MAP_REGION);
+    b.addString(map_name);
+    b.addInt32(top_left.x);
+    b.addInt32(top_left.y);
+    b.addInt32(bottom_right.x);
+    b.addInt32(bottom_right.y);
+
+    bool ret = m_rpcPort_to_Map2DServer.write(b, resp);
+    if (ret)
+    {
+        if (resp.get(0).asVocab() != VOCAB_IMAP_OK)
+        {
+            yCError(MAP2DCLIENT) << "get_map_region() received error from server";
+            return false;
+        }
+        else
+        {
+            Value& bt = resp.get(1);
+            if (Property::copyPortable(bt, map))
+            {
+                return true;
+            }
+            else
+            {
+                yCError(MAP2DCLIENT) << "get_map_region() failed copyPortable()";
+                return false;
+            }
+        }
+    }
+    else
+    {
+        yCError(MAP2DCLIENT) << "get_map_region() error on writing on rpc port";
+        return false;
+    }
+    return true;
+}
+
+bool Map2DClient::update_map(std::string map_name, MapGrid2D& map)
+{
+    yarp::os::Bottle b;
+    yarp::os::Bottle resp;
+
+    std::vector<std::uint64_t> hashes;
+    map.getTileHashes(m_tile_size, hashes);
+    size_t width;
+    size_t height;
+    double resolution;
+    double x;
+    double y;
+    double theta;
+    map.getSize_in_cells(width, height);
+    map.getResolution(resolution);
+    map.getOrigin(x, y, theta);
+
+    b.addVocab(VOCAB_IMAP);
+    b.addVocab(VOCAB_IMAP_UPDATE_MAP);
+    b.addString(map_name);
+    b.addInt32(m_tile_size);
+    yarp::os::Bottle& geometry = b.addList();
+    geometry.addInt32(width);
+    geometry.addInt32(height);
+    geometry.addFloat64(resolution);
+    geometry.addFloat64(x);
+    geometry.addFloat64(y);
+    geometry.addFloat64(theta);
+    yarp::os::Bottle& hashbot = b.addList();
+    for (auto hash : hashes)
+    {
+        hashbot.addInt64(static_cast<std::int64_t>(hash));
+    }
+
+    bool ret = m_rpcPort_to_Map2DServer.write(b, resp);
+    if (!ret)
+    {
+        yCError(MAP2DCLIENT) << "update_map() error on writing on rpc port";
+        return false;
+    }
+    if (resp.get(0).asVocab() != VOCAB_IMAP_OK)
+    {
+        yCError(MAP2DCLIENT) << "update_map() received error from server";
+        return false;
+    }
+
+    if (resp.get(1).asVocab() == VOCAB_IMAP_GET_MAP)
+    {
+        //the geometry of the map changed, the whole map was sent
+        if (!Property::copyPortable(resp.get(2), map))
+        {
+            yCError(MAP2DCLIENT) << "update_map() failed copyPortable()";
+            return false;
+        }
+        return true;
+    }
+
+    for (size_t i = 2; i < resp.size(); i++)
+    {
+        Bottle* tilebot = resp.get(i).asList();
+        MapGrid2D tile;
+        if (tilebot == nullptr ||
+            !Property::copyPortable(tilebot->get(2), tile) ||
+            !map.setMapRegion(XYCell(tilebot->get(0).asInt32(), tilebot->get(1).asInt32()), tile))
+        {
+            yCError(MAP2DCLIENT) << "update_map() received an invalid tile";
+            return false;
+        }
+    }
+    return true;
+}
+
 bool Map2DClient::clearAllMaps()
 {
     yarp::os::Bottle b;
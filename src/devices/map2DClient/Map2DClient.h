@@ -44,6 +44,8 @@
  * |:--------------:|:--------------:|:-------:|:--------------:|:-------------:|:-----------: |:-----------------------------------------------------------------:|:-----:|
  * | local          |      -         | string  | -   |   -           | Yes          | Full port name opened by the Map2DClient device.                             |       |
  * | remote         |     -          | string  | -   |   -           | Yes          | Full port name of the port remotely opened by the Map2DServer, to which the Map2DClient connects to.           |  |
+ * | tile_size      |     -          | int     | cells |   64          | No           | Side of the tiles compared by update_map(), only the tiles which differ are transferred.           |  |
+ * | compress_maps  |     -          | bool    | -     |   false       | No           | Send the maps stored with store_map() run-length encoded. Older servers cannot read them.           |  |
  */
 
 class Map2DClient :
@@ -54,6 +56,8 @@ protected:
     yarp::os::Port      m_rpcPort_to_Map2DServer;
     std::string         m_local_name;
     std::string         m_map_server;
+    size_t              m_tile_size;
+    bool                m_compress_maps;
 
 public:
 
@@ -66,6 +70,8 @@ public:
     bool     remove_map (std::string map_name) override;
     bool     store_map  (const yarp::dev::Nav2D::MapGrid2D& map) override;
     bool     get_map    (std::string map_name, yarp::dev::Nav2D::MapGrid2D& map) override;
+    bool     get_map_region(std::string map_name, yarp::dev::Nav2D::XYCell top_left, yarp::dev::Nav2D::XYCell bottom_right, yarp::dev::Nav2D::MapGrid2D& map) override;
+    bool     update_map (std::string map_name, yarp::dev::Nav2D::MapGrid2D& map) override;
     bool     get_map_names(std::vector<std::string>& map_names) override;
 
     bool     storeLocation(std::string location_name, yarp::dev::Nav2D::Map2DLocation loc) override;
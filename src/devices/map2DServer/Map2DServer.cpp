@@ -18,6 +18,7 @@
 
 #include <sstream>
 #include <limits>
+#include <algorithm>
 #include "Map2DServer.h"
 #include <yarp/dev/IMap2D.h>
 #include <yarp/dev/INavigation2D.h>
@@ -53,11 +54,73 @@ Map2DServer::Map2DServer()
 {
     m_enable_publish_ros_map = false;
     m_enable_subscribe_ros_map = false;
+    m_compress_maps = false;
     m_rosNode = nullptr;
 }
 
 Map2DServer::~Map2DServer() = default;
 
+void Map2DServer::update_map_response(MapGrid2D& map, yarp::os::Bottle& in, yarp::os::Bottle& out)
+{
+    // The request is: imap updt <name> <tile_size> (<width> <height> <resolution> <x> <y> <theta>) (<tile hashes>)
+    // The response is the whole map if its geometry changed, or the tiles which differ
+    std::int32_t requested_tile_size = in.get(3).asInt32();
+    Bottle* geometry = in.get(4).asList();
+    Bottle* client_hashes = in.get(5).asList();
+
+    size_t width;
+    size_t height;
+    double resolution;
+    double x;
+    double y;
+    double theta;
+    map.getSize_in_cells(width, height);
+    map.getResolution(resolution);
+    map.getOrigin(x, y, theta);
+    std::vector<std::uint64_t> hashes;
+    map.enable_map_compression_over_network(true);
+    // The tile size comes from the client, it is checked before it is used as an unsigned value
+    size_t tile_size = 0;
+    if (requested_tile_size > 0 && static_cast<size_t>(requested_tile_size) <= std::max(width, height))
+    {
+        tile_size = static_cast<size_t>(requested_tile_size);
+    }
+    if (tile_size == 0 || geometry == nullptr || client_hashes == nullptr ||
+        geometry->size() != 6 ||
+        static_cast<size_t>(geometry->get(0).asInt32()) != width ||
+        static_cast<size_t>(geometry->get(1).asInt32()) != height ||
+        geometry->get(2).asFloat64() != resolution ||
+        geometry->get(3).asFloat64() != x ||
+        geometry->get(4).asFloat64() != y ||
+        geometry->get(5).asFloat64() != theta ||
+        !map.getTileHashes(tile_size, hashes) ||
+        hashes.size() != client_hashes->size())
+    {
+        out.addVocab(VOCAB_IMAP_GET_MAP);
+        yarp::os::Bottle& mapbot = out.addList();
+        Property::copyPortable(map, mapbot);
+        return;
+    }
+
+    out.addVocab(VOCAB_IMAP_GET_MAP_REGION);
+    size_t tiles_x = width / tile_size + (width % tile_size != 0 ? 1 : 0);
+    for (size_t i = 0; i < hashes.size(); i++)
+    {
+        if (static_cast<std::uint64_t>(client_hashes->get(i).asInt64()) == hashes[i])
+        {
+            continue;
+        }
+        XYCell top_left((i % tiles_x) * tile_size, (i / tiles_x) * tile_size);
+        XYCell bottom_right(std::min(top_left.x + tile_size, width) - 1, std::min(top_left.y + tile_size, height) - 1);
+        MapGrid2D tile;
+        map.getMapRegion(top_left, bottom_right, tile);
+        yarp::os::Bottle& tilebot = out.addList();
+        tilebot.addInt32(top_left.x);
+        tilebot.addInt32(top_left.y);
+        Property::copyPortable(tile, tilebot.addList());
+    }
+}
+
 void Map2DServer::parse_vocab_command(yarp::os::Bottle& in, yarp::os::Bottle& out)
 {
     int code = in.get(0).asVocab();
@@ -104,6 +167,7 @@ void Map2DServer::parse_vocab_command(yarp::os::Bottle& in, yarp::os::Bottle& ou
                 out.clear();
                 out.addVocab(VOCAB_IMAP_OK);
                 yarp::os::Bottle& mapbot = out.addList();
+                it->second.enable_map_compression_over_network(m_compress_maps);
                 Property::copyPortable(it->second, mapbot);
             }
             else
@@ -113,6 +177,51 @@ void Map2DServer::parse_vocab_command(yarp::os::Bottle& in, yarp::os::Bottle& ou
                 yCError(MAP2DSERVER) << "Map" << name << "not found";
             }
         }
+        else if (cmd == VOCAB_IMAP_GET_MAP_REGION)
+        {
+            string name = in.get(2).asString();
+            XYCell top_left(in.get(3).asInt32(), in.get(4).asInt32());
+            XYCell bottom_right(in.get(5).asInt32(), in.get(6).asInt32());
+            auto it = m_maps_storage.find(name);
+            MapGrid2D region;
+            if (it == m_maps_storage.end())
+            {
+                out.clear();
+                out.addVocab(VOCAB_IMAP_ERROR);
+                yCError(MAP2DSERVER) << "Map" << name << "not found";
+            }
+            else if (!it->second.getMapRegion(top_left, bottom_right, region))
+            {
+                out.clear();
+                out.addVocab(VOCAB_IMAP_ERROR);
+                yCError(MAP2DSERVER) << "Invalid region of map" << name;
+            }
+            else
+            {
+                out.clear();
+                out.addVocab(VOCAB_IMAP_OK);
+                yarp::os::Bottle& mapbot = out.addList();
+                region.enable_map_compression_over_network(true);
+                Property::copyPortable(region, mapbot);
+            }
+        }
+        else if (cmd == VOCAB_IMAP_UPDATE_MAP)
+        {
+            string name = in.get(2).asString();
+            auto it = m_maps_storage.find(name);
+            if (it != m_maps_storage.end())
+            {
+                out.clear();
+                out.addVocab(VOCAB_IMAP_OK);
+                update_map_response(it->second, in, out);
+            }
+            else
+            {
+                out.clear();
+                out.addVocab(VOCAB_IMAP_ERROR);
+                yCError(MAP2DSERVER) << "Map" << name << "not found";
+            }
+        }
         else if (cmd == VOCAB_IMAP_GET_NAMES)
         {
             out.clear();
@@ -922,6 +1031,9 @@ bool Map2DServer::open(yarp::os::Searchable &config)
         m_rpcPortName = config.find("name").asString();
     }
 
+    // The compressed maps are not understood by the clients of the older versions
+    m_compress_maps = config.check("compress_maps", Value(false)).asBool();
+
     //open rpc port
     if (!m_rpcPort.open(m_rpcPortName))
     {
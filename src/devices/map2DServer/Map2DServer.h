@@ -65,6 +65,7 @@
  * |:--------------:|:--------------:|:-------:|:--------------:|:----------------:|:-----------: |:-----------------------------------------------------------------:|:-----:|
  * | name           |      -         | string  | -              | /mapServer/rpc   | No           | Full name of the rpc port opened by the Map2DServer device.       |       |
  * | mapCollection  |      -         | string  | -              |   -              | No           | The name of .ini file containing a map collection.                |       |
+ * | compress_maps  |      -         | bool    | -              | false            | No           | Send the maps run-length encoded. Older clients cannot read them.  | Regions and map updates are always compressed |
 
  * \section Notes:
  * Integration with ROS map server is currently under development.
@@ -103,6 +104,7 @@ private:
     yarp::os::Node*              m_rosNode;
     bool                         m_enable_publish_ros_map;
     bool                         m_enable_subscribe_ros_map;
+    bool                         m_compress_maps;
 
     #define ROSNODENAME "/map2DServerNode"
     #define ROSTOPICNAME_MAP "/map"
@@ -120,6 +122,7 @@ private:
 
     void parse_string_command(yarp::os::Bottle& in, yarp::os::Bottle& out);
     void parse_vocab_command(yarp::os::Bottle& in, yarp::os::Bottle& out);
+    void update_map_response(yarp::dev::Nav2D::MapGrid2D& map, yarp::os::Bottle& in, yarp::os::Bottle& out);
     bool updateVizMarkers();
 };
 
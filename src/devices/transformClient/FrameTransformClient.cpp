@@ -21,6 +21,7 @@
 #include <yarp/os/LogComponent.h>
 #include <yarp/os/LogStream.h>
 #include <yarp/math/Math.h>
+#include <cmath>
 #include <mutex>
 
 /*! \file FrameTransformClient.cpp */
@@ -35,6 +36,221 @@ using namespace yarp::math;
 
 namespace {
 YARP_LOG_COMPONENT(FRAMETRANSFORMCLIENT, "yarp.device.transformClient")
+
+typedef Transforms_client_storage::transform_t transform_t;
+typedef Transforms_client_storage::frame_handle frame_handle;
+constexpr frame_handle invalid_frame_handle = IFrameTransform::invalid_frame_handle;
+
+// The composed transforms are dropped when there are too many of them
+constexpr size_t max_cached_transforms = 16384;
+
+void setIdentity(transform_t& t)
+{
+    t.fill(0.0);
+    t[0] = t[5] = t[10] = t[15] = 1.0;
+}
+
+// Same as FrameTransform::toMatrix(), without allocating a Matrix
+void toTransform(const FrameTransform& ft, transform_t& t)
+{
+    double w = ft.rotation.w();
+    double x = ft.rotation.x();
+    double y = ft.rotation.y();
+    double z = ft.rotation.z();
+    double norm = std::sqrt(w * w + x * x + y * y + z * z);
+    w /= norm; x /= norm; y /= norm; z /= norm;
+
+    t[0] = w * w + x * x - y * y - z * z;
+    t[1] = 2.0 * (x * y - w * z);
+    t[2] = 2.0 * (x * z + w * y);
+    t[3] = ft.translation.tX;
+    t[4] = 2.0 * (x * y + w * z);
+    t[5] = w * w - x * x + y * y - z * z;
+    t[6] = 2.0 * (y * z - w * x);
+    t[7] = ft.translation.tY;
+    t[8] = 2.0 * (x * z - w * y);
+    t[9] = 2.0 * (y * z + w * x);
+    t[10] = w * w - x * x - y * y + z * z;
+    t[11] = ft.translation.tZ;
+    t[12] = 0.0; t[13] = 0.0; t[14] = 0.0; t[15] = 1.0;
+}
+
+// result = a * b
+void multiply(const transform_t& a, const transform_t& b, transform_t& result)
+{
+    transform_t tmp;
+    for (size_t r = 0; r < 4; r++)
+    {
+        for (size_t c = 0; c < 4; c++)
+        {
+            tmp[r * 4 + c] = a[r * 4] * b[c] + a[r * 4 + 1] * b[4 + c] + a[r * 4 + 2] * b[8 + c] + a[r * 4 + 3] * b[12 + c];
+        }
+    }
+    result = tmp;
+}
+
+// Inverse of a rigid transformation (transposed rotation)
+void invert(const transform_t& t, transform_t& result)
+{
+    transform_t tmp;
+    for (size_t r = 0; r < 3; r++)
+    {
+        for (size_t c = 0; c < 3; c++)
+        {
+            tmp[r * 4 + c] = t[c * 4 + r];
+        }
+        tmp[r * 4 + 3] = -(t[r] * t[3] + t[4 + r] * t[7] + t[8 + r] * t[11]);
+    }
+    tmp[12] = 0.0; tmp[13] = 0.0; tmp[14] = 0.0; tmp[15] = 1.0;
+    result = tmp;
+}
+
+void toMatrix(const transform_t& t, yarp::sig::Matrix& m)
+{
+    m.resize(4, 4);
+    for (size_t r = 0; r < 4; r++)
+    {
+        for (size_t c = 0; c < 4; c++)
+        {
+            m[r][c] = t[r * 4 + c];
+        }
+    }
+}
+
+bool transformPoint(const transform_t& t, const yarp::sig::Vector& in, yarp::sig::Vector& out)
+{
+    double x = in[0];
+    double y = in[1];
+    double z = in[2];
+    out.resize(3);
+    out[0] = t[0] * x + t[1] * y + t[2] * z + t[3];
+    out[1] = t[4] * x + t[5] * y + t[6] * z + t[7];
+    out[2] = t[8] * x + t[9] * y + t[10] * z + t[11];
+    return true;
+}
+
+} // namespace
+
+void Transform_history::setCapacity(size_t capacity)
+{
+    m_samples.clear();
+    m_samples.resize(capacity);
+    m_first = 0;
+    m_count = 0;
+}
+
+void Transform_history::clear()
+{
+    m_first = 0;
+    m_count = 0;
+}
+
+void Transform_history::add(const FrameTransform& t, double window)
+{
+    if (m_samples.empty())
+    {
+        return;
+    }
+
+    if (m_count > 0 && t.timestamp < at(m_count - 1).timestamp)
+    {
+        return;
+    }
+    if (m_count == 0 || t.timestamp > at(m_count - 1).timestamp)
+    {
+        if (m_count == m_samples.size())
+        {
+            m_first = (m_first + 1) % m_samples.size();
+            m_count--;
+        }
+        m_count++;
+    }
+
+    // The last value is replaced, if it has the same timestamp
+    sample_t& s = m_samples[(m_first + m_count - 1) % m_samples.size()];
+    s.timestamp = t.timestamp;
+    s.tX = t.translation.tX;
+    s.tY = t.translation.tY;
+    s.tZ = t.translation.tZ;
+    s.w = t.rotation.w();
+    s.x = t.rotation.x();
+    s.y = t.rotation.y();
+    s.z = t.rotation.z();
+
+    // Keep the last value older than the window, to interpolate up to its
+    // beginning
+    while (m_count > 1 && at(1).timestamp <= t.timestamp - window)
+    {
+        m_first = (m_first + 1) % m_samples.size();
+        m_count--;
+    }
+}
+
+bool Transform_history::interpolate(double time, std::array<double, 16>& transform) const
+{
+    if (m_count == 0 || time < at(0).timestamp)
+    {
+        return false;
+    }
+
+    FrameTransform ft;
+    const sample_t& last = at(m_count - 1);
+    if (time >= last.timestamp)
+    {
+        ft.translation.set(last.tX, last.tY, last.tZ);
+        ft.rotation = yarp::math::Quaternion(last.x, last.y, last.z, last.w);
+        toTransform(ft, transform);
+        return true;
+    }
+
+    // Find the values before and after time
+    size_t lo = 0;
+    size_t hi = m_count - 1;
+    while (hi - lo > 1)
+    {
+        size_t mid = lo + (hi - lo) / 2;
+        if (at(mid).timestamp <= time)
+        {
+            lo = mid;
+        }
+        else
+        {
+            hi = mid;
+        }
+    }
+    const sample_t& a = at(lo);
+    const sample_t& b = at(hi);
+    double alpha = (time - a.timestamp) / (b.timestamp - a.timestamp);
+
+    ft.translation.set(a.tX + alpha * (b.tX - a.tX),
+                       a.tY + alpha * (b.tY - a.tY),
+                       a.tZ + alpha * (b.tZ - a.tZ));
+
+    // Slerp, along the shortest path
+    double bw = b.w, bx = b.x, by = b.y, bz = b.z;
+    double cos_theta = a.w * bw + a.x * bx + a.y * by + a.z * bz;
+    if (cos_theta < 0.0)
+    {
+        bw = -bw; bx = -bx; by = -by; bz = -bz;
+        cos_theta = -cos_theta;
+    }
+    double ka = 1.0 - alpha;
+    double kb = alpha;
+    if (cos_theta < 0.9995)
+    {
+        double theta = std::acos(cos_theta);
+        double sin_theta = std::sin(theta);
+        ka = std::sin((1.0 - alpha) * theta) / sin_theta;
+        kb = std::sin(alpha * theta) / sin_theta;
+    }
+    // Otherwise the quaternions are too close for a slerp, and a linear
+    // interpolation is used (normalized by toTransform)
+    ft.rotation = yarp::math::Quaternion(ka * a.x + kb * bx,
+                                         ka * a.y + kb * by,
+                                         ka * a.z + kb * bz,
+                                         ka * a.w + kb * bw);
+    toTransform(ft, transform);
+    return true;
 }
 
 inline void Transforms_client_storage::resetStat()
@@ -86,27 +302,14 @@ void Transforms_client_storage::onRead(yarp::os::Bottle &b)
     {
         m_state = IFrameTransform::TRANSFORM_OK;
 
-        m_transforms.clear();
-        int bsize= b.size();
-        for (int i = 0; i < bsize; i++)
+        if (b.size() == 3 && b.get(0).isVocab() &&
+            (b.get(0).asVocab() == yarp::dev::impl::FrameTransformDelta::keyframe_tag || b.get(0).asVocab() == yarp::dev::impl::FrameTransformDelta::delta_tag))
         {
-            //this includes: timed yarp transforms, static yarp transforms, ros transforms
-            Bottle* bt = b.get(i).asList();
-            if (bt != nullptr)
-            {
-                FrameTransform t;
-                t.src_frame_id = bt->get(0).asString();
-                t.dst_frame_id = bt->get(1).asString();
-                t.timestamp = bt->get(2).asFloat64();
-                t.translation.tX = bt->get(3).asFloat64();
-                t.translation.tY = bt->get(4).asFloat64();
-                t.translation.tZ = bt->get(5).asFloat64();
-                t.rotation.w() = bt->get(6).asFloat64();
-                t.rotation.x() = bt->get(7).asFloat64();
-                t.rotation.y() = bt->get(8).asFloat64();
-                t.rotation.z() = bt->get(9).asFloat64();
-                m_transforms.push_back(t);
-            }
+            readDelta(b);
+        }
+        else
+        {
+            readTransforms(b);
         }
     }
     else
@@ -155,14 +358,457 @@ void Transforms_client_storage::getEstFrequency(int &ite, double &av, double &mi
     av=av*1000;
 }
 
+void Transforms_client_storage::readTransforms(const yarp::os::Bottle& b)
+{
+    m_transforms.clear();
+    m_transform_ids.clear();
+    m_transform_index.clear();
+    m_has_keyframe = false;
+    int bsize= b.size();
+    for (int i = 0; i < bsize; i++)
+    {
+        //this includes: timed yarp transforms, static yarp transforms, ros transforms
+        Bottle* bt = b.get(i).asList();
+        if (bt != nullptr)
+        {
+            FrameTransform t;
+            t.src_frame_id = bt->get(0).asString();
+            t.dst_frame_id = bt->get(1).asString();
+            t.timestamp = bt->get(2).asFloat64();
+            t.translation.tX = bt->get(3).asFloat64();
+            t.translation.tY = bt->get(4).asFloat64();
+            t.translation.tZ = bt->get(5).asFloat64();
+            t.rotation.w() = bt->get(6).asFloat64();
+            t.rotation.x() = bt->get(7).asFloat64();
+            t.rotation.y() = bt->get(8).asFloat64();
+            t.rotation.z() = bt->get(9).asFloat64();
+            m_transforms.push_back(t);
+        }
+    }
+    updateFrames();
+}
+
+void Transforms_client_storage::readDelta(const yarp::os::Bottle& b)
+{
+    bool keyframe = (b.get(0).asVocab() == yarp::dev::impl::FrameTransformDelta::keyframe_tag);
+    std::int32_t seq = b.get(1).asInt32();
+    const Value& blob = b.get(2);
+    if (!blob.isBlob())
+    {
+        yCWarning(FRAMETRANSFORMCLIENT) << "Invalid delta encoded message received";
+        return;
+    }
+
+    if (keyframe)
+    {
+        m_transforms.clear();
+        m_transform_ids.clear();
+        m_transform_index.clear();
+        m_has_keyframe = true;
+    }
+    else if (!m_has_keyframe)
+    {
+        // The deltas are useless until the first keyframe is received
+        return;
+    }
+    else if (seq != m_last_seq + 1)
+    {
+        // The transforms may be out of date until the next keyframe
+        yCDebug(FRAMETRANSFORMCLIENT) << "Lost" << seq - m_last_seq - 1 << "delta encoded messages";
+    }
+    m_last_seq = seq;
+
+    // The frame tree is rebuilt only if its structure changes, otherwise the
+    // updated transforms are applied in place
+    bool changed = keyframe;
+    yarp::dev::impl::FrameTransformDelta::Reader reader(blob.asBlob(), blob.asBlobLength());
+    yarp::dev::impl::FrameTransformDelta::Record type;
+    std::uint32_t id;
+    FrameTransform t;
+    while (reader.next(type, id, t))
+    {
+        auto it = m_transform_index.find(id);
+        switch (type)
+        {
+        case yarp::dev::impl::FrameTransformDelta::Record::Define:
+            if (it != m_transform_index.end())
+            {
+                m_transforms[it->second] = t;
+            }
+            else
+            {
+                m_transform_index.emplace(id, m_transforms.size());
+                m_transform_ids.push_back(id);
+                m_transforms.push_back(t);
+            }
+            changed = true;
+            break;
+        case yarp::dev::impl::FrameTransformDelta::Record::Update:
+            if (it != m_transform_index.end())
+            {
+                FrameTransform& current = m_transforms[it->second];
+                current.timestamp = t.timestamp;
+                current.translation = t.translation;
+                current.rotation = t.rotation;
+                if (!changed)
+                {
+                    frame_handle src = getFrameHandle(current.src_frame_id, false);
+                    frame_handle dst = getFrameHandle(current.dst_frame_id, false);
+                    if (dst != invalid_frame_handle && m_frames[dst].parent == src)
+                    {
+                        updateFrame(dst, src, current);
+                    }
+                }
+            }
+            // Otherwise the define record was lost, and the transform will
+            // be received with the next keyframe
+            break;
+        case yarp::dev::impl::FrameTransformDelta::Record::Remove:
+            if (it != m_transform_index.end())
+            {
+                // The order is preserved, since only the first transform to
+                // a frame is used
+                size_t index = it->second;
+                m_transforms.erase(m_transforms.begin() + index);
+                m_transform_ids.erase(m_transform_ids.begin() + index);
+                m_transform_index.erase(it);
+                for (size_t i = index; i < m_transform_ids.size(); i++)
+                {
+                    m_transform_index[m_transform_ids[i]] = i;
+                }
+                changed = true;
+            }
+            break;
+        }
+    }
+    if (reader.isError())
+    {
+        yCWarning(FRAMETRANSFORMCLIENT) << "Invalid delta encoded message received";
+    }
+
+    if (changed)
+    {
+        updateFrames();
+    }
+}
+
 void Transforms_client_storage::clear()
 {
     std::lock_guard<std::recursive_mutex> l(m_mutex);
     m_transforms.clear();
+    m_transform_ids.clear();
+    m_transform_index.clear();
+    m_has_keyframe = false;
+    updateFrames();
+}
+
+void Transforms_client_storage::updateFrames()
+{
+    std::lock_guard<std::recursive_mutex> l(m_mutex);
+
+    for (auto& frame : m_frames)
+    {
+        frame.exists = false;
+    }
+
+    std::vector<std::pair<frame_handle, frame_handle>> edges;
+    edges.reserve(m_transforms.size());
+    for (const auto& t : m_transforms)
+    {
+        frame_handle src = getFrameHandle(t.src_frame_id, true);
+        frame_handle dst = getFrameHandle(t.dst_frame_id, true);
+        if (src == invalid_frame_handle || dst == invalid_frame_handle)
+        {
+            edges.emplace_back(invalid_frame_handle, invalid_frame_handle);
+            continue;
+        }
+        m_frames[src].exists = true;
+        m_frames[dst].exists = true;
+        edges.emplace_back(src, dst);
+    }
+
+    // As getParent(), only the first transform to a frame is used
+    std::vector<bool> has_parent(m_frames.size(), false);
+    for (size_t i = 0; i < m_transforms.size(); i++)
+    {
+        frame_handle src = edges[i].first;
+        frame_handle dst = edges[i].second;
+        if (dst == invalid_frame_handle || has_parent[dst])
+        {
+            continue;
+        }
+        has_parent[dst] = true;
+        updateFrame(dst, src, m_transforms[i]);
+    }
+
+    for (size_t i = 0; i < m_frames.size(); i++)
+    {
+        if (!has_parent[i] && m_frames[i].parent != invalid_frame_handle)
+        {
+            m_frames[i].parent = invalid_frame_handle;
+            m_frames[i].version = ++m_version;
+            m_frames[i].history.clear();
+        }
+    }
+}
+
+void Transforms_client_storage::updateFrame(frame_handle frame, frame_handle parent, const FrameTransform& t)
+{
+    frame_t& f = m_frames[frame];
+    transform_t transform;
+    toTransform(t, transform);
+    if (f.parent != parent)
+    {
+        // The history belongs to the transform from the previous parent
+        f.history.clear();
+    }
+    if (f.parent != parent || f.transform != transform)
+    {
+        f.parent = parent;
+        f.transform = transform;
+        f.version = ++m_version;
+    }
+    f.history.add(t, m_history_window);
+}
+
+frame_handle Transforms_client_storage::getFrameHandle(const std::string& frame_id, bool create)
+{
+    std::lock_guard<std::recursive_mutex> l(m_mutex);
+    auto it = m_frame_ids.find(frame_id);
+    if (it != m_frame_ids.end())
+    {
+        return it->second;
+    }
+    if (!create || frame_id.empty())
+    {
+        return invalid_frame_handle;
+    }
+    auto handle = static_cast<frame_handle>(m_frames.size());
+    m_frames.emplace_back();
+    m_frames.back().name = frame_id;
+    setIdentity(m_frames.back().transform);
+    m_frames.back().history.setCapacity(m_history_samples);
+    m_frame_ids.emplace(frame_id, handle);
+    return handle;
+}
+
+bool Transforms_client_storage::frameExists(frame_handle frame)
+{
+    std::lock_guard<std::recursive_mutex> l(m_mutex);
+    if (frame < 0 || static_cast<size_t>(frame) >= m_frames.size())
+    {
+        return false;
+    }
+    return m_frames[frame].exists;
+}
+
+frame_handle Transforms_client_storage::getParent(frame_handle frame)
+{
+    std::lock_guard<std::recursive_mutex> l(m_mutex);
+    if (frame < 0 || static_cast<size_t>(frame) >= m_frames.size())
+    {
+        return invalid_frame_handle;
+    }
+    return m_frames[frame].parent;
+}
+
+std::string Transforms_client_storage::getFrameName(frame_handle frame)
+{
+    std::lock_guard<std::recursive_mutex> l(m_mutex);
+    if (frame < 0 || static_cast<size_t>(frame) >= m_frames.size())
+    {
+        return {};
+    }
+    return m_frames[frame].name;
+}
+
+void Transforms_client_storage::chainToAncestor(frame_handle frame, frame_handle ancestor, transform_t& transform, std::vector<std::pair<frame_handle, unsigned long>>& chain) const
+{
+    setIdentity(transform);
+    while (frame != ancestor)
+    {
+        const frame_t& f = m_frames[frame];
+        multiply(f.transform, transform, transform);
+        chain.emplace_back(frame, f.version);
+        frame = f.parent;
+    }
+}
+
+frame_handle Transforms_client_storage::commonAncestor(frame_handle target, frame_handle source) const
+{
+    // Walk up from the deepest frame. The depth is bounded, in case the
+    // transforms contain a loop.
+    const auto frames_count = static_cast<frame_handle>(m_frames.size());
+    auto depth = [&](frame_handle frame) {
+        frame_handle d = 0;
+        while (m_frames[frame].parent != invalid_frame_handle && d <= frames_count)
+        {
+            frame = m_frames[frame].parent;
+            d++;
+        }
+        return d;
+    };
+    frame_handle target_depth = depth(target);
+    frame_handle source_depth = depth(source);
+    if (target_depth > frames_count || source_depth > frames_count)
+    {
+        yCError(FRAMETRANSFORMCLIENT) << "Loop detected in the frames tree";
+        return invalid_frame_handle;
+    }
+    frame_handle a = target;
+    frame_handle b = source;
+    for (; target_depth > source_depth; target_depth--)
+    {
+        a = m_frames[a].parent;
+    }
+    for (; source_depth > target_depth; source_depth--)
+    {
+        b = m_frames[b].parent;
+    }
+    while (a != b)
+    {
+        a = m_frames[a].parent;
+        b = m_frames[b].parent;
+    }
+    return a;
+}
+
+bool Transforms_client_storage::getTransform(frame_handle target, frame_handle source, transform_t& transform)
+{
+    std::lock_guard<std::recursive_mutex> l(m_mutex);
+    const auto frames_count = static_cast<frame_handle>(m_frames.size());
+    if (target < 0 || target >= frames_count || source < 0 || source >= frames_count)
+    {
+        return false;
+    }
+
+    if (target == source)
+    {
+        setIdentity(transform);
+        return true;
+    }
+
+    std::uint64_t key = (static_cast<std::uint64_t>(target) << 32) | static_cast<std::uint32_t>(source);
+    auto it = m_cache.find(key);
+    if (it != m_cache.end())
+    {
+        bool valid = true;
+        for (const auto& link : it->second.chain)
+        {
+            if (m_frames[link.first].version != link.second)
+            {
+                valid = false;
+                break;
+            }
+        }
+        if (valid)
+        {
+            transform = it->second.transform;
+            return true;
+        }
+    }
+
+    frame_handle a = commonAncestor(target, source);
+    if (a == invalid_frame_handle)
+    {
+        if (it != m_cache.end())
+        {
+            m_cache.erase(it);
+        }
+        return false;
+    }
+
+    if (it == m_cache.end())
+    {
+        if (m_cache.size() >= max_cached_transforms)
+        {
+            m_cache.clear();
+        }
+        it = m_cache.emplace(key, cached_transform_t()).first;
+    }
+    cached_transform_t& cached = it->second;
+    cached.chain.clear();
+
+    // transform = (ancestor -> source)^-1 * (ancestor -> target)
+    transform_t ancestor2target;
+    transform_t ancestor2source;
+    chainToAncestor(target, a, ancestor2target, cached.chain);
+    chainToAncestor(source, a, ancestor2source, cached.chain);
+    invert(ancestor2source, ancestor2source);
+    multiply(ancestor2source, ancestor2target, cached.transform);
+
+    transform = cached.transform;
+    return true;
+}
+
+bool Transforms_client_storage::chainToAncestorAtTime(frame_handle frame, frame_handle ancestor, double time, transform_t& transform) const
+{
+    setIdentity(transform);
+    transform_t edge;
+    while (frame != ancestor)
+    {
+        const frame_t& f = m_frames[frame];
+        if (!f.history.interpolate(time, edge))
+        {
+            return false;
+        }
+        multiply(edge, transform, transform);
+        frame = f.parent;
+    }
+    return true;
+}
+
+bool Transforms_client_storage::getTransformAtTime(frame_handle target, frame_handle source, double time, transform_t& transform)
+{
+    std::lock_guard<std::recursive_mutex> l(m_mutex);
+    const auto frames_count = static_cast<frame_handle>(m_frames.size());
+    if (target < 0 || target >= frames_count || source < 0 || source >= frames_count)
+    {
+        return false;
+    }
+
+    if (target == source)
+    {
+        setIdentity(transform);
+        return true;
+    }
+
+    frame_handle ancestor = commonAncestor(target, source);
+    if (ancestor == invalid_frame_handle)
+    {
+        return false;
+    }
+
+    transform_t ancestor2target;
+    transform_t ancestor2source;
+    if (!chainToAncestorAtTime(target, ancestor, time, ancestor2target) ||
+        !chainToAncestorAtTime(source, ancestor, time, ancestor2source))
+    {
+        return false;
+    }
+    invert(ancestor2source, ancestor2source);
+    multiply(ancestor2source, ancestor2target, transform);
+    return true;
+}
+
+void Transforms_client_storage::setHistory(double window, size_t max_samples)
+{
+    std::lock_guard<std::recursive_mutex> l(m_mutex);
+    m_history_window = window;
+    m_history_samples = max_samples;
+    for (auto& frame : m_frames)
+    {
+        frame.history.setCapacity(m_history_samples);
+    }
 }
 
 Transforms_client_storage::Transforms_client_storage(std::string local_streaming_name)
 {
+    m_history_window = 1.0;
+    m_history_samples = 100;
+    m_version = 0;
+    m_has_keyframe = false;
+    m_last_seq = 0;
     m_count = 0;
     m_deltaT = 0;
     m_deltaTMax = 0;
@@ -441,7 +1087,16 @@ bool FrameTransformClient::open(yarp::os::Searchable &config)
         return false;
     }
 
+    double history_window = config.check("history_window", Value(1.0), "how long the transforms are kept, in seconds").asFloat64();
+    int history_max_samples = config.check("history_max_samples", Value(100), "how many values of each transform are kept").asInt32();
+    if (history_max_samples < 1)
+    {
+        yCError(FRAMETRANSFORMCLIENT, "open(): Invalid history_max_samples, it must be at least 1");
+        return false;
+    }
+
     m_transform_storage = new Transforms_client_storage(m_local_streaming_name);
+    m_transform_storage->setHistory(history_window, static_cast<size_t>(history_max_samples));
     bool ok = Network::connect(m_remote_streaming_name.c_str(), m_local_streaming_name.c_str(), m_streaming_connection_type.c_str());
     if (!ok)
     {
@@ -482,62 +1137,18 @@ bool FrameTransformClient::allFramesAsString(std::string &all_frames)
     return true;
 }
 
-FrameTransformClient::ConnectionType FrameTransformClient::getConnectionType(const std::string &target_frame, const std::string &source_frame, std::string* commonAncestor = nullptr)
+bool FrameTransformClient::canTransform(const std::string &target_frame, const std::string &source_frame)
 {
-    if (target_frame == source_frame) {return IDENTITY;}
+    if (target_frame == source_frame) { return true; }
 
-    Transforms_client_storage& tfVec = *m_transform_storage;
-    size_t                     i, j;
-    std::vector<std::string>   tar2root_vec;
-    std::vector<std::string>   src2root_vec;
-    std::string                ancestor, child;
-    child = target_frame;
-    std::lock_guard<std::recursive_mutex> l(tfVec.m_mutex);
-    while(getParent(child, ancestor))
-    {
-        if(ancestor == source_frame)
-        {
-            return DIRECT;
-        }
-
-        tar2root_vec.push_back(ancestor);
-        child = ancestor;
-    }
-    child = source_frame;
-    while(getParent(child, ancestor))
-    {
-        if(ancestor == target_frame)
-        {
-            return INVERSE;
-        }
-
-        src2root_vec.push_back(ancestor);
-        child = ancestor;
-    }
-
-    for(i = 0; i < tar2root_vec.size(); i++)
-    {
-        std::string a;
-        a = tar2root_vec[i];
-        for(j = 0; j < src2root_vec.size(); j++)
-        {
-            if(a == src2root_vec[j])
-            {
-                if(commonAncestor)
-                {
-                    *commonAncestor = a;
-                }
-                return UNDIRECT;
-            }
-        }
-    }
-
-    return DISCONNECTED;
+    return canTransform(m_transform_storage->getFrameHandle(target_frame, false),
+                        m_transform_storage->getFrameHandle(source_frame, false));
 }
 
-bool FrameTransformClient::canTransform(const std::string &target_frame, const std::string &source_frame)
+bool FrameTransformClient::canTransform(frame_handle target_frame, frame_handle source_frame)
 {
-    return getConnectionType(target_frame, source_frame) != DISCONNECTED;
+    Transforms_client_storage::transform_t transform;
+    return m_transform_storage->getTransform(target_frame, source_frame, transform);
 }
 
 bool FrameTransformClient::clear()
@@ -567,12 +1178,7 @@ bool FrameTransformClient::clear()
 
 bool FrameTransformClient::frameExists(const std::string &frame_id)
 {
-    for (size_t i = 0; i < m_transform_storage->size(); i++)
-    {
-        if (((*m_transform_storage)[i].src_frame_id) == frame_id) { return true; }
-        if (((*m_transform_storage)[i].dst_frame_id) == frame_id) { return true; }
-    }
-    return false;
+    return m_transform_storage->frameExists(m_transform_storage->getFrameHandle(frame_id, false));
 }
 
 bool FrameTransformClient::getAllFrameIds(std::vector< std::string > &ids)
@@ -602,17 +1208,15 @@ bool FrameTransformClient::getAllFrameIds(std::vector< std::string > &ids)
 
 bool FrameTransformClient::getParent(const std::string &frame_id, std::string &parent_frame_id)
 {
-    for (size_t i = 0; i < m_transform_storage->size(); i++)
+    Transforms_client_storage& tfVec = *m_transform_storage;
+    std::lock_guard<std::recursive_mutex> l(tfVec.m_mutex);
+    frame_handle parent = tfVec.getParent(tfVec.getFrameHandle(frame_id, false));
+    if (parent == invalid_frame_handle)
     {
-        std::string par((*m_transform_storage)[i].dst_frame_id);
-        if (((*m_transform_storage)[i].dst_frame_id == frame_id))
-        {
-
-            parent_frame_id = (*m_transform_storage)[i].src_frame_id;
-            return true;
-        }
+        return false;
     }
-    return false;
+    parent_frame_id = tfVec.getFrameName(parent);
+    return true;
 }
 
 bool FrameTransformClient::canExplicitTransform(const std::string& target_frame_id, const std::string& source_frame_id) const
@@ -632,69 +1236,71 @@ bool FrameTransformClient::canExplicitTransform(const std::string& target_frame_
     return false;
 }
 
-bool FrameTransformClient::getChainedTransform(const std::string& target_frame_id, const std::string& source_frame_id, yarp::sig::Matrix& transform) const
+bool FrameTransformClient::getTransform(const std::string& target_frame_id, const std::string& source_frame_id, yarp::sig::Matrix& transform)
 {
-    Transforms_client_storage& tfVec = *m_transform_storage;
-    size_t                     i, tfVec_size;
-    std::lock_guard<std::recursive_mutex>         l(tfVec.m_mutex);
+    if (target_frame_id == source_frame_id)
+    {
+        transform.resize(4, 4);
+        transform.eye();
+        return true;
+    }
 
-    tfVec_size = tfVec.size();
-    for (i = 0; i < tfVec_size; i++)
+    Transforms_client_storage::transform_t t;
+    if (!m_transform_storage->getTransform(m_transform_storage->getFrameHandle(target_frame_id, false),
+                                           m_transform_storage->getFrameHandle(source_frame_id, false),
+                                           t))
     {
-        if (tfVec[i].dst_frame_id == target_frame_id)
-        {
-            if (tfVec[i].src_frame_id == source_frame_id)
-            {
-                transform = tfVec[i].toMatrix();
-                return true;
-            }
-            else
-            {
-                yarp::sig::Matrix m;
-                if (getChainedTransform(tfVec[i].src_frame_id, source_frame_id, m))
-                {
-                    transform = m * tfVec[i].toMatrix();
-                    return true;
-                }
-            }
-        }
+        yCError(FRAMETRANSFORMCLIENT) << "getTransform(): Frames " << source_frame_id << " and " << target_frame_id << " are not connected";
+        return false;
     }
-    return false;
+    toMatrix(t, transform);
+    return true;
 }
 
-bool FrameTransformClient::getTransform(const std::string& target_frame_id, const std::string& source_frame_id, yarp::sig::Matrix& transform)
+bool FrameTransformClient::getTransformAtTime(const std::string& target_frame_id, const std::string& source_frame_id, double time, yarp::sig::Matrix& transform)
 {
-    ConnectionType ct;
-    std::string    ancestor;
-    ct = getConnectionType(target_frame_id, source_frame_id, &ancestor);
-    if (ct == DIRECT)
+    if (target_frame_id == source_frame_id)
     {
-        return getChainedTransform(target_frame_id, source_frame_id, transform);
-    }
-    else if (ct == INVERSE)
-    {
-        yarp::sig::Matrix m(4, 4);
-        getChainedTransform(source_frame_id, target_frame_id, m);
-        transform = yarp::math::SE3inv(m);
+        transform.resize(4, 4);
+        transform.eye();
         return true;
     }
-    else if(ct == UNDIRECT)
+
+    Transforms_client_storage::transform_t t;
+    if (!m_transform_storage->getTransformAtTime(m_transform_storage->getFrameHandle(target_frame_id, false),
+                                                 m_transform_storage->getFrameHandle(source_frame_id, false),
+                                                 time,
+                                                 t))
     {
-        yarp::sig::Matrix root2tar(4, 4), root2src(4, 4);
-        getChainedTransform(source_frame_id, ancestor, root2src);
-        getChainedTransform(target_frame_id, ancestor, root2tar);
-        transform = yarp::math::SE3inv(root2src) * root2tar;
-        return true;
+        yCError(FRAMETRANSFORMCLIENT) << "getTransformAtTime(): No transform between frames " << source_frame_id << " and " << target_frame_id << " at time " << time;
+        return false;
     }
-    else if (ct == IDENTITY)
+    toMatrix(t, transform);
+    return true;
+}
+
+bool FrameTransformClient::getTransformAtTime(frame_handle target_frame, frame_handle source_frame, double time, yarp::sig::Matrix& transform)
+{
+    Transforms_client_storage::transform_t t;
+    if (!m_transform_storage->getTransformAtTime(target_frame, source_frame, time, t))
     {
-        yarp::sig::Matrix tmp(4, 4); tmp.eye();
-        transform = tmp;
-        return true;
+        yCError(FRAMETRANSFORMCLIENT) << "getTransformAtTime(): No transform between frames " << m_transform_storage->getFrameName(source_frame) << " and " << m_transform_storage->getFrameName(target_frame) << " at time " << time;
+        return false;
     }
+    toMatrix(t, transform);
+    return true;
+}
 
-    yCError(FRAMETRANSFORMCLIENT) << "getTransform(): Frames " << source_frame_id << " and " << target_frame_id << " are not connected";
-    return false;
+bool FrameTransformClient::getTransform(frame_handle target_frame, frame_handle source_frame, yarp::sig::Matrix& transform)
+{
+    Transforms_client_storage::transform_t t;
+    if (!m_transform_storage->getTransform(target_frame, source_frame, t))
+    {
+        yCError(FRAMETRANSFORMCLIENT) << "getTransform(): Frames " << m_transform_storage->getFrameName(source_frame) << " and " << m_transform_storage->getFrameName(target_frame) << " are not connected";
+        return false;
+    }
+    toMatrix(t, transform);
+    return true;
 }
 
 bool FrameTransformClient::setTransform(const std::string& target_frame_id, const std::string& source_frame_id, const yarp::sig::Matrix& transform)
@@ -837,17 +1443,35 @@ bool FrameTransformClient::transformPoint(const std::string &target_frame_id, co
         yCError(FRAMETRANSFORMCLIENT) << "Only 3 dimensional vector allowed.";
         return false;
     }
-    yarp::sig::Matrix m(4, 4);
-    if (!getTransform(target_frame_id, source_frame_id, m))
+    Transforms_client_storage::transform_t t;
+    if (target_frame_id == source_frame_id)
+    {
+        setIdentity(t);
+    }
+    else if (!m_transform_storage->getTransform(m_transform_storage->getFrameHandle(target_frame_id, false),
+                                                m_transform_storage->getFrameHandle(source_frame_id, false),
+                                                t))
     {
         yCError(FRAMETRANSFORMCLIENT) << "No transform found between source '" << target_frame_id << "' and target '" << source_frame_id << "'";
         return false;
     }
-    yarp::sig::Vector in = input_point;
-    in.push_back(1);
-    transformed_point = m * in;
-    transformed_point.pop_back();
-    return true;
+    return ::transformPoint(t, input_point, transformed_point);
+}
+
+bool FrameTransformClient::transformPoint(frame_handle target_frame, frame_handle source_frame, const yarp::sig::Vector &input_point, yarp::sig::Vector &transformed_point)
+{
+    if (input_point.size() != 3)
+    {
+        yCError(FRAMETRANSFORMCLIENT) << "Only 3 dimensional vector allowed.";
+        return false;
+    }
+    Transforms_client_storage::transform_t t;
+    if (!m_transform_storage->getTransform(target_frame, source_frame, t))
+    {
+        yCError(FRAMETRANSFORMCLIENT) << "No transform found between source '" << m_transform_storage->getFrameName(target_frame) << "' and target '" << m_transform_storage->getFrameName(source_frame) << "'";
+        return false;
+    }
+    return ::transformPoint(t, input_point, transformed_point);
 }
 
 bool FrameTransformClient::transformPose(const std::string &target_frame_id, const std::string &source_frame_id, const yarp::sig::Vector &input_pose, yarp::sig::Vector &transformed_pose)
@@ -898,6 +1522,11 @@ bool FrameTransformClient::transformQuaternion(const std::string &target_frame_i
     return true;
 }
 
+IFrameTransform::frame_handle FrameTransformClient::getFrameHandle(const std::string &frame_id)
+{
+    return m_transform_storage->getFrameHandle(frame_id, true);
+}
+
 bool FrameTransformClient::waitForTransform(const std::string &target_frame_id, const std::string &source_frame_id, const double &timeout)
 {
     //loop until canTransform == true or timeout expires
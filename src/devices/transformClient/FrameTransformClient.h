@@ -25,6 +25,7 @@
 #include <yarp/dev/IPreciselyTimed.h>
 #include <yarp/dev/IFrameTransform.h>
 #include <yarp/dev/IFrameTransformClientControl.h>
+#include <yarp/dev/impl/FrameTransformDelta.h>
 #include <yarp/dev/ControlBoardInterfaces.h>
 #include <yarp/dev/ControlBoardHelpers.h>
 #include <yarp/sig/Vector.h>
@@ -33,7 +34,11 @@
 #include <yarp/dev/PolyDriver.h>
 #include <yarp/math/FrameTransform.h>
 #include <yarp/os/PeriodicThread.h>
+#include <array>
+#include <cstdint>
 #include <mutex>
+#include <unordered_map>
+#include <utility>
 
 
 #define DEFAULT_THREAD_PERIOD 20 //ms
@@ -41,9 +46,54 @@ const int TRANSFORM_TIMEOUT_MS = 100; //ms
 const int MAX_PORTS = 5;
 
 
+/**
+ * The recent values of a transform, ordered by time, in a ring buffer of
+ * bounded size.
+ */
+class Transform_history
+{
+public:
+    void setCapacity(size_t capacity);
+    void clear();
+
+    /**
+     * Add a value, if it is not older than the last one, and drop the values
+     * older than window seconds before it.
+     */
+    void add(const yarp::math::FrameTransform& t, double window);
+
+    /**
+     * Interpolate the transform at the given time (linearly for the
+     * translation, with a slerp for the rotation). The last value is
+     * returned for a time after it, and false for a time before the first
+     * value.
+     */
+    bool interpolate(double time, std::array<double, 16>& transform) const;
+
+private:
+    struct sample_t
+    {
+        double timestamp;
+        double tX, tY, tZ;
+        double w, x, y, z;
+    };
+    const sample_t& at(size_t i) const { return m_samples[(m_first + i) % m_samples.size()]; }
+
+    std::vector<sample_t> m_samples;
+    size_t                m_first {0};
+    size_t                m_count {0};
+};
+
+
 class Transforms_client_storage :
         public yarp::os::BufferedPort<yarp::os::Bottle>
 {
+public:
+    typedef yarp::dev::IFrameTransform::frame_handle frame_handle;
+
+    // A rigid transformation, as a 4x4 row major matrix
+    typedef std::array<double, 16> transform_t;
+
 private:
     yarp::os::Bottle m_lastBottle;
     yarp::os::Stamp  m_lastStamp;
@@ -57,12 +107,80 @@ private:
 
     std::vector <yarp::math::FrameTransform> m_transforms;
 
+    // The ids of the transforms received with the delta encoded stream,
+    // parallel to m_transforms, and the index of each id in m_transforms
+    std::vector<std::uint32_t>                m_transform_ids;
+    std::unordered_map<std::uint32_t, size_t> m_transform_index;
+    bool                                      m_has_keyframe;
+    std::int32_t                              m_last_seq;
+
+    // The frames, indexed by their handle. The names are interned when they
+    // are first seen, and a handle is never reused.
+    struct frame_t
+    {
+        std::string   name;
+        frame_handle  parent {yarp::dev::IFrameTransform::invalid_frame_handle};
+        bool          exists {false};
+        transform_t   transform;     // from the parent frame
+        unsigned long version {0};   // changes when parent or transform change
+        Transform_history history;
+    };
+    std::vector<frame_t>                          m_frames;
+    std::unordered_map<std::string, frame_handle> m_frame_ids;
+    unsigned long                                 m_version;
+    double                                        m_history_window;
+    size_t                                        m_history_samples;
+
+    // The transforms already composed, with the version of each frame of the
+    // chain when they were composed
+    struct cached_transform_t
+    {
+        transform_t transform;
+        std::vector<std::pair<frame_handle, unsigned long>> chain;
+    };
+    std::unordered_map<std::uint64_t, cached_transform_t> m_cache;
+
+    void updateFrames();
+    void updateFrame(frame_handle frame, frame_handle parent, const yarp::math::FrameTransform& t);
+    void readTransforms(const yarp::os::Bottle& b);
+    void readDelta(const yarp::os::Bottle& b);
+    frame_handle commonAncestor(frame_handle target, frame_handle source) const;
+    void chainToAncestor(frame_handle frame, frame_handle ancestor, transform_t& transform, std::vector<std::pair<frame_handle, unsigned long>>& chain) const;
+    bool chainToAncestorAtTime(frame_handle frame, frame_handle ancestor, double time, transform_t& transform) const;
+
 public:
     std::recursive_mutex  m_mutex;
     size_t   size();
     yarp::math::FrameTransform& operator[]   (std::size_t idx);
     void clear();
 
+    /**
+     * Return the handle of a frame, adding it if create is true and the
+     * frame is not known yet.
+     */
+    frame_handle getFrameHandle(const std::string& frame_id, bool create);
+    bool     frameExists(frame_handle frame);
+    frame_handle getParent(frame_handle frame);
+    std::string getFrameName(frame_handle frame);
+
+    /**
+     * Compose the transform from source to target, or return a cached one
+     * if no frame of the chain changed since it was composed.
+     */
+    bool     getTransform(frame_handle target, frame_handle source, transform_t& transform);
+
+    /**
+     * Compose the transform from source to target at the given time, from
+     * the history of the transforms of the chain.
+     */
+    bool     getTransformAtTime(frame_handle target, frame_handle source, double time, transform_t& transform);
+
+    /**
+     * Set how long (in seconds) and how many values of each transform are
+     * kept in its history.
+     */
+    void     setHistory(double window, size_t max_samples);
+
 public:
     Transforms_client_storage (std::string port_name);
     ~Transforms_client_storage ( );
@@ -93,12 +211,7 @@ class FrameTransformClient :
         public yarp::os::PeriodicThread
 {
 private:
-    enum ConnectionType {DISCONNECTED = 0, DIRECT, INVERSE, UNDIRECT, IDENTITY};
-
-    FrameTransformClient::ConnectionType getConnectionType(const std::string &target_frame, const std::string &source_frame, std::string* commonAncestor);
-
     bool canExplicitTransform(const std::string& target_frame_id, const std::string& source_frame_id) const;
-    bool getChainedTransform(const std::string &target_frame_id, const std::string &source_frame_id, yarp::sig::Matrix &transform) const;
 
 protected:
 
@@ -147,6 +260,7 @@ public:
      bool     getAllFrameIds(std::vector< std::string > &ids) override;
      bool     getParent(const std::string &frame_id, std::string &parent_frame_id) override;
      bool     getTransform(const std::string &target_frame_id, const std::string &source_frame_id, yarp::sig::Matrix &transform) override;
+     bool     getTransformAtTime(const std::string &target_frame_id, const std::string &source_frame_id, double time, yarp::sig::Matrix &transform) override;
      bool     setTransform(const std::string &target_frame_id, const std::string &source_frame_id, const yarp::sig::Matrix &transform) override;
      bool     setTransformStatic(const std::string &target_frame_id, const std::string &source_frame_id, const yarp::sig::Matrix &transform) override;
      bool     deleteTransform(const std::string &target_frame_id, const std::string &source_frame_id) override;
@@ -154,6 +268,11 @@ public:
      bool     transformPose(const std::string &target_frame_id, const std::string &source_frame_id, const yarp::sig::Vector &input_pose, yarp::sig::Vector &transformed_pose) override;
      bool     transformQuaternion(const std::string &target_frame_id, const std::string &source_frame_id, const yarp::math::Quaternion &input_quaternion, yarp::math::Quaternion &transformed_quaternion) override;
      bool     waitForTransform(const std::string &target_frame_id, const std::string &source_frame_id, const double &timeout) override;
+     frame_handle getFrameHandle(const std::string &frame_id) override;
+     bool     canTransform(frame_handle target_frame, frame_handle source_frame) override;
+     bool     getTransform(frame_handle target_frame, frame_handle source_frame, yarp::sig::Matrix &transform) override;
+     bool     getTransformAtTime(frame_handle target_frame, frame_handle source_frame, double time, yarp::sig::Matrix &transform) override;
+     bool     transformPoint(frame_handle target_frame, frame_handle source_frame, const yarp::sig::Vector &input_point, yarp::sig::Vector &transformed_point) override;
 
      bool     isConnectedWithServer() override;
      bool     reconnectWithServer() override;
@@ -154,6 +154,13 @@ FrameTransformServer::FrameTransformServer() : PeriodicThread(DEFAULT_THREAD_PER
     m_ros_timed_transform_storage = nullptr;
     m_rosNode = nullptr;
     m_FrameTransformTimeout = 0.200; //ms
+    m_delta_broadcast = false;
+    m_keyframe_period = 1.0;
+    m_last_keyframe = 0.0;
+    m_last_output_count = 0;
+    m_broadcast_seq = 0;
+    m_next_broadcast_id = 0;
+    m_broadcast_cycle = 0;
 }
 
 FrameTransformServer::~FrameTransformServer()
@@ -573,6 +580,23 @@ bool FrameTransformServer::open(yarp::os::Searchable &config)
         yCInfo(FRAMETRANSFORMSERVER) << "transforms_lifetime set to:" << m_FrameTransformTimeout;
     }
 
+    // The clients of the previous versions understand only the bottle format
+    std::string streaming_format = config.check("streaming_format", Value("bottle"), "format of the streaming port: delta or bottle").asString();
+    if (streaming_format == "delta")
+    {
+        m_delta_broadcast = true;
+    }
+    else if (streaming_format == "bottle")
+    {
+        m_delta_broadcast = false;
+    }
+    else
+    {
+        yCError(FRAMETRANSFORMSERVER) << "Invalid streaming_format" << streaming_format << ", it must be delta or bottle";
+        return false;
+    }
+    m_keyframe_period = config.check("keyframe_period", Value(1.0), "period of the full broadcasts of the transforms, in seconds").asFloat64();
+
     std::string name;
     if (!config.check("name"))
     {
@@ -655,6 +679,177 @@ void FrameTransformServer::threadRelease()
     }
 }
 
+void FrameTransformServer::broadcastFull()
+{
+    size_t    tfVecSize_static_yarp = m_yarp_static_transform_storage->size();
+    size_t    tfVecSize_timed_yarp = m_yarp_timed_transform_storage->size();
+    size_t    tfVecSize_static_ros  = m_ros_static_transform_storage->size();
+    size_t    tfVecSize_timed_ros = m_ros_timed_transform_storage->size();
+#if 0
+    yCDebug(FRAMETRANSFORMSERVER) << "yarp size" << tfVecSize_yarp << "ros_size" << tfVecSize_ros;
+#endif
+    yarp::os::Bottle& b = m_streamingPort.prepare();
+    b.clear();
+
+    for (size_t i = 0; i < tfVecSize_static_yarp; i++)
+    {
+        yarp::os::Bottle& transform = b.addList();
+        transform.addString((*m_yarp_static_transform_storage)[i].src_frame_id);
+        transform.addString((*m_yarp_static_transform_storage)[i].dst_frame_id);
+        transform.addFloat64((*m_yarp_static_transform_storage)[i].timestamp);
+
+        transform.addFloat64((*m_yarp_static_transform_storage)[i].translation.tX);
+        transform.addFloat64((*m_yarp_static_transform_storage)[i].translation.tY);
+        transform.addFloat64((*m_yarp_static_transform_storage)[i].translation.tZ);
+
+        transform.addFloat64((*m_yarp_static_transform_storage)[i].rotation.w());
+        transform.addFloat64((*m_yarp_static_transform_storage)[i].rotation.x());
+        transform.addFloat64((*m_yarp_static_transform_storage)[i].rotation.y());
+        transform.addFloat64((*m_yarp_static_transform_storage)[i].rotation.z());
+    }
+    for (size_t i = 0; i < tfVecSize_timed_yarp; i++)
+    {
+        yarp::os::Bottle& transform = b.addList();
+        transform.addString((*m_yarp_timed_transform_storage)[i].src_frame_id);
+        transform.addString((*m_yarp_timed_transform_storage)[i].dst_frame_id);
+        transform.addFloat64((*m_yarp_timed_transform_storage)[i].timestamp);
+
+        transform.addFloat64((*m_yarp_timed_transform_storage)[i].translation.tX);
+        transform.addFloat64((*m_yarp_timed_transform_storage)[i].translation.tY);
+        transform.addFloat64((*m_yarp_timed_transform_storage)[i].translation.tZ);
+
+        transform.addFloat64((*m_yarp_timed_transform_storage)[i].rotation.w());
+        transform.addFloat64((*m_yarp_timed_transform_storage)[i].rotation.x());
+        transform.addFloat64((*m_yarp_timed_transform_storage)[i].rotation.y());
+        transform.addFloat64((*m_yarp_timed_transform_storage)[i].rotation.z());
+    }
+    for (size_t i = 0; i < tfVecSize_timed_ros; i++)
+    {
+        yarp::os::Bottle& transform = b.addList();
+        transform.addString((*m_ros_timed_transform_storage)[i].src_frame_id);
+        transform.addString((*m_ros_timed_transform_storage)[i].dst_frame_id);
+        transform.addFloat64((*m_ros_timed_transform_storage)[i].timestamp);
+
+        transform.addFloat64((*m_ros_timed_transform_storage)[i].translation.tX);
+        transform.addFloat64((*m_ros_timed_transform_storage)[i].translation.tY);
+        transform.addFloat64((*m_ros_timed_transform_storage)[i].translation.tZ);
+
+        transform.addFloat64((*m_ros_timed_transform_storage)[i].rotation.w());
+        transform.addFloat64((*m_ros_timed_transform_storage)[i].rotation.x());
+        transform.addFloat64((*m_ros_timed_transform_storage)[i].rotation.y());
+        transform.addFloat64((*m_ros_timed_transform_storage)[i].rotation.z());
+    }
+    for (size_t i = 0; i < tfVecSize_static_ros; i++)
+    {
+        yarp::os::Bottle& transform = b.addList();
+        transform.addString((*m_ros_static_transform_storage)[i].src_frame_id);
+        transform.addString((*m_ros_static_transform_storage)[i].dst_frame_id);
+        transform.addFloat64((*m_ros_static_transform_storage)[i].timestamp);
+
+        transform.addFloat64((*m_ros_static_transform_storage)[i].translation.tX);
+        transform.addFloat64((*m_ros_static_transform_storage)[i].translation.tY);
+        transform.addFloat64((*m_ros_static_transform_storage)[i].translation.tZ);
+
+        transform.addFloat64((*m_ros_static_transform_storage)[i].rotation.w());
+        transform.addFloat64((*m_ros_static_transform_storage)[i].rotation.x());
+        transform.addFloat64((*m_ros_static_transform_storage)[i].rotation.y());
+        transform.addFloat64((*m_ros_static_transform_storage)[i].rotation.z());
+    }
+}
+
+void FrameTransformServer::broadcastDelta()
+{
+    // A keyframe is sent periodically, and when a client connects, so that
+    // it does not need to wait for it, and also to recover from lost messages
+    double now = yarp::os::Time::now();
+    int output_count = m_streamingPort.getOutputCount();
+    bool keyframe = (now - m_last_keyframe >= m_keyframe_period) || (output_count > m_last_output_count);
+    m_last_output_count = output_count;
+    if (keyframe)
+    {
+        m_last_keyframe = now;
+    }
+
+    m_broadcast_records.clear();
+    m_broadcast_cycle++;
+
+    // Same order as the full broadcast
+    Transforms_server_storage* storages[] = {m_yarp_static_transform_storage,
+                                             m_yarp_timed_transform_storage,
+                                             m_ros_timed_transform_storage,
+                                             m_ros_static_transform_storage};
+    std::string key;
+    for (auto* storage : storages)
+    {
+        size_t storage_size = storage->size();
+        for (size_t i = 0; i < storage_size; i++)
+        {
+            const FrameTransform& t = (*storage)[i];
+            key = t.src_frame_id;
+            key += ' ';
+            key += t.dst_frame_id;
+
+            auto it = m_broadcast_transforms.find(key);
+            if (it == m_broadcast_transforms.end())
+            {
+                it = m_broadcast_transforms.emplace(key, broadcast_transform_t{m_next_broadcast_id++, t, m_broadcast_cycle}).first;
+                m_broadcast_records.addDefine(it->second.id, t);
+                continue;
+            }
+
+            broadcast_transform_t& sent = it->second;
+            if (sent.cycle == m_broadcast_cycle)
+            {
+                // The same transform in more than one storage, the first is used
+                continue;
+            }
+            sent.cycle = m_broadcast_cycle;
+
+            if (keyframe)
+            {
+                sent.transform = t;
+                m_broadcast_records.addDefine(sent.id, t);
+            }
+            else if (sent.transform.timestamp != t.timestamp ||
+                     sent.transform.translation.tX != t.translation.tX ||
+                     sent.transform.translation.tY != t.translation.tY ||
+                     sent.transform.translation.tZ != t.translation.tZ ||
+                     sent.transform.rotation.w() != t.rotation.w() ||
+                     sent.transform.rotation.x() != t.rotation.x() ||
+                     sent.transform.rotation.y() != t.rotation.y() ||
+                     sent.transform.rotation.z() != t.rotation.z())
+            {
+                sent.transform = t;
+                m_broadcast_records.addUpdate(sent.id, t);
+            }
+        }
+    }
+
+    for (auto it = m_broadcast_transforms.begin(); it != m_broadcast_transforms.end();)
+    {
+        if (it->second.cycle != m_broadcast_cycle)
+        {
+            if (!keyframe)
+            {
+                m_broadcast_records.addRemove(it->second.id);
+            }
+            it = m_broadcast_transforms.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    // An empty delta is sent anyway, so that the clients know that the
+    // server is alive
+    yarp::os::Bottle& b = m_streamingPort.prepare();
+    b.clear();
+    b.addVocab(keyframe ? yarp::dev::impl::FrameTransformDelta::keyframe_tag : yarp::dev::impl::FrameTransformDelta::delta_tag);
+    b.addInt32(m_broadcast_seq++);
+    b.add(yarp::os::Value(const_cast<char*>(m_broadcast_records.data()), static_cast<int>(m_broadcast_records.size())));
+}
+
 void FrameTransformServer::run()
 {
     std::lock_guard<std::mutex> lock(m_mutex);
@@ -760,79 +955,14 @@ void FrameTransformServer::run()
         m_lastStateStamp.update();
         size_t    tfVecSize_static_yarp = m_yarp_static_transform_storage->size();
         size_t    tfVecSize_timed_yarp = m_yarp_timed_transform_storage->size();
-        size_t    tfVecSize_static_ros  = m_ros_static_transform_storage->size();
-        size_t    tfVecSize_timed_ros = m_ros_timed_transform_storage->size();
-#if 0
-        yCDebug(FRAMETRANSFORMSERVER) << "yarp size" << tfVecSize_yarp << "ros_size" << tfVecSize_ros;
-#endif
-        yarp::os::Bottle& b = m_streamingPort.prepare();
-        b.clear();
-
-        for (size_t i = 0; i < tfVecSize_static_yarp; i++)
-        {
-            yarp::os::Bottle& transform = b.addList();
-            transform.addString((*m_yarp_static_transform_storage)[i].src_frame_id);
-            transform.addString((*m_yarp_static_transform_storage)[i].dst_frame_id);
-            transform.addFloat64((*m_yarp_static_transform_storage)[i].timestamp);
-
-            transform.addFloat64((*m_yarp_static_transform_storage)[i].translation.tX);
-            transform.addFloat64((*m_yarp_static_transform_storage)[i].translation.tY);
-            transform.addFloat64((*m_yarp_static_transform_storage)[i].translation.tZ);
-
-            transform.addFloat64((*m_yarp_static_transform_storage)[i].rotation.w());
-            transform.addFloat64((*m_yarp_static_transform_storage)[i].rotation.x());
-            transform.addFloat64((*m_yarp_static_transform_storage)[i].rotation.y());
-            transform.addFloat64((*m_yarp_static_transform_storage)[i].rotation.z());
-        }
-        for (size_t i = 0; i < tfVecSize_timed_yarp; i++)
+        if (m_delta_broadcast)
         {
-            yarp::os::Bottle& transform = b.addList();
-            transform.addString((*m_yarp_timed_transform_storage)[i].src_frame_id);
-            transform.addString((*m_yarp_timed_transform_storage)[i].dst_frame_id);
-            transform.addFloat64((*m_yarp_timed_transform_storage)[i].timestamp);
-
-            transform.addFloat64((*m_yarp_timed_transform_storage)[i].translation.tX);
-            transform.addFloat64((*m_yarp_timed_transform_storage)[i].translation.tY);
-            transform.addFloat64((*m_yarp_timed_transform_storage)[i].translation.tZ);
-
-            transform.addFloat64((*m_yarp_timed_transform_storage)[i].rotation.w());
-            transform.addFloat64((*m_yarp_timed_transform_storage)[i].rotation.x());
-            transform.addFloat64((*m_yarp_timed_transform_storage)[i].rotation.y());
-            transform.addFloat64((*m_yarp_timed_transform_storage)[i].rotation.z());
+            broadcastDelta();
         }
-        for (size_t i = 0; i < tfVecSize_timed_ros; i++)
-        {
-            yarp::os::Bottle& transform = b.addList();
-            transform.addString((*m_ros_timed_transform_storage)[i].src_frame_id);
-            transform.addString((*m_ros_timed_transform_storage)[i].dst_frame_id);
-            transform.addFloat64((*m_ros_timed_transform_storage)[i].timestamp);
-
-            transform.addFloat64((*m_ros_timed_transform_storage)[i].translation.tX);
-            transform.addFloat64((*m_ros_timed_transform_storage)[i].translation.tY);
-            transform.addFloat64((*m_ros_timed_transform_storage)[i].translation.tZ);
-
-            transform.addFloat64((*m_ros_timed_transform_storage)[i].rotation.w());
-            transform.addFloat64((*m_ros_timed_transform_storage)[i].rotation.x());
-            transform.addFloat64((*m_ros_timed_transform_storage)[i].rotation.y());
-            transform.addFloat64((*m_ros_timed_transform_storage)[i].rotation.z());
-        }
-        for (size_t i = 0; i < tfVecSize_static_ros; i++)
+        else
         {
-            yarp::os::Bottle& transform = b.addList();
-            transform.addString((*m_ros_static_transform_storage)[i].src_frame_id);
-            transform.addString((*m_ros_static_transform_storage)[i].dst_frame_id);
-            transform.addFloat64((*m_ros_static_transform_storage)[i].timestamp);
-
-            transform.addFloat64((*m_ros_static_transform_storage)[i].translation.tX);
-            transform.addFloat64((*m_ros_static_transform_storage)[i].translation.tY);
-            transform.addFloat64((*m_ros_static_transform_storage)[i].translation.tZ);
-
-            transform.addFloat64((*m_ros_static_transform_storage)[i].rotation.w());
-            transform.addFloat64((*m_ros_static_transform_storage)[i].rotation.x());
-            transform.addFloat64((*m_ros_static_transform_storage)[i].rotation.y());
-            transform.addFloat64((*m_ros_static_transform_storage)[i].rotation.z());
+            broadcastFull();
         }
-
         m_streamingPort.setEnvelope(m_lastStateStamp);
         m_streamingPort.write();
 
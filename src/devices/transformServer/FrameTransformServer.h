@@ -24,6 +24,7 @@
 #include <string>
 #include <sstream>
 #include <mutex>
+#include <unordered_map>
 
 #include <yarp/os/Network.h>
 #include <yarp/os/Port.h>
@@ -45,6 +46,7 @@
 #include <yarp/os/Subscriber.h>
 #include <yarp/os/Node.h>
 #include <yarp/dev/IFrameTransform.h>
+#include <yarp/dev/impl/FrameTransformDelta.h>
 
 #include <yarp/math/FrameTransform.h>
 
@@ -106,6 +108,24 @@ private:
     Transforms_server_storage*   m_yarp_static_transform_storage;
     double                       m_FrameTransformTimeout;
 
+    // The state of the transforms known by the clients, for the delta
+    // encoded broadcast, indexed by "src_frame_id dst_frame_id"
+    struct broadcast_transform_t
+    {
+        std::uint32_t              id;
+        yarp::math::FrameTransform transform;
+        unsigned long              cycle;
+    };
+    bool                         m_delta_broadcast;
+    double                       m_keyframe_period;
+    double                       m_last_keyframe;
+    int                          m_last_output_count;
+    std::int32_t                 m_broadcast_seq;
+    std::uint32_t                m_next_broadcast_id;
+    unsigned long                m_broadcast_cycle;
+    std::unordered_map<std::string, broadcast_transform_t> m_broadcast_transforms;
+    yarp::dev::impl::FrameTransformDelta m_broadcast_records;
+
     yarp::os::RpcServer                      m_rpcPort;
     yarp::os::BufferedPort<yarp::os::Bottle> m_streamingPort;
     yarp::os::Publisher<yarp::rosmsg::tf2_msgs::TFMessage> m_rosPublisherPort_tf_timed;
@@ -115,6 +135,8 @@ private:
 
     bool read(yarp::os::ConnectionReader& connection) override;
     inline  void list_response(yarp::os::Bottle& out);
+    void         broadcastFull();
+    void         broadcastDelta();
     bool         parseStartingTf(yarp::os::Searchable &config);
 };
 
@@ -8,4 +8,6 @@
 
 #include <yarp/dev/IFrameTransform.h>
 
+constexpr yarp::dev::IFrameTransform::frame_handle yarp::dev::IFrameTransform::invalid_frame_handle;
+
 yarp::dev::IFrameTransform::~IFrameTransform() = default;
@@ -38,6 +38,14 @@ public:
         TRANSFORM_GENERAL_ERROR = 1,
         TRANSFORM_TIMEOUT       = 2,
     };
+
+    /**
+     * A handle to a reference frame, returned by getFrameHandle().
+     * Looking up frames by handle avoids resolving their names on each call.
+     */
+    typedef int frame_handle;
+    static constexpr frame_handle invalid_frame_handle = -1;
+
     /**
      * Destructor.
      */
@@ -97,6 +105,17 @@ public:
     */
     virtual bool     getTransform (const std::string &target_frame_id, const std::string &source_frame_id, yarp::sig::Matrix &transform) = 0;
 
+    /**
+     Get the transform between two frames at a given time, interpolated from
+     the recent values of the transforms.
+    * @param target_frame_id the name of target reference frame
+    * @param source_frame_id the name of source reference frame
+    * @param time the time of the transform, with the same clock of the timestamps of the transforms
+    * @param transform the transformation matrix from source_frame_id to target_frame_id
+    * @return true/false (false if the time is older than the values kept)
+    */
+    virtual bool     getTransformAtTime(const std::string &target_frame_id, const std::string &source_frame_id, double time, yarp::sig::Matrix &transform) = 0;
+
     /**
      Register a transform between two frames.
      * @param target_frame_id the name of target reference frame
@@ -162,6 +181,53 @@ public:
     * @return true/false
     */
     virtual bool     waitForTransform(const std::string &target_frame_id, const std::string &source_frame_id, const double &timeout) = 0;
+
+    /**
+     Get a handle to a reference frame.
+     The handle remains valid for the lifetime of the device, even if the frame
+     does not exist yet, or is deleted and later created again.
+    * @param frame_id the name of the reference frame
+    * @return the handle, or invalid_frame_handle if the name is not valid
+    */
+    virtual frame_handle getFrameHandle(const std::string &frame_id) = 0;
+
+    /**
+    Test if a transform exists.
+    * @param target_frame the handle of target reference frame
+    * @param source_frame the handle of source reference frame
+    * @return true/false
+    */
+    virtual bool     canTransform(frame_handle target_frame, frame_handle source_frame) = 0;
+
+    /**
+     Get the transform between two frames.
+    * @param target_frame the handle of target reference frame
+    * @param source_frame the handle of source reference frame
+    * @param transform the transformation matrix from source_frame to target_frame
+    * @return true/false
+    */
+    virtual bool     getTransform(frame_handle target_frame, frame_handle source_frame, yarp::sig::Matrix &transform) = 0;
+
+    /**
+     Get the transform between two frames at a given time, interpolated from
+     the recent values of the transforms.
+    * @param target_frame the handle of target reference frame
+    * @param source_frame the handle of source reference frame
+    * @param time the time of the transform, with the same clock of the timestamps of the transforms
+    * @param transform the transformation matrix from source_frame to target_frame
+    * @return true/false (false if the time is older than the values kept)
+    */
+    virtual bool     getTransformAtTime(frame_handle target_frame, frame_handle source_frame, double time, yarp::sig::Matrix &transform) = 0;
+
+    /**
+    Transform a point into the target frame.
+    * @param target_frame the handle of target reference frame
+    * @param source_frame the handle of frame in which input_point is expressed
+    * @param input_point the input point (x y z)
+    * @param transformed_point the returned point (x y z)
+    * @return true/false
+    */
+    virtual bool     transformPoint(frame_handle target_frame, frame_handle source_frame, const yarp::sig::Vector &input_point, yarp::sig::Vector &transformed_point) = 0;
 };
 
 constexpr yarp::conf::vocab32_t VOCAB_ITRANSFORM              = yarp::os::createVocab('i','t','r','f');
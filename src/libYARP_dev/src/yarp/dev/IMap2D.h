@@ -61,6 +61,24 @@ public:
     */
     virtual bool     get_map(std::string map_name, yarp::dev::Nav2D::MapGrid2D& map) = 0;
 
+    /**
+    Gets a region of a map from the map server, without transferring the whole map.
+    * @param map_name the name of the map
+    * @param top_left, bottom_right the corners of the region (expressed in pixel coordinates, included in the region)
+    * @param map the region of the map, see MapGrid2D::getMapRegion()
+    * @return true/false
+    */
+    virtual bool     get_map_region(std::string map_name, yarp::dev::Nav2D::XYCell top_left, yarp::dev::Nav2D::XYCell bottom_right, yarp::dev::Nav2D::MapGrid2D& map) = 0;
+
+    /**
+    Updates a copy of a map previously retrieved from the map server. Only the tiles of the map which differ from the
+    copy are transferred, unless the size, the resolution or the origin of the map changed.
+    * @param map_name the name of the map
+    * @param map the copy of the map to update
+    * @return true/false
+    */
+    virtual bool     update_map(std::string map_name, yarp::dev::Nav2D::MapGrid2D& map) = 0;
+
     /**
     Gets a list containing the names of all registered maps.
     * @return true/false
@@ -209,6 +227,8 @@ public:
 constexpr yarp::conf::vocab32_t VOCAB_IMAP                    = yarp::os::createVocab('i','m','a','p');
 constexpr yarp::conf::vocab32_t VOCAB_IMAP_SET_MAP            = yarp::os::createVocab('s','e','t');
 constexpr yarp::conf::vocab32_t VOCAB_IMAP_GET_MAP            = yarp::os::createVocab('g','e','t');
+constexpr yarp::conf::vocab32_t VOCAB_IMAP_GET_MAP_REGION     = yarp::os::createVocab('g','e','t','r');
+constexpr yarp::conf::vocab32_t VOCAB_IMAP_UPDATE_MAP         = yarp::os::createVocab('u','p','d','t');
 constexpr yarp::conf::vocab32_t VOCAB_IMAP_GET_NAMES          = yarp::os::createVocab('n','a','m','s');
 constexpr yarp::conf::vocab32_t VOCAB_IMAP_CLEAR              = yarp::os::createVocab('c','l','r');
 constexpr yarp::conf::vocab32_t VOCAB_IMAP_REMOVE             = yarp::os::createVocab('r','e','m','v');
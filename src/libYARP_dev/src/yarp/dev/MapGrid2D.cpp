@@ -16,8 +16,12 @@
 #include <yarp/os/LogStream.h>
 #include <yarp/sig/ImageFile.h>
 #include <algorithm>
+#include <cstdint>
+#include <cstring>
 #include <fstream>
 #include <cmath>
+#include <limits>
+#include <vector>
 
 using namespace yarp::dev;
 using namespace yarp::dev::Nav2D;
@@ -51,6 +55,178 @@ string extractExtensionFromFile(string full_filename)
     return full_filename.substr(start, 3);
 }
 
+namespace {
+
+//squared distance returned by distanceTransform() when there are no obstacles
+constexpr std::int64_t no_obstacle = std::numeric_limits<std::int64_t>::max();
+
+//integer division, rounded down
+std::int64_t floorDiv(std::int64_t num, std::int64_t den)
+{
+    return (num >= 0) ? num / den : -((-num + den - 1) / den);
+}
+
+//largest squared distance (in cells) not larger than the given distance (in cells)
+std::int64_t maxSquaredDistance(double distance)
+{
+    return static_cast<std::int64_t>(std::floor(distance * distance + 1e-6));
+}
+
+//Euclidean distance transform of the region [x0,x1)x[y0,y1) of a map, with the linear time
+//algorithm by Meijster, Roerdink and Hesselink. isObstacle(x,y) tells if a cell is an obstacle,
+//visit(x,y,d2) is called once for each cell, with the squared distance (in cells) of the closest
+//obstacle of the region. All the cells are checked by isObstacle() before the first visit().
+template <typename IsObstacle, typename Visit>
+void distanceTransform(size_t x0, size_t y0, size_t x1, size_t y1, IsObstacle isObstacle, Visit visit)
+{
+    const auto w = static_cast<std::int64_t>(x1 - x0);
+    const auto h = static_cast<std::int64_t>(y1 - y0);
+    if (w <= 0 || h <= 0)
+    {
+        return;
+    }
+    const std::int64_t inf = w + h;
+
+    //distance of the closest obstacle in the same column
+    std::vector<std::int32_t> g(w * h);
+    for (std::int64_t y = 0; y < h; y++)
+    {
+        for (std::int64_t x = 0; x < w; x++)
+        {
+            if (isObstacle(x0 + x, y0 + y))
+            {
+                g[y * w + x] = 0;
+            }
+            else
+            {
+                g[y * w + x] = static_cast<std::int32_t>((y == 0) ? inf : std::min(inf, g[(y - 1) * w + x] + std::int64_t{1}));
+            }
+        }
+    }
+    for (std::int64_t y = h - 2; y >= 0; y--)
+    {
+        for (std::int64_t x = 0; x < w; x++)
+        {
+            if (g[(y + 1) * w + x] < g[y * w + x])
+            {
+                g[y * w + x] = g[(y + 1) * w + x] + 1;
+            }
+        }
+    }
+
+    //lower envelope of the parabolas of each row
+    std::vector<std::int64_t> s(w);
+    std::vector<std::int64_t> t(w);
+    for (std::int64_t y = 0; y < h; y++)
+    {
+        const std::int32_t* gy = &g[y * w];
+        auto f = [gy](std::int64_t x, std::int64_t i) {
+            return (x - i) * (x - i) + std::int64_t{gy[i]} * gy[i];
+        };
+        auto sep = [gy](std::int64_t i, std::int64_t u) {
+            return floorDiv(u * u - i * i + std::int64_t{gy[u]} * gy[u] - std::int64_t{gy[i]} * gy[i], 2 * (u - i));
+        };
+
+        std::int64_t q = 0;
+        s[0] = 0;
+        t[0] = 0;
+        for (std::int64_t u = 1; u < w; u++)
+        {
+            while (q >= 0 && f(t[q], s[q]) > f(t[q], u))
+            {
+                q--;
+            }
+            if (q < 0)
+            {
+                q = 0;
+                s[0] = u;
+            }
+            else
+            {
+                std::int64_t next = 1 + sep(s[q], u);
+                if (next < w)
+                {
+                    q++;
+                    s[q] = u;
+                    t[q] = next;
+                }
+            }
+        }
+        for (std::int64_t u = w - 1; u >= 0; u--)
+        {
+            std::int64_t d2 = f(u, s[q]);
+            visit(x0 + u, y0 + y, (d2 >= inf * inf) ? no_obstacle : d2);
+            if (u == t[q])
+            {
+                q--;
+            }
+        }
+    }
+}
+
+//compression id of the run-length encoded layers, in the network format
+constexpr std::int32_t compression_rle = 1;
+
+//run-length encoding of a layer: each run of equal bytes is stored as the byte, followed by
+//the length of the run minus one, as a variable length integer (7 bits per byte, LSB first)
+void encodeRLE(const unsigned char* data, size_t size, std::vector<char>& out)
+{
+    out.clear();
+    size_t i = 0;
+    while (i < size)
+    {
+        size_t run = 1;
+        while (i + run < size && data[i + run] == data[i])
+        {
+            run++;
+        }
+        out.push_back(static_cast<char>(data[i]));
+        size_t len = run - 1;
+        while (len >= 0x80)
+        {
+            out.push_back(static_cast<char>((len & 0x7F) | 0x80));
+            len >>= 7;
+        }
+        out.push_back(static_cast<char>(len));
+        i += run;
+    }
+}
+
+bool decodeRLE(const std::vector<char>& in, unsigned char* data, size_t size)
+{
+    size_t pos = 0;
+    size_t i = 0;
+    while (i < in.size())
+    {
+        auto value = static_cast<unsigned char>(in[i++]);
+        size_t len = 0;
+        size_t shift = 0;
+        while (true)
+        {
+            if (i >= in.size() || shift > 8 * sizeof(size_t))
+            {
+                return false;
+            }
+            auto byte = static_cast<unsigned char>(in[i++]);
+            len |= static_cast<size_t>(byte & 0x7F) << shift;
+            shift += 7;
+            if ((byte & 0x80) == 0)
+            {
+                break;
+            }
+        }
+        if (len >= size - pos)
+        {
+            return false;
+        }
+        std::fill(data + pos, data + pos + len + 1, value);
+        pos += len + 1;
+    }
+    return pos == size;
+}
+
+} // namespace
+
 
 bool MapGrid2D::isIdenticalTo(const MapGrid2D& other) const
 {
@@ -77,6 +253,9 @@ MapGrid2D::MapGrid2D()
     m_map_flags.resize(m_width, m_height);
     m_occupied_thresh = 0.80;
     m_free_thresh = 0.20;
+    m_enlargement = 0;
+    m_obstacle_distance_valid = false;
+    m_compressed_data_over_network = false;
     for (size_t y = 0; y < m_height; y++)
     {
         for (size_t x = 0; x < m_width; x++)
@@ -174,6 +353,7 @@ bool MapGrid2D::setMapImage(yarp::sig::ImageOf<PixelRgb>& image)
             m_map_flags.safePixel(x, y) = PixelToCellData(image.safePixel(x, y));
         }
     }
+    m_obstacle_distance_valid = false;
     return true;
 }
 
@@ -191,55 +371,119 @@ bool MapGrid2D::enlargeObstacles(double size)
                 }
             }
         }
+        m_enlargement = 0;
         return true;
     }
-    auto repeat_num = (size_t)(std::ceil(size/ m_resolution));
-    for (size_t repeat = 0; repeat < repeat_num; repeat++)
+
+    //the cells already enlarged are obstacles too, so that the enlargement sums up
+    std::int64_t max_d2 = maxSquaredDistance(size / m_resolution);
+    distanceTransform(0, 0, m_width, m_height,
+        [this](size_t x, size_t y)
+        {
+            return m_map_flags.pixel(x, y) != MAP_CELL_FREE;
+        },
+        [this, max_d2](size_t x, size_t y, std::int64_t d2)
+        {
+            if (d2 <= max_d2 && m_map_flags.pixel(x, y) == MAP_CELL_FREE)
+            {
+                m_map_flags.pixel(x, y) = MAP_CELL_ENLARGED_OBSTACLE;
+            }
+        });
+    m_enlargement += size;
+    return true;
+}
+
+bool MapGrid2D::updateEnlargedObstacles(XYCell top_left, XYCell bottom_right)
+{
+    if (isInsideMap(top_left) == false || isInsideMap(bottom_right) == false)
     {
-        //contains the cells to be enlarged;
-        std::vector<XYCell> list_of_cells;
-        for (size_t y = 0; y < m_height; y++)
+        yError() << "Invalid region requested " << top_left.x << " " << top_left.y << " " << bottom_right.x << " " << bottom_right.y;
+        return false;
+    }
+    if (m_enlargement <= 0)
+    {
+        return true;
+    }
+
+    //the cells farther than the enlargement from the region are not affected
+    auto margin = static_cast<size_t>(std::ceil(m_enlargement / m_resolution));
+    size_t left = std::min(top_left.x, bottom_right.x);
+    size_t top = std::min(top_left.y, bottom_right.y);
+    size_t right = std::max(top_left.x, bottom_right.x);
+    size_t bottom = std::max(top_left.y, bottom_right.y);
+    enlargeRegion(left > margin ? left - margin : 0,
+                  top > margin ? top - margin : 0,
+                  std::min(right + 1 + margin, m_width),
+                  std::min(bottom + 1 + margin, m_height),
+                  m_enlargement);
+    return true;
+}
+
+void MapGrid2D::enlargeRegion(size_t x0, size_t y0, size_t x1, size_t y1, double size)
+{
+    //the obstacles which can enlarge the region are at most margin cells away
+    auto margin = static_cast<size_t>(std::ceil(size / m_resolution));
+    std::int64_t max_d2 = maxSquaredDistance(size / m_resolution);
+    distanceTransform(x0 > margin ? x0 - margin : 0,
+                      y0 > margin ? y0 - margin : 0,
+                      std::min(x1 + margin, m_width),
+                      std::min(y1 + margin, m_height),
+        [this](size_t x, size_t y)
         {
-            for (size_t x = 0; x < m_width; x++)
+            CellData flag = m_map_flags.pixel(x, y);
+            return flag != MAP_CELL_FREE && flag != MAP_CELL_ENLARGED_OBSTACLE;
+        },
+        [this, x0, y0, x1, y1, max_d2](size_t x, size_t y, std::int64_t d2)
+        {
+            if (x < x0 || x >= x1 || y < y0 || y >= y1)
             {
-                //this check could be optimized...
-                if (this->m_map_flags.safePixel(x, y) == MAP_CELL_KEEP_OUT ||
-                    this->m_map_flags.safePixel(x, y) == MAP_CELL_ENLARGED_OBSTACLE ||
-                    this->m_map_flags.safePixel(x, y) == MAP_CELL_WALL ||
-                    this->m_map_flags.safePixel(x, y) == MAP_CELL_UNKNOWN ||
-                    this->m_map_flags.safePixel(x, y) == MAP_CELL_TEMPORARY_OBSTACLE)
-                {
-                    list_of_cells.emplace_back(x, y);
-                }
+                return;
             }
-        }
+            CellData& flag = m_map_flags.pixel(x, y);
+            if (flag == MAP_CELL_ENLARGED_OBSTACLE && d2 > max_d2)
+            {
+                flag = MAP_CELL_FREE;
+            }
+            else if (flag == MAP_CELL_FREE && d2 <= max_d2)
+            {
+                flag = MAP_CELL_ENLARGED_OBSTACLE;
+            }
+        });
+}
 
-        //process each cell of the list and enlarges it
-        for (auto& list_of_cell : list_of_cells)
+bool MapGrid2D::computeObstacleDistance()
+{
+    m_obstacle_distance.setQuantum(1);
+    m_obstacle_distance.resize(m_width, m_height);
+    distanceTransform(0, 0, m_width, m_height,
+        [this](size_t x, size_t y)
         {
-            enlargeCell(list_of_cell);
-        }
-    }
+            CellData flag = m_map_flags.pixel(x, y);
+            return flag != MAP_CELL_FREE && flag != MAP_CELL_ENLARGED_OBSTACLE;
+        },
+        [this](size_t x, size_t y, std::int64_t d2)
+        {
+            m_obstacle_distance.pixel(x, y) = (d2 == no_obstacle) ?
+                std::numeric_limits<float>::infinity() :
+                static_cast<float>(std::sqrt(static_cast<double>(d2)) * m_resolution);
+        });
+    m_obstacle_distance_valid = true;
     return true;
 }
 
-void MapGrid2D::enlargeCell(XYCell cell)
+bool MapGrid2D::getObstacleDistance(XYCell cell, double& distance) const
 {
-    size_t i = cell.x;
-    size_t j = cell.y;
-    size_t il = cell.x > 1 ? cell.x - 1 : 0;
-    size_t ir = cell.x + 1 < (m_width)-1 ? cell.x + 1 : (m_width)-1;
-    size_t ju = cell.y > 1 ? cell.y - 1 : 0;
-    size_t jd = cell.y + 1 < (m_height)-1 ? cell.y + 1 : (m_height)-1;
-
-    if (m_map_flags.pixel(il, j) == MAP_CELL_FREE) m_map_flags.pixel(il, j) = MAP_CELL_ENLARGED_OBSTACLE;
-    if (m_map_flags.pixel(ir, j) == MAP_CELL_FREE) m_map_flags.pixel(ir, j) = MAP_CELL_ENLARGED_OBSTACLE;
-    if (m_map_flags.pixel(i, ju) == MAP_CELL_FREE) m_map_flags.pixel(i, ju) = MAP_CELL_ENLARGED_OBSTACLE;
-    if (m_map_flags.pixel(i, jd) == MAP_CELL_FREE) m_map_flags.pixel(i, jd) = MAP_CELL_ENLARGED_OBSTACLE;
-    if (m_map_flags.pixel(il, ju) == MAP_CELL_FREE) m_map_flags.pixel(il, ju) = MAP_CELL_ENLARGED_OBSTACLE;
-    if (m_map_flags.pixel(il, jd) == MAP_CELL_FREE) m_map_flags.pixel(il, jd) = MAP_CELL_ENLARGED_OBSTACLE;
-    if (m_map_flags.pixel(ir, ju) == MAP_CELL_FREE) m_map_flags.pixel(ir, ju) = MAP_CELL_ENLARGED_OBSTACLE;
-    if (m_map_flags.pixel(ir, jd) == MAP_CELL_FREE) m_map_flags.pixel(ir, jd) = MAP_CELL_ENLARGED_OBSTACLE;
+    if (isInsideMap(cell) == false)
+    {
+        yError() << "Invalid cell requested " << cell.x << " " << cell.y;
+        return false;
+    }
+    if (!m_obstacle_distance_valid)
+    {
+        return false;
+    }
+    distance = m_obstacle_distance.pixel(cell.x, cell.y);
+    return true;
 }
 
 bool MapGrid2D::loadROSParams(string ros_yaml_filename, string& pgm_occ_filename, double& resolution, double& orig_x, double& orig_y, double& orig_t )
@@ -554,6 +798,8 @@ bool  MapGrid2D::loadFromFile(std::string map_file_with_path)
 
     m_width = -1;
     m_height = -1;
+    m_enlargement = 0;
+    m_obstacle_distance_valid = false;
     string yarp_flg_filename_with_path = mapfile_path + ppm_flg_filename;
     string ros_yaml_filename_with_path = mapfile_path + yaml_filename;
     if (YarpMapDataFound && RosMapDataFound)
@@ -697,6 +943,7 @@ bool  MapGrid2D::crop (int left, int top, int right, int bottom)
         }
     m_map_occupancy.copy(new_map_occupancy);
     m_map_flags.copy(new_map_flags);
+    m_obstacle_distance_valid = false;
     this->m_width=m_map_occupancy.width();
     this->m_height=m_map_occupancy.height();
     yDebug() << m_origin.get_x() << m_origin.get_y();
@@ -706,6 +953,86 @@ bool  MapGrid2D::crop (int left, int top, int right, int bottom)
     return true;
 }
 
+bool MapGrid2D::getMapRegion(XYCell top_left, XYCell bottom_right, MapGrid2D& region) const
+{
+    if (isInsideMap(top_left) == false || isInsideMap(bottom_right) == false ||
+        top_left.x > bottom_right.x || top_left.y > bottom_right.y)
+    {
+        yError() << "Invalid region requested " << top_left.x << " " << top_left.y << " " << bottom_right.x << " " << bottom_right.y;
+        return false;
+    }
+    size_t w = bottom_right.x - top_left.x + 1;
+    size_t h = bottom_right.y - top_left.y + 1;
+    region.m_map_name = m_map_name;
+    region.m_resolution = m_resolution;
+    region.m_occupied_thresh = m_occupied_thresh;
+    region.m_free_thresh = m_free_thresh;
+    region.m_compressed_data_over_network = m_compressed_data_over_network;
+    region.setSize_in_cells(w, h);
+    for (size_t y = 0; y < h; y++)
+    {
+        memcpy(region.m_map_occupancy.getRow(y), m_map_occupancy.getRow(top_left.y + y) + top_left.x, w);
+        memcpy(region.m_map_flags.getRow(y), m_map_flags.getRow(top_left.y + y) + top_left.x, w);
+    }
+    //same as crop()
+    double x0 = m_origin.get_x() + (top_left.x * m_resolution);
+    double y0 = m_origin.get_y() + (double(m_height) - double(bottom_right.y + 1)) * m_resolution;
+    region.m_origin.setOrigin(x0, y0, m_origin.get_theta());
+    return true;
+}
+
+bool MapGrid2D::setMapRegion(XYCell top_left, const MapGrid2D& region)
+{
+    if (top_left.x + region.m_width > m_width || top_left.y + region.m_height > m_height)
+    {
+        yError() << "Invalid region requested " << top_left.x << " " << top_left.y << " " << region.m_width << " " << region.m_height;
+        return false;
+    }
+    for (size_t y = 0; y < region.m_height; y++)
+    {
+        memcpy(m_map_occupancy.getRow(top_left.y + y) + top_left.x, region.m_map_occupancy.getRow(y), region.m_width);
+        memcpy(m_map_flags.getRow(top_left.y + y) + top_left.x, region.m_map_flags.getRow(y), region.m_width);
+    }
+    m_obstacle_distance_valid = false;
+    return true;
+}
+
+bool MapGrid2D::getTileHashes(size_t tile_size, std::vector<std::uint64_t>& hashes) const
+{
+    if (tile_size == 0)
+    {
+        yError() << "Invalid tile size " << tile_size;
+        return false;
+    }
+    //the partial tiles are counted without rounding up, which would wrap around with big tiles
+    size_t tiles_x = m_width / tile_size + (m_width % tile_size != 0 ? 1 : 0);
+    size_t tiles_y = m_height / tile_size + (m_height % tile_size != 0 ? 1 : 0);
+
+    //64 bit FNV-1a of the occupancy and of the flags of each tile
+    constexpr std::uint64_t fnv_offset = 14695981039346656037ULL;
+    constexpr std::uint64_t fnv_prime = 1099511628211ULL;
+    hashes.assign(tiles_x * tiles_y, fnv_offset);
+    for (size_t y = 0; y < m_height; y++)
+    {
+        const unsigned char* occ = m_map_occupancy.getRow(y);
+        const unsigned char* flg = m_map_flags.getRow(y);
+        std::uint64_t* row_hashes = &hashes[(y / tile_size) * tiles_x];
+        for (size_t x = 0; x < m_width; x++)
+        {
+            std::uint64_t& hash = row_hashes[x / tile_size];
+            hash = (hash ^ occ[x]) * fnv_prime;
+            hash = (hash ^ flg[x]) * fnv_prime;
+        }
+    }
+    return true;
+}
+
+bool MapGrid2D::enable_map_compression_over_network(bool val)
+{
+    m_compressed_data_over_network = val;
+    return true;
+}
+
 bool  MapGrid2D::saveToFile(std::string map_file_with_path) const
 {
     std::string yarp_filename = this->getMapName() + "_yarpflags.ppm";
@@ -771,7 +1098,7 @@ bool MapGrid2D::read(yarp::os::ConnectionReader& connection)
     connection.convertTextMode();
 
     connection.expectInt32();
-    connection.expectInt32();
+    int count = connection.expectInt32();
 
     connection.expectInt32();
     m_width = connection.expectInt32();
@@ -793,9 +1120,36 @@ bool MapGrid2D::read(yarp::os::ConnectionReader& connection)
     m_map_name = buff;
     m_map_occupancy.resize(m_width, m_height);
     m_map_flags.resize(m_width, m_height);
+    m_enlargement = 0;
+    m_obstacle_distance_valid = false;
     bool ok = true;
+    std::int32_t compression = 0;
+    if (count == 10)
+    {
+        connection.expectInt32();
+        compression = connection.expectInt32();
+        if (compression != compression_rle) { return false; }
+    }
     unsigned char *mem = nullptr;
     size_t memsize = 0;
+    if (compression == compression_rle)
+    {
+        std::vector<char> encoded;
+        connection.expectInt32();
+        std::int32_t len = connection.expectInt32();
+        if (len < 0 || static_cast<size_t>(len) > connection.getSize()) { return false; }
+        encoded.resize(len);
+        ok &= connection.expectBlock(encoded.data(), encoded.size());
+        ok &= decodeRLE(encoded, m_map_occupancy.getRawImage(), m_map_occupancy.getRawImageSize());
+        connection.expectInt32();
+        len = connection.expectInt32();
+        if (len < 0 || static_cast<size_t>(len) > connection.getSize()) { return false; }
+        encoded.resize(len);
+        ok &= connection.expectBlock(encoded.data(), encoded.size());
+        ok &= decodeRLE(encoded, m_map_flags.getRawImage(), m_map_flags.getRawImageSize());
+        if (!ok) return false;
+        return !connection.isError();
+    }
     connection.expectInt32();
     memsize = connection.expectInt32();
     if (memsize != m_map_occupancy.getRawImageSize()) { return false; }
@@ -814,7 +1168,7 @@ bool MapGrid2D::read(yarp::os::ConnectionReader& connection)
 bool MapGrid2D::write(yarp::os::ConnectionWriter& connection) const
 {
     connection.appendInt32(BOTTLE_TAG_LIST);
-    connection.appendInt32(9);
+    connection.appendInt32(m_compressed_data_over_network ? 10 : 9);
     connection.appendInt32(BOTTLE_TAG_INT32);
     connection.appendInt32(m_width);
     connection.appendInt32(BOTTLE_TAG_INT32);
@@ -830,6 +1184,26 @@ bool MapGrid2D::write(yarp::os::ConnectionWriter& connection) const
     connection.appendInt32(BOTTLE_TAG_STRING);
     connection.appendString(m_map_name);
 
+    if (m_compressed_data_over_network)
+    {
+        connection.appendInt32(BOTTLE_TAG_INT32);
+        connection.appendInt32(compression_rle);
+
+        //appendBlock() copies the data, so the same buffer is reused for both layers
+        std::vector<char> encoded;
+        encodeRLE(m_map_occupancy.getRawImage(), m_map_occupancy.getRawImageSize(), encoded);
+        connection.appendInt32(BOTTLE_TAG_BLOB);
+        connection.appendInt32(encoded.size());
+        connection.appendBlock(encoded.data(), encoded.size());
+        encodeRLE(m_map_flags.getRawImage(), m_map_flags.getRawImageSize(), encoded);
+        connection.appendInt32(BOTTLE_TAG_BLOB);
+        connection.appendInt32(encoded.size());
+        connection.appendBlock(encoded.data(), encoded.size());
+
+        connection.convertTextMode();
+        return !connection.isError();
+    }
+
     unsigned char *mem = nullptr;
     int            memsize = 0;
     mem     = m_map_occupancy.getRawImage();
@@ -942,6 +1316,8 @@ bool MapGrid2D::setSize_in_cells(size_t x, size_t y)
     m_map_flags.resize(x, y);
     m_map_occupancy.zero();
     m_map_flags.zero();
+    m_enlargement = 0;
+    m_obstacle_distance_valid = false;
     m_width = x;
     m_height = y;
     return true;
@@ -967,6 +1343,7 @@ bool MapGrid2D::setMapFlag(XYCell cell, map_flags flag)
         return false;
     }
     m_map_flags.safePixel(cell.x, cell.y) = flag;
+    m_obstacle_distance_valid = false;
     return true;
 }
 
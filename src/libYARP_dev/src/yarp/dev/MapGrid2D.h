@@ -9,7 +9,9 @@
 #ifndef YARP_DEV_MAPGRID2D_H
 #define YARP_DEV_MAPGRID2D_H
 
+#include <cstdint>
 #include <string>
+#include <vector>
 
 #include <yarp/os/Portable.h>
 #include <yarp/os/ConnectionReader.h>
@@ -53,11 +55,23 @@ namespace yarp
                 double m_occupied_thresh;
                 double m_free_thresh;
 
+                //the sum of the enlargements performed by enlargeObstacles(), in meters
+                double m_enlargement;
+
+                //the distance of each cell from the closest obstacle, in meters. It is valid only
+                //until the flags of the map are changed.
+                yarp::sig::ImageOf<yarp::sig::PixelFloat> m_obstacle_distance;
+                bool   m_obstacle_distance_valid;
+
+                //if true, the layers are run-length encoded when the map is sent over the network
+                bool   m_compressed_data_over_network;
+
                 //std::vector<map_link> links_to_other_maps;
 
             private:
-                //performs an obstacles enlargement on the specified cell.
-                void enlargeCell(XYCell cell);
+                //recomputes the enlarged obstacles in the region [x0,x1)x[y0,y1), considering only the
+                //obstacles closer than the enlargement to the region.
+                void enlargeRegion(size_t x0, size_t y0, size_t x1, size_t y1, double size);
 
                 //conversion from pixel color to CellData and viceversa
                 CellData PixelToCellData(const yarp::sig::PixelRgb& pixin) const;
@@ -212,6 +226,31 @@ namespace yarp
                 */
                 bool   crop(int left, int top, int right, int bottom);
 
+                /**
+                * Copies a region of the map into another map. The origin of the region is set so that each cell keeps its world coordinates.
+                * @param top_left, bottom_right the corners of the region (expressed in pixel coordinates, included in the region).
+                * @param region the map which receives the region.
+                * @return true if the region is inside the map, false otherwise.
+                */
+                bool   getMapRegion(XYCell top_left, XYCell bottom_right, MapGrid2D& region) const;
+
+                /**
+                * Overwrites a region of the map with the content of another map, e.g. a region retrieved with getMapRegion().
+                * Only the occupancy and the flags of the cells are copied.
+                * @param top_left the position of the top-left corner of the region in the map (expressed in pixel coordinates).
+                * @param region the map to copy.
+                * @return true if the region fits inside the map, false otherwise.
+                */
+                bool   setMapRegion(XYCell top_left, const MapGrid2D& region);
+
+                /**
+                * Computes a hash of the content of each tile of the map, to find the parts in which two maps differ without transferring them.
+                * @param tile_size the side of the square tiles, expressed in cells. The tiles on the right and bottom borders may be smaller.
+                * @param hashes the hashes of the tiles, row by row.
+                * @return true if tile_size is valid, false otherwise.
+                */
+                bool   getTileHashes(size_t tile_size, std::vector<std::uint64_t>& hashes) const;
+
 #if 0
                 /**
                 * Checks if a cell is inside the map.
@@ -237,12 +276,37 @@ namespace yarp
                 /**
                 * Performs the obstacle enlargement operation. It's useful to set size to a value equal or larger to the radius of the robot bounding box.
                 * In this way a navigation algorithm can easily check obstacle collision by comparing the location of the center of the robot with cell value (free/occupied etc)
+                * The enlarged obstacles are all the free cells whose distance from an obstacle is not larger than size, so the enlargement is circular.
                 * @param size the size of the enlargement, in meters. If size>0 the requested enlargement is performed. If the function is called multiple times, the enlargement sums up.
                 If size <= 0 the enlargement stored in the map is cleaned up.
                 * @return true always.
                 */
                 bool   enlargeObstacles(double size);
 
+                /**
+                * Updates the obstacle enlargement around a region of the map, after its flags were changed (e.g. temporary obstacles were added or removed).
+                * It gives the same result of a new enlargement of the whole map, but only the cells around the region are processed.
+                * The enlargement is the sum of the sizes given to enlargeObstacles().
+                * @param top_left, bottom_right the corners of the region whose flags were changed (expressed in pixel coordinates).
+                * @return true if the region is inside the map, false otherwise.
+                */
+                bool   updateEnlargedObstacles(XYCell top_left, XYCell bottom_right);
+
+                /**
+                * Computes the distance of each cell from the closest obstacle, i.e. the closest cell which is not free, excluding the enlarged obstacles.
+                * The result is kept until the flags of the map are changed, and can be retrieved with getObstacleDistance().
+                * @return true always.
+                */
+                bool   computeObstacleDistance();
+
+                /**
+                * Retrieves the distance of a cell from the closest obstacle, as computed by computeObstacleDistance().
+                * @param cell the cell location, referred to the top-left corner of the map.
+                * @param distance the distance, in meters. It is infinity if the map contains no obstacles.
+                * @return true if the cell is inside the map and the distances are up to date, false otherwise.
+                */
+                bool   getObstacleDistance(XYCell cell, double& distance) const;
+
                 //-------------------------------file access functions-------------------------------
 
                 /**
@@ -259,6 +323,14 @@ namespace yarp
                 */
                 bool   saveToFile(std::string map_filename) const;
 
+                /**
+                * Enables the compression of the map when it is sent over the network. The occupancy and flags layers are run-length encoded,
+                * which is very effective with the large uniform areas of a typical map. Both formats are always accepted when a map is read.
+                * @param val true to enable the compression, false (default) to send the raw layers.
+                * @return true always.
+                */
+                bool   enable_map_compression_over_network(bool val);
+
                 /*
                 * Read vector from a connection.
                 * return true iff a vector was read correctly
@@ -0,0 +1,153 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/dev/impl/FrameTransformDelta.h>
+
+#include <yarp/os/NetFloat64.h>
+#include <yarp/os/NetUint16.h>
+#include <yarp/os/NetUint32.h>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+using yarp::dev::impl::FrameTransformDelta;
+using yarp::math::FrameTransform;
+
+constexpr std::int32_t FrameTransformDelta::keyframe_tag;
+constexpr std::int32_t FrameTransformDelta::delta_tag;
+
+namespace {
+
+template <typename T>
+inline void append(std::vector<char>& buffer, const T& value)
+{
+    const char* p = reinterpret_cast<const char*>(&value);
+    buffer.insert(buffer.end(), p, p + sizeof(T));
+}
+
+template <typename T>
+inline bool extract(const char*& cursor, const char* end, T& value)
+{
+    if (static_cast<size_t>(end - cursor) < sizeof(T)) {
+        return false;
+    }
+    std::memcpy(&value, cursor, sizeof(T));
+    cursor += sizeof(T);
+    return true;
+}
+
+} // namespace
+
+void FrameTransformDelta::appendValues(const FrameTransform& t)
+{
+    append(buffer, yarp::os::NetFloat64(t.timestamp));
+    append(buffer, yarp::os::NetFloat64(t.translation.tX));
+    append(buffer, yarp::os::NetFloat64(t.translation.tY));
+    append(buffer, yarp::os::NetFloat64(t.translation.tZ));
+    append(buffer, yarp::os::NetFloat64(t.rotation.w()));
+    append(buffer, yarp::os::NetFloat64(t.rotation.x()));
+    append(buffer, yarp::os::NetFloat64(t.rotation.y()));
+    append(buffer, yarp::os::NetFloat64(t.rotation.z()));
+}
+
+void FrameTransformDelta::appendString(const std::string& str)
+{
+    // Frame names longer than 64k are truncated
+    size_t len = std::min(str.size(), static_cast<size_t>(std::numeric_limits<std::uint16_t>::max()));
+    append(buffer, yarp::os::NetUint16(static_cast<std::uint16_t>(len)));
+    buffer.insert(buffer.end(), str.data(), str.data() + len);
+}
+
+void FrameTransformDelta::addDefine(std::uint32_t id, const FrameTransform& t)
+{
+    buffer.push_back(static_cast<char>(Record::Define));
+    append(buffer, yarp::os::NetUint32(id));
+    appendString(t.src_frame_id);
+    appendString(t.dst_frame_id);
+    appendValues(t);
+}
+
+void FrameTransformDelta::addUpdate(std::uint32_t id, const FrameTransform& t)
+{
+    buffer.push_back(static_cast<char>(Record::Update));
+    append(buffer, yarp::os::NetUint32(id));
+    appendValues(t);
+}
+
+void FrameTransformDelta::addRemove(std::uint32_t id)
+{
+    buffer.push_back(static_cast<char>(Record::Remove));
+    append(buffer, yarp::os::NetUint32(id));
+}
+
+
+FrameTransformDelta::Reader::Reader(const char* data, size_t size) :
+        cursor(data),
+        end(data + size)
+{
+}
+
+bool FrameTransformDelta::Reader::readValues(FrameTransform& t)
+{
+    yarp::os::NetFloat64 v[8];
+    for (auto& value : v) {
+        if (!extract(cursor, end, value)) {
+            return false;
+        }
+    }
+    t.timestamp = v[0];
+    t.translation.tX = v[1];
+    t.translation.tY = v[2];
+    t.translation.tZ = v[3];
+    t.rotation.w() = v[4];
+    t.rotation.x() = v[5];
+    t.rotation.y() = v[6];
+    t.rotation.z() = v[7];
+    return true;
+}
+
+bool FrameTransformDelta::Reader::readString(std::string& str)
+{
+    yarp::os::NetUint16 len;
+    if (!extract(cursor, end, len) || static_cast<size_t>(end - cursor) < len) {
+        return false;
+    }
+    str.assign(cursor, len);
+    cursor += len;
+    return true;
+}
+
+bool FrameTransformDelta::Reader::next(Record& type, std::uint32_t& id, FrameTransform& t)
+{
+    if (error || cursor == end) {
+        return false;
+    }
+
+    type = static_cast<Record>(*cursor++);
+    yarp::os::NetUint32 netId;
+    if (!extract(cursor, end, netId)) {
+        error = true;
+        return false;
+    }
+    id = netId;
+
+    switch (type) {
+    case Record::Define:
+        error = !readString(t.src_frame_id) || !readString(t.dst_frame_id) || !readValues(t);
+        break;
+    case Record::Update:
+        error = !readValues(t);
+        break;
+    case Record::Remove:
+        break;
+    default:
+        error = true;
+    }
+    return !error;
+}
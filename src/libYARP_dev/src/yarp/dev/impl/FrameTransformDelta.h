@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef YARP_DEV_IMPL_FRAMETRANSFORMDELTA_H
+#define YARP_DEV_IMPL_FRAMETRANSFORMDELTA_H
+
+#include <yarp/os/Vocab.h>
+#include <yarp/dev/api.h>
+#include <yarp/math/FrameTransform.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace yarp {
+namespace dev {
+namespace impl {
+
+/**
+ * The binary encoding of the transforms broadcast by the transformServer.
+ *
+ * The server sends a Bottle containing a tag (keyframe_tag or delta_tag),
+ * a sequence number (int32) and a blob with a list of records.
+ * Each transform is identified by a number assigned by the server when it
+ * is first sent.
+ * A keyframe contains all the transforms, and replaces the ones known by the
+ * receiver. A delta contains only the transforms added, changed or removed
+ * since the previous message.
+ *
+ * The layout of a record is:
+ * | Type    | Content                                             |
+ * |:-------:|:---------------------------------------------------:|
+ * | uint8   | type of record ('d' define, 'u' update, 'r' remove) |
+ * | uint32  | id of the transform                                 |
+ * | uint16  | length of src_frame_id (define only)                |
+ * | char    | src_frame_id (define only)                          |
+ * | uint16  | length of dst_frame_id (define only)                |
+ * | char    | dst_frame_id (define only)                          |
+ * | float64 | timestamp (define and update only)                  |
+ * | float64 | translation x y z (define and update only)          |
+ * | float64 | rotation w x y z (define and update only)           |
+ */
+class YARP_dev_API FrameTransformDelta
+{
+public:
+    static constexpr std::int32_t keyframe_tag = yarp::os::createVocab('t', 'f', 'k', 'f');
+    static constexpr std::int32_t delta_tag = yarp::os::createVocab('t', 'f', 'd', 't');
+
+    enum class Record : std::uint8_t
+    {
+        Define = 'd',
+        Update = 'u',
+        Remove = 'r'
+    };
+
+    void clear() { buffer.clear(); }
+    bool empty() const { return buffer.empty(); }
+    const char* data() const { return buffer.data(); }
+    size_t size() const { return buffer.size(); }
+
+    /**
+     * Add a transform not known by the receiver.
+     */
+    void addDefine(std::uint32_t id, const yarp::math::FrameTransform& t);
+
+    /**
+     * Change the values of a transform.
+     */
+    void addUpdate(std::uint32_t id, const yarp::math::FrameTransform& t);
+
+    void addRemove(std::uint32_t id);
+
+    /**
+     * Parser of the records of a message.
+     */
+    class YARP_dev_API Reader
+    {
+    public:
+        Reader(const char* data, size_t size);
+
+        /**
+         * Read the next record. For an update record, only the timestamp
+         * and the values of \c t are set.
+         *
+         * @return false at the end of the message, or if it is malformed
+         */
+        bool next(Record& type, std::uint32_t& id, yarp::math::FrameTransform& t);
+
+        /**
+         * @return true if the message is malformed.
+         */
+        bool isError() const { return error; }
+
+    private:
+        bool readValues(yarp::math::FrameTransform& t);
+        bool readString(std::string& str);
+
+        const char* cursor;
+        const char* end;
+        bool error {false};
+    };
+
+private:
+    void appendValues(const yarp::math::FrameTransform& t);
+    void appendString(const std::string& str);
+
+    std::vector<char> buffer;
+};
+
+} // namespace impl
+} // namespace dev
+} // namespace yarp
+
+#endif // YARP_DEV_IMPL_FRAMETRANSFORMDELTA_H
@@ -0,0 +1,141 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/dev/impl/StreamingCommand.h>
+
+#include <yarp/os/ConnectionReader.h>
+#include <yarp/os/ConnectionWriter.h>
+
+#include <algorithm>
+#include <cstring>
+
+using yarp::dev::impl::StreamingCommand;
+
+constexpr std::int32_t StreamingCommand::tag;
+constexpr size_t StreamingCommand::max_axes;
+
+namespace {
+inline size_t maskWords(size_t axes)
+{
+    return (axes + 31) / 32;
+}
+} // namespace
+
+void StreamingCommand::reset(std::int32_t command, size_t axes, double timestamp)
+{
+    this->command = command;
+    this->axes = axes;
+    this->timestamp = timestamp;
+    mask.assign(maskWords(axes), 0);
+}
+
+bool StreamingCommand::setSingle(std::int32_t command, size_t axes, int j, double ref, double timestamp)
+{
+    reset(command, axes, timestamp);
+    refs.clear();
+    if (j < 0 || static_cast<size_t>(j) >= axes) {
+        return false;
+    }
+    mask[j >> 5] |= 1U << (j & 31);
+    refs.push_back(ref);
+    return true;
+}
+
+void StreamingCommand::setAll(std::int32_t command, size_t axes, const double* refs, double timestamp)
+{
+    reset(command, axes, timestamp);
+    std::fill(mask.begin(), mask.end(), ~0U);
+    if (axes % 32 != 0) {
+        mask.back() = (1U << (axes % 32)) - 1;
+    }
+    this->refs.resize(axes);
+    std::memcpy(this->refs.data(), refs, sizeof(double) * axes);
+}
+
+bool StreamingCommand::setGroup(std::int32_t command, size_t axes, int n_joints, const int* joints, const double* refs, double timestamp)
+{
+    reset(command, axes, timestamp);
+    this->refs.clear();
+
+    // Sort the references by joint number, through a per axis array
+    scratch.resize(axes);
+    for (int i = 0; i < n_joints; i++) {
+        int j = joints[i];
+        if (j < 0 || static_cast<size_t>(j) >= axes) {
+            std::fill(mask.begin(), mask.end(), 0U);
+            return false;
+        }
+        mask[j >> 5] |= 1U << (j & 31);
+        scratch[j] = refs[i];
+    }
+    for (size_t j = 0; j < axes; j++) {
+        if (isSelected(j)) {
+            this->refs.push_back(scratch[j]);
+        }
+    }
+    return true;
+}
+
+bool StreamingCommand::readPayload(yarp::os::ConnectionReader& connection)
+{
+    command = connection.expectInt32();
+    std::int32_t n = connection.expectInt32();
+    std::int32_t m = connection.expectInt32();
+    timestamp = connection.expectFloat64();
+    if (n < 0 || static_cast<size_t>(n) > max_axes || m < 0 || m > n) {
+        return false;
+    }
+    axes = static_cast<size_t>(n);
+
+    // Resizing does not allocate, once the first message was received
+    mask.resize(maskWords(axes));
+    refs.resize(static_cast<size_t>(m));
+    // Each word is read on its own, to convert it from the network byte order
+    for (auto& word : mask) {
+        word = static_cast<std::uint32_t>(connection.expectInt32());
+    }
+    for (auto& ref : refs) {
+        ref = connection.expectFloat64();
+    }
+    if (connection.isError()) {
+        return false;
+    }
+
+    // Check that the mask is consistent with the number of references
+    size_t count = 0;
+    for (size_t j = 0; j < axes; j++) {
+        if (isSelected(j)) {
+            count++;
+        }
+    }
+    return count == refs.size();
+}
+
+bool StreamingCommand::read(yarp::os::ConnectionReader& connection)
+{
+    if (connection.expectInt32() != tag) {
+        return false;
+    }
+    return readPayload(connection);
+}
+
+bool StreamingCommand::write(yarp::os::ConnectionWriter& connection) const
+{
+    connection.appendInt32(tag);
+    connection.appendInt32(command);
+    connection.appendInt32(static_cast<std::int32_t>(axes));
+    connection.appendInt32(static_cast<std::int32_t>(refs.size()));
+    connection.appendFloat64(timestamp);
+    for (auto word : mask) {
+        connection.appendInt32(static_cast<std::int32_t>(word));
+    }
+    for (auto ref : refs) {
+        connection.appendFloat64(ref);
+    }
+    return !connection.isError();
+}
@@ -0,0 +1,127 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef YARP_DEV_IMPL_STREAMINGCOMMAND_H
+#define YARP_DEV_IMPL_STREAMINGCOMMAND_H
+
+#include <yarp/os/Portable.h>
+#include <yarp/os/Vocab.h>
+#include <yarp/dev/api.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace yarp {
+namespace dev {
+namespace impl {
+
+/**
+ * A streaming command for the controlboardwrapper2, with a fixed binary
+ * layout.
+ *
+ * The remote_controlboard sends it on the command port instead of a
+ * CommandMessage (i.e. a PortablePair<Bottle, Vector>), when the wrapper
+ * supports it (protocol version 1.9.1 or later).
+ * The joints commanded are selected by a bit mask, and the references are
+ * sorted by joint number, so that the receiver can map them to the
+ * subdevices without parsing a Bottle or allocating memory.
+ *
+ * The layout on the wire is:
+ * | Type    | Content                               |
+ * |:-------:|:-------------------------------------:|
+ * | int32   | StreamingCommand::tag                 |
+ * | int32   | command vocab                         |
+ * | int32   | number of axes (n)                    |
+ * | int32   | number of references (m)              |
+ * | float64 | timestamp                             |
+ * | int32   | joint mask, (n + 31) / 32 words       |
+ * | float64 | references, m values                  |
+ *
+ * As in the other YARP messages, each value is in the network byte order.
+ */
+class YARP_dev_API StreamingCommand : public yarp::os::Portable
+{
+public:
+    /**
+     * The first word of the message, used to tell it apart from a
+     * CommandMessage, that starts with BOTTLE_TAG_LIST.
+     */
+    static constexpr std::int32_t tag = yarp::os::createVocab('s', 'c', 'm', 'd');
+
+    /**
+     * The maximum number of axes accepted when reading a command.
+     */
+    static constexpr size_t max_axes = 4096;
+
+    /**
+     * Command the joint \c j only.
+     *
+     * @return false if the joint is out of range.
+     */
+    bool setSingle(std::int32_t command, size_t axes, int j, double ref, double timestamp);
+
+    /**
+     * Command all the joints.
+     */
+    void setAll(std::int32_t command, size_t axes, const double* refs, double timestamp);
+
+    /**
+     * Command the joints listed in \c joints, in any order.
+     * If a joint is listed more than once, the last reference is used.
+     *
+     * @return false if a joint is out of range.
+     */
+    bool setGroup(std::int32_t command, size_t axes, int n_joints, const int* joints, const double* refs, double timestamp);
+
+    std::int32_t getCommand() const { return command; }
+    size_t getAxes() const { return axes; }
+    double getTimestamp() const { return timestamp; }
+
+    /**
+     * @return true if the joint \c j is commanded.
+     */
+    bool isSelected(size_t j) const
+    {
+        return (mask[j >> 5] >> (j & 31)) & 1U;
+    }
+
+    /**
+     * @return the number of joints commanded.
+     */
+    size_t getCount() const { return refs.size(); }
+
+    /**
+     * @return the references of the joints commanded, sorted by joint number.
+     */
+    const double* getReferences() const { return refs.data(); }
+
+    /**
+     * Read the message, after its tag.
+     */
+    bool readPayload(yarp::os::ConnectionReader& connection);
+
+    bool read(yarp::os::ConnectionReader& connection) override;
+    bool write(yarp::os::ConnectionWriter& connection) const override;
+
+private:
+    void reset(std::int32_t command, size_t axes, double timestamp);
+
+    std::int32_t command {0};
+    size_t axes {0};
+    double timestamp {0.0};
+    std::vector<std::uint32_t> mask;
+    std::vector<double> refs;
+    std::vector<double> scratch;
+};
+
+} // namespace impl
+} // namespace dev
+} // namespace yarp
+
+#endif // YARP_DEV_IMPL_STREAMINGCOMMAND_H
@@ -218,6 +218,105 @@ LoggerEngine::logger_thread::logger_thread (std::string _portname, double _perio
         unknown_format_received      = 0;
 }
 
+namespace {
+// Fills a message with the fields forwarded by yarp::os::Log, either parsed
+// from a string (single message) or received as a list (batch of messages)
+void fill_message_entry(const yarp::os::Searchable& p, MessageEntry& body)
+{
+    body.text = p.find("message").toString();
+
+    auto level = p.find("level").toString();
+    if (level == "TRACE") {
+        body.level = LOGLEVEL_TRACE;
+    } else if (level == "DEBUG") {
+        body.level = LOGLEVEL_DEBUG;
+    } else if (level == "INFO") {
+        body.level = LOGLEVEL_INFO;
+    } else if (level == "WARNING") {
+        body.level = LOGLEVEL_WARNING;
+    } else if (level == "ERROR") {
+        body.level = LOGLEVEL_ERROR;
+    } else if (level == "FATAL") {
+        body.level = LOGLEVEL_FATAL;
+    } else {
+        body.level = LOGLEVEL_UNDEFINED;
+    }
+
+    if (p.check("filename")) {
+        body.filename = p.find("filename").asString();
+    } else {
+        body.filename.clear();
+    }
+
+    if (p.check("line")) {
+        body.line = static_cast<uint32_t>(p.find("line").asInt32());
+    } else {
+        body.line = 0;
+    }
+
+    if (p.check("function")) {
+        body.function = p.find("function").asString();
+    } else {
+        body.function.clear();
+    }
+
+    if (p.check("hostname")) {
+        body.hostname = p.find("hostname").asString();
+    } else {
+        body.hostname.clear();
+    }
+
+    if (p.check("pid")) {
+        body.pid = p.find("pid").asInt32();
+    } else {
+        body.pid = 0;
+    }
+
+    if (p.check("cmd")) {
+        body.cmd = p.find("cmd").asString();
+    } else {
+        body.cmd.clear();
+    }
+
+    if (p.check("args")) {
+        body.args = p.find("args").asString();
+    } else {
+        body.args.clear();
+    }
+
+    if (p.check("thread_id")) {
+        body.thread_id = p.find("thread_id").asInt64();
+    } else {
+        body.thread_id = 0;
+    }
+
+    if (p.check("component")) {
+        body.component = p.find("component").asString();
+    } else {
+        body.component.clear();
+    }
+
+    if (p.check("systemtime")) {
+        body.systemtime = p.find("systemtime").asFloat64();
+    } else {
+        body.systemtime = 0.0;
+    }
+
+    if (p.check("networktime")) {
+        body.networktime = p.find("networktime").asFloat64();
+    } else {
+        body.networktime = 0.0;
+        body.yarprun_timestamp.clear();
+    }
+
+    if (p.check("backtrace")) {
+        body.backtrace = p.find("backtrace").asString();
+    } else {
+        body.backtrace.clear();
+    }
+}
+} // namespace
+
 void LoggerEngine::logger_thread::run()
 {
     //if (is_discovering()==true)
@@ -249,239 +348,160 @@ void LoggerEngine::logger_thread::run()
                 return;
             }
 
-            if (b->size()!=2)
+            if (b->size()<2 || !b->get(0).isString())
             {
                 fprintf (stderr, "ERROR: unknown log format!\n");
                 unknown_format_received++;
                 continue;
             }
 
-            std::string bottlestring = b->toString();
-            std::string header;
+            std::string header = b->get(0).asString();
 
-            if (b->get(0).isString())
-            {
-                header = b->get(0).asString();
-            }
-            else
-            {
-                fprintf(stderr, "ERROR: unknown log format!\n");
-                unknown_format_received++;
-                continue;
-            }
-
-            MessageEntry body;
-
-            char ttstr [20];
-            static int count=0;
-            sprintf(ttstr,"%d",count++);
-            body.yarprun_timestamp = string(ttstr);
-            body.local_timestamp   = machine_current_time_s;
-
-            std::string s;
-
-            if (b->get(1).isString())
+            auto new_message_entry = [&]()
             {
-                s = b->get(1).asString();
-            }
-            else
+                MessageEntry body;
+                char ttstr [20];
+                static int count=0;
+                sprintf(ttstr,"%d",count++);
+                body.yarprun_timestamp = string(ttstr);
+                body.local_timestamp   = machine_current_time_s;
+                return body;
+            };
+
+            auto append_message_entry = [&](MessageEntry& body)
             {
-                fprintf(stderr, "ERROR: unknown log format!\n");
-                unknown_format_received++;
-                continue;
-            }
-
-            yarp::os::Property p(s.c_str());
-
-            if (p.check("level")) {
-                body.text = p.find("message").toString();
-
-                auto level = p.find("level").toString();
-                if (level == "TRACE") {
-                    body.level = LOGLEVEL_TRACE;
-                } else if (level == "DEBUG") {
-                    body.level = LOGLEVEL_DEBUG;
-                } else if (level == "INFO") {
-                    body.level = LOGLEVEL_INFO;
-                } else if (level == "WARNING") {
-                    body.level = LOGLEVEL_WARNING;
-                } else if (level == "ERROR") {
-                    body.level = LOGLEVEL_ERROR;
-                } else if (level == "FATAL") {
-                    body.level = LOGLEVEL_FATAL;
-                } else {
-                    body.level = LOGLEVEL_UNDEFINED;
-                }
-
-                if (p.check("filename")) {
-                    body.filename = p.find("filename").asString();
-                } else {
-                    body.filename.clear();
-                }
-
-                if (p.check("line")) {
-                    body.line = static_cast<uint32_t>(p.find("line").asInt32());
-                } else {
-                    body.line = 0;
-                }
-
-                if (p.check("function")) {
-                    body.function = p.find("function").asString();
-                } else {
-                    body.function.clear();
-                }
-
-                if (p.check("hostname")) {
-                    body.hostname = p.find("hostname").asString();
-                } else {
-                    body.hostname.clear();
-                }
-
-                if (p.check("pid")) {
-                    body.pid = p.find("pid").asInt32();
-                } else {
-                    body.pid = 0;
-                }
-
-                if (p.check("cmd")) {
-                    body.cmd = p.find("cmd").asString();
-                } else {
-                    body.cmd.clear();
-                }
-
-                if (p.check("args")) {
-                    body.args = p.find("args").asString();
-                } else {
-                    body.args.clear();
-                }
-
-                if (p.check("thread_id")) {
-                    body.thread_id = p.find("thread_id").asInt64();
-                } else {
-                    body.thread_id = 0;
+                if (body.level == LOGLEVEL_UNDEFINED && listen_to_LOGLEVEL_UNDEFINED == false) {return;}
+                if (body.level == LOGLEVEL_TRACE     && listen_to_LOGLEVEL_TRACE     == false) {return;}
+                if (body.level == LOGLEVEL_DEBUG     && listen_to_LOGLEVEL_DEBUG     == false) {return;}
+                if (body.level == LOGLEVEL_INFO      && listen_to_LOGLEVEL_INFO      == false) {return;}
+                if (body.level == LOGLEVEL_WARNING   && listen_to_LOGLEVEL_WARNING   == false) {return;}
+                if (body.level == LOGLEVEL_ERROR     && listen_to_LOGLEVEL_ERROR     == false) {return;}
+                if (body.level == LOGLEVEL_FATAL     && listen_to_LOGLEVEL_FATAL     == false) {return;}
+
+                std::lock_guard<std::mutex> lock(this->mutex);
+                LogEntry entry;
+                entry.logInfo.port_complete = header;
+                entry.logInfo.port_complete.erase(0,1);
+                entry.logInfo.port_complete.erase(entry.logInfo.port_complete.size()-1);
+                std::istringstream iss(header);
+                std::string token;
+                getline(iss, token, '/');
+                getline(iss, token, '/'); entry.logInfo.port_system  = token;
+                getline(iss, token, '/'); entry.logInfo.port_prefix  = "/"+ token;
+                getline(iss, token, '/'); entry.logInfo.process_name = token;
+                getline(iss, token, '/'); entry.logInfo.process_pid  = token.erase(token.size()-1);
+                if (entry.logInfo.port_system == "log" && listen_to_YARP_MESSAGES==false)    return;
+                if (entry.logInfo.port_system == "yarprunlog" && listen_to_YARPRUN_MESSAGES==false) return;
+
+                std::list<LogEntry>::iterator it;
+                for (it = log_list.begin(); it != log_list.end(); it++)
+                {
+                    if (it->logInfo.port_complete==entry.logInfo.port_complete)
+                    {
+                        if (it->logging_enabled)
+                        {
+                            it->logInfo.setNewError(body.level);
+                            it->logInfo.last_update=machine_current_time;
+                            it->append_logEntry(body);
+                        }
+                        else
+                        {
+                            //just skipping this message
+                        }
+                        break;
+                    }
                 }
-
-                if (p.check("component")) {
-                    body.component = p.find("component").asString();
-                } else {
-                    body.component.clear();
+                if (it == log_list.end())
+                {
+                    if (log_list.size() < log_list_max_size || log_list_max_size_enabled==false )
+                    {
+                        yarp::os::Contact contact = yarp::os::Network::queryName(entry.logInfo.port_complete);
+                        if (contact.isValid())
+                        {
+                            entry.logInfo.setNewError(body.level);
+                            entry.logInfo.ip_address = contact.getHost();
+                        }
+                        else
+                        {
+                            printf("ERROR: invalid contact: %s\n", entry.logInfo.port_complete.c_str());
+                        };
+                        entry.append_logEntry(body);
+                        entry.logInfo.last_update=machine_current_time;
+                        log_list.push_back(entry);
+                    }
+                    //else
+                    //{
+                    //    printf("WARNING: exceeded log_list_max_size=%d\n",log_list_max_size);
+                    //}
                 }
+            };
 
-                if (p.check("systemtime")) {
-                    body.systemtime = p.find("systemtime").asFloat64();
-                } else {
-                    body.systemtime = 0.0;
+            if (b->get(1).isString())
+            {
+                // A single message, formatted as a string
+                if (b->size()!=2)
+                {
+                    fprintf (stderr, "ERROR: unknown log format!\n");
+                    unknown_format_received++;
+                    continue;
                 }
 
-                if (p.check("networktime")) {
-                    body.networktime = p.find("networktime").asFloat64();
-                } else {
-                    body.networktime = 0.0;
-                    body.yarprun_timestamp.clear();
-                }
+                MessageEntry body = new_message_entry();
+                std::string s = b->get(1).asString();
+                yarp::os::Property p(s.c_str());
 
-                if (p.check("backtrace")) {
-                    body.backtrace = p.find("backtrace").asString();
+                if (p.check("level")) {
+                    fill_message_entry(p, body);
                 } else {
-                    body.backtrace.clear();
-                }
-            } else {
-                // This is plain output forwarded by yarprun
-                // Perhaps at some point yarprun could be formatting it properly
-                // But for now we just try to extract the level information
-                body.text = s;
-                body.level = LOGLEVEL_UNDEFINED;
-
-                size_t str = s.find('[',0);
-                size_t end = s.find(']',0);
-                if (str==std::string::npos || end==std::string::npos )
-                {
-                    body.level = LOGLEVEL_UNDEFINED;
-                }
-                else if (str==0)
-                {
-                    std::string level = s.substr(str,end+1);
-                    body.level = LOGLEVEL_UNDEFINED;
-                    if      (level.find("TRACE")!=std::string::npos)   body.level = LOGLEVEL_TRACE;
-                    else if (level.find("DEBUG")!=std::string::npos)   body.level = LOGLEVEL_DEBUG;
-                    else if (level.find("INFO")!=std::string::npos)    body.level = LOGLEVEL_INFO;
-                    else if (level.find("WARNING")!=std::string::npos) body.level = LOGLEVEL_WARNING;
-                    else if (level.find("ERROR")!=std::string::npos)   body.level = LOGLEVEL_ERROR;
-                    else if (level.find("FATAL")!=std::string::npos)   body.level = LOGLEVEL_FATAL;
-                    body.text = s.substr(end+1);
-                }
-                else
-                {
+                    // This is plain output forwarded by yarprun
+                    // Perhaps at some point yarprun could be formatting it properly
+                    // But for now we just try to extract the level information
+                    body.text = s;
                     body.level = LOGLEVEL_UNDEFINED;
-                }
-            }
 
-            if (body.level == LOGLEVEL_UNDEFINED && listen_to_LOGLEVEL_UNDEFINED == false) {continue;}
-            if (body.level == LOGLEVEL_TRACE     && listen_to_LOGLEVEL_TRACE     == false) {continue;}
-            if (body.level == LOGLEVEL_DEBUG     && listen_to_LOGLEVEL_DEBUG     == false) {continue;}
-            if (body.level == LOGLEVEL_INFO      && listen_to_LOGLEVEL_INFO      == false) {continue;}
-            if (body.level == LOGLEVEL_WARNING   && listen_to_LOGLEVEL_WARNING   == false) {continue;}
-            if (body.level == LOGLEVEL_ERROR     && listen_to_LOGLEVEL_ERROR     == false) {continue;}
-            if (body.level == LOGLEVEL_FATAL     && listen_to_LOGLEVEL_FATAL     == false) {continue;}
-
-            this->mutex.lock();
-            LogEntry entry;
-            entry.logInfo.port_complete = header;
-            entry.logInfo.port_complete.erase(0,1);
-            entry.logInfo.port_complete.erase(entry.logInfo.port_complete.size()-1);
-            std::istringstream iss(header);
-            std::string token;
-            getline(iss, token, '/');
-            getline(iss, token, '/'); entry.logInfo.port_system  = token;
-            getline(iss, token, '/'); entry.logInfo.port_prefix  = "/"+ token;
-            getline(iss, token, '/'); entry.logInfo.process_name = token;
-            getline(iss, token, '/'); entry.logInfo.process_pid  = token.erase(token.size()-1);
-            if (entry.logInfo.port_system == "log" && listen_to_YARP_MESSAGES==false)    continue;
-            if (entry.logInfo.port_system == "yarprunlog" && listen_to_YARPRUN_MESSAGES==false) continue;
-
-            std::list<LogEntry>::iterator it;
-            for (it = log_list.begin(); it != log_list.end(); it++)
-            {
-                if (it->logInfo.port_complete==entry.logInfo.port_complete)
-                {
-                    if (it->logging_enabled)
+                    size_t str = s.find('[',0);
+                    size_t end = s.find(']',0);
+                    if (str==std::string::npos || end==std::string::npos )
                     {
-                        it->logInfo.setNewError(body.level);
-                        it->logInfo.last_update=machine_current_time;
-                        it->append_logEntry(body);
+                        body.level = LOGLEVEL_UNDEFINED;
+                    }
+                    else if (str==0)
+                    {
+                        std::string level = s.substr(str,end+1);
+                        body.level = LOGLEVEL_UNDEFINED;
+                        if      (level.find("TRACE")!=std::string::npos)   body.level = LOGLEVEL_TRACE;
+                        else if (level.find("DEBUG")!=std::string::npos)   body.level = LOGLEVEL_DEBUG;
+                        else if (level.find("INFO")!=std::string::npos)    body.level = LOGLEVEL_INFO;
+                        else if (level.find("WARNING")!=std::string::npos) body.level = LOGLEVEL_WARNING;
+                        else if (level.find("ERROR")!=std::string::npos)   body.level = LOGLEVEL_ERROR;
+                        else if (level.find("FATAL")!=std::string::npos)   body.level = LOGLEVEL_FATAL;
+                        body.text = s.substr(end+1);
                     }
                     else
                     {
-                        //just skipping this message
+                        body.level = LOGLEVEL_UNDEFINED;
                     }
-                    break;
                 }
+                append_message_entry(body);
             }
-            if (it == log_list.end())
+            else
             {
-                if (log_list.size() < log_list_max_size || log_list_max_size_enabled==false )
+                // A batch of messages, each one a list of (key value) pairs
+                for (size_t i = 1; i < b->size(); i++)
                 {
-                    yarp::os::Contact contact = yarp::os::Network::queryName(entry.logInfo.port_complete);
-                    if (contact.isValid())
+                    Bottle* record = b->get(i).asList();
+                    if (record == nullptr || !record->check("level"))
                     {
-                        entry.logInfo.setNewError(body.level);
-                        entry.logInfo.ip_address = contact.getHost();
+                        fprintf (stderr, "ERROR: unknown log format!\n");
+                        unknown_format_received++;
+                        continue;
                     }
-                    else
-                    {
-                        printf("ERROR: invalid contact: %s\n", entry.logInfo.port_complete.c_str());
-                    };
-                    entry.append_logEntry(body);
-                    entry.logInfo.last_update=machine_current_time;
-                    log_list.push_back(entry);
+
+                    MessageEntry body = new_message_entry();
+                    fill_message_entry(*record, body);
+                    append_message_entry(body);
                 }
-                //else
-                //{
-                //    printf("WARNING: exceeded log_list_max_size=%d\n",log_list_max_size);
-                //}
             }
-
-            this->mutex.unlock();
         }
     }
 
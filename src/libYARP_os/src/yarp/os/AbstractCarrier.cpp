@@ -16,6 +16,8 @@
 #include <yarp/os/SizedWriter.h>
 #include <yarp/os/impl/LogComponent.h>
 
+#include <vector>
+
 using namespace yarp::os;
 using namespace yarp::os::impl;
 
@@ -227,20 +229,29 @@ bool AbstractCarrier::sendSenderSpecifier(ConnectionState& proto)
 
 bool AbstractCarrier::defaultSendIndex(ConnectionState& proto, SizedWriter& writer)
 {
-    writeYarpInt(10, proto);
+    char buf[8];
+    Bytes header(&(buf[0]), sizeof(buf));
+    createYarpNumber(10, header);
     int len = (int)writer.length();
     char lens[] = {(char)len, (char)1, (char)-1, (char)-1, (char)-1, (char)-1, (char)-1, (char)-1, (char)-1, (char)-1};
-    Bytes b(lens, 10);
-    OutputStream& os = proto.os();
-    os.write(b);
-    NetInt32 numberSrc;
-    Bytes number((char*)&numberSrc, sizeof(NetInt32));
+    // Block lengths, followed by a 0 for the (empty) reply lengths.  Most
+    // messages have just a few blocks, therefore the heap is rarely needed.
+    NetInt32 fewNumbers[16];
+    std::vector<NetInt32> manyNumbers;
+    NetInt32* numbers = fewNumbers;
+    if (len + 1 > 16) {
+        manyNumbers.resize(len + 1);
+        numbers = manyNumbers.data();
+    }
     for (int i = 0; i < len; i++) {
-        NetType::netInt((int)writer.length(i), number);
-        os.write(number);
+        numbers[i] = static_cast<NetInt32>(writer.length(i));
     }
-    NetType::netInt(0, number);
-    os.write(number);
+    numbers[len] = 0;
+    Bytes blocks[] = {header,
+                      Bytes(lens, 10),
+                      Bytes(reinterpret_cast<char*>(numbers), (len + 1) * sizeof(NetInt32))};
+    OutputStream& os = proto.os();
+    os.writev(blocks, 3);
     return os.isOk();
 }
 
@@ -272,11 +283,14 @@ bool AbstractCarrier::defaultExpectIndex(ConnectionState& proto)
 {
     yCDebug(ABSTRACTCARRIER, "expecting an index");
     yCDebug(ABSTRACTCARRIER, "ConnectionState::expectIndex for %s", proto.getRoute().toString().c_str());
-    // expect index header
+    // expect index header and secondary header
     char buf[8];
     Bytes header((char*)&buf[0], sizeof(buf));
-    yarp::conf::ssize_t r = proto.is().readFull(header);
-    if ((size_t)r != header.length()) {
+    char buf2[10];
+    Bytes indexHeader((char*)&buf2[0], sizeof(buf2));
+    Bytes headers[] = {header, indexHeader};
+    yarp::conf::ssize_t r = proto.is().readvFull(headers, 2);
+    if ((size_t)r != header.length() + indexHeader.length()) {
         yCDebug(ABSTRACTCARRIER, "broken index");
         return false;
     }
@@ -290,39 +304,30 @@ bool AbstractCarrier::defaultExpectIndex(ConnectionState& proto)
         return false;
     }
     yCDebug(ABSTRACTCARRIER, "index coming in happily...");
-    char buf2[10];
-    Bytes indexHeader((char*)&buf2[0], sizeof(buf2));
-    r = proto.is().readFull(indexHeader);
-    if ((size_t)r != indexHeader.length()) {
-        yCDebug(ABSTRACTCARRIER, "broken index, secondary header");
-        return false;
-    }
-    yCDebug(ABSTRACTCARRIER, "secondary header came in happily...");
     int inLen = (unsigned char)(indexHeader.get()[0]);
     int outLen = (unsigned char)(indexHeader.get()[1]);
     // Big limit on number of blocks here!  Inherited from QNX.
     // should make it go away if it hurts someone.
 
-    int total = 0;
-    NetInt32 numberSrc;
-    Bytes number((char*)&numberSrc, sizeof(NetInt32));
-    for (int i = 0; i < inLen; i++) {
-        yarp::conf::ssize_t l = proto.is().readFull(number);
-        if ((size_t)l != number.length()) {
-            yCDebug(ABSTRACTCARRIER, "bad input block length");
-            return false;
-        }
-        int x = NetType::netInt(number);
-        total += x;
+    // Read all the block lengths at once
+    NetInt32 fewNumbers[16];
+    std::vector<NetInt32> manyNumbers;
+    NetInt32* numbers = fewNumbers;
+    if (inLen + outLen > 16) {
+        manyNumbers.resize(inLen + outLen);
+        numbers = manyNumbers.data();
     }
-    for (int i2 = 0; i2 < outLen; i2++) {
-        yarp::conf::ssize_t l = proto.is().readFull(number);
-        if ((size_t)l != number.length()) {
-            yCDebug(ABSTRACTCARRIER, "bad output block length");
+    Bytes lengths(reinterpret_cast<char*>(numbers), (inLen + outLen) * sizeof(NetInt32));
+    if (lengths.length() > 0) {
+        yarp::conf::ssize_t l = proto.is().readFull(lengths);
+        if ((size_t)l != lengths.length()) {
+            yCDebug(ABSTRACTCARRIER, "bad block lengths");
             return false;
         }
-        int x = NetType::netInt(number);
-        total += x;
+    }
+    int total = 0;
+    for (int i = 0; i < inLen + outLen; i++) {
+        total += numbers[i];
     }
     proto.setRemainingLength(total);
     yCDebug(ABSTRACTCARRIER, "Total message length: %d", total);
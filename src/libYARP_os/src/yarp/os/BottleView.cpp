@@ -0,0 +1,651 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/os/BottleView.h>
+
+#include <yarp/os/ConnectionReader.h>
+#include <yarp/os/NetFloat32.h>
+#include <yarp/os/NetFloat64.h>
+#include <yarp/os/NetInt16.h>
+#include <yarp/os/NetInt32.h>
+#include <yarp/os/NetInt64.h>
+#include <yarp/os/NetInt8.h>
+#include <yarp/os/Vocab.h>
+#include <yarp/os/impl/LogComponent.h>
+
+#include <algorithm>
+#include <cinttypes>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+using yarp::os::Bottle;
+using yarp::os::BottleView;
+using yarp::os::ConnectionReader;
+using yarp::os::Value;
+
+namespace {
+YARP_OS_LOG_COMPONENT(BOTTLEVIEW, "yarp.os.BottleView")
+
+constexpr std::int32_t unitMask = BOTTLE_TAG_INT8 | BOTTLE_TAG_INT16 | BOTTLE_TAG_INT32 |
+                                  BOTTLE_TAG_INT64 | BOTTLE_TAG_FLOAT32 | BOTTLE_TAG_FLOAT64 |
+                                  BOTTLE_TAG_VOCAB | BOTTLE_TAG_STRING | BOTTLE_TAG_BLOB;
+constexpr std::int32_t groupMask = BOTTLE_TAG_LIST | BOTTLE_TAG_DICT;
+
+// Size of the raw data of fixed size items, 0 for the others
+size_t fixedSize(std::int32_t code)
+{
+    switch (code) {
+    case BOTTLE_TAG_INT8:
+        return 1;
+    case BOTTLE_TAG_INT16:
+        return 2;
+    case BOTTLE_TAG_INT32:
+    case BOTTLE_TAG_VOCAB:
+    case BOTTLE_TAG_FLOAT32:
+        return 4;
+    case BOTTLE_TAG_INT64:
+    case BOTTLE_TAG_FLOAT64:
+        return 8;
+    default:
+        return 0;
+    }
+}
+
+template <typename NetT>
+NetT load(const char* data)
+{
+    NetT x;
+    std::memcpy(&x, data, sizeof(NetT));
+    return x;
+}
+
+void appendInt32(std::string& out, std::int32_t value)
+{
+    yarp::os::NetInt32 x = value;
+    out.append(reinterpret_cast<const char*>(&x), sizeof(x));
+}
+
+} // namespace
+
+
+/*
+ * The index contains an Item for each item in the Bottle, and one for the
+ * Bottle itself (at index 0). The items of each list are contiguous.
+ *
+ * The raw data of an item starts at `begin` and ends at `end`, and it is
+ * the same that the corresponding Storable reads with readRaw():
+ *  - fixed size items: the value
+ *  - strings and blobs: the length, then the data
+ *  - lists: the number of items, then the items, with their codes unless
+ *    the list is specialized
+ *  - dictionaries: a full Bottle, including its code
+ */
+class BottleView::Private
+{
+public:
+    struct Item
+    {
+        std::int32_t code;
+        std::uint32_t begin;
+        std::uint32_t end;
+        // Lists and dictionaries only
+        std::int32_t subCode; // The code of all the items, or 0
+        std::uint32_t first;  // The index of the first item
+        std::uint32_t count;  // The number of items
+        std::uint32_t items;  // The position of the first item in the data
+    };
+
+    std::vector<char> storage;
+    const char* data {nullptr};
+    size_t length {0};
+    std::vector<Item> index;
+    bool valid {false};
+
+    void clear();
+    bool parse(const char* buf, size_t len);
+    bool copyFrom(ConnectionReader& reader);
+
+    static const Item* item(const Private* priv, size_type list, size_type i)
+    {
+        if (priv == nullptr || !priv->valid) {
+            return nullptr;
+        }
+        const Item& l = priv->index[list];
+        return (i < l.count) ? &priv->index[l.first + i] : nullptr;
+    }
+
+    template <typename T>
+    static T number(const Private* priv, size_type list, size_type i);
+
+    bool slice(std::string& out, size_type list) const;
+
+private:
+    bool parseBottle(size_t& pos, size_type slot);
+    bool parseItems(size_t& pos, size_type slot);
+    bool parseItem(size_t& pos, std::int32_t code, size_type slot);
+    bool readInt32(size_t& pos, std::int32_t& value) const;
+
+    bool copyInt32(ConnectionReader& reader, std::int32_t& value);
+    bool copyBlock(ConnectionReader& reader, size_t len);
+    bool copyBottle(ConnectionReader& reader);
+    bool copyItems(ConnectionReader& reader, std::int32_t subCode);
+    bool copyItem(ConnectionReader& reader, std::int32_t code);
+};
+
+
+bool BottleView::Private::readInt32(size_t& pos, std::int32_t& value) const
+{
+    if (length - pos < sizeof(std::int32_t)) {
+        return false;
+    }
+    value = static_cast<std::int32_t>(load<NetInt32>(data + pos));
+    pos += sizeof(std::int32_t);
+    return true;
+}
+
+void BottleView::Private::clear()
+{
+    data = nullptr;
+    length = 0;
+    index.clear();
+    valid = false;
+}
+
+bool BottleView::Private::parse(const char* buf, size_t len)
+{
+    clear();
+    data = buf;
+    length = len;
+
+    if (len > std::numeric_limits<std::uint32_t>::max()) {
+        yCError(BOTTLEVIEW, "Bottle too large to be indexed (%zu bytes)", len);
+        return false;
+    }
+
+    size_t pos = 0;
+    index.resize(1);
+    if (!parseBottle(pos, 0) || pos != length) {
+        yCError(BOTTLEVIEW, "Invalid binary Bottle");
+        index.clear();
+        return false;
+    }
+    valid = true;
+    return true;
+}
+
+// A Bottle with its header, as written at the top level and in a dictionary
+bool BottleView::Private::parseBottle(size_t& pos, size_type slot)
+{
+    size_t begin = pos;
+    std::int32_t code = 0;
+    if (!readInt32(pos, code)) {
+        return false;
+    }
+    std::int32_t count = 0;
+    if (!readInt32(pos, count)) {
+        return false;
+    }
+    index[slot].subCode = code & unitMask;
+    index[slot].begin = static_cast<std::uint32_t>(begin);
+    index[slot].count = static_cast<std::uint32_t>(count);
+    if (count < 0 || static_cast<size_t>(count) > length - pos) {
+        // Each item takes at least one byte
+        return false;
+    }
+    if (!parseItems(pos, slot)) {
+        return false;
+    }
+    index[slot].code = BOTTLE_TAG_LIST | index[slot].subCode;
+    index[slot].end = static_cast<std::uint32_t>(pos);
+    return true;
+}
+
+bool BottleView::Private::parseItems(size_t& pos, size_type slot)
+{
+    size_t first = index.size();
+    std::uint32_t count = index[slot].count;
+    std::int32_t subCode = index[slot].subCode;
+    index[slot].first = static_cast<std::uint32_t>(first);
+    index[slot].items = static_cast<std::uint32_t>(pos);
+
+    // Each item takes at least 4 bytes for its code, or one byte in the
+    // specialized lists. Each item in the index has its own bytes in the
+    // message, so the index cannot be longer than the message.
+    size_t minSize = (subCode == 0) ? sizeof(NetInt32) : std::max<size_t>(1, fixedSize(subCode));
+    if (count > (length - pos) / minSize || first + count > length + 1) {
+        return false;
+    }
+    index.resize(first + count);
+
+    for (std::uint32_t i = 0; i < count; ++i) {
+        std::int32_t code = subCode;
+        if (code == 0 && !readInt32(pos, code)) {
+            return false;
+        }
+        if (!parseItem(pos, code, first + i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool BottleView::Private::parseItem(size_t& pos, std::int32_t code, size_type slot)
+{
+    Item it {code, static_cast<std::uint32_t>(pos), 0, 0, 0, 0, 0};
+
+    size_t size = fixedSize(code);
+    if (size != 0) {
+        if (length - pos < size) {
+            return false;
+        }
+        pos += size;
+    } else if (code == BOTTLE_TAG_STRING || code == BOTTLE_TAG_BLOB) {
+        std::int32_t len = 0;
+        if (!readInt32(pos, len) || len < 0 || static_cast<size_t>(len) > length - pos) {
+            return false;
+        }
+        pos += len;
+    } else if ((code & BOTTLE_TAG_DICT) != 0) {
+        index[slot] = it;
+        if (!parseBottle(pos, slot)) {
+            return false;
+        }
+        index[slot].code = code;
+        return true;
+    } else if ((code & BOTTLE_TAG_LIST) != 0) {
+        std::int32_t count = 0;
+        if (!readInt32(pos, count) || count < 0 || static_cast<size_t>(count) > length - pos) {
+            return false;
+        }
+        it.subCode = code & unitMask;
+        it.count = static_cast<std::uint32_t>(count);
+        index[slot] = it;
+        if (!parseItems(pos, slot)) {
+            return false;
+        }
+        index[slot].end = static_cast<std::uint32_t>(pos);
+        return true;
+    } else {
+        yCError(BOTTLEVIEW, "Unrecognized object code %" PRId32, code);
+        return false;
+    }
+
+    it.end = static_cast<std::uint32_t>(pos);
+    index[slot] = it;
+    return true;
+}
+
+
+bool BottleView::Private::copyInt32(ConnectionReader& reader, std::int32_t& value)
+{
+    value = reader.expectInt32();
+    if (reader.isError()) {
+        return false;
+    }
+    NetInt32 x = value;
+    const char* p = reinterpret_cast<const char*>(&x);
+    storage.insert(storage.end(), p, p + sizeof(x));
+    return true;
+}
+
+bool BottleView::Private::copyBlock(ConnectionReader& reader, size_t len)
+{
+    if (len == 0) {
+        return true;
+    }
+    size_t pos = storage.size();
+    storage.resize(pos + len);
+    return reader.expectBlock(storage.data() + pos, len) && !reader.isError();
+}
+
+bool BottleView::Private::copyBottle(ConnectionReader& reader)
+{
+    std::int32_t code = 0;
+    if (!copyInt32(reader, code)) {
+        return false;
+    }
+    return copyItems(reader, code & unitMask);
+}
+
+bool BottleView::Private::copyItems(ConnectionReader& reader, std::int32_t subCode)
+{
+    std::int32_t count = 0;
+    if (!copyInt32(reader, count) || count < 0) {
+        return false;
+    }
+    for (std::int32_t i = 0; i < count; ++i) {
+        std::int32_t code = subCode;
+        if (code == 0 && !copyInt32(reader, code)) {
+            return false;
+        }
+        if (!copyItem(reader, code)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool BottleView::Private::copyItem(ConnectionReader& reader, std::int32_t code)
+{
+    size_t size = fixedSize(code);
+    if (size != 0) {
+        return copyBlock(reader, size);
+    }
+    if (code == BOTTLE_TAG_STRING || code == BOTTLE_TAG_BLOB) {
+        std::int32_t len = 0;
+        if (!copyInt32(reader, len) || len < 0 || static_cast<size_t>(len) > reader.getSize()) {
+            return false;
+        }
+        return copyBlock(reader, len);
+    }
+    if ((code & BOTTLE_TAG_DICT) != 0) {
+        return copyBottle(reader);
+    }
+    if ((code & BOTTLE_TAG_LIST) != 0) {
+        return copyItems(reader, code & unitMask);
+    }
+    yCError(BOTTLEVIEW, "Reader failed, unrecognized object code %" PRId32, code);
+    return false;
+}
+
+// Copy exactly the bytes of the Bottle, that could be followed by other data
+bool BottleView::Private::copyFrom(ConnectionReader& reader)
+{
+    storage.clear();
+    return copyBottle(reader);
+}
+
+
+template <typename T>
+T BottleView::Private::number(const Private* priv, size_type list, size_type i)
+{
+    const Item* it = item(priv, list, i);
+    if (it == nullptr) {
+        return 0;
+    }
+    const char* p = priv->data + it->begin;
+    switch (it->code) {
+    case BOTTLE_TAG_INT8:
+        return static_cast<T>(load<NetInt8>(p));
+    case BOTTLE_TAG_INT16:
+        return static_cast<T>(load<NetInt16>(p));
+    case BOTTLE_TAG_INT32:
+    case BOTTLE_TAG_VOCAB:
+        return static_cast<T>(load<NetInt32>(p));
+    case BOTTLE_TAG_INT64:
+        return static_cast<T>(load<NetInt64>(p));
+    case BOTTLE_TAG_FLOAT32:
+        return static_cast<T>(load<NetFloat32>(p));
+    case BOTTLE_TAG_FLOAT64:
+        return static_cast<T>(load<NetFloat64>(p));
+    default:
+        return 0;
+    }
+}
+
+// Build the binary representation of a list, as a top level Bottle
+bool BottleView::Private::slice(std::string& out, size_type list) const
+{
+    if (!valid) {
+        return false;
+    }
+    const Item& l = index[list];
+    out.clear();
+    appendInt32(out, BOTTLE_TAG_LIST | l.subCode);
+    appendInt32(out, static_cast<std::int32_t>(l.count));
+    out.append(data + l.items, l.end - l.items);
+    return true;
+}
+
+
+BottleView::BottleView() :
+        mPriv(std::make_shared<Private>()),
+        list(0)
+{
+}
+
+BottleView::BottleView(std::shared_ptr<Private> storage, size_type list) :
+        mPriv(std::move(storage)),
+        list(list)
+{
+}
+
+BottleView::BottleView(const BottleView& rhs) = default;
+
+BottleView::BottleView(BottleView&& rhs) noexcept = default;
+
+BottleView& BottleView::operator=(const BottleView& rhs) = default;
+
+BottleView& BottleView::operator=(BottleView&& rhs) noexcept = default;
+
+BottleView::~BottleView() = default;
+
+bool BottleView::read(ConnectionReader& reader)
+{
+    // The data can still be used by other views, in this case it is left
+    // to them.
+    if (!mPriv || mPriv.use_count() > 1) {
+        mPriv = std::make_shared<Private>();
+    }
+    list = 0;
+
+    if (reader.isTextMode()) {
+        Bottle bot;
+        if (!bot.read(reader)) {
+            mPriv->clear();
+            return false;
+        }
+        size_t len = 0;
+        const char* buf = bot.toBinary(&len);
+        mPriv->storage.assign(buf, buf + len);
+    } else if (!mPriv->copyFrom(reader)) {
+        mPriv->clear();
+        return false;
+    }
+    return mPriv->parse(mPriv->storage.data(), mPriv->storage.size());
+}
+
+bool BottleView::fromBinary(const char* buf, size_t len)
+{
+    if (!mPriv || mPriv.use_count() > 1) {
+        mPriv = std::make_shared<Private>();
+    }
+    list = 0;
+    return mPriv->parse(buf, len);
+}
+
+bool BottleView::isValid() const
+{
+    return mPriv && mPriv->valid;
+}
+
+BottleView::size_type BottleView::size() const
+{
+    return isValid() ? mPriv->index[list].count : 0;
+}
+
+std::int32_t BottleView::getCode(size_type index) const
+{
+    const auto* it = Private::item(mPriv.get(), list, index);
+    return (it != nullptr) ? it->code : 0;
+}
+
+bool BottleView::isInt8(size_type index) const
+{
+    return getCode(index) == BOTTLE_TAG_INT8;
+}
+
+bool BottleView::isInt16(size_type index) const
+{
+    return getCode(index) == BOTTLE_TAG_INT16;
+}
+
+bool BottleView::isInt32(size_type index) const
+{
+    return getCode(index) == BOTTLE_TAG_INT32;
+}
+
+bool BottleView::isInt64(size_type index) const
+{
+    return getCode(index) == BOTTLE_TAG_INT64;
+}
+
+bool BottleView::isFloat32(size_type index) const
+{
+    return getCode(index) == BOTTLE_TAG_FLOAT32;
+}
+
+bool BottleView::isFloat64(size_type index) const
+{
+    return getCode(index) == BOTTLE_TAG_FLOAT64;
+}
+
+bool BottleView::isVocab(size_type index) const
+{
+    return getCode(index) == BOTTLE_TAG_VOCAB;
+}
+
+bool BottleView::isString(size_type index) const
+{
+    return getCode(index) == BOTTLE_TAG_STRING;
+}
+
+bool BottleView::isBlob(size_type index) const
+{
+    return getCode(index) == BOTTLE_TAG_BLOB;
+}
+
+bool BottleView::isList(size_type index) const
+{
+    std::int32_t code = getCode(index);
+    return (code & groupMask) == BOTTLE_TAG_LIST;
+}
+
+bool BottleView::isDict(size_type index) const
+{
+    return (getCode(index) & BOTTLE_TAG_DICT) != 0;
+}
+
+std::int8_t BottleView::asInt8(size_type index) const
+{
+    return Private::number<std::int8_t>(mPriv.get(), list, index);
+}
+
+std::int16_t BottleView::asInt16(size_type index) const
+{
+    return Private::number<std::int16_t>(mPriv.get(), list, index);
+}
+
+std::int32_t BottleView::asInt32(size_type index) const
+{
+    return Private::number<std::int32_t>(mPriv.get(), list, index);
+}
+
+std::int64_t BottleView::asInt64(size_type index) const
+{
+    return Private::number<std::int64_t>(mPriv.get(), list, index);
+}
+
+yarp::conf::float32_t BottleView::asFloat32(size_type index) const
+{
+    return Private::number<yarp::conf::float32_t>(mPriv.get(), list, index);
+}
+
+yarp::conf::float64_t BottleView::asFloat64(size_type index) const
+{
+    return Private::number<yarp::conf::float64_t>(mPriv.get(), list, index);
+}
+
+std::int32_t BottleView::asVocab(size_type index) const
+{
+    const auto* it = Private::item(mPriv.get(), list, index);
+    if (it == nullptr || (it->code != BOTTLE_TAG_VOCAB && it->code != BOTTLE_TAG_INT32)) {
+        return 0;
+    }
+    return Private::number<std::int32_t>(mPriv.get(), list, index);
+}
+
+std::string BottleView::asString(size_type index) const
+{
+    if (isVocab(index)) {
+        return yarp::os::Vocab::decode(asVocab(index));
+    }
+    if (!isString(index)) {
+        return {};
+    }
+    return std::string(asBlob(index), asBlobLength(index));
+}
+
+const char* BottleView::asBlob(size_type index) const
+{
+    const auto* it = Private::item(mPriv.get(), list, index);
+    if (it == nullptr || (it->code != BOTTLE_TAG_STRING && it->code != BOTTLE_TAG_BLOB)) {
+        return nullptr;
+    }
+    return mPriv->data + it->begin + sizeof(std::int32_t);
+}
+
+size_t BottleView::asBlobLength(size_type index) const
+{
+    const auto* it = Private::item(mPriv.get(), list, index);
+    if (it == nullptr || (it->code != BOTTLE_TAG_STRING && it->code != BOTTLE_TAG_BLOB)) {
+        return 0;
+    }
+    return it->end - it->begin - sizeof(std::int32_t);
+}
+
+BottleView BottleView::asList(size_type index) const
+{
+    const auto* it = Private::item(mPriv.get(), list, index);
+    if (it == nullptr || (it->code & groupMask) == 0) {
+        return BottleView();
+    }
+    return BottleView(mPriv, static_cast<size_type>(it - mPriv->index.data()));
+}
+
+Value BottleView::get(size_type index) const
+{
+    const auto* it = Private::item(mPriv.get(), list, index);
+    if (it == nullptr) {
+        return Value::getNullValue();
+    }
+
+    // A Bottle with just this item
+    std::string buf;
+    appendInt32(buf, BOTTLE_TAG_LIST);
+    appendInt32(buf, 1);
+    appendInt32(buf, it->code);
+    buf.append(mPriv->data + it->begin, it->end - it->begin);
+    Bottle bot;
+    bot.fromBinary(buf.data(), buf.size());
+    return bot.get(0);
+}
+
+bool BottleView::toBottle(Bottle& bottle) const
+{
+    bottle.clear();
+    std::string buf;
+    if (!isValid() || !mPriv->slice(buf, list)) {
+        return false;
+    }
+    bottle.fromBinary(buf.data(), buf.size());
+    return true;
+}
+
+Bottle BottleView::toBottle() const
+{
+    Bottle bottle;
+    toBottle(bottle);
+    return bottle;
+}
+
+std::string BottleView::toString() const
+{
+    return toBottle().toString();
+}
@@ -0,0 +1,189 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef YARP_OS_BOTTLEVIEW_H
+#define YARP_OS_BOTTLEVIEW_H
+
+#include <yarp/os/Bottle.h>
+#include <yarp/os/PortReader.h>
+#include <yarp/os/Value.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace yarp {
+namespace os {
+
+/**
+ * \ingroup key_class
+ *
+ * \brief A read-only view over a Bottle in binary form.
+ *
+ * The binary representation of the Bottle is validated and indexed once,
+ * when it is read, and the items are decoded only when they are accessed,
+ * without building the Value objects of a Bottle.
+ * This is convenient when only a few items of a message are used, for
+ * example the command vocab of an RPC message, or a few fields of a large
+ * state message.
+ *
+ * The data read from a connection is stored in a buffer owned by the view,
+ * that is reused for the following reads. fromBinary() instead does not
+ * copy the data.
+ *
+ * The views returned by asList() share the data with the view they come
+ * from, and remain valid even after the original view is destroyed or
+ * reads a new message.
+ *
+ * A full Bottle, or a Value for a single item, can be obtained on demand
+ * with toBottle() and get().
+ */
+class YARP_os_API BottleView : public PortReader
+{
+public:
+    using size_type = size_t;
+
+    /**
+     * Constructor. The view is empty and invalid until something is read.
+     */
+    BottleView();
+
+    BottleView(const BottleView& rhs);
+    BottleView(BottleView&& rhs) noexcept;
+    BottleView& operator=(const BottleView& rhs);
+    BottleView& operator=(BottleView&& rhs) noexcept;
+    ~BottleView() override;
+
+    /**
+     * Read a Bottle from a connection and index it.
+     * In text mode, the Bottle is parsed and converted to binary first.
+     *
+     * @param reader the connection
+     * @return true if the data is a valid Bottle
+     */
+    bool read(ConnectionReader& reader) override;
+
+    /**
+     * Index a Bottle in binary form (as returned by Bottle::toBinary()).
+     * The data is not copied, and must remain valid as long as this view
+     * and the views obtained from it are used.
+     *
+     * @param buf the binary representation of the Bottle
+     * @param len the length of the data
+     * @return true if the data is a valid Bottle
+     */
+    bool fromBinary(const char* buf, size_t len);
+
+    /**
+     * Check if the view contains a valid Bottle.
+     */
+    bool isValid() const;
+
+    /**
+     * Get the number of items in the view.
+     */
+    size_type size() const;
+
+    /**
+     * Get the type code of an item (one of the BOTTLE_TAG_* values).
+     * @return the code, or 0 if the index is out of range
+     */
+    std::int32_t getCode(size_type index) const;
+
+    bool isInt8(size_type index) const;
+    bool isInt16(size_type index) const;
+    bool isInt32(size_type index) const;
+    bool isInt64(size_type index) const;
+    bool isFloat32(size_type index) const;
+    bool isFloat64(size_type index) const;
+    bool isVocab(size_type index) const;
+    bool isString(size_type index) const;
+    bool isBlob(size_type index) const;
+    bool isList(size_type index) const;
+    bool isDict(size_type index) const;
+
+    /**
+     * Get a numeric item. Numbers of other types (and vocabs) are
+     * converted, any other item returns 0.
+     */
+    std::int8_t asInt8(size_type index) const;
+    std::int16_t asInt16(size_type index) const;
+    std::int32_t asInt32(size_type index) const;
+    std::int64_t asInt64(size_type index) const;
+    yarp::conf::float32_t asFloat32(size_type index) const;
+    yarp::conf::float64_t asFloat64(size_type index) const;
+
+    /**
+     * Get a vocab item, or an integer item as a vocab.
+     * @return the vocab, or 0 for any other item
+     */
+    std::int32_t asVocab(size_type index) const;
+
+    /**
+     * Get a string item, or a vocab converted to a string.
+     * @return the string, or an empty string for any other item
+     */
+    std::string asString(size_type index) const;
+
+    /**
+     * Get the data of a blob or of a string item, without copying it.
+     * The string is not null terminated.
+     * @return the data, or nullptr for any other item
+     */
+    const char* asBlob(size_type index) const;
+
+    /**
+     * Get the length of a blob or of a string item.
+     */
+    size_t asBlobLength(size_type index) const;
+
+    /**
+     * Get a view over a nested list, or over the key/value pairs of a
+     * dictionary.
+     * @return the view, or an invalid view for any other item
+     */
+    BottleView asList(size_type index) const;
+
+    /**
+     * Decode a single item.
+     * @return the item, or a null Value if the index is out of range
+     */
+    Value get(size_type index) const;
+
+    /**
+     * Decode all the items in a Bottle.
+     * @param[out] bottle the Bottle
+     * @return true on success
+     */
+    bool toBottle(Bottle& bottle) const;
+
+    /**
+     * Decode all the items in a Bottle.
+     */
+    Bottle toBottle() const;
+
+    /**
+     * Gives a human-readable textual representation of the items.
+     */
+    std::string toString() const;
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+private:
+    class Private;
+
+    BottleView(std::shared_ptr<Private> storage, size_type list);
+
+    YARP_SUPPRESS_DLL_INTERFACE_WARNING_ARG(std::shared_ptr<Private>) mPriv;
+    size_type list; // Index of the list item this view refers to
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+};
+
+} // namespace os
+} // namespace yarp
+
+#endif // YARP_OS_BOTTLEVIEW_H
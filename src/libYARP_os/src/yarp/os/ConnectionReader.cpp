@@ -15,6 +15,13 @@ using namespace yarp::os::impl;
 
 ConnectionReader::~ConnectionReader() = default;
 
+const char* ConnectionReader::expectSharedBlock(size_t len, std::shared_ptr<void>& owner)
+{
+    YARP_UNUSED(len);
+    YARP_UNUSED(owner);
+    return nullptr;
+}
+
 Bytes ConnectionReader::readEnvelope()
 {
     return {nullptr, 0};
@@ -16,6 +16,7 @@
 #include <yarp/os/Contact.h>
 #include <yarp/os/Searchable.h>
 
+#include <memory>
 #include <string>
 
 namespace yarp {
@@ -53,6 +54,20 @@ public:
      */
     virtual bool expectBlock(char* data, size_t len) = 0;
 
+    /**
+     * Read a block of data without copying it, if the connection shares
+     * memory with the sender (e.g. a shared memory carrier).
+     *
+     * If the block is not available this way, nothing is read, and
+     * expectBlock should be used instead.
+     *
+     * @param len Length of the block of data
+     * @param[out] owner Keeps the block of data valid until it is destroyed
+     *
+     * @return a pointer to the block of data, or nullptr if not available
+     */
+    virtual const char* expectSharedBlock(size_t len, std::shared_ptr<void>& owner);
+
     /**
      * Read some text from the network connection.
      * @param terminatingChar The marker for the end of the text
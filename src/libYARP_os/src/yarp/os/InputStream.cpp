@@ -112,6 +112,26 @@ yarp::conf::ssize_t InputStream::readFull(Bytes& b)
     return (result <= 0) ? -1 : fullLen;
 }
 
+yarp::conf::ssize_t InputStream::readvFull(Bytes* blocks, size_t count)
+{
+    yarp::conf::ssize_t total = 0;
+    for (size_t i = 0; i < count; i++) {
+        yarp::conf::ssize_t result = readFull(blocks[i]);
+        if (result < 0) {
+            return -1;
+        }
+        total += result;
+    }
+    return total;
+}
+
+const char* InputStream::readShared(size_t len, std::shared_ptr<void>& owner)
+{
+    YARP_UNUSED(len);
+    YARP_UNUSED(owner);
+    return nullptr;
+}
+
 yarp::conf::ssize_t InputStream::readDiscard(size_t len)
 {
     if (len < 100) {
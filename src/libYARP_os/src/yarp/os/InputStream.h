@@ -14,6 +14,7 @@
 
 #include <yarp/os/api.h>
 
+#include <memory>
 #include <string>
 
 namespace yarp {
@@ -116,6 +117,31 @@ public:
      */
     yarp::conf::ssize_t readFull(Bytes& b);
 
+    /**
+     * Keep reading until all the blocks are full.  Streams that support
+     * scatter-gather I/O can fill all the blocks at once.
+     * By default, this calls readFull(Bytes& b) for each block.
+     *
+     * @param[out] blocks the blocks of data to read to
+     * @param count the number of blocks
+     *
+     * @return the total number of bytes read, or -1 upon error
+     */
+    virtual yarp::conf::ssize_t readvFull(yarp::os::Bytes* blocks, size_t count);
+
+    /**
+     * Read a block of data without copying it, if the stream shares
+     * memory with the writer.  If the next block of data is not available
+     * this way, nothing is read.
+     * By default, this returns nullptr.
+     *
+     * @param len the length of the block
+     * @param[out] owner keeps the block valid until it is destroyed
+     *
+     * @return a pointer to the block, or nullptr if not available
+     */
+    virtual const char* readShared(size_t len, std::shared_ptr<void>& owner);
+
     /**
      * Read and discard a fixed number of bytes.
      */
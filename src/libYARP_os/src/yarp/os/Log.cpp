@@ -341,7 +341,7 @@ inline void forwardable_output(std::ostream* ost,
     *ost << " (systemtime " << yarp::os::NetType::toString(systemtime)  << ")";
     *ost << " (networktime " << yarp::os::NetType::toString(networktime)  << ")";
     if (customtime != 0.0) {
-        *ost << "(customtime " << yarp::os::NetType::toString(customtime) << ")";
+        *ost << " (customtime " << yarp::os::NetType::toString(customtime) << ")";
     }
     if (yarp::os::impl::LogPrivate::forward_codeinfo.load()) {
         *ost << " (filename " << yarp::os::impl::StoreString::quotedString(file) << ")";
@@ -623,9 +623,34 @@ void yarp::os::impl::LogPrivate::forward_callback(yarp::os::Log::LogType t,
         // And avoid creating the LogForwarder!
         return;
     }
-    std::stringstream stringstream_buffer;
-    forwardable_output(&stringstream_buffer, t, msg, file, line, func, systemtime, networktime, customtime, comp_name);
-    LogForwarder::getInstance().forward(stringstream_buffer.str());
+
+    // Only the fields are copied here, the message is formatted by the
+    // LogForwarder thread
+    LogForwarder::Record record;
+    record.level = logTypeToString(t);
+    record.message = msg;
+    record.systemtime = systemtime;
+    record.networktime = networktime;
+    record.customtime = customtime;
+    if (yarp::os::impl::LogPrivate::forward_codeinfo.load()) {
+        record.codeinfo = true;
+        record.filename = (file ? file : "");
+        record.line = line;
+        record.function = (func ? func : "");
+    }
+    record.hostname = yarp::os::impl::LogPrivate::forward_hostname.load();
+    if (yarp::os::impl::LogPrivate::forward_processinfo.load()) {
+        thread_local long thread_id(yarp::os::impl::ThreadImpl::getKeyOfCaller());
+        record.processinfo = true;
+        record.thread_id = thread_id;
+    }
+    if (comp_name) {
+        record.component = comp_name;
+    }
+    if (t == yarp::os::Log::FatalType || yarp::os::impl::LogPrivate::forward_backtrace.load()) {
+        record.backtrace = backtrace();
+    }
+    LogForwarder::getInstance().forward(std::move(record));
 }
 
 void yarp::os::impl::LogPrivate::log(yarp::os::Log::LogType type,
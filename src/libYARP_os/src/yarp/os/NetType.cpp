@@ -13,10 +13,22 @@
 #include <yarp/os/impl/LogComponent.h>
 
 #include <clocale>
+#include <cstdint>
 #include <cstdlib>
 #include <cstring>
+#include <initializer_list>
 #include <limits>
 
+// The crc of large buffers is computed with PCLMULQDQ when the processor
+// supports it
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#    define YARP_CRC_PCLMUL 1
+#    include <cpuid.h>
+#    include <immintrin.h>
+#else
+#    define YARP_CRC_PCLMUL 0
+#endif
+
 
 /*
  * The maximum string length for a 'double' printed as a string using ("%.*g", DECIMAL_DIG) will be:
@@ -197,33 +209,42 @@ yarp::conf::float64_t NetType::toFloat64(std::string&& s)
 /*
   PNG's nice and simple CRC code
   (from http://www.w3.org/TR/PNG-CRCAppendix.html)
+  extended to process 8 bytes at a time ("slicing-by-8"), using 8 tables:
+  crc_table[k][n] is the CRC of the byte n followed by k zero bytes.
 */
 
-/* Table of CRCs of all 8-bit messages. */
-static unsigned long crc_table[256];
-
-/* Flag: has the table been computed? Initially false. */
-static int crc_table_computed = 0;
+namespace {
 
-/* Make the table for a fast CRC. */
-static void make_crc_table()
+struct CrcTables
 {
-    unsigned long c;
-    int n;
-    int k;
-
-    for (n = 0; n < 256; n++) {
-        c = (unsigned long)n;
-        for (k = 0; k < 8; k++) {
-            if ((c & 1) != 0) {
-                c = 0xedb88320L ^ (c >> 1);
-            } else {
-                c = c >> 1;
+    std::uint32_t table[8][256];
+
+    CrcTables()
+    {
+        for (std::uint32_t n = 0; n < 256; n++) {
+            std::uint32_t c = n;
+            for (int k = 0; k < 8; k++) {
+                if ((c & 1) != 0) {
+                    c = 0xedb88320L ^ (c >> 1);
+                } else {
+                    c = c >> 1;
+                }
+            }
+            table[0][n] = c;
+        }
+        for (std::uint32_t n = 0; n < 256; n++) {
+            for (int k = 1; k < 8; k++) {
+                std::uint32_t c = table[k - 1][n];
+                table[k][n] = table[0][c & 0xff] ^ (c >> 8);
             }
         }
-        crc_table[n] = c;
     }
-    crc_table_computed = 1;
+};
+
+const CrcTables& crc_tables()
+{
+    static const CrcTables tables;
+    return tables;
 }
 
 /* Update a running CRC with the bytes buf[0..len-1]--the CRC
@@ -231,20 +252,154 @@ static void make_crc_table()
    is the 1's complement of the final running CRC (see the
    crc() routine below)). */
 
-static unsigned long update_crc(unsigned long crc, unsigned char* buf, size_t len)
+std::uint32_t update_crc_slice8(std::uint32_t c, const unsigned char* buf, size_t len)
+{
+    const auto& t = crc_tables().table;
+    while (len >= 8) {
+        // Little endian loads, the compiler merges them on little endian
+        // machines
+        std::uint32_t lo = c ^ (static_cast<std::uint32_t>(buf[0]) |
+                                static_cast<std::uint32_t>(buf[1]) << 8 |
+                                static_cast<std::uint32_t>(buf[2]) << 16 |
+                                static_cast<std::uint32_t>(buf[3]) << 24);
+        std::uint32_t hi = (static_cast<std::uint32_t>(buf[4]) |
+                            static_cast<std::uint32_t>(buf[5]) << 8 |
+                            static_cast<std::uint32_t>(buf[6]) << 16 |
+                            static_cast<std::uint32_t>(buf[7]) << 24);
+        c = t[7][lo & 0xff] ^ t[6][(lo >> 8) & 0xff] ^ t[5][(lo >> 16) & 0xff] ^ t[4][lo >> 24] ^
+            t[3][hi & 0xff] ^ t[2][(hi >> 8) & 0xff] ^ t[1][(hi >> 16) & 0xff] ^ t[0][hi >> 24];
+        buf += 8;
+        len -= 8;
+    }
+    while (len > 0) {
+        c = t[0][(c ^ *buf) & 0xff] ^ (c >> 8);
+        buf++;
+        len--;
+    }
+    return c;
+}
+
+#if YARP_CRC_PCLMUL
+/*
+  CRC of large buffers on x86 processors with carry-less multiplication,
+  folding 4 blocks of 16 bytes in parallel, and reducing the result with
+  Barrett reduction, as described in "Fast CRC Computation for Generic
+  Polynomials Using PCLMULQDQ Instruction" (Intel, 2009).
+  len must be at least 64 and a multiple of 16.
+*/
+__attribute__((target("pclmul,sse4.1")))
+std::uint32_t update_crc_pclmul(std::uint32_t crc, const unsigned char* buf, size_t len)
 {
+    // Constants for the bit-reflected polynomial 0xedb88320
+    alignas(16) static const std::uint64_t k1k2[] = {0x0154442bd4, 0x01c6e41596};
+    alignas(16) static const std::uint64_t k3k4[] = {0x01751997d0, 0x00ccaa009e};
+    alignas(16) static const std::uint64_t k5k0[] = {0x0163cd6124, 0x0000000000};
+    alignas(16) static const std::uint64_t poly[] = {0x01db710641, 0x01f7011641};
+
+    __m128i x0;
+    __m128i x1;
+    __m128i x2;
+    __m128i x3;
+    __m128i x4;
+    __m128i x5;
+
+    x1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + 0x00));
+    x2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + 0x10));
+    x3 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + 0x20));
+    x4 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + 0x30));
+    x1 = _mm_xor_si128(x1, _mm_cvtsi32_si128(static_cast<int>(crc)));
+    x0 = _mm_load_si128(reinterpret_cast<const __m128i*>(k1k2));
+    buf += 64;
+    len -= 64;
+
+    // Fold 64 bytes at a time
+    while (len >= 64) {
+        __m128i x6;
+        __m128i x7;
+        __m128i x8;
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x6 = _mm_clmulepi64_si128(x2, x0, 0x00);
+        x7 = _mm_clmulepi64_si128(x3, x0, 0x00);
+        x8 = _mm_clmulepi64_si128(x4, x0, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x2 = _mm_clmulepi64_si128(x2, x0, 0x11);
+        x3 = _mm_clmulepi64_si128(x3, x0, 0x11);
+        x4 = _mm_clmulepi64_si128(x4, x0, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, x5), _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + 0x00)));
+        x2 = _mm_xor_si128(_mm_xor_si128(x2, x6), _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + 0x10)));
+        x3 = _mm_xor_si128(_mm_xor_si128(x3, x7), _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + 0x20)));
+        x4 = _mm_xor_si128(_mm_xor_si128(x4, x8), _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf + 0x30)));
+        buf += 64;
+        len -= 64;
+    }
 
-    unsigned long c = crc;
-    size_t n;
+    // Fold the 4 blocks into one
+    x0 = _mm_load_si128(reinterpret_cast<const __m128i*>(k3k4));
+    for (__m128i next : {x2, x3, x4}) {
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, next), x5);
+    }
 
-    if (crc_table_computed == 0) {
-        make_crc_table();
+    // Fold the remaining blocks of 16 bytes
+    while (len >= 16) {
+        x5 = _mm_clmulepi64_si128(x1, x0, 0x00);
+        x1 = _mm_clmulepi64_si128(x1, x0, 0x11);
+        x1 = _mm_xor_si128(_mm_xor_si128(x1, _mm_loadu_si128(reinterpret_cast<const __m128i*>(buf))), x5);
+        buf += 16;
+        len -= 16;
     }
-    for (n = 0; n < len; n++) {
-        c = crc_table[(c ^ buf[n]) & 0xff] ^ (c >> 8);
+
+    // Fold 128 bits to 64 bits
+    x2 = _mm_clmulepi64_si128(x1, x0, 0x10);
+    x3 = _mm_setr_epi32(~0, 0, ~0, 0);
+    x1 = _mm_srli_si128(x1, 8);
+    x1 = _mm_xor_si128(x1, x2);
+    x0 = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(k5k0));
+    x2 = _mm_srli_si128(x1, 4);
+    x1 = _mm_and_si128(x1, x3);
+    x1 = _mm_clmulepi64_si128(x1, x0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    // Barrett reduction to 32 bits
+    x0 = _mm_load_si128(reinterpret_cast<const __m128i*>(poly));
+    x2 = _mm_and_si128(x1, x3);
+    x2 = _mm_clmulepi64_si128(x2, x0, 0x10);
+    x2 = _mm_and_si128(x2, x3);
+    x2 = _mm_clmulepi64_si128(x2, x0, 0x00);
+    x1 = _mm_xor_si128(x1, x2);
+
+    return static_cast<std::uint32_t>(_mm_extract_epi32(x1, 1));
+}
+
+bool has_pclmul()
+{
+    unsigned int eax = 0;
+    unsigned int ebx = 0;
+    unsigned int ecx = 0;
+    unsigned int edx = 0;
+    if (__get_cpuid(1, &eax, &ebx, &ecx, &edx) == 0) {
+        return false;
     }
-    return c;
+    return (ecx & bit_PCLMUL) != 0 && (ecx & bit_SSE4_1) != 0;
 }
+#endif // YARP_CRC_PCLMUL
+
+std::uint32_t update_crc(std::uint32_t c, const unsigned char* buf, size_t len)
+{
+#if YARP_CRC_PCLMUL
+    static const bool pclmul = has_pclmul();
+    if (pclmul && len >= 64) {
+        size_t blocks = len & ~static_cast<size_t>(15);
+        c = update_crc_pclmul(c, buf, blocks);
+        buf += blocks;
+        len -= blocks;
+    }
+#endif
+    return update_crc_slice8(c, buf, len);
+}
+
+} // namespace
 
 /* Return the CRC of the bytes buf[0..len-1]. */
 unsigned long NetType::getCrc(char* buf, size_t len)
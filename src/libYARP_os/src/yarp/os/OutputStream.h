@@ -12,6 +12,8 @@
 
 #include <yarp/os/api.h>
 
+#include <cstddef>
+
 namespace yarp {
 namespace os {
 
@@ -54,6 +56,16 @@ public:
      */
     virtual void write(const yarp::os::Bytes& b) = 0;
 
+    /**
+     * Write a sequence of blocks of bytes to the stream.  Streams that
+     * support scatter-gather I/O can send all the blocks at once.
+     * By default, this calls write(const Bytes& b) for each block.
+     *
+     * @param blocks the blocks of bytes to write
+     * @param count the number of blocks
+     */
+    virtual void writev(const yarp::os::Bytes* blocks, size_t count);
+
     /**
      * Terminate the stream.
      */
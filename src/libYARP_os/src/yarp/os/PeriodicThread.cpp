@@ -10,15 +10,88 @@
 #include <yarp/os/PeriodicThread.h>
 
 #include <yarp/os/SystemClock.h>
+#include <yarp/os/impl/LogComponent.h>
 #include <yarp/os/impl/PlatformTime.h>
 #include <yarp/os/impl/ThreadImpl.h>
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cmath>
 #include <mutex>
+#include <thread>
+#include <vector>
+
+#if defined(__linux__)
+#    include <pthread.h>
+#    include <sched.h>
+#endif
+#if defined(__unix__)
+#    include <cerrno>
+#    include <ctime>
+#endif
 
 using namespace yarp::os::impl;
 using namespace yarp::os;
 
+namespace {
+YARP_OS_LOG_COMPONENT(PERIODICTHREAD, "yarp.os.PeriodicThread")
+
+// Number of recent iterations used to compute the lateness percentiles
+constexpr size_t latenessWindow = 4096;
+
+#if defined(__linux__)
+bool applyCpuAffinity(int cpu)
+{
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (cpu < 0) {
+        for (int i = 0; i < CPU_SETSIZE; ++i) {
+            CPU_SET(i, &set);
+        }
+    } else {
+        if (cpu >= CPU_SETSIZE) {
+            return false;
+        }
+        CPU_SET(cpu, &set);
+    }
+    return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
+#else
+bool applyCpuAffinity(int cpu)
+{
+    return cpu < 0;
+}
+#endif
+
+// Sleep until the system clock reaches deadline.
+// The deadline is converted to the monotonic clock just before sleeping, so
+// that the absolute sleep is not affected by changes of the wall clock.
+void sleepUntilSystem(double deadline)
+{
+    double remaining = deadline - SystemClock::nowSystem();
+    if (remaining <= 0) {
+        return;
+    }
+#if defined(__unix__)
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    auto sec = static_cast<time_t>(remaining);
+    ts.tv_sec += sec;
+    ts.tv_nsec += static_cast<long>((remaining - sec) * 1e9);
+    if (ts.tv_nsec >= 1000000000L) {
+        ts.tv_sec++;
+        ts.tv_nsec -= 1000000000L;
+    }
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR) {
+    }
+#else
+    std::this_thread::sleep_until(std::chrono::steady_clock::now() + std::chrono::duration<double>(remaining));
+#endif
+}
+
+} // namespace
+
 
 class yarp::os::PeriodicThread::Private : public ThreadImpl
 {
@@ -46,6 +119,17 @@ private:
     const NowFuncPtr nowFunc;
     const DelayFuncPtr delayFunc;
 
+    const PeriodicThreadClock clockAccuracy;
+    const bool systemClock;
+    PeriodicThreadOverrun overrunPolicy;
+    double nextRun;              //absolute deadline of the next iteration
+    unsigned int overruns;       //number of missed deadlines from last reset
+    std::vector<double> lateness; //wake-up lateness of the recent iterations
+    size_t latenessNext;
+    double latenessMax;
+    std::atomic<int> cpuAffinity;
+    std::atomic<bool> cpuAffinityChanged;
+
     void _resetStat()
     {
         totalUsed = 0;
@@ -55,11 +139,71 @@ private:
         sumUsedSq = 0;
         sumTSq = 0;
         elapsed = 0;
+        overruns = 0;
+        lateness.clear();
+        latenessNext = 0;
+        latenessMax = 0;
         scheduleReset = false;
     }
 
+    void addLateness(double late)
+    {
+        if (late < 0) {
+            late = 0;
+        }
+        if (lateness.size() < latenessWindow) {
+            lateness.push_back(late);
+        } else {
+            lateness[latenessNext] = late;
+            latenessNext = (latenessNext + 1) % latenessWindow;
+        }
+        latenessMax = std::max(latenessMax, late);
+    }
+
+    void sleepUntil(double deadline)
+    {
+        if (systemClock || yarp::os::Time::isSystemClock()) {
+            sleepUntilSystem(deadline);
+        } else {
+            delayFunc(deadline - nowFunc());
+        }
+    }
+
+    // Wait for the next absolute deadline, applying the overrun policy
+    void waitNextRun()
+    {
+        double period = adaptedPeriod;
+        if (nextRun == 0) {
+            nextRun = currentRun;
+        }
+        nextRun += period;
+
+        double now = nowFunc();
+        if (now >= nextRun) {
+            lock();
+            overruns++;
+            unlock();
+            if (overrunPolicy == PeriodicThreadOverrun::CatchUp) {
+                // Run again immediately, the deadline is not changed
+                return;
+            }
+            if (period > 0) {
+                nextRun += (std::floor((now - nextRun) / period) + 1) * period;
+            } else {
+                nextRun = now;
+                return;
+            }
+        }
+
+        sleepUntil(nextRun);
+
+        lock();
+        addLateness(nowFunc() - nextRun);
+        unlock();
+    }
+
 public:
-    Private(PeriodicThread* owner, double p, ShouldUseSystemClock useSystemClock) :
+    Private(PeriodicThread* owner, double p, ShouldUseSystemClock useSystemClock, PeriodicThreadClock clockAccuracy) :
             adaptedPeriod(p),
             owner(owner),
             elapsed(0),
@@ -75,8 +219,18 @@ public:
             currentRun(0),
             scheduleReset(false),
             nowFunc(useSystemClock == ShouldUseSystemClock::Yes ? SystemClock::nowSystem : yarp::os::Time::now),
-            delayFunc(useSystemClock == ShouldUseSystemClock::Yes ? SystemClock::delaySystem : yarp::os::Time::delay)
+            delayFunc(useSystemClock == ShouldUseSystemClock::Yes ? SystemClock::delaySystem : yarp::os::Time::delay),
+            clockAccuracy(clockAccuracy),
+            systemClock(useSystemClock == ShouldUseSystemClock::Yes),
+            overrunPolicy(PeriodicThreadOverrun::Skip),
+            nextRun(0),
+            overruns(0),
+            latenessNext(0),
+            latenessMax(0),
+            cpuAffinity(-1),
+            cpuAffinityChanged(false)
     {
+        lateness.reserve(latenessWindow);
     }
 
     void resetStat()
@@ -152,9 +306,74 @@ public:
         unlock();
     }
 
+    void getEstimatedLateness(double& p50, double& p99, double& max) const
+    {
+        lock();
+        std::vector<double> sorted(lateness);
+        max = latenessMax;
+        unlock();
+        if (sorted.empty()) {
+            p50 = 0;
+            p99 = 0;
+            return;
+        }
+        auto percentile = [&sorted](double p) {
+            auto n = static_cast<size_t>(std::ceil(p * sorted.size())) - 1;
+            std::nth_element(sorted.begin(), sorted.begin() + n, sorted.end());
+            return sorted[n];
+        };
+        p50 = percentile(0.50);
+        p99 = percentile(0.99);
+    }
+
+    unsigned int getOverruns() const
+    {
+        lock();
+        unsigned int ret = overruns;
+        unlock();
+        return ret;
+    }
+
+    void setOverrunPolicy(PeriodicThreadOverrun policy)
+    {
+        overrunPolicy = policy;
+    }
+
+    bool setCpuAffinity(int cpu)
+    {
+#if defined(__linux__)
+        if (cpu >= CPU_SETSIZE) {
+            return false;
+        }
+#else
+        if (cpu >= 0) {
+            return false;
+        }
+#endif
+        cpuAffinity = cpu;
+        cpuAffinityChanged = true;
+        return true;
+    }
+
+    int getCpuAffinity() const
+    {
+        return cpuAffinity;
+    }
+
 
     void step()
     {
+        // The affinity is applied by the thread itself, the first time
+        // after it is changed
+        if (cpuAffinityChanged.exchange(false)) {
+            int cpu = cpuAffinity;
+            if (!applyCpuAffinity(cpu)) {
+                yCError(PERIODICTHREAD, "Cannot pin the thread to CPU %d, the affinity is removed", cpu);
+                applyCpuAffinity(-1);
+                cpuAffinity = -1;
+            }
+        }
+
         lock();
         currentRun = nowFunc();
 
@@ -198,9 +417,27 @@ public:
         sumUsedSq += elapsed * elapsed;
         unlock();
 
+        if (clockAccuracy == PeriodicThreadClock::Absolute) {
+            waitNextRun();
+            return;
+        }
+
         sleepPeriod = adaptedPeriod - elapsed; // everything is in [seconds] except period, for it is used in the interface as [ms]
 
+        if (sleepPeriod <= 0) {
+            lock();
+            overruns++;
+            unlock();
+        }
+
+        double expectedWakeUp = currentRun + elapsed + sleepPeriod;
         delayFunc(sleepPeriod);
+
+        if (sleepPeriod > 0) {
+            lock();
+            addLateness(nowFunc() - expectedWakeUp);
+            unlock();
+        }
     }
 
     void run() override
@@ -212,6 +449,7 @@ public:
 
     bool threadInit() override
     {
+        nextRun = 0;
         return owner->threadInit();
     }
 
@@ -268,8 +506,13 @@ public:
 };
 
 
-PeriodicThread::PeriodicThread(double period, ShouldUseSystemClock useSystemClock) :
-        mPriv(new Private(this, period, useSystemClock))
+PeriodicThread::PeriodicThread(double period, ShouldUseSystemClock useSystemClock, PeriodicThreadClock clockAccuracy) :
+        mPriv(new Private(this, period, useSystemClock, clockAccuracy))
+{
+}
+
+PeriodicThread::PeriodicThread(double period, PeriodicThreadClock clockAccuracy) :
+        mPriv(new Private(this, period, ShouldUseSystemClock::No, clockAccuracy))
 {
 }
 
@@ -353,6 +596,31 @@ void PeriodicThread::getEstimatedUsed(double& av, double& std) const
     mPriv->getEstimatedUsed(av, std);
 }
 
+void PeriodicThread::getEstimatedLateness(double& p50, double& p99, double& max) const
+{
+    mPriv->getEstimatedLateness(p50, p99, max);
+}
+
+unsigned int PeriodicThread::getOverruns() const
+{
+    return mPriv->getOverruns();
+}
+
+void PeriodicThread::setOverrunPolicy(PeriodicThreadOverrun policy)
+{
+    mPriv->setOverrunPolicy(policy);
+}
+
+bool PeriodicThread::setCpuAffinity(int cpu)
+{
+    return mPriv->setCpuAffinity(cpu);
+}
+
+int PeriodicThread::getCpuAffinity() const
+{
+    return mPriv->getCpuAffinity();
+}
+
 void PeriodicThread::resetStat()
 {
     mPriv->resetStat();
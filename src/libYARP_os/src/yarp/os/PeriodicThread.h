@@ -16,6 +16,39 @@
 namespace yarp {
 namespace os {
 
+/**
+ * How the PeriodicThread computes the time to wait before the next run.
+ */
+enum class PeriodicThreadClock
+{
+    /**
+     * Sleep for the period minus the time spent in run().
+     * Any wake-up latency is added to the period.
+     */
+    Relative,
+    /**
+     * Sleep until an absolute deadline advanced by one period at every
+     * iteration, so wake-up latency does not accumulate.
+     */
+    Absolute
+};
+
+/**
+ * What the PeriodicThread does when run() misses its deadline.
+ * Used only with PeriodicThreadClock::Absolute.
+ */
+enum class PeriodicThreadOverrun
+{
+    /**
+     * Drop the missed deadlines and wait for the next one on the grid.
+     */
+    Skip,
+    /**
+     * Run again immediately until the missed deadlines are recovered.
+     */
+    CatchUp
+};
+
 /**
  * \ingroup key_class
  *
@@ -34,9 +67,22 @@ public:
      * @param useSystemClock whether the thread should always
      * use the system clock, or depend on the current
      * configuration of the network.
+     * @param clockAccuracy whether the thread should sleep for a relative
+     * period or until an absolute deadline.
      */
     explicit PeriodicThread(double period,
-                            ShouldUseSystemClock useSystemClock = ShouldUseSystemClock::No);
+                            ShouldUseSystemClock useSystemClock = ShouldUseSystemClock::No,
+                            PeriodicThreadClock clockAccuracy = PeriodicThreadClock::Relative);
+
+    /**
+     * Constructor.  Thread begins in a dormant state.  Call PeriodicThread::start
+     * to get things going.
+     * @param period The period in seconds [sec] between
+     * successive calls to the PeriodicThread::run method
+     * @param clockAccuracy whether the thread should sleep for a relative
+     * period or until an absolute deadline.
+     */
+    PeriodicThread(double period, PeriodicThreadClock clockAccuracy);
 
     virtual ~PeriodicThread();
 
@@ -136,6 +182,46 @@ public:
      */
     void getEstimatedUsed(double& av, double& std) const;
 
+    /**
+     * @brief Return the wake-up lateness since last reset, i.e. how late
+     * the thread woke up with respect to the expected time.
+     * The percentiles are computed on the most recent iterations.
+     * @param[out] p50 median lateness [sec]
+     * @param[out] p99 99th percentile of the lateness [sec]
+     * @param[out] max maximum lateness [sec]
+     */
+    void getEstimatedLateness(double& p50, double& p99, double& max) const;
+
+    /**
+     * @brief Return the number of iterations since last reset in which
+     * run() did not complete before the next deadline.
+     */
+    unsigned int getOverruns() const;
+
+    /**
+     * @brief Set what the thread should do when run() misses its deadline.
+     * Only used with PeriodicThreadClock::Absolute.
+     * @param policy the overrun policy (default PeriodicThreadOverrun::Skip)
+     */
+    void setOverrunPolicy(PeriodicThreadOverrun policy);
+
+    /**
+     * @brief Pin the thread to a CPU, if the OS supports that.
+     * It can be called before start(), for example in the constructor of
+     * the derived class, and it is applied when the thread starts.
+     * If the thread cannot be pinned to the CPU when the affinity is
+     * applied, an error is logged and the affinity is removed.
+     * @param cpu the index of the CPU, or -1 to remove the affinity.
+     * @return false if the affinity cannot be set.
+     */
+    bool setCpuAffinity(int cpu);
+
+    /**
+     * @brief Return the CPU the thread is pinned to, or -1 if none or if
+     * the thread could not be pinned.
+     */
+    int getCpuAffinity() const;
+
     /**
      * @brief Set the priority and scheduling policy of the thread, if the OS supports that.
      * @param priority the new priority of the thread.
@@ -148,6 +234,8 @@ public:
      * SCHED_OTHER : policy=0, priority=[0 ..  0]
      * SCHED_FIFO  : policy=1, priority=[1 .. 99]
      * SCHED_RR    : policy=2, priority=[1 .. 99]
+     * It can be called before start(), and it is applied when the thread
+     * starts.
      */
     int setPriority(int priority, int policy = -1);
 
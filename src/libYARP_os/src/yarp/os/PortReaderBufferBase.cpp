@@ -198,6 +198,7 @@ public:
     PortReaderPool pool;
 
     int ct;
+    size_t dropped;
     Port* port;
     yarp::os::Semaphore contentSema;
     yarp::os::Semaphore consumeSema;
@@ -213,6 +214,7 @@ public:
             period(-1),
             last_recv(-1),
             ct(0),
+            dropped(0),
             port(nullptr),
             contentSema(0),
             consumeSema(0),
@@ -317,6 +319,7 @@ public:
             drop = pool.getActivePacket();
             if (drop != nullptr) {
                 pool.addInactivePacket(drop);
+                dropped++;
             }
             ct--;
         }
@@ -538,6 +541,12 @@ unsigned int PortReaderBufferBase::getMaxBuffer()
     return mPriv->maxBuffer;
 }
 
+size_t PortReaderBufferBase::getDropCount()
+{
+    std::lock_guard<std::mutex> lock(mPriv->stateMutex);
+    return mPriv->dropped;
+}
+
 bool PortReaderBufferBase::isClosed()
 {
     return mPriv->port == nullptr;
@@ -40,6 +40,12 @@ public:
 
     unsigned int getMaxBuffer();
 
+    /**
+     * @return the number of messages dropped because a newer message was
+     * received before they were read (only when pruning is enabled).
+     */
+    size_t getDropCount();
+
     bool isClosed();
 
     void clear();
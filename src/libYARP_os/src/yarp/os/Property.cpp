@@ -21,9 +21,11 @@
 #include <algorithm>
 #include <cctype>
 #include <cstdio>
+#include <cstdint>
 #include <cstring>
-#include <map>
 #include <memory>
+#include <utility>
+#include <vector>
 
 using namespace yarp::os::impl;
 using namespace yarp::os;
@@ -100,10 +102,207 @@ public:
     }
 };
 
+namespace {
+// FNV-1a, folded to the size of size_t.
+size_t hashKey(const char* key, size_t len)
+{
+    std::uint64_t h = 14695981039346656037ULL;
+    for (size_t i = 0; i < len; i++) {
+        h ^= static_cast<unsigned char>(key[i]);
+        h *= 1099511628211ULL;
+    }
+    h ^= h >> 32;
+    return static_cast<size_t>(h);
+}
+
+size_t hashKey(const std::string& key)
+{
+    return hashKey(key.data(), key.size());
+}
+} // namespace
+
+/*
+ * Hash table using open addressing with linear probing.
+ *
+ * The slots store the hash of the key, so that a probe does not touch the
+ * entries with a different hash. The entries are allocated separately, so
+ * that the references returned by Property::find() and Property::findGroup()
+ * are not invalidated when the table grows (as it was with std::map).
+ * Erased entries are removed by shifting back the following slots, instead
+ * of leaving tombstones.
+ */
+class PropertyTable
+{
+public:
+    struct Entry
+    {
+        std::string key;
+        PropertyItem item;
+    };
+
+    PropertyTable() = default;
+
+    PropertyTable(const PropertyTable& rhs) :
+            slots(rhs.slots.size()),
+            count(rhs.count)
+    {
+        for (size_t i = 0; i < rhs.slots.size(); i++) {
+            if (rhs.slots[i].entry) {
+                slots[i].hash = rhs.slots[i].hash;
+                slots[i].entry.reset(new Entry(*rhs.slots[i].entry)); // FIXME: std::make_unique
+            }
+        }
+    }
+
+    PropertyTable& operator=(const PropertyTable& rhs)
+    {
+        if (&rhs != this) {
+            PropertyTable tmp(rhs);
+            std::swap(slots, tmp.slots);
+            std::swap(count, tmp.count);
+        }
+        return *this;
+    }
+
+    PropertyTable(PropertyTable&& rhs) noexcept = default;
+    PropertyTable& operator=(PropertyTable&& rhs) noexcept = default;
+    ~PropertyTable() = default;
+
+    size_t size() const
+    {
+        return count;
+    }
+
+    Entry* find(const std::string& key, size_t hash) const
+    {
+        if (count == 0) {
+            return nullptr;
+        }
+        const size_t mask = slots.size() - 1;
+        for (size_t i = hash & mask; slots[i].entry; i = (i + 1) & mask) {
+            if (slots[i].hash == hash && slots[i].entry->key == key) {
+                return slots[i].entry.get();
+            }
+        }
+        return nullptr;
+    }
+
+    // Find the entry, or add a new one
+    Entry& get(const std::string& key, size_t hash)
+    {
+        Entry* entry = find(key, hash);
+        if (entry != nullptr) {
+            return *entry;
+        }
+        if ((count + 1) * 4 > slots.size() * 3) {
+            rehash(std::max<size_t>(slots.size() * 2, minSlots));
+        }
+        const size_t mask = slots.size() - 1;
+        size_t i = hash & mask;
+        while (slots[i].entry) {
+            i = (i + 1) & mask;
+        }
+        slots[i].hash = hash;
+        slots[i].entry.reset(new Entry{key, PropertyItem()}); // FIXME: std::make_unique
+        count++;
+        return *slots[i].entry;
+    }
+
+    void erase(const std::string& key, size_t hash)
+    {
+        if (count == 0) {
+            return;
+        }
+        const size_t mask = slots.size() - 1;
+        size_t i = hash & mask;
+        while (slots[i].entry && (slots[i].hash != hash || slots[i].entry->key != key)) {
+            i = (i + 1) & mask;
+        }
+        if (!slots[i].entry) {
+            return;
+        }
+        slots[i].entry.reset();
+        count--;
+        // Move back the following entries that would not be found anymore
+        for (size_t j = (i + 1) & mask; slots[j].entry; j = (j + 1) & mask) {
+            size_t home = slots[j].hash & mask;
+            bool between = (i <= j) ? (i < home && home <= j) : (i < home || home <= j);
+            if (!between) {
+                slots[i] = std::move(slots[j]);
+                i = j;
+            }
+        }
+    }
+
+    void clear()
+    {
+        // Keep the slots, a cleared Property is usually filled again
+        for (auto& slot : slots) {
+            slot.entry.reset();
+        }
+        count = 0;
+    }
+
+    void reserve(size_t n)
+    {
+        size_t len = minSlots;
+        while (n * 4 > len * 3) {
+            len *= 2;
+        }
+        if (len > slots.size()) {
+            rehash(len);
+        }
+    }
+
+    // The entries sorted by key, i.e. in the order used by toString()
+    std::vector<const Entry*> sorted() const
+    {
+        std::vector<const Entry*> entries;
+        entries.reserve(count);
+        for (const auto& slot : slots) {
+            if (slot.entry) {
+                entries.push_back(slot.entry.get());
+            }
+        }
+        std::sort(entries.begin(), entries.end(), [](const Entry* a, const Entry* b) {
+            return a->key < b->key;
+        });
+        return entries;
+    }
+
+private:
+    static constexpr size_t minSlots = 8;
+
+    struct Slot
+    {
+        size_t hash {0};
+        std::unique_ptr<Entry> entry;
+    };
+
+    void rehash(size_t len)
+    {
+        std::vector<Slot> old(len);
+        std::swap(slots, old);
+        const size_t mask = slots.size() - 1;
+        for (auto& slot : old) {
+            if (slot.entry) {
+                size_t i = slot.hash & mask;
+                while (slots[i].entry) {
+                    i = (i + 1) & mask;
+                }
+                slots[i] = std::move(slot);
+            }
+        }
+    }
+
+    std::vector<Slot> slots; // The size is 0 or a power of 2
+    size_t count {0};
+};
+
 class Property::Private
 {
 public:
-    std::map<std::string, PropertyItem> data;
+    PropertyTable data;
     Property* owner;
 
     explicit Private(Property* owner) :
@@ -111,32 +310,33 @@ public:
     {
     }
 
-    PropertyItem* getPropNoCreate(const std::string& key) const
+    PropertyItem* getPropNoCreate(const std::string& key, size_t hash) const
     {
-        auto it = data.find(key);
-        if (it == data.end()) {
+        PropertyTable::Entry* entry = data.find(key, hash);
+        if (entry == nullptr) {
             return nullptr;
         }
-        return const_cast<PropertyItem*>(&(it->second));
+        return &(entry->item);
     }
 
-    PropertyItem* getProp(const std::string& key, bool create = true)
+    PropertyItem* getPropNoCreate(const std::string& key) const
     {
-        auto entry = data.find(key);
-        if (entry == data.end()) {
-            if (!create) {
-                return nullptr;
-            }
-            data[key] = PropertyItem();
-            entry = data.find(key);
-        }
-        yCAssert(PROPERTY, entry != data.end());
-        return &(entry->second);
+        return getPropNoCreate(key, hashKey(key));
+    }
+
+    PropertyItem* getProp(const std::string& key, size_t hash)
+    {
+        return &(data.get(key, hash).item);
+    }
+
+    PropertyItem* getProp(const std::string& key)
+    {
+        return getProp(key, hashKey(key));
     }
 
     void put(const std::string& key, const std::string& val)
     {
-        PropertyItem* p = getProp(key, true);
+        PropertyItem* p = getProp(key);
         p->singleton = true;
         p->clear();
         p->bot.clear();
@@ -146,7 +346,12 @@ public:
 
     void put(const std::string& key, const Value& bit)
     {
-        PropertyItem* p = getProp(key, true);
+        put(key, hashKey(key), bit);
+    }
+
+    void put(const std::string& key, size_t hash, const Value& bit)
+    {
+        PropertyItem* p = getProp(key, hash);
         p->singleton = true;
         p->clear();
         p->bot.clear();
@@ -156,7 +361,7 @@ public:
 
     void put(const std::string& key, Value* bit)
     {
-        PropertyItem* p = getProp(key, true);
+        PropertyItem* p = getProp(key);
         p->singleton = true;
         p->clear();
         p->bot.clear();
@@ -166,7 +371,7 @@ public:
 
     Property& addGroup(const std::string& key)
     {
-        PropertyItem* p = getProp(key, true);
+        PropertyItem* p = getProp(key);
         p->singleton = true;
         p->clear();
         p->bot.clear();
@@ -177,12 +382,12 @@ public:
 
     void unput(const std::string& key)
     {
-        data.erase(key);
+        data.erase(key, hashKey(key));
     }
 
-    bool check(const std::string& key) const
+    bool check(const std::string& key, size_t hash) const
     {
-        PropertyItem* p = getPropNoCreate(key);
+        PropertyItem* p = getPropNoCreate(key, hash);
         if (owner->getMonitor() != nullptr) {
             SearchReport report;
             report.key = key;
@@ -192,9 +397,9 @@ public:
         return p != nullptr;
     }
 
-    Value& get(const std::string& key) const
+    Value& get(const std::string& key, size_t hash) const
     {
-        PropertyItem* p = getPropNoCreate(key);
+        PropertyItem* p = getPropNoCreate(key, hash);
         if (p != nullptr) {
             p->flush();
             if (owner->getMonitor() != nullptr) {
@@ -227,7 +432,7 @@ public:
 
     Bottle& putBottle(const char* key, const Bottle& val)
     {
-        PropertyItem* p = getProp(key, true);
+        PropertyItem* p = getProp(key);
         p->singleton = false;
         p->clear();
         p->bot = val;
@@ -237,7 +442,7 @@ public:
 
     Bottle& putBottle(const char* key)
     {
-        PropertyItem* p = getProp(key, true);
+        PropertyItem* p = getProp(key);
         p->singleton = false;
         p->clear();
         p->bot.clear();
@@ -245,9 +450,9 @@ public:
     }
 
 
-    Bottle* getBottle(const std::string& key) const
+    Bottle* getBottle(const std::string& key, size_t hash) const
     {
-        PropertyItem* p = getPropNoCreate(key);
+        PropertyItem* p = getPropNoCreate(key, hash);
         if (p != nullptr) {
             p->flush();
             return &(p->bot);
@@ -255,6 +460,38 @@ public:
         return nullptr;
     }
 
+    Bottle* getBottle(const std::string& key) const
+    {
+        return getBottle(key, hashKey(key));
+    }
+
+    Bottle& findGroup(const std::string& key, size_t hash) const
+    {
+        Bottle* result = getBottle(key, hash);
+        if (owner->getMonitor() != nullptr) {
+            SearchReport report;
+            report.key = key;
+            report.isGroup = true;
+            if (result != nullptr) {
+                report.isFound = true;
+                report.value = result->toString();
+            }
+            owner->reportToMonitor(report);
+            if (result != nullptr) {
+                std::string context = owner->getMonitorContext();
+                context += ".";
+                context += key;
+                result->setMonitor(owner->getMonitor(),
+                                   context.c_str()); // pass on any monitoring
+            }
+        }
+
+        if (result != nullptr) {
+            return *result;
+        }
+        return Bottle::getNullBottle();
+    }
+
     void clear()
     {
         data.clear();
@@ -729,8 +966,8 @@ public:
     std::string toString() const
     {
         Bottle bot;
-        for (const auto& it : data) {
-            const PropertyItem& rec = it.second;
+        for (const auto* entry : data.sorted()) {
+            const PropertyItem& rec = entry->item;
             Bottle& sub = bot.addList();
             rec.flush();
             sub.copy(rec.bot);
@@ -916,6 +1153,28 @@ public:
     }
 };
 
+Property::Key::Key(const std::string& name) :
+        mName(name),
+        mHash(hashKey(name))
+{
+}
+
+Property::Key::Key(const char* name) :
+        Key(std::string(name))
+{
+}
+
+const std::string& Property::Key::name() const
+{
+    return mName;
+}
+
+size_t Property::Key::hash() const
+{
+    return mHash;
+}
+
+
 Property::Property() :
         Searchable(),
         Portable(),
@@ -929,7 +1188,9 @@ Property::Property(int hash_size) :
         Portable(),
         mPriv(new Private(this))
 {
-    YARP_UNUSED(hash_size);
+    if (hash_size > 0) {
+        mPriv->data.reserve(static_cast<size_t>(hash_size));
+    }
 }
 #endif
 
@@ -1011,6 +1272,11 @@ void Property::put(const std::string& key, Value* value)
     mPriv->put(key, value);
 }
 
+void Property::put(const Key& key, const Value& value)
+{
+    mPriv->put(key.name(), key.hash(), value);
+}
+
 void Property::put(const std::string& key, int value)
 {
     put(key, Value::makeInt32(value));
@@ -1023,7 +1289,12 @@ void Property::put(const std::string& key, double value)
 
 bool Property::check(const std::string& key) const
 {
-    return mPriv->check(key);
+    return mPriv->check(key, hashKey(key));
+}
+
+bool Property::check(const Key& key) const
+{
+    return mPriv->check(key.name(), key.hash());
 }
 
 void Property::unput(const std::string& key)
@@ -1033,7 +1304,12 @@ void Property::unput(const std::string& key)
 
 Value& Property::find(const std::string& key) const
 {
-    return mPriv->get(key);
+    return mPriv->get(key, hashKey(key));
+}
+
+Value& Property::find(const Key& key) const
+{
+    return mPriv->get(key.name(), key.hash());
 }
 
 
@@ -1124,29 +1400,13 @@ bool Property::write(ConnectionWriter& writer) const
 
 Bottle& Property::findGroup(const std::string& key) const
 {
-    Bottle* result = mPriv->getBottle(key);
-    if (getMonitor() != nullptr) {
-        SearchReport report;
-        report.key = key;
-        report.isGroup = true;
-        if (result != nullptr) {
-            report.isFound = true;
-            report.value = result->toString();
-        }
-        reportToMonitor(report);
-        if (result != nullptr) {
-            std::string context = getMonitorContext();
-            context += ".";
-            context += key;
-            result->setMonitor(getMonitor(),
-                               context.c_str()); // pass on any monitoring
-        }
-    }
+    return mPriv->findGroup(key, hashKey(key));
+}
 
-    if (result != ((Bottle*)nullptr)) {
-        return *result;
-    }
-    return Bottle::getNullBottle();
+
+Bottle& Property::findGroup(const Key& key) const
+{
+    return mPriv->findGroup(key.name(), key.hash());
 }
 
 
@@ -29,7 +29,9 @@ namespace os {
  * It can read from configuration files using the fromConfigFile() method, and
  * from command line options using the fromCommand() method, and from any
  * Searchable object (include Bottle objects) using the fromString() method.
- * Property objects can be searched efficiently.
+ * Property objects can be searched efficiently: the keys are stored in a
+ * hash table, and a Property::Key can be used to avoid hashing the same key
+ * at every lookup.
  */
 class YARP_os_API Property :
         public Searchable,
@@ -39,6 +41,42 @@ public:
     using Searchable::check;
     using Searchable::findGroup;
 
+    /**
+     * \brief A key that can be used for repeated lookups.
+     *
+     * The hash of the key is computed when the Key is constructed, instead
+     * of at every lookup. Keys used many times (for example in a control
+     * loop, or for all the devices opened with similar configurations) can
+     * be constructed once and reused with any Property.
+     *
+     * \code
+     * static const Property::Key period("period");
+     * if (config.check(period)) {
+     *     double p = config.find(period).asFloat64();
+     * }
+     * \endcode
+     */
+    class YARP_os_API Key
+    {
+    public:
+        explicit Key(const std::string& name);
+        explicit Key(const char* name);
+
+        /**
+         * @return the key as a string
+         */
+        const std::string& name() const;
+
+        /**
+         * @return the hash of the key
+         */
+        size_t hash() const;
+
+    private:
+        YARP_SUPPRESS_DLL_INTERFACE_WARNING_ARG(std::string) mName;
+        size_t mHash;
+    };
+
     /**
      * Constructor.
      */
@@ -48,10 +86,8 @@ public:
     /**
      * Constructor.
      *
-     * @param hash_size a scalar controlling efficiency of the
-     * hash map storing the data.  Set to 0 for default size.
-     * The bigger this number, the more memory used, but the
-     * more efficient the map.
+     * @param hash_size the number of keys to reserve space for in the hash
+     * table storing the data. Set to 0 for default size.
      *
      * @deprecated Since YARP 3.3
      */
@@ -98,6 +134,16 @@ public:
     // documented in Searchable
     bool check(const std::string& key) const override;
 
+    /**
+     * \brief Check if there exists a property of the given key.
+     *
+     * Same as check(const std::string&), without hashing the key again.
+     *
+     * @param key the key
+     * @return true if the key exists
+     */
+    bool check(const Key& key) const;
+
     /**
      * \brief Associate the given \c key with the given string.
      *
@@ -137,6 +183,17 @@ public:
      */
     void put(const std::string& key, Value* value);
 
+    /**
+     * \brief Associate the given \c key with the given value.
+     *
+     * Same as put(const std::string&, const Value&), without hashing the key
+     * again.
+     *
+     * @param key the key
+     * @param value the value
+     */
+    void put(const Key& key, const Value& value);
+
     /**
      * \brief Associate the given \c key with the given integer.
      *
@@ -191,6 +248,26 @@ public:
     // documented in Searchable
     Bottle& findGroup(const std::string& key) const override;
 
+    /**
+     * \brief Get the value associated with the given key.
+     *
+     * Same as find(const std::string&), without hashing the key again.
+     *
+     * @param key the key
+     * @return the value, or a null value if the key is not found
+     */
+    Value& find(const Key& key) const;
+
+    /**
+     * \brief Get the group associated with the given key.
+     *
+     * Same as findGroup(const std::string&), without hashing the key again.
+     *
+     * @param key the key
+     * @return the group, or a null Bottle if the key is not found
+     */
+    Bottle& findGroup(const Key& key) const;
+
     /**
      * \brief Remove all associations.
      *
@@ -14,6 +14,7 @@
 #include <yarp/os/AbstractContactable.h>
 #include <yarp/os/BinPortable.h>
 #include <yarp/os/Bottle.h>
+#include <yarp/os/BottleView.h>
 #include <yarp/os/BufferedPort.h>
 #include <yarp/os/Clock.h>
 #include <yarp/os/ConnectionReader.h>
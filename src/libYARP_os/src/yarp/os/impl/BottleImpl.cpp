@@ -18,6 +18,7 @@
 #include <yarp/os/impl/MemoryOutputStream.h>
 #include <yarp/os/impl/StreamConnectionReader.h>
 
+#include <algorithm>
 #include <limits>
 
 using yarp::os::Bottle;
@@ -31,6 +32,10 @@ using yarp::os::impl::Storable;
 
 namespace {
 YARP_OS_LOG_COMPONENT(BOTTLEIMPL, "yarp.os.impl.BottleImpl")
+
+// Items reserved in advance by each nested list, the longer ones grow as
+// they are read
+constexpr size_t nested_reserve_limit = 64;
 } // namespace
 
 BottleImpl::BottleImpl() :
@@ -60,6 +65,20 @@ BottleImpl::~BottleImpl()
 }
 
 
+void BottleImpl::reserve(std::int32_t len, const ConnectionReader& reader, size_t limit)
+{
+    // Each item takes at least 4 bytes for its code, or one byte in the
+    // specialized lists, do not trust lengths that cannot fit in the
+    // message. The nested lists reserve at most `limit` items each, so that
+    // deeply nested messages cannot reserve much more than their size.
+    if (len <= 0) {
+        return;
+    }
+    size_t count = std::min(static_cast<size_t>(len), reader.getSize() / ((speciality != 0) ? 1 : sizeof(NetInt32)));
+    count = std::min(count, limit);
+    content.reserve(content.size() + count);
+}
+
 void BottleImpl::add(Storable* s)
 {
     content.push_back(s);
@@ -70,12 +89,22 @@ void BottleImpl::add(Storable* s)
 void BottleImpl::clear()
 {
     for (auto& i : content) {
-        delete i;
+        arena.destroy(i);
     }
     content.clear();
+    arena.rewind();
     dirty = true;
 }
 
+Storable* BottleImpl::cloneStorable(const Value& bit)
+{
+    const auto* storable = dynamic_cast<const Storable*>(&bit);
+    if (storable != nullptr) {
+        return storable->cloneStorable(arena);
+    }
+    return static_cast<Storable*>(bit.clone());
+}
+
 void BottleImpl::smartAdd(const std::string& str)
 {
     if (str.length() > 0) {
@@ -143,18 +172,18 @@ void BottleImpl::smartAdd(const std::string& str)
             ((ch >= '0' && ch <= '9') || ch == '+' || ch == '-' || ch == '.' || ch == 'i' /* inf */ || ch == 'n' /* nan */) &&
             (ch != '.' || str.length() > 1)) {
             if (!hasPeriodOrE) {
-                s = new StoreInt64(0);
+                s = arena.make<StoreInt64>(0);
             } else {
-                s = new StoreFloat64(0);
+                s = arena.make<StoreFloat64>(0);
             }
         } else if (ch == '(') {
-            s = new StoreList();
+            s = arena.make<StoreList>();
         } else if (ch == '[') {
-            s = new StoreVocab();
+            s = arena.make<StoreVocab>();
         } else if (ch == '{') {
-            s = new StoreBlob();
+            s = arena.make<StoreBlob>();
         } else {
-            s = ss = new StoreString("");
+            s = ss = arena.make<StoreString>("");
         }
         if (s != nullptr) {
             s->fromStringNested(str);
@@ -166,21 +195,22 @@ void BottleImpl::smartAdd(const std::string& str)
             if (s->isInt64()
                 && s->asInt64() >= std::numeric_limits<int32_t>::min()
                 && s->asInt64() <= std::numeric_limits<int32_t>::max()) {
-                Storable* s_i32 = new StoreInt32(s->asInt32());
-                delete s;
-                s = s_i32;
-                s_i32 = nullptr;
+                // The item is destroyed first, so that the new one reuses
+                // its memory in the arena
+                std::int32_t val = s->asInt32();
+                arena.destroy(s);
+                s = arena.make<StoreInt32>(val);
             }
 
             if (ss != nullptr) {
                 if (str.length() == 0 || str[0] != '\"') {
                     std::string val = ss->asString();
                     if (val == "true") {
-                        delete s;
-                        s = new StoreVocab(static_cast<int>('1'));
+                        arena.destroy(s);
+                        s = arena.make<StoreVocab>(static_cast<int>('1'));
                     } else if (val == "false") {
-                        delete s;
-                        s = new StoreVocab(0);
+                        arena.destroy(s);
+                        s = arena.make<StoreVocab>(0);
                     }
                 }
             }
@@ -239,7 +269,7 @@ void BottleImpl::fromString(const std::string& line)
                         (nestedAlt == 0) && (nested == 0)) {
                         if (!arg.empty()) {
                             if (arg == "null") {
-                                add(new StoreVocab(yarp::os::createVocab('n', 'u', 'l', 'l')));
+                                add(arena.make<StoreVocab>(yarp::os::createVocab('n', 'u', 'l', 'l')));
                             } else {
                                 smartAdd(arg);
                             }
@@ -344,7 +374,7 @@ bool BottleImpl::fromBytes(ConnectionReader& reader)
     } else {
         yCTrace(BOTTLEIMPL, "READ skipped subcode %" PRId32, speciality);
     }
-    Storable* storable = Storable::createByCode(id);
+    Storable* storable = Storable::createByCode(id, arena);
     if (storable == nullptr) {
         yCError(BOTTLEIMPL, "Reader failed, unrecognized object code %" PRId32, id);
         return false;
@@ -398,6 +428,7 @@ bool BottleImpl::fromBytes(const Bytes& data)
         return false;
     }
     yCTrace(BOTTLEIMPL, "READ bottle length %d", len);
+    reserve(len, reader, std::numeric_limits<size_t>::max());
     for (int i = 0; i < len; i++) {
         bool ok = fromBytes(reader);
         if (!ok) {
@@ -507,6 +538,7 @@ bool BottleImpl::read(ConnectionReader& reader)
             return false;
         }
         yCTrace(BOTTLEIMPL, "READ got length %d", len);
+        reserve(len, reader, nested ? nested_reserve_limit : std::numeric_limits<size_t>::max());
         for (int i = 0; i < len; i++) {
             bool ok = fromBytes(reader);
             if (!ok) {
@@ -634,6 +666,18 @@ Storable* BottleImpl::pop()
         stb = content[size() - 1];
         content.pop_back();
         dirty = true;
+        // The caller takes the ownership of the item, therefore it must be
+        // moved out of the arena
+        if (arena.owns(stb)) {
+            Storable* heap = stb->cloneStorable();
+            arena.destroy(stb);
+            stb = heap;
+        }
+        // Only the memory of the most recent item is reused by the arena,
+        // the rest is reclaimed when the Bottle is empty
+        if (content.empty()) {
+            arena.rewind();
+        }
     }
     yCAssert(BOTTLEIMPL, stb != nullptr);
     return stb;
@@ -646,14 +690,14 @@ Storable& BottleImpl::get(size_type index) const
 
 yarp::os::Bottle& BottleImpl::addList()
 {
-    auto* lst = new StoreList();
+    auto* lst = arena.make<StoreList>();
     add(lst);
     return lst->internal();
 }
 
 yarp::os::Property& BottleImpl::addDict()
 {
-    auto* lst = new StoreDict();
+    auto* lst = arena.make<StoreDict>();
     add(lst);
     return lst->internal();
 }
@@ -678,7 +722,7 @@ void BottleImpl::copyRange(const BottleImpl* alt, size_type first, size_type len
 
     const size_t last = src->size() - 1;
     for (size_t i = 0; (i < len) && (first + i <= last); ++i) {
-        add(src->get(first + i).cloneStorable());
+        add(cloneStorable(src->get(first + i)));
     }
 }
 
@@ -59,42 +59,42 @@ public:
 
     void addInt8(std::int8_t x)
     {
-        add(new StoreInt8(x));
+        add(arena.make<StoreInt8>(x));
     }
 
     void addInt16(std::int16_t x)
     {
-        add(new StoreInt16(x));
+        add(arena.make<StoreInt16>(x));
     }
 
     void addInt32(std::int32_t x)
     {
-        add(new StoreInt32(x));
+        add(arena.make<StoreInt32>(x));
     }
 
     void addInt64(std::int64_t x)
     {
-        add(new StoreInt64(x));
+        add(arena.make<StoreInt64>(x));
     }
 
     void addFloat32(yarp::conf::float32_t x)
     {
-        add(new StoreFloat32(x));
+        add(arena.make<StoreFloat32>(x));
     }
 
     void addFloat64(yarp::conf::float64_t x)
     {
-        add(new StoreFloat64(x));
+        add(arena.make<StoreFloat64>(x));
     }
 
     void addVocab(std::int32_t x)
     {
-        add(new StoreVocab(x));
+        add(arena.make<StoreVocab>(x));
     }
 
     void addString(const std::string& text)
     {
-        add(new StoreString(text));
+        add(arena.make<StoreString>(text));
     }
 
     yarp::os::Bottle& addList();
@@ -140,7 +140,7 @@ public:
     {
         // all Values are Storables -- important invariant!
         if (!bit.isNull()) {
-            add((Storable*)(bit.clone()));
+            add(cloneStorable(bit));
         }
     }
 
@@ -171,6 +171,12 @@ public:
 
     bool checkIndex(size_type index) const;
 
+    // total size of the memory reserved by the arena for the items
+    size_t arenaCapacity() const
+    {
+        return arena.capacity();
+    }
+
     bool invalid;
     bool ro;
 
@@ -180,6 +186,11 @@ public:
     Value& findBit(const std::string& key) const;
 
 private:
+    // The items are constructed in the arena, except those added with
+    // addBit(Value*), that are owned by the Bottle but allocated by the user.
+    // The arena must be declared before the content, so that it is
+    // destroyed after the items.
+    StorableArena arena;
     YARP_SUPPRESS_DLL_INTERFACE_WARNING_ARG(std::vector<Storable*>) content;
     YARP_SUPPRESS_DLL_INTERFACE_WARNING_ARG(std::vector<char>) data;
     int speciality;
@@ -187,7 +198,9 @@ private:
     bool dirty;
 
     void add(Storable* s);
+    void reserve(std::int32_t len, const ConnectionReader& reader, size_t limit);
     void smartAdd(const std::string& str);
+    Storable* cloneStorable(const yarp::os::Value& bit);
 
     /*
      * Bottle is using a lazy synchronization method. Whenever some operation
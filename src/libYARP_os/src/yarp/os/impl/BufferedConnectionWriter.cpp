@@ -359,14 +359,19 @@ bool BufferedConnectionWriter::write(ConnectionWriter& connection) const
 void BufferedConnectionWriter::write(OutputStream& os)
 {
     stopWrite();
+    // Collect all the fragments, so that streams supporting scatter-gather
+    // I/O can send the whole message at once.  The vector is reused across
+    // messages, therefore no allocation happens in steady state.
+    blocks.clear();
     for (size_t i = 0; i < header_used; i++) {
         yarp::os::ManagedBytes& b = *(header[i]);
-        os.write(b.usedBytes());
+        blocks.push_back(b.usedBytes());
     }
     for (size_t i = 0; i < lst_used; i++) {
         yarp::os::ManagedBytes& b = *(lst[i]);
-        os.write(b.usedBytes());
+        blocks.push_back(b.usedBytes());
     }
+    os.writev(blocks.data(), blocks.size());
     os.flush();
 }
 
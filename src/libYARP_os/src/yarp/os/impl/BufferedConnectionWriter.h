@@ -10,6 +10,7 @@
 #ifndef YARP_OS_IMPL_BUFFEREDCONNECTIONWRITER_H
 #define YARP_OS_IMPL_BUFFEREDCONNECTIONWRITER_H
 
+#include <yarp/os/Bytes.h>
 #include <yarp/os/ConnectionWriter.h>
 #include <yarp/os/SizedWriter.h>
 
@@ -20,7 +21,6 @@
 namespace yarp {
 namespace os {
 
-class Bytes;
 class ManagedBytes;
 
 namespace impl {
@@ -267,6 +267,7 @@ private:
     size_t header_used;           ///< how many header buffers are in use for the current message
     size_t* target_used;          ///< points to lst_used of header_used
     size_t initialPoolSize;       ///< size of new pool buffers
+    YARP_SUPPRESS_DLL_INTERFACE_WARNING_ARG(std::vector<yarp::os::Bytes>) blocks; ///< header and payload buffers handed to the stream in a single write
 };
 
 
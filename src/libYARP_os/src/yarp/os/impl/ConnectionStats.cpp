@@ -0,0 +1,157 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/os/impl/ConnectionStats.h>
+
+#include <yarp/os/SystemClock.h>
+
+using yarp::os::Bottle;
+using yarp::os::SystemClock;
+using yarp::os::impl::ConnectionStats;
+using yarp::os::impl::DurationHistogram;
+
+constexpr size_t DurationHistogram::buckets;
+
+DurationHistogram::DurationHistogram()
+{
+    reset();
+}
+
+void DurationHistogram::add(double seconds)
+{
+    if (seconds < 0.0) {
+        seconds = 0.0;
+    }
+    auto ns = static_cast<std::uint64_t>(seconds * 1e9);
+
+    // Index of the highest bit of the duration in microseconds
+    std::uint64_t us = ns / 1000;
+    size_t bucket = 0;
+    while (us != 0 && bucket < buckets - 1) {
+        us >>= 1;
+        bucket++;
+    }
+
+    counts[bucket].fetch_add(1, std::memory_order_relaxed);
+    count.fetch_add(1, std::memory_order_relaxed);
+    totalNs.fetch_add(ns, std::memory_order_relaxed);
+    std::uint64_t max = maxNs.load(std::memory_order_relaxed);
+    while (ns > max && !maxNs.compare_exchange_weak(max, ns, std::memory_order_relaxed)) {
+    }
+}
+
+void DurationHistogram::reset()
+{
+    for (auto& c : counts) {
+        c.store(0, std::memory_order_relaxed);
+    }
+    count.store(0, std::memory_order_relaxed);
+    totalNs.store(0, std::memory_order_relaxed);
+    maxNs.store(0, std::memory_order_relaxed);
+}
+
+void DurationHistogram::write(Bottle& result) const
+{
+    std::uint64_t n = count.load(std::memory_order_relaxed);
+
+    Bottle& bcount = result.addList();
+    bcount.addString("count");
+    bcount.addInt64(static_cast<std::int64_t>(n));
+
+    Bottle& bmean = result.addList();
+    bmean.addString("mean");
+    bmean.addFloat64(n > 0 ? totalNs.load(std::memory_order_relaxed) * 1e-9 / n : 0.0);
+
+    Bottle& bmax = result.addList();
+    bmax.addString("max");
+    bmax.addFloat64(maxNs.load(std::memory_order_relaxed) * 1e-9);
+
+    // Trailing empty buckets are omitted
+    size_t last = 0;
+    for (size_t i = 0; i < buckets; i++) {
+        if (counts[i].load(std::memory_order_relaxed) != 0) {
+            last = i + 1;
+        }
+    }
+    Bottle& bbuckets = result.addList();
+    bbuckets.addString("buckets");
+    for (size_t i = 0; i < last; i++) {
+        bbuckets.addInt32(static_cast<std::int32_t>(counts[i].load(std::memory_order_relaxed)));
+    }
+}
+
+
+ConnectionStats::ConnectionStats() :
+        since(SystemClock::nowSystem())
+{
+}
+
+void ConnectionStats::addMessage(size_t bytes, double serialization, double transfer)
+{
+    messages.fetch_add(1, std::memory_order_relaxed);
+    this->bytes.fetch_add(bytes, std::memory_order_relaxed);
+    if (serialization >= 0.0) {
+        serializationTime.add(serialization);
+    }
+    transferTime.add(transfer);
+}
+
+void ConnectionStats::addSkipped()
+{
+    skipped.fetch_add(1, std::memory_order_relaxed);
+}
+
+void ConnectionStats::reset()
+{
+    since = SystemClock::nowSystem();
+    messages.store(0, std::memory_order_relaxed);
+    bytes.store(0, std::memory_order_relaxed);
+    skipped.store(0, std::memory_order_relaxed);
+    serializationTime.reset();
+    transferTime.reset();
+}
+
+void ConnectionStats::write(Bottle& result, bool isOutput) const
+{
+    double elapsed = SystemClock::nowSystem() - since.load();
+    std::uint64_t nbytes = bytes.load(std::memory_order_relaxed);
+
+    Bottle& bmessages = result.addList();
+    bmessages.addString("messages");
+    bmessages.addInt64(static_cast<std::int64_t>(messages.load(std::memory_order_relaxed)));
+
+    Bottle& bbytes = result.addList();
+    bbytes.addString("bytes");
+    bbytes.addInt64(static_cast<std::int64_t>(nbytes));
+
+    Bottle& brate = result.addList();
+    brate.addString("rate");
+    brate.addFloat64(elapsed > 0.0 ? nbytes / elapsed : 0.0);
+
+    Bottle& belapsed = result.addList();
+    belapsed.addString("elapsed");
+    belapsed.addFloat64(elapsed);
+
+    if (isOutput) {
+        Bottle& bskipped = result.addList();
+        bskipped.addString("skipped");
+        bskipped.addInt64(static_cast<std::int64_t>(skipped.load(std::memory_order_relaxed)));
+
+        Bottle& bserialize = result.addList();
+        bserialize.addString("serialize");
+        serializationTime.write(bserialize);
+
+        Bottle& bwrite = result.addList();
+        bwrite.addString("write");
+        transferTime.write(bwrite);
+    } else {
+        Bottle& bread = result.addList();
+        bread.addString("read");
+        transferTime.write(bread);
+    }
+}
@@ -0,0 +1,112 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef YARP_OS_IMPL_CONNECTIONSTATS_H
+#define YARP_OS_IMPL_CONNECTIONSTATS_H
+
+#include <yarp/os/Bottle.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace yarp {
+namespace os {
+namespace impl {
+
+/**
+ * A histogram of durations, with logarithmic buckets.
+ *
+ * The bucket 0 counts the durations shorter than 1 microsecond, and the
+ * bucket i the durations between 2^(i-1) and 2^i microseconds. The last
+ * bucket counts all the longer durations.
+ *
+ * It can be updated by one thread while it is read by other threads,
+ * without locks.
+ */
+class DurationHistogram
+{
+public:
+    static constexpr size_t buckets = 24;
+
+    DurationHistogram();
+
+    /**
+     * Add a duration, in seconds.
+     */
+    void add(double seconds);
+
+    void reset();
+
+    /**
+     * Describe the histogram, as
+     * `(count n) (mean s) (max s) (buckets n0 n1 ...)`.
+     */
+    void write(yarp::os::Bottle& result) const;
+
+private:
+    std::atomic<std::uint32_t> counts[buckets];
+    std::atomic<std::uint64_t> count {0};
+    std::atomic<std::uint64_t> totalNs {0};
+    std::atomic<std::uint64_t> maxNs {0};
+};
+
+
+/**
+ * Statistics about the messages transferred by a connection.
+ *
+ * For an output connection, the serialization time is the time spent by the
+ * PortWriter to write the message, and the transfer time is the time spent
+ * by the carrier to send it (and to receive the reply, if any).
+ * For an input connection, the transfer time is the time spent by the
+ * reader to read the message, including the user callback if any.
+ */
+class ConnectionStats
+{
+public:
+    ConnectionStats();
+
+    /**
+     * Record a message.
+     *
+     * @param bytes the size of the message, if known
+     * @param serialization the time spent serializing the message
+     * @param transfer the time spent transferring the message
+     */
+    void addMessage(size_t bytes, double serialization, double transfer);
+
+    /**
+     * Record a message not sent because the connection was still busy
+     * with the previous one.
+     */
+    void addSkipped();
+
+    void reset();
+
+    /**
+     * Append the statistics to \c result as a list of `(key value)` pairs:
+     * `messages`, `bytes`, `rate` (bytes per second), `elapsed` (time since
+     * the last reset), then for an output connection `skipped`, `serialize`
+     * and `write`, and for an input connection `read`.
+     */
+    void write(yarp::os::Bottle& result, bool isOutput) const;
+
+private:
+    std::atomic<double> since;
+    std::atomic<std::uint64_t> messages {0};
+    std::atomic<std::uint64_t> bytes {0};
+    std::atomic<std::uint64_t> skipped {0};
+    DurationHistogram serializationTime;
+    DurationHistogram transferTime;
+};
+
+} // namespace impl
+} // namespace os
+} // namespace yarp
+
+#endif // YARP_OS_IMPL_CONNECTIONSTATS_H
@@ -37,6 +37,7 @@
 #    include <unistd.h>
 #endif
 
+#include <algorithm>
 #include <cerrno>
 #include <cstring>
 
@@ -46,6 +47,14 @@ using namespace yarp::os;
 #define CRC_SIZE 8
 #define UDP_MAX_DATAGRAM_SIZE (65507 - CRC_SIZE)
 
+// On linux the datagrams that are already queued are received together with
+// recvmmsg, up to DGRAM_BATCH_MAX datagrams and DGRAM_BATCH_BYTES bytes.
+#if !defined(YARP_HAS_ACE) && defined(__linux__)
+#    define YARP_DGRAM_RECVMMSG 1
+#    define DGRAM_BATCH_MAX 32
+#    define DGRAM_BATCH_BYTES 524288
+#endif
+
 
 namespace {
 YARP_OS_LOG_COMPONENT(DGRAMTWOWAYSTREAM, "yarp.os.impl.DgramTwoWayStream")
@@ -243,6 +252,21 @@ void DgramTwoWayStream::allocate(int readSize, int writeSize)
 #endif
     }
 
+    // The delay after the long datagrams is proportional to their size only
+    // if requested, since it makes small datagrams sent much faster
+    scaledDelay = (NetworkBase::getEnvironment("YARP_DGRAM_SCALED_DELAY") == "1");
+
+    readSlots = 1;
+#if defined(YARP_DGRAM_RECVMMSG)
+    if (dgram_sockfd >= 0 && _read_size > 0) {
+        readSlots = std::max(1, std::min(DGRAM_BATCH_MAX, DGRAM_BATCH_BYTES / _read_size));
+    }
+#endif
+    readSlotSize = _read_size;
+    batchLengths.assign(readSlots, 0);
+    batchNext = 0;
+    batchCount = 0;
+
     readBuffer.allocate(_read_size);
     writeBuffer.allocate(_write_size);
     readAt = 0;
@@ -695,6 +719,47 @@ void DgramTwoWayStream::closeMain()
     happy = false;
 }
 
+#if !defined(YARP_HAS_ACE)
+yarp::conf::ssize_t DgramTwoWayStream::receive(yarp::conf::ssize_t& at)
+{
+#    if defined(YARP_DGRAM_RECVMMSG)
+    if (batchNext >= batchCount) {
+        // Wait for one datagram, and take also the ones that are already
+        // queued, each one in its slot of the read buffer. The slots are
+        // allocated here, so that they are not used by the senders.
+        if (readBuffer.length() < static_cast<size_t>(readSlots * readSlotSize)) {
+            readBuffer.allocate(readSlots * readSlotSize);
+        }
+        mmsghdr msgs[DGRAM_BATCH_MAX];
+        iovec iovs[DGRAM_BATCH_MAX];
+        memset(msgs, 0, sizeof(msgs));
+        for (int i = 0; i < readSlots; i++) {
+            iovs[i].iov_base = readBuffer.get() + i * readSlotSize;
+            iovs[i].iov_len = readSlotSize;
+            msgs[i].msg_hdr.msg_iov = &iovs[i];
+            msgs[i].msg_hdr.msg_iovlen = 1;
+        }
+        int count = recvmmsg(dgram_sockfd, msgs, readSlots, MSG_WAITFORONE, nullptr);
+        if (count <= 0) {
+            at = 0;
+            return -1;
+        }
+        for (int i = 0; i < count; i++) {
+            batchLengths[i] = msgs[i].msg_len;
+        }
+        batchNext = 0;
+        batchCount = count;
+        yCTrace(DGRAMTWOWAYSTREAM, "DGRAM Got %d datagrams", count);
+    }
+    at = batchNext * readSlotSize;
+    return batchLengths[batchNext++];
+#    else
+    at = 0;
+    return recv(dgram_sockfd, readBuffer.get(), readBuffer.length(), 0);
+#    endif
+}
+#endif
+
 yarp::conf::ssize_t DgramTwoWayStream::read(Bytes& b)
 {
     reader = true;
@@ -738,7 +803,7 @@ yarp::conf::ssize_t DgramTwoWayStream::read(Bytes& b)
                 yCTrace(DGRAMTWOWAYSTREAM, "DGRAM Waiting for something!");
                 result = dgram->recv(readBuffer.get(), readBuffer.length(), dummy);
 #else
-                result = recv(dgram_sockfd, readBuffer.get(), readBuffer.length(), 0);
+                result = receive(readAt);
 #endif
                 yCDebug(DGRAMTWOWAYSTREAM, "DGRAM Got %zd bytes", result);
             } else {
@@ -760,7 +825,7 @@ yarp::conf::ssize_t DgramTwoWayStream::read(Bytes& b)
 
             // deal with CRC
             int altPct = 0;
-            bool crcOk = checkCrc(readBuffer.get(), readAvail, CRC_SIZE, pct, &altPct);
+            bool crcOk = checkCrc(readBuffer.get() + readAt, readAvail, CRC_SIZE, pct, &altPct);
             if (altPct != -1) {
                 pct++;
                 if (!crcOk) {
@@ -890,8 +955,15 @@ void DgramTwoWayStream::flush()
             // looked at iperf, it just does a busy-waiting delay
             // there's an implementation below, but commented out -
             // better solution was to increase recv buffer size
+            // With YARP_DGRAM_SCALED_DELAY the delay is 1 ms for the largest
+            // datagrams, and shorter for the smaller ones, so that the byte
+            // rate is the same.
 
             double first = yarp::os::SystemClock::nowSystem();
+            double delay = 0.001;
+            if (scaledDelay) {
+                delay *= std::min(1.0, static_cast<double>(len) / UDP_MAX_DATAGRAM_SIZE);
+            }
             double now;
             int ct = 0;
             do {
@@ -899,7 +971,7 @@ void DgramTwoWayStream::flush()
                 yarp::os::SystemClock::delaySystem(0);
                 now = yarp::os::SystemClock::nowSystem();
                 ct++;
-            } while (now - first < 0.001);
+            } while (now - first < delay);
         }
 
         if (len < 0) {
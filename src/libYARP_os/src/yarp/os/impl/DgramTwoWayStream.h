@@ -15,6 +15,7 @@
 
 #include <cstdlib>
 #include <mutex>
+#include <vector>
 
 #ifdef YARP_HAS_ACE
 #    include <ace/SOCK_Dgram.h>
@@ -54,6 +55,11 @@ public:
             readAvail(0),
             writeAvail(0),
             pct(0),
+            readSlots(1),
+            readSlotSize(0),
+            batchNext(0),
+            batchCount(0),
+            scaledDelay(false),
             happy(true),
             bufferAlertNeeded(false),
             bufferAlerted(false),
@@ -177,6 +183,14 @@ private:
     std::mutex mutex;
     yarp::conf::ssize_t readAt, readAvail, writeAvail;
     int pct;
+    // readBuffer is split in readSlots slots, so that several datagrams
+    // can be received at once. batchLengths keeps the size of the ones
+    // received and not read yet, from batchNext to batchCount.
+    int readSlots;
+    yarp::conf::ssize_t readSlotSize;
+    int batchNext, batchCount;
+    std::vector<yarp::conf::ssize_t> batchLengths;
+    bool scaledDelay;
     bool happy;
     bool bufferAlertNeeded;
     bool bufferAlerted;
@@ -186,6 +200,8 @@ private:
 
     void allocate(int readSize = 0, int writeSize = 0);
 
+    yarp::conf::ssize_t receive(yarp::conf::ssize_t& at);
+
     void configureSystemBuffers();
 };
 
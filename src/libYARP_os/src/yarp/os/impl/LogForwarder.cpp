@@ -8,27 +8,264 @@
 
 #include <yarp/os/impl/LogForwarder.h>
 
+#include <yarp/os/Bottle.h>
 #include <yarp/os/Log.h>
 #include <yarp/os/NetType.h>
 #include <yarp/os/Network.h>
 #include <yarp/os/Os.h>
+#include <yarp/os/SystemClock.h>
 #include <yarp/os/SystemInfo.h>
 #include <yarp/os/Time.h>
 #include <yarp/os/impl/PlatformLimits.h>
+#include <yarp/os/impl/Storable.h>
 
+#include <chrono>
+#include <cstring>
+#include <iomanip>
 #include <sstream>
 
-bool yarp::os::impl::LogForwarder::started{false};
+using yarp::os::Bottle;
+using yarp::os::impl::LogForwarder;
 
-yarp::os::impl::LogForwarder& yarp::os::impl::LogForwarder::getInstance()
+namespace {
+
+inline bool from_env(const char* name, bool defaultvalue)
+{
+    const char *strvalue = yarp::os::getenv(name);
+
+    if(!strvalue) { return defaultvalue; }
+
+    if(strcmp(strvalue, "1") == 0) { return true; }
+    if(strcmp(strvalue, "true") == 0) { return true; }
+    if(strcmp(strvalue, "True") == 0) { return true; }
+    if(strcmp(strvalue, "TRUE") == 0) { return true; }
+    if(strcmp(strvalue, "on") == 0) { return true; }
+    if(strcmp(strvalue, "On") == 0) { return true; }
+    if(strcmp(strvalue, "ON") == 0) { return true; }
+
+    if(strcmp(strvalue, "0") == 0) { return false; }
+    if(strcmp(strvalue, "false") == 0) { return false; }
+    if(strcmp(strvalue, "False") == 0) { return false; }
+    if(strcmp(strvalue, "FALSE") == 0) { return false; }
+    if(strcmp(strvalue, "off") == 0) { return false; }
+    if(strcmp(strvalue, "Off") == 0) { return false; }
+    if(strcmp(strvalue, "OFF") == 0) { return false; }
+
+    return defaultvalue;
+}
+
+// Maximum number of messages queued, must be a power of 2
+constexpr size_t queue_size = 4096;
+
+// Maximum number of messages sent in a single Bottle
+constexpr size_t max_batch_size = 256;
+
+// Interval between two batches
+constexpr std::chrono::milliseconds batch_period(10);
+
+void addField(Bottle& record, const char* key, const std::string& value)
+{
+    Bottle& field = record.addList();
+    field.addString(key);
+    field.addString(value);
+}
+
+void addField(Bottle& record, const char* key, double value)
+{
+    Bottle& field = record.addList();
+    field.addString(key);
+    field.addFloat64(value);
+}
+
+void addField(Bottle& record, const char* key, std::int32_t value)
+{
+    Bottle& field = record.addList();
+    field.addString(key);
+    field.addInt32(value);
+}
+
+void addField(Bottle& record, const char* key, std::int64_t value)
+{
+    Bottle& field = record.addList();
+    field.addString(key);
+    field.addInt64(value);
+}
+
+double networkTime(double systemtime)
+{
+    return (!yarp::os::NetworkBase::isNetworkInitialized() ? 0.0 : (yarp::os::Time::isSystemClock() ? systemtime : yarp::os::Time::now()));
+}
+
+} // namespace
+
+
+LogForwarder::Queue::Queue(size_t size) :
+        cells(new Cell[size]),
+        mask(size - 1)
+{
+    for (size_t i = 0; i < size; ++i) {
+        cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+LogForwarder::Queue::~Queue() = default;
+
+bool LogForwarder::Queue::push(Record&& record)
+{
+    size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+    Cell* cell;
+    while (true) {
+        cell = &cells[pos & mask];
+        size_t seq = cell->sequence.load(std::memory_order_acquire);
+        auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+        if (diff == 0) {
+            if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // Full
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            droppedTotal.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        } else {
+            pos = enqueue_pos.load(std::memory_order_relaxed);
+        }
+    }
+    cell->record = std::move(record);
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+bool LogForwarder::Queue::pop(Record& record)
+{
+    size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+    Cell* cell;
+    while (true) {
+        cell = &cells[pos & mask];
+        size_t seq = cell->sequence.load(std::memory_order_acquire);
+        auto diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos + 1);
+        if (diff == 0) {
+            if (dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if (diff < 0) {
+            // Empty
+            return false;
+        } else {
+            pos = dequeue_pos.load(std::memory_order_relaxed);
+        }
+    }
+    record = std::move(cell->record);
+    cell->sequence.store(pos + mask + 1, std::memory_order_release);
+    return true;
+}
+
+std::uint64_t LogForwarder::Queue::takeDropped()
+{
+    return dropped.exchange(0, std::memory_order_relaxed);
+}
+
+std::uint64_t LogForwarder::Queue::getDroppedCount() const
+{
+    return droppedTotal.load(std::memory_order_relaxed);
+}
+
+
+bool LogForwarder::started{false};
+
+LogForwarder& LogForwarder::getInstance()
 {
     static LogForwarder instance;
     return instance;
 }
 
-yarp::os::impl::LogForwarder::~LogForwarder() = default;
+// The fields are the same written by forwardable_output() in Log.cpp, but
+// the values are typed
+void LogForwarder::toBottle(const Record& record, Bottle& b)
+{
+    addField(b, "level", std::string(record.level));
+    addField(b, "systemtime", record.systemtime);
+    addField(b, "networktime", record.networktime);
+    if (record.customtime != 0.0) {
+        addField(b, "customtime", record.customtime);
+    }
+    if (record.codeinfo) {
+        addField(b, "filename", record.filename);
+        addField(b, "line", static_cast<std::int32_t>(record.line));
+        addField(b, "function", record.function);
+    }
+    if (record.hostname) {
+        static std::string hostname(yarp::os::gethostname());
+        addField(b, "hostname", hostname);
+    }
+    if (record.processinfo) {
+        static yarp::os::SystemInfo::ProcessInfo processInfo(yarp::os::SystemInfo::getProcessInfo());
+        static std::string cmd(processInfo.name.substr(processInfo.name.find_last_of("\\/") + 1));
+        addField(b, "pid", static_cast<std::int32_t>(processInfo.pid));
+        addField(b, "cmd", cmd);
+        addField(b, "args", processInfo.arguments);
+        addField(b, "thread_id", static_cast<std::int64_t>(record.thread_id));
+    }
+    if (!record.component.empty()) {
+        addField(b, "component", record.component);
+    }
+    if (!record.message.empty()) {
+        addField(b, "message", record.message);
+    }
+    if (!record.backtrace.empty()) {
+        addField(b, "backtrace", record.backtrace);
+    }
+}
+
+// Same string generated by forwardable_output() in Log.cpp
+std::string LogForwarder::toString(const Record& record)
+{
+    using yarp::os::impl::StoreString;
 
-yarp::os::impl::LogForwarder::LogForwarder()
+    std::ostringstream ost;
+    ost << "(level " << StoreString::quotedString(record.level) << ")";
+    ost << " (systemtime " << yarp::os::NetType::toString(record.systemtime) << ")";
+    ost << " (networktime " << yarp::os::NetType::toString(record.networktime) << ")";
+    if (record.customtime != 0.0) {
+        ost << " (customtime " << yarp::os::NetType::toString(record.customtime) << ")";
+    }
+    if (record.codeinfo) {
+        ost << " (filename " << StoreString::quotedString(record.filename) << ")";
+        ost << " (line " << record.line << ")";
+        ost << " (function " << StoreString::quotedString(record.function) << ")";
+    }
+    if (record.hostname) {
+        static std::string hostname(yarp::os::gethostname());
+        ost << " (hostname " << StoreString::quotedString(hostname) << ")";
+    }
+    if (record.processinfo) {
+        static yarp::os::SystemInfo::ProcessInfo processInfo(yarp::os::SystemInfo::getProcessInfo());
+        static std::string cmd(processInfo.name.substr(processInfo.name.find_last_of("\\/") + 1));
+        ost << " (pid " << processInfo.pid << ")";
+        ost << " (cmd " << StoreString::quotedString(cmd) << ")";
+        ost << " (args " << StoreString::quotedString(processInfo.arguments) << ")";
+        ost << " (thread_id 0x" << std::setfill('0') << std::setw(8) << yarp::os::NetType::toHexString(record.thread_id) << ")";
+    }
+    if (!record.component.empty()) {
+        ost << " (component " << StoreString::quotedString(record.component) << ")";
+    }
+    if (!record.message.empty()) {
+        ost << " (message " << StoreString::quotedString(record.message) << ")";
+    }
+    if (!record.backtrace.empty()) {
+        ost << " (backtrace " << StoreString::quotedString(record.backtrace) << ")";
+    }
+    return ost.str();
+}
+
+LogForwarder::~LogForwarder()
+{
+    stop();
+}
+
+LogForwarder::LogForwarder() :
+        queue(queue_size),
+        batched(from_env("YARP_FORWARD_BATCH_ENABLE", false))
 {
     char hostname[HOST_NAME_MAX];
     yarp::os::gethostname(hostname, HOST_NAME_MAX);
@@ -40,40 +277,122 @@ yarp::os::impl::LogForwarder::LogForwarder()
     if (!outputPort.open(logPortName)) {
         printf("LogForwarder error while opening port %s\n", logPortName.c_str());
     }
-    outputPort.enableBackgroundWrite(true);
-    outputPort.addOutput("/yarplogger", "fast_tcp");
+    if (batched) {
+        // The yarplogger of the previous versions cannot parse the batches.
+        // The messages are written by the forwarder thread, therefore
+        // waiting for the acknowledgement does not slow down the logging
+        // threads, and large batches sent back to back over fast_tcp could
+        // be lost by the receiver.
+        outputPort.addOutput("/yarplogger", "tcp");
+    } else {
+        outputPort.addOutput("/yarplogger", "fast_tcp");
+    }
+
+    thread = std::thread(&LogForwarder::run, this);
 
     started = true;
 }
 
-void yarp::os::impl::LogForwarder::forward(const std::string& message)
+bool LogForwarder::forward(Record&& record)
+{
+    return queue.push(std::move(record));
+}
+
+std::uint64_t LogForwarder::getDroppedCount() const
 {
-    mutex.lock();
-    static Bottle b;
+    return queue.getDroppedCount();
+}
+
+bool LogForwarder::send(const std::string& port, Bottle& b)
+{
+    // Sends either a single message or a batch of messages
+    auto write = [&](const Record& record) {
+        if (batched) {
+            toBottle(record, b.addList());
+        } else {
+            b.clear();
+            b.addString(port);
+            b.addString(toString(record));
+            outputPort.write(b);
+        }
+    };
+
     b.clear();
-    std::string port = "[" + outputPort.getName() + "]";
     b.addString(port);
-    b.addString(message);
-    outputPort.write(b);
-    mutex.unlock();
+
+    size_t count = 0;
+    std::uint64_t lost = queue.takeDropped();
+    if (lost != 0) {
+        Record warning;
+        warning.level = "WARNING";
+        warning.systemtime = yarp::os::SystemClock::nowSystem();
+        warning.networktime = networkTime(warning.systemtime);
+        warning.message = std::to_string(lost) + " log messages were dropped because the forwarding queue was full";
+        write(warning);
+        ++count;
+    }
+
+    Record record;
+    while (count < max_batch_size && queue.pop(record)) {
+        write(record);
+        ++count;
+    }
+
+    if (count == 0) {
+        return false;
+    }
+    if (batched) {
+        outputPort.write(b);
+    }
+    return true;
 }
 
-void yarp::os::impl::LogForwarder::shutdown()
+void LogForwarder::run()
 {
-    if (started) {
-        std::ostringstream ost;
-        auto systemtime = yarp::os::SystemClock::nowSystem();
-        auto networktime = (!yarp::os::NetworkBase::isNetworkInitialized() ? 0.0 : (yarp::os::Time::isSystemClock() ? systemtime : yarp::os::Time::now()));
-
-        ost << "(level INFO)";
-        ost << " (systemtime " << yarp::os::NetType::toString(systemtime)  << ")";
-        ost << " (networktime " << yarp::os::NetType::toString(networktime)  << ")";
-
-        yarp::os::impl::LogForwarder& fw = getInstance();
-        fw.forward(ost.str());
-        while (fw.outputPort.isWriting()) {
-            yarp::os::SystemClock::delaySystem(0.2);
+    const std::string port = "[" + outputPort.getName() + "]";
+    Bottle b;
+
+    bool done = false;
+    while (!done) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cv.wait_for(lock, batch_period, [this]() { return stopping; });
+            done = stopping;
         }
+
+        // At most max_batch_size messages are sent every period, in order
+        // not to flood the receiver. When stopping, everything left in the queue is sent.
+        bool sent = send(port, b);
+        while (done && sent) {
+            std::this_thread::sleep_for(batch_period);
+            sent = send(port, b);
+        }
+    }
+}
+
+void LogForwarder::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    cv.notify_one();
+    if (thread.joinable()) {
+        thread.join();
+    }
+}
+
+void LogForwarder::shutdown()
+{
+    if (started) {
+        Record record;
+        record.level = "INFO";
+        record.systemtime = yarp::os::SystemClock::nowSystem();
+        record.networktime = networkTime(record.systemtime);
+
+        LogForwarder& fw = getInstance();
+        fw.forward(std::move(record));
+        fw.stop();
         fw.outputPort.interrupt();
         fw.outputPort.close();
     }
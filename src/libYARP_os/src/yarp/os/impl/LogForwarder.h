@@ -11,30 +11,160 @@
 
 #include <yarp/os/api.h>
 
+#include <yarp/os/Bottle.h>
 #include <yarp/os/Port.h>
 
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
 #include <mutex>
 #include <string>
+#include <thread>
 
 namespace yarp {
 namespace os {
 namespace impl {
 
+/**
+ * Forwards the log messages to the yarplogger.
+ *
+ * The messages are pushed in a bounded lock-free queue, and a background
+ * thread sends them to the yarplogger.
+ * By default each message is sent in a Bottle containing the name of the
+ * port and the message formatted as a string, using the fast_tcp carrier.
+ * If YARP_FORWARD_BATCH_ENABLE is set, the messages are sent in batches
+ * using the tcp carrier, each one a Bottle containing the name of the port
+ * followed by one list of (key value) pairs with typed values per message.
+ * The yarplogger of the previous versions cannot parse the batches.
+ * The messages that do not fit in the queue are dropped, and the number of
+ * messages dropped is forwarded as a warning.
+ */
 class YARP_os_impl_API LogForwarder
 {
 public:
+    /**
+     * A log message, with the optional fields that should be forwarded.
+     */
+    struct Record
+    {
+        const char* level {nullptr};
+        std::string message;
+        double systemtime {0.0};
+        double networktime {0.0};
+        double customtime {0.0};
+        bool codeinfo {false};
+        std::string filename;
+        unsigned int line {0};
+        std::string function;
+        bool hostname {false};
+        bool processinfo {false};
+        long thread_id {0};
+        std::string component;
+        std::string backtrace;
+    };
+
+    /**
+     * Bounded multiple producers multiple consumers queue of records.
+     *
+     * Each cell holds a sequence number telling whether it can be written
+     * or read at the current position, so that the producers and the
+     * consumers only need to reserve a position with a compare and swap.
+     */
+    class YARP_os_impl_API Queue
+    {
+    public:
+        /**
+         * @param size the maximum number of records, must be a power of 2.
+         */
+        explicit Queue(size_t size);
+        ~Queue();
+
+        /**
+         * Pushes a record, without blocking.
+         *
+         * @return false if the queue was full and the record was dropped.
+         */
+        bool push(Record&& record);
+
+        /**
+         * Pops the oldest record, without blocking.
+         *
+         * @return false if the queue was empty.
+         */
+        bool pop(Record& record);
+
+        /**
+         * @return the number of records dropped since the last call.
+         */
+        std::uint64_t takeDropped();
+
+        /**
+         * @return the number of records dropped since the queue was created.
+         */
+        std::uint64_t getDroppedCount() const;
+
+    private:
+        struct Cell
+        {
+            std::atomic<size_t> sequence;
+            Record record;
+        };
+
+        std::unique_ptr<Cell[]> cells;
+        const size_t mask;
+        std::atomic<size_t> enqueue_pos {0};
+        std::atomic<size_t> dequeue_pos {0};
+        std::atomic<std::uint64_t> dropped {0};
+        std::atomic<std::uint64_t> droppedTotal {0};
+    };
+
     ~LogForwarder();
     static LogForwarder& getInstance();
 
-    void forward(const std::string& message);
+    /**
+     * Appends the fields of a message to a list, as (key value) pairs with
+     * typed values (batched format).
+     */
+    static void toBottle(const Record& record, yarp::os::Bottle& b);
+
+    /**
+     * Formats a message as a string, that can be parsed by a Property
+     * (single message format).
+     */
+    static std::string toString(const Record& record);
+
+    /**
+     * Queues a message for forwarding.
+     * This method never blocks.
+     *
+     * @return false if the queue was full and the message was dropped.
+     */
+    bool forward(Record&& record);
     static void shutdown();
 
+    /**
+     * @return the number of messages dropped because the queue was full.
+     */
+    std::uint64_t getDroppedCount() const;
+
 private:
     LogForwarder();
     LogForwarder(LogForwarder const&) = delete;
     LogForwarder& operator=(LogForwarder const&) = delete;
 
+    bool send(const std::string& port, yarp::os::Bottle& b);
+    void run();
+    void stop();
+
+    Queue queue;
+    bool batched {false};
+
     std::mutex mutex;
+    std::condition_variable cv;
+    bool stopping {false};
+    std::thread thread;
+
     yarp::os::Port outputPort;
     static bool started;
 };
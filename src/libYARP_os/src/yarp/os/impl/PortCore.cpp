@@ -85,6 +85,7 @@ PortCore::PortCore() :
         m_dataOutputCount(0),
         m_flags(PORTCORE_IS_INPUT | PORTCORE_IS_OUTPUT),
         m_logNeeded(false),
+        m_statsEnabled(NetworkBase::getEnvironment("YARP_PORT_STATS") == "1"),
         m_timeout(-1),
         m_counter(1),
         m_prop(nullptr),
@@ -575,6 +576,21 @@ int PortCore::getEventCount()
     return ct;
 }
 
+void PortCore::setStatsEnabled(bool enabled)
+{
+    m_stateSemaphore.wait();
+    if (enabled && !m_statsEnabled.load()) {
+        // Start counting from now
+        for (auto* unit : m_units) {
+            if (unit != nullptr) {
+                unit->getStats().reset();
+            }
+        }
+    }
+    m_statsEnabled = enabled;
+    m_stateSemaphore.post();
+}
+
 
 void PortCore::closeUnits()
 {
@@ -705,6 +721,9 @@ void PortCore::cleanUnits(bool blocking)
     m_packetMutex.lock();
     m_inputCount = updatedInputCount;
     m_outputCount = updatedOutputCount;
+    // Each output connection can hold on to a message while the next one is
+    // being sent, allocate enough packets to avoid doing it while sending.
+    m_packets.reserve(static_cast<size_t>(updatedOutputCount) + 2);
     m_packetMutex.unlock();
     yCDebug(PORTCORE, "\\ routine check of connections to this port ends");
 }
@@ -1357,15 +1376,34 @@ bool PortCore::sendHelper(const PortWriter& writer,
     }
 
     yCTrace(PORTCORE, "------- send in");
+
+    // Count the connections that will carry the message, so that the
+    // packet can be prepared with a single lock.  A connection may finish
+    // before we get to it, the count is adjusted at the end.
+    int expected = 0;
+    for (auto unit : m_units) {
+        if ((unit != nullptr) && unit->isOutput() && !unit->isFinished()) {
+            bool log = (!unit->getMode().empty());
+            bool ok = (mode == PORTCORE_SEND_NORMAL) ? (!log) : (log);
+            if (ok) {
+                expected++;
+            }
+        }
+    }
+
     // Prepare a "packet" for tracking a single message which
     // may travel by multiple outputs.
     m_packetMutex.lock();
     PortCorePacket* packet = m_packets.getFreePacket();
     yCAssert(PORTCORE, packet != nullptr);
     packet->setContent(&writer, false, callback);
+    for (int i = 0; i < expected; i++) {
+        packet->inc(); // One more connection carrying message.
+    }
     m_packetMutex.unlock();
 
     // Scan connections, placing message everyhere we can.
+    int sent = 0;
     for (auto unit : m_units) {
         if ((unit != nullptr) && unit->isOutput() && !unit->isFinished()) {
             bool log = (!unit->getMode().empty());
@@ -1377,11 +1415,15 @@ bool PortCore::sendHelper(const PortWriter& writer,
             if (!ok) {
                 continue;
             }
+            if (sent == expected) {
+                // A connection we did not count (should not happen)
+                m_packetMutex.lock();
+                packet->inc();
+                m_packetMutex.unlock();
+                expected++;
+            }
+            sent++;
             bool waiter = m_waitAfterSend || (mode == PORTCORE_SEND_LOG);
-            yCTrace(PORTCORE, "------- -- inc");
-            m_packetMutex.lock();
-            packet->inc(); // One more connection carrying message.
-            m_packetMutex.unlock();
             yCTrace(PORTCORE, "------- -- presend");
             bool gotReplyOne = false;
             // Send the message off on this connection.
@@ -1418,6 +1460,11 @@ bool PortCore::sendHelper(const PortWriter& writer,
     // But that is not our problem anymore.
     packet->dec();
 
+    // Connections that finished before we could send the message on them
+    for (int i = sent; i < expected; i++) {
+        packet->dec();
+    }
+
     m_packets.checkPacket(packet);
     m_packetMutex.unlock();
     yCTrace(PORTCORE, "------- packed");
@@ -1588,6 +1635,7 @@ enum class PortCoreCommand : yarp::conf::vocab32_t
     Set = yarp::os::createVocab('s', 'e', 't'),
     Get = yarp::os::createVocab('g', 'e', 't'),
     Prop = yarp::os::createVocab('p', 'r', 'o', 'p'),
+    Stats = yarp::os::createVocab('s', 't', 'a', 't'),
     RosPublisherUpdate = yarp::os::createVocab('r', 'p', 'u', 'p'),
     RosRequestTopic = yarp::os::createVocab('r', 't', 'o', 'p'),
     RosGetPid = yarp::os::createVocab('p', 'i', 'd'),
@@ -1626,6 +1674,9 @@ PortCoreCommand parseCommand(const yarp::os::Value& v)
         if (cmd == "getBusInfo") {
             return PortCoreCommand::RosGetBusInfo;
         }
+        if (cmd == "stats") {
+            return PortCoreCommand::Stats;
+        }
     }
 
     auto cmd = static_cast<PortCoreCommand>(v.asVocab());
@@ -1641,6 +1692,7 @@ PortCoreCommand parseCommand(const yarp::os::Value& v)
     case PortCoreCommand::Set:
     case PortCoreCommand::Get:
     case PortCoreCommand::Prop:
+    case PortCoreCommand::Stats:
     case PortCoreCommand::RosPublisherUpdate:
     case PortCoreCommand::RosRequestTopic:
     case PortCoreCommand::RosGetPid:
@@ -1743,6 +1795,9 @@ bool PortCore::adminBlock(ConnectionReader& reader,
         result.addString("[atch] [in]  $prop      # attach a portmonitor plug-in to the port's input");
         result.addString("[dtch] [out]            # detach portmonitor plug-in from the port's output");
         result.addString("[dtch] [in]             # detach portmonitor plug-in from the port's input");
+        result.addString("[stats]                 # get the statistics of the connections");
+        result.addString("[stats] on|off          # enable or disable the statistics of the connections");
+        result.addString("[stats] reset           # reset the statistics of the connections");
         //result.addString("[atch] $portname $prop  # attach a portmonitor plug-in to the connection to/from $portname");
         //result.addString("[dtch] $portname        # detach any portmonitor plug-in from the connection to/from $portname");
         return result;
@@ -2269,6 +2324,15 @@ bool PortCore::adminBlock(ConnectionReader& reader,
                         port_prop.put("is_output", is_output);
                         port_prop.put("is_rpc", is_rpc);
                         port_prop.put("type", getType().getName());
+
+                        m_packetMutex.lock();
+                        Bottle& packets = result.addList();
+                        packets.addString("packets");
+                        Property& packets_prop = packets.addDict();
+                        packets_prop.put("active", static_cast<int>(m_packets.getCount()));
+                        packets_prop.put("capacity", static_cast<int>(m_packets.getCapacity()));
+                        packets_prop.put("grow_count", static_cast<int>(m_packets.getGrowCount()));
+                        m_packetMutex.unlock();
                     } else {
                         for (auto unit : m_units) {
                             if ((unit != nullptr) && !unit->isFinished()) {
@@ -2598,6 +2662,80 @@ bool PortCore::adminBlock(ConnectionReader& reader,
         return result;
     };
 
+    auto handleAdminStatsCmd = [this](const std::string& action) {
+        Bottle result;
+        if (action == "on" || action == "off") {
+            setStatsEnabled(action == "on");
+            result.addVocab(Vocab::encode("ok"));
+            return result;
+        }
+        if (!action.empty() && action != "reset") {
+            result.addVocab(Vocab::encode("fail"));
+            result.addString("stats action not known");
+            return result;
+        }
+
+        // Messages dropped by the reader (e.g. a BufferedPort)
+        size_t dropped = getReaderDropCount();
+
+        m_stateSemaphore.wait();
+        if (action == "reset") {
+            for (auto* unit : m_units) {
+                if (unit != nullptr) {
+                    unit->getStats().reset();
+                }
+            }
+            m_stateSemaphore.post();
+            result.addVocab(Vocab::encode("ok"));
+            return result;
+        }
+
+        Bottle& benabled = result.addList();
+        benabled.addString("enabled");
+        benabled.addInt32(isStatsEnabled() ? 1 : 0);
+
+        // Messages in flight on the output connections
+        Bottle& bpackets = result.addList();
+        bpackets.addString("packets");
+        m_packetMutex.lock();
+        bpackets.addInt32(static_cast<int>(m_packets.getCount()));
+        m_packetMutex.unlock();
+
+        Bottle& bdropped = result.addList();
+        bdropped.addString("dropped");
+        bdropped.addInt64(static_cast<std::int64_t>(dropped));
+
+        for (auto* unit : m_units) {
+            if ((unit == nullptr) || unit->isFinished()) {
+                continue;
+            }
+            Route route = unit->getRoute();
+            if (unit->isOutput()) {
+                Bottle& bunit = result.addList();
+                bunit.addString("out");
+                Bottle& bto = bunit.addList();
+                bto.addString("to");
+                bto.addString(route.getToName());
+                Bottle& bcarrier = bunit.addList();
+                bcarrier.addString("carrier");
+                bcarrier.addString(route.getCarrierName());
+                unit->getStats().write(bunit, true);
+            } else if (unit->isInput() && !route.getFromName().empty()) {
+                Bottle& bunit = result.addList();
+                bunit.addString("in");
+                Bottle& bfrom = bunit.addList();
+                bfrom.addString("from");
+                bfrom.addString(route.getFromName());
+                Bottle& bcarrier = bunit.addList();
+                bcarrier.addString("carrier");
+                bcarrier.addString(route.getCarrierName());
+                unit->getStats().write(bunit, false);
+            }
+        }
+        m_stateSemaphore.post();
+        return result;
+    };
+
     auto handleAdminUnknownCmd = [this](const Bottle& cmd) {
         Bottle result;
         bool ok = false;
@@ -2705,6 +2843,9 @@ bool PortCore::adminBlock(ConnectionReader& reader,
             break;
         }
     } break;
+    case PortCoreCommand::Stats:
+        result = handleAdminStatsCmd(cmd.get(1).asString());
+        break;
     case PortCoreCommand::RosPublisherUpdate: {
         yCDebug(PORTCORE, "publisherUpdate! --> %s", cmd.toString().c_str());
         // std::string caller_id = cmd.get(1).asString(); // Currently unused
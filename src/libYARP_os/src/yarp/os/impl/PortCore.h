@@ -32,6 +32,7 @@
 #undef YARP_INCLUDING_DEPRECATED_HEADER_ON_PURPOSE
 #endif
 
+#include <atomic>
 #include <mutex>
 #include <vector>
 
@@ -419,6 +420,31 @@ public:
      */
     int getEventCount();
 
+    /**
+     * Enable or disable the statistics of the connections of the port
+     * (see the `stats` administrative command).
+     * They are enabled by default if the YARP_PORT_STATS environment
+     * variable is set to 1.
+     */
+    void setStatsEnabled(bool enabled);
+
+    /**
+     * @return true if the statistics of the connections are enabled.
+     */
+    bool isStatsEnabled() const
+    {
+        return m_statsEnabled.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @return the number of messages dropped by the reader of the port,
+     * e.g. by a BufferedPort that keeps only the latest message.
+     */
+    virtual size_t getReaderDropCount()
+    {
+        return 0;
+    }
+
     /**
      * Get the address associated with the port.
      */
@@ -543,6 +569,7 @@ private:
     unsigned int m_flags;      ///< binary flags encoding restrictions on port
     bool m_logNeeded; ///< port needs to monitor message content
     PortCorePackets m_packets; ///< a pool for tracking messages currently being sent
+    std::atomic<bool> m_statsEnabled; ///< are the statistics of the connections collected?
     std::string m_envelope;///< user-defined wrapping data
     float m_timeout;  ///< a timeout to apply to all network operations
     int m_counter;    ///< port-unique ids for connections
@@ -10,6 +10,7 @@
 #include <yarp/os/impl/PortCoreAdapter.h>
 
 #include <yarp/os/PortReader.h>
+#include <yarp/os/PortReaderBufferBase.h>
 #include <yarp/os/Time.h>
 #include <yarp/os/impl/LogComponent.h>
 
@@ -315,6 +316,13 @@ yarp::os::PortReaderCreator* yarp::os::impl::PortCoreAdapter::checkReadCreator()
     return recReadCreator;
 }
 
+size_t yarp::os::impl::PortCoreAdapter::getReaderDropCount()
+{
+    // The permanent reader is set only once, when the port is configured
+    auto* buffer = dynamic_cast<PortReaderBufferBase*>(permanentReadDelegate);
+    return (buffer != nullptr) ? buffer->getDropCount() : 0;
+}
+
 int yarp::os::impl::PortCoreAdapter::checkWaitAfterSend()
 {
     return recWaitAfterSend;
@@ -98,6 +98,7 @@ YARP_WARNING_POP
     PortReader* checkPortReader();
     PortReader* checkAdminPortReader();
     PortReaderCreator* checkReadCreator();
+    size_t getReaderDropCount() override;
     int checkWaitAfterSend();
     bool isOpened();
     void setOpen(bool opened);
@@ -13,6 +13,7 @@
 #include <yarp/os/Os.h>
 #include <yarp/os/PortInfo.h>
 #include <yarp/os/PortReport.h>
+#include <yarp/os/SystemClock.h>
 #include <yarp/os/Time.h>
 #include <yarp/os/impl/BufferedConnectionWriter.h>
 #include <yarp/os/impl/LogComponent.h>
@@ -182,6 +183,8 @@ void PortCoreInputUnit::run()
 
         if (br.getReference() != nullptr) {
             //printf("HAVE A REFERENCE\n");
+            const bool statsEnabled = getOwner().isStatsEnabled();
+            double start = statsEnabled ? SystemClock::nowSystem() : 0.0;
             if (localReader != nullptr) {
                 bool ok = localReader->read(br);
                 if (!br.isActive()) {
@@ -201,6 +204,9 @@ void PortCoreInputUnit::run()
                 }
             }
             //printf("DONE WITH A REFERENCE\n");
+            if (statsEnabled) {
+                getStats().addMessage(0, -1.0, SystemClock::nowSystem() - start);
+            }
             if (ip != nullptr) {
                 ip->endRead();
             }
@@ -276,6 +282,10 @@ void PortCoreInputUnit::run()
                 man.setEnvelope(env2);
                 ip->setEnvelope(env2);
             }
+            // The time spent by the reader, including the user callback
+            const bool statsEnabled = man.isStatsEnabled();
+            double start = statsEnabled ? SystemClock::nowSystem() : 0.0;
+            size_t size = statsEnabled ? br.getSize() : 0;
             if (localReader != nullptr) {
                 localReader->read(br);
                 if (!br.isActive()) {
@@ -308,6 +318,9 @@ void PortCoreInputUnit::run()
                     break;
                 }
             }
+            if (statsEnabled) {
+                getStats().addMessage(size, -1.0, SystemClock::nowSystem() - start);
+            }
         } break;
         case 'a': {
             man.adminBlock(br, id);
@@ -13,6 +13,7 @@
 #include <yarp/os/PortInfo.h>
 #include <yarp/os/PortReport.h>
 #include <yarp/os/Portable.h>
+#include <yarp/os/SystemClock.h>
 #include <yarp/os/Time.h>
 #include <yarp/os/impl/BufferedConnectionWriter.h>
 #include <yarp/os/impl/LogComponent.h>
@@ -257,6 +258,9 @@ bool PortCoreOutputUnit::sendHelper()
     bool replied = false;
     if (op != nullptr) {
         bool done = false;
+        const bool statsEnabled = getOwner().isStatsEnabled();
+        double start = statsEnabled ? SystemClock::nowSystem() : 0.0;
+        double serialized = -1.0;
         BufferedConnectionWriter buf(op->getConnection().isTextMode(),
                                      op->getConnection().isBareMode());
         if (cachedReader != nullptr) {
@@ -289,6 +293,9 @@ bool PortCoreOutputUnit::sendHelper()
             if (!ok) {
                 done = true;
             }
+            if (statsEnabled) {
+                serialized = SystemClock::nowSystem();
+            }
 
             bool suppressReply = (buf.getReplyHandler() == nullptr);
 
@@ -322,6 +329,14 @@ bool PortCoreOutputUnit::sendHelper()
                 if (replied && op->getSender().modifiesReply() && cachedReader != nullptr) {
                     cachedReader = &op->getSender().modifyReply(*cachedReader);
                 }
+                if (statsEnabled) {
+                    double now = SystemClock::nowSystem();
+                    if (serialized < 0.0) {
+                        getStats().addMessage(buf.dataSize(), -1.0, now - start);
+                    } else {
+                        getStats().addMessage(buf.dataSize(), serialized - start, now - serialized);
+                    }
+                }
             }
             if (!op->isOk()) {
                 done = true;
@@ -393,6 +408,9 @@ void* PortCoreOutputUnit::send(const yarp::os::PortWriter& writer,
         }
     } else {
         yCDebug(PORTCOREOUTPUTUNIT, "skipping connection tagged as sending something");
+        if (getOwner().isStatsEnabled()) {
+            getStats().addSkipped();
+        }
     }
 
     if (waitAfter) {
@@ -20,30 +20,58 @@ YARP_OS_LOG_COMPONENT(PORTCOREPACKETS, "yarp.os.impl.PortCorePackets")
 
 PortCorePackets::~PortCorePackets()
 {
-    while (!inactive.empty()) {
-        delete inactive.back();
-        inactive.pop_back();
+    // Destroying the blocks destroys all the packets, active or not
+    inactive = nullptr;
+    active = nullptr;
+    blocks.clear();
+}
+
+void PortCorePackets::allocate(size_t count)
+{
+    if (count == 0) {
+        return;
     }
-    while (!active.empty()) {
-        delete active.back();
-        active.pop_back();
+    blocks.emplace_back(new PortCorePacket[count]);
+    PortCorePacket* block = blocks.back().get();
+    for (size_t i = 0; i < count; i++) {
+        block[i].prev_ = nullptr;
+        block[i].next_ = inactive;
+        inactive = &block[i];
     }
+    capacity += count;
 }
 
 size_t PortCorePackets::getCount()
 {
-    return active.size();
+    return activeCount;
+}
+
+size_t PortCorePackets::getCapacity()
+{
+    return capacity;
+}
+
+size_t PortCorePackets::getGrowCount()
+{
+    return growCount;
+}
+
+void PortCorePackets::reserve(size_t count)
+{
+    if (count > capacity) {
+        allocate(count - capacity);
+    }
 }
 
 PortCorePacket* PortCorePackets::getFreePacket()
 {
-    if (inactive.empty()) {
-        PortCorePacket* obj = nullptr;
-        obj = new PortCorePacket();
-        yCAssert(PORTCOREPACKETS, obj != nullptr);
-        inactive.push_back(obj);
+    if (inactive == nullptr) {
+        // Double the size of the pool
+        allocate((capacity != 0) ? capacity : 1);
+        growCount++;
+        yCDebug(PORTCOREPACKETS, "Packet pool grown to %zu packets", capacity);
     }
-    PortCorePacket* next = inactive.front();
+    PortCorePacket* next = inactive;
     if (next == nullptr) {
         yCError(PORTCOREPACKETS, "*** YARP consistency check failed.\n");
         yCError(PORTCOREPACKETS, "*** There has been a low-level failure in \"PortCorePackets\".\n");
@@ -51,8 +79,15 @@ PortCorePacket* PortCorePackets::getFreePacket()
         yCError(PORTCOREPACKETS, "*** For help: https://github.com/robotology/yarp/issues/new\n");
     }
     yCAssert(PORTCOREPACKETS, next != nullptr);
-    inactive.remove(next);
-    active.push_back(next);
+    inactive = next->next_;
+
+    next->prev_ = nullptr;
+    next->next_ = active;
+    if (active != nullptr) {
+        active->prev_ = next;
+    }
+    active = next;
+    activeCount++;
     return next;
 }
 
@@ -63,8 +98,25 @@ void PortCorePackets::freePacket(PortCorePacket* packet, bool clear)
             packet->reset();
         }
         packet->completed = true;
-        active.remove(packet);
-        inactive.push_back(packet);
+
+        // Inactive packets are never linked backwards nor at the head of the
+        // active list
+        if (packet->prev_ == nullptr && packet != active) {
+            return;
+        }
+        if (packet->prev_ != nullptr) {
+            packet->prev_->next_ = packet->next_;
+        } else {
+            active = packet->next_;
+        }
+        if (packet->next_ != nullptr) {
+            packet->next_->prev_ = packet->prev_;
+        }
+        activeCount--;
+
+        packet->prev_ = nullptr;
+        packet->next_ = inactive;
+        inactive = packet;
     }
 }
 
@@ -14,7 +14,8 @@
 
 #include <yarp/os/Log.h>
 
-#include <list>
+#include <memory>
+#include <vector>
 
 namespace yarp {
 namespace os {
@@ -26,13 +27,29 @@ namespace impl {
  * This tracks uses of the messages for memory management purposes.
  * We call messages "packets" for no particular reason.
  *
+ * Packets are allocated in blocks and recycled, and the lists of active and
+ * inactive packets are linked through the packets themselves, so that
+ * sending a message does not allocate memory once the pool is large enough
+ * for the traffic of the port.
+ *
  */
 class PortCorePackets
 {
 private:
-    std::list<PortCorePacket*> inactive; // unused packets we may reuse
-    std::list<PortCorePacket*> active;   // a list of packets being sent
+    PortCorePacket* inactive {nullptr}; // unused packets we may reuse (linked through next_)
+    PortCorePacket* active {nullptr};   // a list of packets being sent (linked through prev_/next_)
+    size_t activeCount {0};
+    size_t capacity {0};
+    size_t growCount {0};
+    std::vector<std::unique_ptr<PortCorePacket[]>> blocks;
+
+    void allocate(size_t count);
+
 public:
+    PortCorePackets() = default;
+    PortCorePackets(const PortCorePackets&) = delete;
+    PortCorePackets& operator=(const PortCorePackets&) = delete;
+
     virtual ~PortCorePackets();
 
     /**
@@ -40,6 +57,26 @@ public:
      */
     size_t getCount();
 
+    /**
+     * @return the number of packets allocated, active or not.
+     */
+    size_t getCapacity();
+
+    /**
+     * @return how many times the pool had to grow while getting a free
+     *         packet (i.e. because reserve() was not called with a large
+     *         enough size).
+     */
+    size_t getGrowCount();
+
+    /**
+     * Make sure that at least the given number of packets is allocated,
+     * so that they will not be allocated while sending messages.
+     *
+     * @param count the number of packets
+     */
+    void reserve(size_t count);
+
     /**
      * Get a packet that we can prepare for sending.  If a previously sent
      * packet that is not being used is available, we take that.  Otherwise
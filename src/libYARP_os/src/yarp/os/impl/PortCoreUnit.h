@@ -11,6 +11,7 @@
 #define YARP_OS_IMPL_PORTCOREUNIT_H
 
 #include <yarp/os/Name.h>
+#include <yarp/os/impl/ConnectionStats.h>
 #include <yarp/os/impl/PortCore.h>
 #include <yarp/os/impl/ThreadImpl.h>
 
@@ -271,6 +272,15 @@ public:
         YARP_UNUSED(params);
     }
 
+    /**
+     * @return the statistics of the messages transferred by this
+     * connection, updated only when they are enabled on the port.
+     */
+    ConnectionStats& getStats()
+    {
+        return stats;
+    }
+
 
 protected:
     /**
@@ -289,6 +299,7 @@ private:
     bool pupped;           ///< whether the connection was made by `publisherUpdate`
     int index;             ///< an ID assigned to the connection
     std::string pupString; ///< the target of the connection if created by `publisherUpdate`
+    ConnectionStats stats; ///< statistics of the messages transferred
 };
 
 } // namespace impl
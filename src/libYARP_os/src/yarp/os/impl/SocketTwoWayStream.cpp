@@ -27,11 +27,24 @@
 #    include <netinet/tcp.h>
 #endif
 
+#ifdef YARP_HAS_ACE
+#    include <ace/os_include/sys/os_uio.h>
+#else
+#    include <sys/uio.h>
+#endif
+
 using namespace yarp::os;
 using namespace yarp::os::impl;
 
 YARP_OS_LOG_COMPONENT(SOCKETTWOWAYSTREAM, "yarp.os.impl.PortCoreOutputUnit")
 
+namespace {
+// Number of blocks handed to the kernel with a single system call.  This is
+// well below IOV_MAX on all the supported platforms, and small enough to keep
+// the iovec array on the stack.
+constexpr size_t max_iov_batch = 64;
+} // namespace
+
 int SocketTwoWayStream::open(const Contact& address)
 {
     if (address.getPort() == -1) {
@@ -89,6 +102,74 @@ int SocketTwoWayStream::open(yarp::os::impl::TcpAcceptor& acceptor)
     return result;
 }
 
+void SocketTwoWayStream::writev(const Bytes* blocks, size_t count)
+{
+    iovec iov[max_iov_batch];
+    size_t done = 0;
+    while (done < count) {
+        if (!isOk()) {
+            return;
+        }
+        int n = 0;
+        while (done < count && n < static_cast<int>(max_iov_batch)) {
+            iov[n].iov_base = const_cast<char*>(blocks[done].get());
+            iov[n].iov_len = blocks[done].length();
+            n++;
+            done++;
+        }
+        yarp::conf::ssize_t result;
+        if (haveWriteTimeout) {
+            result = stream.sendv_n(iov, n, &writeTimeout);
+        } else {
+            result = stream.sendv_n(iov, n);
+        }
+        if (result < 0) {
+            happy = false;
+            yCDebug(SOCKETTWOWAYSTREAM, "bad socket write");
+        }
+    }
+}
+
+yarp::conf::ssize_t SocketTwoWayStream::readvFull(Bytes* blocks, size_t count)
+{
+    iovec iov[max_iov_batch];
+    yarp::conf::ssize_t total = 0;
+    size_t done = 0;
+    while (done < count) {
+        if (!isOk()) {
+            return -1;
+        }
+        int n = 0;
+        size_t expected = 0;
+        while (done < count && n < static_cast<int>(max_iov_batch)) {
+            iov[n].iov_base = blocks[done].get();
+            iov[n].iov_len = blocks[done].length();
+            expected += blocks[done].length();
+            n++;
+            done++;
+        }
+        if (expected == 0) {
+            continue;
+        }
+        yarp::conf::ssize_t result;
+        if (haveReadTimeout) {
+            result = stream.recvv_n(iov, n, &readTimeout);
+        } else {
+            result = stream.recvv_n(iov, n);
+        }
+        if (!happy) {
+            return -1;
+        }
+        if (result <= 0 || static_cast<size_t>(result) != expected) {
+            happy = false;
+            yCDebug(SOCKETTWOWAYSTREAM, "bad socket read");
+            return -1;
+        }
+        total += result;
+    }
+    return total;
+}
+
 void SocketTwoWayStream::updateAddresses()
 {
     int one = 1;
@@ -29,6 +29,8 @@
 #    include <netinet/tcp.h>
 #endif
 
+#include <cstddef>
+
 YARP_DECLARE_LOG_COMPONENT(SOCKETTWOWAYSTREAM)
 
 namespace yarp {
@@ -161,6 +163,10 @@ public:
         }
     }
 
+    void writev(const Bytes* blocks, size_t count) override;
+
+    yarp::conf::ssize_t readvFull(Bytes* blocks, size_t count) override;
+
     void flush() override
     {
 #ifdef TCP_CORK
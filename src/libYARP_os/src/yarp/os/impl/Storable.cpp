@@ -29,6 +29,7 @@ using yarp::os::ConnectionWriter;
 using yarp::os::Value;
 using yarp::os::impl::BottleImpl;
 using yarp::os::impl::Storable;
+using yarp::os::impl::StorableArena;
 using yarp::os::impl::StoreBlob;
 using yarp::os::impl::StoreDict;
 using yarp::os::impl::StoreFloat32;
@@ -64,40 +65,54 @@ const int StoreDict::code = BOTTLE_TAG_LIST | BOTTLE_TAG_DICT;
 
 Storable::~Storable() = default;
 
-Storable* Storable::createByCode(std::int32_t id)
+namespace {
+
+struct HeapFactory
+{
+    template <typename T>
+    T* make()
+    {
+        return new T();
+    }
+};
+
+} // namespace
+
+template <typename Factory>
+Storable* Storable::createByCodeImpl(std::int32_t id, Factory& factory)
 {
     Storable* storable = nullptr;
     std::int32_t subCode = 0;
     switch (id) {
     case StoreInt8::code:
-        storable = new StoreInt8();
+        storable = factory.template make<StoreInt8>();
         break;
     case StoreInt16::code:
-        storable = new StoreInt16();
+        storable = factory.template make<StoreInt16>();
         break;
     case StoreInt32::code:
-        storable = new StoreInt32();
+        storable = factory.template make<StoreInt32>();
         break;
     case StoreInt64::code:
-        storable = new StoreInt64();
+        storable = factory.template make<StoreInt64>();
         break;
     case StoreVocab::code:
-        storable = new StoreVocab();
+        storable = factory.template make<StoreVocab>();
         break;
     case StoreFloat32::code:
-        storable = new StoreFloat32();
+        storable = factory.template make<StoreFloat32>();
         break;
     case StoreFloat64::code:
-        storable = new StoreFloat64();
+        storable = factory.template make<StoreFloat64>();
         break;
     case StoreString::code:
-        storable = new StoreString();
+        storable = factory.template make<StoreString>();
         break;
     case StoreBlob::code:
-        storable = new StoreBlob();
+        storable = factory.template make<StoreBlob>();
         break;
     case StoreList::code:
-        storable = new StoreList();
+        storable = factory.template make<StoreList>();
         yCAssert(STORABLE, storable != nullptr);
         storable->asList()->implementation->setNested(true);
         break;
@@ -106,10 +121,10 @@ Storable* Storable::createByCode(std::int32_t id)
             // typed list
             subCode = (id & UNIT_MASK);
             if ((id & BOTTLE_TAG_DICT) != 0) {
-                storable = new StoreDict();
+                storable = factory.template make<StoreDict>();
                 yCAssert(STORABLE, storable != nullptr);
             } else {
-                storable = new StoreList();
+                storable = factory.template make<StoreList>();
                 yCAssert(STORABLE, storable != nullptr);
                 storable->asList()->implementation->specialize(subCode);
                 storable->asList()->implementation->setNested(true);
@@ -120,6 +135,17 @@ Storable* Storable::createByCode(std::int32_t id)
     return storable;
 }
 
+Storable* Storable::createByCode(std::int32_t id)
+{
+    HeapFactory factory;
+    return createByCodeImpl(id, factory);
+}
+
+Storable* Storable::createByCode(std::int32_t id, StorableArena& arena)
+{
+    return createByCodeImpl(id, arena);
+}
+
 Value& Storable::find(const std::string& key) const
 {
     YARP_UNUSED(key);
@@ -16,6 +16,7 @@
 #include <yarp/os/LogComponent.h>
 #include <yarp/os/Value.h>
 #include <yarp/os/Vocab.h>
+#include <yarp/os/impl/StorableArena.h>
 
 
 #define UNIT_MASK         \
@@ -56,6 +57,11 @@ public:
      */
     virtual Storable* createStorable() const = 0;
 
+    /**
+     * Factory method, constructing the item in an arena.
+     */
+    virtual Storable* createStorable(StorableArena& arena) const = 0;
+
     /**
      * Typed synonym for clone()
      */
@@ -67,6 +73,16 @@ public:
         return item;
     }
 
+    /**
+     * Clone the item in an arena.
+     */
+    Storable* cloneStorable(StorableArena& arena) const
+    {
+        Storable* item = createStorable(arena);
+        item->copy(*this);
+        return item;
+    }
+
     /**
      * Become a copy of the passed item.
      */
@@ -85,6 +101,7 @@ public:
     }
 
     static Storable* createByCode(std::int32_t id);
+    static Storable* createByCode(std::int32_t id, StorableArena& arena);
 
 
     bool read(ConnectionReader& connection) override;
@@ -278,6 +295,10 @@ public:
     {
         return true;
     }
+
+private:
+    template <typename Factory>
+    static Storable* createByCodeImpl(std::int32_t id, Factory& factory);
 };
 
 
@@ -295,6 +316,11 @@ public:
         return new StoreNull();
     }
 
+    Storable* createStorable(StorableArena& arena) const override
+    {
+        return arena.make<StoreNull>();
+    }
+
     void copy(const Storable& alt) override
     {
         YARP_UNUSED(alt);
@@ -356,6 +382,11 @@ public:
         return new StoreInt8();
     }
 
+    Storable* createStorable(StorableArena& arena) const override
+    {
+        return arena.make<StoreInt8>();
+    }
+
     void copy(const Storable& alt) override
     {
         x = alt.asInt8();
@@ -442,6 +473,11 @@ public:
         return new StoreInt16();
     }
 
+    Storable* createStorable(StorableArena& arena) const override
+    {
+        return arena.make<StoreInt16>();
+    }
+
     void copy(const Storable& alt) override
     {
         x = alt.asInt16();
@@ -528,6 +564,11 @@ public:
         return new StoreInt32();
     }
 
+    Storable* createStorable(StorableArena& arena) const override
+    {
+        return arena.make<StoreInt32>();
+    }
+
     void copy(const Storable& alt) override
     {
         x = alt.asInt32();
@@ -613,6 +654,11 @@ public:
         return new StoreInt64();
     }
 
+    Storable* createStorable(StorableArena& arena) const override
+    {
+        return arena.make<StoreInt64>();
+    }
+
     void copy(const Storable& alt) override
     {
         x = alt.asInt64();
@@ -698,6 +744,11 @@ public:
         return new StoreFloat32();
     }
 
+    Storable* createStorable(StorableArena& arena) const override
+    {
+        return arena.make<StoreFloat32>();
+    }
+
     void copy(const Storable& alt) override
     {
         x = alt.asFloat32();
@@ -773,6 +824,11 @@ public:
         return new StoreFloat64();
     }
 
+    Storable* createStorable(StorableArena& arena) const override
+    {
+        return arena.make<StoreFloat64>();
+    }
+
     void copy(const Storable& alt) override
     {
         x = alt.asFloat64();
@@ -847,6 +903,11 @@ public:
         return new StoreVocab();
     }
 
+    Storable* createStorable(StorableArena& arena) const override
+    {
+        return arena.make<StoreVocab>();
+    }
+
     void copy(const Storable& alt) override
     {
         x = alt.asVocab();
@@ -934,6 +995,11 @@ public:
         return new StoreString();
     }
 
+    Storable* createStorable(StorableArena& arena) const override
+    {
+        return arena.make<StoreString>();
+    }
+
     void copy(const Storable& alt) override
     {
         x = alt.asString();
@@ -994,6 +1060,11 @@ public:
         return new StoreBlob();
     }
 
+    Storable* createStorable(StorableArena& arena) const override
+    {
+        return arena.make<StoreBlob>();
+    }
+
     void copy(const Storable& alt) override
     {
         if (alt.isBlob()) {
@@ -1052,6 +1123,11 @@ public:
         return new StoreList();
     }
 
+    Storable* createStorable(StorableArena& arena) const override
+    {
+        return arena.make<StoreList>();
+    }
+
     void copy(const Storable& alt) override
     {
         content = *(alt.asList());
@@ -1117,6 +1193,11 @@ public:
         return new StoreDict();
     }
 
+    Storable* createStorable(StorableArena& arena) const override
+    {
+        return arena.make<StoreDict>();
+    }
+
     void copy(const Storable& alt) override
     {
         content = *(alt.asDict());
@@ -0,0 +1,120 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/os/impl/StorableArena.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+using yarp::os::impl::StorableArena;
+
+constexpr size_t StorableArena::initialChunkSize;
+constexpr size_t StorableArena::maxChunkSize;
+constexpr size_t StorableArena::maxRetainedSize;
+
+namespace {
+// The header is padded, so that the data of the chunk is aligned as any
+// memory returned by malloc
+constexpr size_t headerSize = alignof(std::max_align_t) > 16 ? alignof(std::max_align_t) : 16;
+} // namespace
+
+StorableArena::~StorableArena()
+{
+    releaseChunks();
+}
+
+void StorableArena::releaseChunks()
+{
+    while (chunks != nullptr) {
+        Chunk* next = chunks->next;
+        std::free(chunks);
+        chunks = next;
+    }
+    used = 0;
+    last = 0;
+}
+
+char* StorableArena::begin(Chunk* chunk)
+{
+    return reinterpret_cast<char*>(chunk) + headerSize;
+}
+
+void StorableArena::addChunk(size_t minSize)
+{
+    size_t size = (chunks == nullptr) ? initialChunkSize : std::min(chunks->size * 2, maxChunkSize);
+    size = std::max(size, minSize);
+    void* mem = std::malloc(headerSize + size);
+    if (mem == nullptr) {
+        throw std::bad_alloc();
+    }
+    auto* chunk = static_cast<Chunk*>(mem);
+    chunk->next = chunks;
+    chunk->size = size;
+    chunks = chunk;
+    used = 0;
+    last = 0;
+}
+
+void* StorableArena::allocate(size_t size, size_t alignment)
+{
+    size_t offset = (used + alignment - 1) & ~(alignment - 1);
+    if (chunks == nullptr || offset + size > chunks->size) {
+        addChunk(size);
+        offset = 0;
+    }
+    used = offset + size;
+    last = offset;
+    return begin(chunks) + offset;
+}
+
+void StorableArena::release(void* ptr)
+{
+    // The padding before the block, if any, is not reclaimed
+    if (chunks != nullptr && ptr == begin(chunks) + last && used > last) {
+        used = last;
+    }
+}
+
+bool StorableArena::owns(const void* ptr) const
+{
+    const char* p = static_cast<const char*>(ptr);
+    for (Chunk* chunk = chunks; chunk != nullptr; chunk = chunk->next) {
+        if (p >= begin(chunk) && p < begin(chunk) + chunk->size) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void StorableArena::rewind()
+{
+    used = 0;
+    last = 0;
+    if (chunks == nullptr || chunks->next == nullptr) {
+        return;
+    }
+
+    // Replace all the chunks with one chunk big enough for all the items,
+    // unless the Bottle was unusually large
+    size_t total = capacity();
+    releaseChunks();
+    if (total <= maxRetainedSize) {
+        addChunk(total);
+    }
+}
+
+size_t StorableArena::capacity() const
+{
+    size_t total = 0;
+    for (Chunk* chunk = chunks; chunk != nullptr; chunk = chunk->next) {
+        total += chunk->size;
+    }
+    return total;
+}
@@ -0,0 +1,124 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef YARP_OS_IMPL_STORABLEARENA_H
+#define YARP_OS_IMPL_STORABLEARENA_H
+
+#include <yarp/os/api.h>
+
+#include <cstddef>
+#include <new>
+#include <utility>
+
+namespace yarp {
+namespace os {
+namespace impl {
+
+/**
+ * A memory arena for the items of a Bottle.
+ *
+ * The items are constructed one after the other in a few large chunks, and
+ * the memory is reclaimed all at once, when all the items are destroyed.
+ * When the arena is rewound, the chunks are merged in a single one, so that
+ * a Bottle that is filled repeatedly with a similar content does not
+ * allocate memory for its items at all.
+ *
+ * Destroying an item does not release its memory until the arena is rewound,
+ * unless it is the most recent allocation, whose memory is reused
+ * immediately (e.g. an item replaced just after being constructed, or an
+ * item added and then popped).
+ * The arena is not thread safe.
+ */
+class YARP_os_impl_API StorableArena
+{
+public:
+    StorableArena() = default;
+    StorableArena(const StorableArena&) = delete;
+    StorableArena(StorableArena&&) = delete;
+    StorableArena& operator=(const StorableArena&) = delete;
+    StorableArena& operator=(StorableArena&&) = delete;
+    ~StorableArena();
+
+    /**
+     * Construct an object of type T in the arena.
+     */
+    template <typename T, typename... Args>
+    T* make(Args&&... args)
+    {
+        return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+
+    /**
+     * Destroy an object, either constructed in the arena or in the heap.
+     * T must be a polymorphic type, in order to find the start of the
+     * memory of the object.
+     */
+    template <typename T>
+    void destroy(T* obj)
+    {
+        if (owns(obj)) {
+            void* mem = dynamic_cast<void*>(obj);
+            obj->~T();
+            release(mem);
+        } else {
+            delete obj;
+        }
+    }
+
+    /**
+     * Allocate a block of memory in the arena.
+     */
+    void* allocate(size_t size, size_t alignment);
+
+    /**
+     * Release a block of memory allocated in the arena.
+     * The memory is reused only if it is the most recent allocation.
+     */
+    void release(void* ptr);
+
+    /**
+     * Check if a pointer points to the memory of the arena.
+     */
+    bool owns(const void* ptr) const;
+
+    /**
+     * Make all the memory of the arena available again.
+     * All the objects constructed in the arena must have been destroyed.
+     */
+    void rewind();
+
+    /**
+     * Return the total size of the chunks.
+     */
+    size_t capacity() const;
+
+private:
+    struct Chunk
+    {
+        Chunk* next;
+        size_t size;
+    };
+
+    static constexpr size_t initialChunkSize = 128;
+    static constexpr size_t maxChunkSize = 16384;
+    static constexpr size_t maxRetainedSize = 65536;
+
+    void addChunk(size_t minSize);
+    void releaseChunks();
+    static char* begin(Chunk* chunk);
+
+    Chunk* chunks {nullptr}; // Most recent chunk first
+    size_t used {0};         // Bytes used in the most recent chunk
+    size_t last {0};         // Offset of the most recent allocation
+};
+
+} // namespace impl
+} // namespace os
+} // namespace yarp
+
+#endif // YARP_OS_IMPL_STORABLEARENA_H
@@ -259,6 +259,19 @@ bool StreamConnectionReader::expectBlock(char* data, size_t len)
     return expectBlock(bytes);
 }
 
+const char* StreamConnectionReader::expectSharedBlock(size_t len, std::shared_ptr<void>& owner)
+{
+    if (!isGood() || len == 0) {
+        return nullptr;
+    }
+    yAssert(in != nullptr);
+    const char* data = in->readShared(len, owner);
+    if (data != nullptr) {
+        messageLen -= len;
+    }
+    return data;
+}
+
 std::string StreamConnectionReader::expectText(const char terminatingChar)
 {
     if (!isGood()) {
@@ -69,6 +69,7 @@ public:
     yarp::conf::float32_t expectFloat32() override;
     yarp::conf::float64_t expectFloat64() override;
     bool expectBlock(char* data, size_t len) override;
+    const char* expectSharedBlock(size_t len, std::shared_ptr<void>& owner) override;
     std::string expectText(const char terminatingChar) override;
     bool isTextMode() const override;
     bool isBareMode() const override;
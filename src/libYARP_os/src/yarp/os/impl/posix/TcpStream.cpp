@@ -38,6 +38,74 @@ int TcpStream::open() {
     return 0;
 }
 
+ssize_t TcpStream::sendv_n(const iovec iov[], int iovcnt)
+{
+    ssize_t total = 0;
+    int i = 0;
+    while (i < iovcnt) {
+        ssize_t n = ::writev(sd, iov + i, iovcnt - i);
+        if (n < 0) {
+            return -1;
+        }
+        total += n;
+        // Skip the blocks that were sent completely
+        while (i < iovcnt && static_cast<size_t>(n) >= iov[i].iov_len) {
+            n -= iov[i].iov_len;
+            i++;
+        }
+        if (i < iovcnt && n > 0) {
+            // Block sent partially, send the rest before moving on
+            const char* rest = static_cast<const char*>(iov[i].iov_base) + n;
+            size_t len = iov[i].iov_len - n;
+            while (len > 0) {
+                ssize_t r = ::send(sd, rest, len, 0);
+                if (r < 0) {
+                    return -1;
+                }
+                rest += r;
+                len -= r;
+                total += r;
+            }
+            i++;
+        }
+    }
+    return total;
+}
+
+ssize_t TcpStream::recvv_n(const iovec iov[], int iovcnt)
+{
+    ssize_t total = 0;
+    int i = 0;
+    while (i < iovcnt) {
+        ssize_t n = ::readv(sd, iov + i, iovcnt - i);
+        if (n <= 0) {
+            return n;
+        }
+        total += n;
+        // Skip the blocks that were filled completely
+        while (i < iovcnt && static_cast<size_t>(n) >= iov[i].iov_len) {
+            n -= iov[i].iov_len;
+            i++;
+        }
+        if (i < iovcnt && n > 0) {
+            // Block filled partially, fill the rest before moving on
+            char* rest = static_cast<char*>(iov[i].iov_base) + n;
+            size_t len = iov[i].iov_len - n;
+            while (len > 0) {
+                ssize_t r = ::recv(sd, rest, len, 0);
+                if (r <= 0) {
+                    return r;
+                }
+                rest += r;
+                len -= r;
+                total += r;
+            }
+            i++;
+        }
+    }
+    return total;
+}
+
 int TcpStream::get_local_addr (sockaddr & sa) {
 
     int len = sizeof(sa);
@@ -13,6 +13,7 @@
 // General files
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/uio.h>
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <unistd.h>
@@ -76,6 +77,35 @@ public:
         return ::send(sd, buf, n, 0);
     }
 
+    /**
+     * Send all the data in the iovec array, calling writev(2) again if the
+     * kernel accepts only part of it.
+     *
+     * @return the number of bytes sent, or -1 on failure
+     */
+    ssize_t sendv_n(const iovec iov[], int iovcnt);
+
+    inline ssize_t sendv_n(const iovec iov[], int iovcnt, struct timeval *tv)
+    {
+        setsockopt(sd, SOL_SOCKET, SO_SNDTIMEO, (char *)tv, sizeof (*tv));
+        return sendv_n(iov, iovcnt);
+    }
+
+    /**
+     * Fill all the buffers in the iovec array, calling readv(2) again if
+     * less data than requested is available.
+     *
+     * @return the number of bytes received, 0 if the peer closed the
+     *         connection, or -1 on failure
+     */
+    ssize_t recvv_n(const iovec iov[], int iovcnt);
+
+    inline ssize_t recvv_n(const iovec iov[], int iovcnt, struct timeval *tv)
+    {
+        setsockopt(sd, SOL_SOCKET, SO_RCVTIMEO, (char *)tv, sizeof (*tv));
+        return recvv_n(iov, iovcnt);
+    }
+
     // No idea what this should do...
     void flush() { }
 
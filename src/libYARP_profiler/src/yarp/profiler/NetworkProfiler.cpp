@@ -14,6 +14,7 @@
 #include <yarp/os/Port.h>
 #include <yarp/os/OutputProtocol.h>
 #include <yarp/os/Carrier.h>
+#include <yarp/os/Vocab.h>
 #include <yarp/companion/impl/Companion.h>
 
 using namespace std;
@@ -469,3 +470,41 @@ bool NetworkProfiler::getPortmonitorParams(std::string portName, yarp::os::Bottl
     }
     return true;
 }
+
+bool NetworkProfiler::getPortStats(const std::string& portName, yarp::os::Bottle& stats) {
+    yarp::os::Bottle cmd;
+    cmd.addString("stats");
+    Contact srcCon = Contact::fromString(portName);
+    stats.clear();
+    bool ret = yarp::os::NetworkBase::write(srcCon, cmd, stats, true, true, 2.0);
+    if(!ret || stats.size() == 0) {
+        yError()<<"Cannot get the statistics of"<<portName;
+        return false;
+    }
+    if(stats.get(0).isVocab() && stats.get(0).asVocab() == yarp::os::Vocab::encode("fail")) {
+        yError()<<stats.toString();
+        return false;
+    }
+    return true;
+}
+
+static bool writeStatsCommand(const std::string& portName, const std::string& action) {
+    yarp::os::Bottle cmd, reply;
+    cmd.addString("stats");
+    cmd.addString(action);
+    Contact srcCon = Contact::fromString(portName);
+    bool ret = yarp::os::NetworkBase::write(srcCon, cmd, reply, true, true, 2.0);
+    if(!ret || reply.get(0).asVocab() != yarp::os::Vocab::encode("ok")) {
+        yError()<<"Cannot write (stats"<<action<<") to"<<portName;
+        return false;
+    }
+    return true;
+}
+
+bool NetworkProfiler::setPortStatsEnabled(const std::string& portName, bool enabled) {
+    return writeStatsCommand(portName, enabled ? "on" : "off");
+}
+
+bool NetworkProfiler::resetPortStats(const std::string& portName) {
+    return writeStatsCommand(portName, "reset");
+}
@@ -142,6 +142,17 @@ public:
     static bool setPortmonitorParams(std::string portName, yarp::os::Property& param);
     static bool getPortmonitorParams(std::string portName, yarp::os::Bottle &param);
 
+    /**
+     * @brief getPortStats gets the statistics of the connections of a port
+     * (see the "stats" command of the port administrative interface)
+     * @param portName
+     * @param stats
+     * @return
+     */
+    static bool getPortStats(const std::string& portName, yarp::os::Bottle& stats);
+    static bool setPortStatsEnabled(const std::string& portName, bool enabled);
+    static bool resetPortStats(const std::string& portName);
+
 private:
         static ProgressCallback* progCallback;
 
@@ -10,6 +10,8 @@
 #include <yarp/os/Log.h>
 #include <yarp/sig/Image.h>
 #include <yarp/sig/impl/IplImage.h>
+#include <yarp/sig/impl/PixelRowConversion.h>
+#include <yarp/sig/impl/WorkerPool.h>
 
 #include <cstring>
 #include <cstdio>
@@ -1160,6 +1162,114 @@ static inline void CopyPixel(const PixelInt* src, PixelInt* dest)
 
 /******************************************************************************/
 
+// Default row copy mechanism
+template <class T1, class T2>
+static inline void CopyRow(const T1 *src, T2 *dest, int w)
+{
+    for (int j = 0; j < w; j++) {
+        CopyPixel(src,dest);
+        src++;
+        dest++;
+    }
+}
+
+// Rows of the same pixel type (different padding or flipped image)
+template <class T>
+static inline void CopyRow(const T *src, T *dest, int w)
+{
+    memcpy(dest, src, w*sizeof(T));
+}
+
+// Vectorized conversions for the most common pixel types
+static inline const unsigned char* RowBytes(const void* row)
+{
+    return reinterpret_cast<const unsigned char*>(row);
+}
+
+static inline unsigned char* RowBytes(void* row)
+{
+    return reinterpret_cast<unsigned char*>(row);
+}
+
+static inline void CopyRow(const PixelRgb* src, PixelBgr* dest, int w)
+{
+    yarp::sig::impl::swapRowRgb(RowBytes(src), RowBytes(dest), w);
+}
+
+static inline void CopyRow(const PixelBgr* src, PixelRgb* dest, int w)
+{
+    yarp::sig::impl::swapRowRgb(RowBytes(src), RowBytes(dest), w);
+}
+
+static inline void CopyRow(const PixelRgb* src, PixelMono* dest, int w)
+{
+    yarp::sig::impl::convertRowRgbToMono(RowBytes(src), RowBytes(dest), w);
+}
+
+static inline void CopyRow(const PixelBgr* src, PixelMono* dest, int w)
+{
+    yarp::sig::impl::convertRowRgbToMono(RowBytes(src), RowBytes(dest), w);
+}
+
+static inline void CopyRow(const PixelMono* src, PixelRgb* dest, int w)
+{
+    yarp::sig::impl::convertRowMonoToRgb(RowBytes(src), RowBytes(dest), w);
+}
+
+static inline void CopyRow(const PixelMono* src, PixelBgr* dest, int w)
+{
+    yarp::sig::impl::convertRowMonoToRgb(RowBytes(src), RowBytes(dest), w);
+}
+
+static inline void CopyRow(const PixelRgb* src, PixelRgba* dest, int w)
+{
+    yarp::sig::impl::convertRowRgbToRgba(RowBytes(src), RowBytes(dest), w, false);
+}
+
+static inline void CopyRow(const PixelRgb* src, PixelBgra* dest, int w)
+{
+    yarp::sig::impl::convertRowRgbToRgba(RowBytes(src), RowBytes(dest), w, true);
+}
+
+static inline void CopyRow(const PixelBgr* src, PixelBgra* dest, int w)
+{
+    yarp::sig::impl::convertRowRgbToRgba(RowBytes(src), RowBytes(dest), w, false);
+}
+
+static inline void CopyRow(const PixelBgr* src, PixelRgba* dest, int w)
+{
+    yarp::sig::impl::convertRowRgbToRgba(RowBytes(src), RowBytes(dest), w, true);
+}
+
+static inline void CopyRow(const PixelRgba* src, PixelRgb* dest, int w)
+{
+    yarp::sig::impl::convertRowRgbaToRgb(RowBytes(src), RowBytes(dest), w, false);
+}
+
+static inline void CopyRow(const PixelRgba* src, PixelBgr* dest, int w)
+{
+    yarp::sig::impl::convertRowRgbaToRgb(RowBytes(src), RowBytes(dest), w, true);
+}
+
+static inline void CopyRow(const PixelBgra* src, PixelBgr* dest, int w)
+{
+    yarp::sig::impl::convertRowRgbaToRgb(RowBytes(src), RowBytes(dest), w, false);
+}
+
+static inline void CopyRow(const PixelBgra* src, PixelRgb* dest, int w)
+{
+    yarp::sig::impl::convertRowRgbaToRgb(RowBytes(src), RowBytes(dest), w, true);
+}
+
+#ifdef YARP_LITTLE_ENDIAN
+static inline void CopyRow(const PixelMono16* src, PixelFloat* dest, int w)
+{
+    yarp::sig::impl::convertRowMono16ToFloat(src, dest, w);
+}
+#endif // YARP_LITTLE_ENDIAN
+
+/******************************************************************************/
+
 
 //static inline int PAD_BYTES (int len, int pad)
 //{
@@ -1189,13 +1299,9 @@ static void CopyPixels(const T1 *osrc, int q1, T2 *odest, int q2,
 
     for (int i=0; i<h; i++) {
         DBG printf("x,y = %d,%d\n", 0,i);
-        for (int j = 0; j < w; j++) {
-            CopyPixel(src,dest);
-            src++;
-            dest++;
-        }
+        CopyRow(src,dest,w);
 
-        src = reinterpret_cast<const T1*>(((char *)src) + p1);
+        src = reinterpret_cast<const T1*>(((char *)(src + w)) + p1);
         odest = reinterpret_cast<T2*>(((char *)odest) + step2*(flip?-1:1));
         dest = odest;
     }
@@ -1222,10 +1328,10 @@ using Def_VOCAB_PIXEL_RGB_INT = PixelRgbInt;
 #define MAKE_CASE(id1, id2) case HASH(id1, id2): HANDLE_CASE(len, src, Def_##id1, quantum1, topIsLow1, dest, Def_##id2, quantum2, topIsLow2); break;
 
 // More elegant ways to do this, but needs to be efficient at pixel level
-void Image::copyPixels(const unsigned char *src, size_t id1,
-                       char unsigned *dest, size_t id2, size_t w, size_t h,
-                       size_t imageSize, size_t quantum1, size_t quantum2,
-                       bool topIsLow1, bool topIsLow2)
+static void CopyPixelRows(const unsigned char *src, size_t id1,
+                          unsigned char *dest, size_t id2, size_t w, size_t h,
+                          size_t imageSize, size_t quantum1, size_t quantum2,
+                          bool topIsLow1, bool topIsLow2)
 {
     DBG printf("copyPixels...\n");
 
@@ -1464,3 +1570,31 @@ void Image::copyPixels(const unsigned char *src, size_t id1,
 
     DBG printf("... done copyPixels\n");
 }
+
+
+void Image::copyPixels(const unsigned char *src, size_t id1,
+                       char unsigned *dest, size_t id2, size_t w, size_t h,
+                       size_t imageSize, size_t quantum1, size_t quantum2,
+                       bool topIsLow1, bool topIsLow2)
+{
+    auto size1 = pixelCode2Size.find(static_cast<YarpVocabPixelTypesEnum>(id1));
+    auto size2 = pixelCode2Size.find(static_cast<YarpVocabPixelTypesEnum>(id2));
+    if (size1 == pixelCode2Size.end() || size2 == pixelCode2Size.end()) {
+        CopyPixelRows(src, id1, dest, id2, w, h, imageSize, quantum1, quantum2, topIsLow1, topIsLow2);
+        return;
+    }
+
+    // Each band of rows is copied to the same band of the destination, or
+    // to the opposite one if the image is flipped
+    const size_t rowSize1 = w * size1->second + PAD_BYTES(w * size1->second, quantum1);
+    const size_t rowSize2 = w * size2->second + PAD_BYTES(w * size2->second, quantum2);
+    const bool flip = (topIsLow1 != topIsLow2);
+    impl::WorkerPool::instance().forEachBand(w, h, [&](size_t begin, size_t end) {
+        const size_t rows = end - begin;
+        CopyPixelRows(src + begin * rowSize1, id1,
+                      dest + (flip ? h - end : begin) * rowSize2, id2,
+                      w, rows, (rows == h) ? imageSize : rows * rowSize2,
+                      quantum1, quantum2,
+                      topIsLow1, topIsLow2);
+    });
+}
@@ -24,6 +24,7 @@
 #include <yarp/sig/ImageNetworkHeader.h>
 #include <yarp/sig/impl/IplImage.h>
 #include <yarp/sig/impl/DeBayer.h>
+#include <yarp/sig/impl/WorkerPool.h>
 
 #include <cstdio>
 #include <cstring>
@@ -47,6 +48,20 @@ using namespace yarp::os;
 */
 inline bool readFromConnection(Image &dest, ImageNetworkHeader &header, ConnectionReader& connection)
 {
+    // Images allocated from a shared memory pool are wrapped, if the
+    // connection supports it.
+    std::shared_ptr<void> owner;
+    const char* shared = connection.expectSharedBlock(header.imgSize, owner);
+    if (shared != nullptr) {
+        dest.setExternal(shared, header.width, header.height, std::move(owner));
+        if (dest.getRawImageSize() != (size_t) header.imgSize) {
+            printf("There is a problem wrapping a shared image\n");
+            dest.resize(0, 0);
+            return false;
+        }
+        return !connection.isError();
+    }
+
     dest.resize(header.width, header.height);
     unsigned char *mem = dest.getRawImage();
     size_t allocatedBytes = dest.getRawImageSize();
@@ -76,6 +91,8 @@ public:
     size_t extern_type_quantum;
     size_t quantum;
     bool topIsLow;
+    // keeps alive the external buffer, when its lifetime is managed
+    std::shared_ptr<void> extern_owner;
 
 protected:
     Image& owner;
@@ -135,6 +152,10 @@ public:
     void _alloc_complete_extern(const void *buf, size_t x, size_t y, int pixel_type,
                                 size_t quantum, bool topIsLow);
 
+    // true if the buffer might be shared with other images or processes
+    bool isShared() const { return extern_owner != nullptr; }
+
+    void release() { _free_complete(); }
 };
 
 
@@ -248,6 +269,7 @@ void ImageStorage::_free ()
                 Data = nullptr;
                 pImage->imageData = nullptr;
             }
+    extern_owner.reset();
 }
 
 void ImageStorage::_free_data ()
@@ -665,6 +687,13 @@ bool Image::read(yarp::os::ConnectionReader& connection) {
     bool ok = connection.expectBlock((char*)&header,sizeof(header));
     if (!ok) return false;
 
+    // never overwrite a buffer shared with other processes
+    auto* impl = (ImageStorage*)implementation;
+    if (impl->isShared()) {
+        impl->release();
+        synchronize();
+    }
+
     //first check that the received image size is reasonable
     if (header.width == 0 || header.height == 0)
     {
@@ -876,6 +905,16 @@ void Image::setExternal(const void *data, size_t imgWidth, size_t imgHeight) {
 }
 
 
+void Image::setExternal(const void *data, size_t imgWidth, size_t imgHeight, std::shared_ptr<void> owner) {
+    setExternal(data, imgWidth, imgHeight);
+    auto* impl = (ImageStorage*)implementation;
+    impl->extern_owner = std::move(owner);
+    // resizing to the same size keeps using the buffer
+    impl->extern_type_id = imgPixelCode;
+    impl->extern_type_quantum = imgQuantum;
+}
+
+
 bool Image::copy(const Image& alt, size_t w, size_t h) {
     if (getPixelCode()==0) {
         setPixelCode(alt.getPixelCode());
@@ -906,16 +945,42 @@ bool Image::copy(const Image& alt, size_t w, size_t h) {
     float di = ((float)h)/nh;
     float dj = ((float)w)/nw;
 
-    for (size_t i=0; i<nh; i++)
-        {
-            auto i0 = (size_t)(di*i);
-            for (size_t j=0; j<nw; j++)
-                {
-                    auto j0 = (size_t)(dj*j);
-                    memcpy(getPixelAddress(j,i),
-                           alt.getPixelAddress(j0,i0),
-                           d);
-                }
-        }
+    impl::WorkerPool::instance().forEachBand(nw, nh, [&](size_t begin, size_t end) {
+        for (size_t i=begin; i<end; i++)
+            {
+                auto i0 = (size_t)(di*i);
+                for (size_t j=0; j<nw; j++)
+                    {
+                        auto j0 = (size_t)(dj*j);
+                        memcpy(getPixelAddress(j,i),
+                               alt.getPixelAddress(j0,i0),
+                               d);
+                    }
+            }
+    });
     return true;
 }
+
+
+void Image::setProcessingThreads(size_t threads)
+{
+    impl::WorkerPool::instance().setThreads(threads);
+}
+
+
+size_t Image::getProcessingThreads()
+{
+    return impl::WorkerPool::instance().getThreads();
+}
+
+
+void Image::setParallelThreshold(size_t pixels)
+{
+    impl::WorkerPool::instance().setThreshold(pixels);
+}
+
+
+size_t Image::getParallelThreshold()
+{
+    return impl::WorkerPool::instance().getThreshold();
+}
@@ -17,6 +17,7 @@
 #include <yarp/os/Vocab.h>
 #include <yarp/sig/api.h>
 #include <map>
+#include <memory>
 
 namespace yarp {
     /**
@@ -145,6 +146,34 @@ public:
      */
     bool copy(const Image& alt, size_t w, size_t h);
 
+    /**
+     * Set the number of threads used to copy, convert and scale large
+     * images, including the calling thread.
+     * The rows of the image are split in bands, processed by a process-wide
+     * pool of threads.
+     * By default images are processed by the calling thread only (i.e. 1
+     * thread), unless the YARP_IMAGE_THREADS environment variable is set.
+     * @param threads the number of threads (0 and 1 disable the pool)
+     */
+    static void setProcessingThreads(size_t threads);
+
+    /**
+     * @return the number of threads used to process large images
+     */
+    static size_t getProcessingThreads();
+
+    /**
+     * Set the minimum size of the images processed by more than one thread.
+     * @param pixels the number of pixels (width * height)
+     */
+    static void setParallelThreshold(size_t pixels);
+
+    /**
+     * @return the minimum size of the images processed by more than one
+     *         thread
+     */
+    static size_t getParallelThreshold();
+
 
     /**
      * Gets width of image in pixels.
@@ -270,6 +299,16 @@ public:
      */
     void setExternal(const void *data, size_t imgWidth, size_t imgHeight);
 
+    /**
+     * Use this to wrap an external image, whose lifetime is managed by
+     * another object (e.g. a slot of a yarp::sig::SharedImagePool).
+     * A reference to \a owner is kept until the image stops using the
+     * external buffer.
+     * Make sure to that pixel type and padding quantum are
+     * synchronized (you can set these in the FlexImage class).
+     */
+    void setExternal(const void *data, size_t imgWidth, size_t imgHeight, std::shared_ptr<void> owner);
+
     /**
     * Access to the internal image buffer.
     * @return pointer to the internal image buffer.
@@ -0,0 +1,622 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/sig/SharedImagePool.h>
+
+#include <yarp/os/LogComponent.h>
+#include <yarp/sig/Image.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <new>
+#include <string>
+
+#if defined(__linux__)
+#    include <cerrno>
+#    include <fcntl.h>
+#    include <signal.h>
+#    include <sys/mman.h>
+#    include <sys/stat.h>
+#    include <time.h>
+#    include <unistd.h>
+#endif
+
+using yarp::sig::Image;
+using yarp::sig::SharedImagePool;
+
+namespace {
+YARP_LOG_COMPONENT(SHAREDIMAGEPOOL, "yarp.sig.SharedImagePool")
+}
+
+#if defined(__linux__)
+
+namespace {
+
+constexpr std::uint32_t pool_magic = 0x59504c32; // "YPL2"
+constexpr size_t slot_alignment = 64;
+constexpr const char pool_prefix[] = "/yarp-pool-";
+
+// The number of processes that can use a slot at the same time, chosen so
+// that the state of a slot fills two cache lines.
+constexpr size_t slot_leases = 13;
+
+// References sent but not received yet are considered lost after this time,
+// when the pool runs out of free slots.
+constexpr std::int64_t pending_lease_ns = 1000000000;
+
+// Stored at the beginning of the segment, followed by the state of each
+// slot, and by the slots.
+struct PoolHeader
+{
+    std::uint32_t magic;
+    std::int32_t creatorPid;
+    std::atomic<std::uint32_t> destroyed;
+    std::uint32_t reserved;
+    std::uint64_t slotSize;
+    std::uint64_t slotCount;
+    std::uint64_t dataOffset;
+};
+
+// The references to a slot held by a process, released by the pool creator
+// if the process dies.
+struct SlotLease
+{
+    std::atomic<std::int32_t> pid;
+    std::atomic<std::uint32_t> count;
+};
+
+// A slot is free when it is not used by an image of the creator, and no
+// reference to it is pending or held by a process.
+struct SlotState
+{
+    std::atomic<std::uint32_t> owned;
+    std::atomic<std::uint32_t> generation;
+    std::atomic<std::uint32_t> pending;
+    std::uint32_t reserved;
+    std::atomic<std::int64_t> pendingDeadline;
+    SlotLease leases[slot_leases];
+
+    bool isFree() const
+    {
+        if (owned.load(std::memory_order_acquire) != 0 || pending.load(std::memory_order_acquire) != 0) {
+            return false;
+        }
+        for (const auto& lease : leases) {
+            if (lease.count.load(std::memory_order_acquire) != 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Take a pending reference, unless it expired or the slot was reused
+    bool takePending(std::uint32_t gen)
+    {
+        std::uint32_t count = pending.load(std::memory_order_acquire);
+        do {
+            if (count == 0 || generation.load(std::memory_order_acquire) != gen) {
+                return false;
+            }
+        } while (!pending.compare_exchange_weak(count, count - 1, std::memory_order_acq_rel));
+        return true;
+    }
+};
+
+std::int64_t monotonicNow()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<std::int64_t>(ts.tv_sec) * 1000000000 + ts.tv_nsec;
+}
+
+bool isProcessDead(std::int32_t pid)
+{
+    return kill(pid, 0) != 0 && errno == ESRCH;
+}
+
+struct Segment
+{
+    std::string name;
+    bool creator {false};
+    void* base {nullptr};
+    size_t size {0};
+    PoolHeader* header {nullptr};
+    SlotState* slots {nullptr};
+    char* data {nullptr};
+
+    ~Segment()
+    {
+        if (base != nullptr) {
+            if (creator) {
+                header->destroyed = 1;
+            }
+            munmap(base, size);
+        }
+        if (creator) {
+            shm_unlink(name.c_str());
+        }
+    }
+
+    bool map(int fd, size_t len)
+    {
+        void* ptr = mmap(nullptr, len, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        if (ptr == MAP_FAILED) {
+            yCError(SHAREDIMAGEPOOL, "Cannot map %s: %s", name.c_str(), strerror(errno));
+            return false;
+        }
+        base = ptr;
+        size = len;
+        header = static_cast<PoolHeader*>(base);
+        slots = reinterpret_cast<SlotState*>(static_cast<char*>(base) + sizeof(PoolHeader));
+        return true;
+    }
+
+    char* slot(size_t index) const
+    {
+        return data + index * header->slotSize;
+    }
+
+    // Returns an owner that releases the slot used by an image of the
+    // creator when destroyed.
+    static std::shared_ptr<void> makeOwner(const std::shared_ptr<Segment>& segment, std::uint32_t index, char* ptr)
+    {
+        return std::shared_ptr<void>(ptr, [segment, index](void*) {
+            segment->slots[index].owned.store(0, std::memory_order_release);
+        });
+    }
+
+    // Returns an owner that releases a reference held by this process when
+    // destroyed.  The segment stays mapped as long as the owner exists.
+    static std::shared_ptr<void> makeLeaseOwner(const std::shared_ptr<Segment>& segment, SlotLease* lease, char* ptr)
+    {
+        return std::shared_ptr<void>(ptr, [segment, lease](void*) {
+            lease->count.fetch_sub(1, std::memory_order_acq_rel);
+        });
+    }
+
+    // Returns the lease of this process on a slot, or nullptr if too many
+    // processes are using it.  Only the creator of the pool clears the
+    // leases, and only those of dead processes, so a lease found here stays
+    // valid.
+    static SlotLease* findLease(SlotState& slot)
+    {
+        auto pid = static_cast<std::int32_t>(getpid());
+        for (auto& lease : slot.leases) {
+            if (lease.pid.load(std::memory_order_acquire) == pid) {
+                return &lease;
+            }
+        }
+        for (auto& lease : slot.leases) {
+            std::int32_t expected = 0;
+            if (lease.pid.compare_exchange_strong(expected, pid, std::memory_order_acq_rel)) {
+                return &lease;
+            }
+        }
+        return nullptr;
+    }
+};
+
+// Segments created by this process (the pools own them), and segments
+// created by other processes and attached by this one.
+std::mutex registry_mutex;
+std::map<std::string, std::weak_ptr<Segment>> created_segments;
+std::map<std::string, std::shared_ptr<Segment>> attached_segments;
+std::atomic<int> segment_counter {0};
+
+// Unmap the segments no longer referenced, whose pool was destroyed.
+// Must be called with the registry mutex locked.
+void purgeAttachedSegments()
+{
+    for (auto it = attached_segments.begin(); it != attached_segments.end();) {
+        const auto& segment = it->second;
+        bool dead = segment->header->destroyed != 0 || isProcessDead(segment->header->creatorPid);
+        if (dead && segment.use_count() == 1) {
+            it = attached_segments.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+// Must be called with the registry mutex locked.
+std::shared_ptr<Segment> findSegment(const std::string& name)
+{
+    auto cit = created_segments.find(name);
+    if (cit != created_segments.end()) {
+        return cit->second.lock();
+    }
+
+    auto ait = attached_segments.find(name);
+    if (ait != attached_segments.end()) {
+        return ait->second;
+    }
+
+    if (name.compare(0, sizeof(pool_prefix) - 1, pool_prefix) != 0) {
+        yCError(SHAREDIMAGEPOOL, "%s is not a pool", name.c_str());
+        return nullptr;
+    }
+
+    purgeAttachedSegments();
+
+    auto segment = std::make_shared<Segment>();
+    segment->name = name;
+    int fd = shm_open(name.c_str(), O_RDWR, 0);
+    if (fd < 0) {
+        yCError(SHAREDIMAGEPOOL, "Cannot open %s: %s", name.c_str(), strerror(errno));
+        return nullptr;
+    }
+    struct stat st;
+    bool ok = (fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) >= sizeof(PoolHeader));
+    ok = ok && segment->map(fd, static_cast<size_t>(st.st_size));
+    ::close(fd);
+    if (!ok) {
+        return nullptr;
+    }
+
+    const PoolHeader* header = segment->header;
+    if (header->magic != pool_magic || header->dataOffset + header->slotSize * header->slotCount > segment->size) {
+        yCError(SHAREDIMAGEPOOL, "%s is not a valid pool", name.c_str());
+        return nullptr;
+    }
+    segment->data = static_cast<char*>(segment->base) + header->dataOffset;
+
+    attached_segments[name] = segment;
+    return segment;
+}
+
+} // namespace
+
+
+class SharedImagePool::Private
+{
+public:
+    std::shared_ptr<Segment> segment;
+    size_t next {0};
+    std::mutex reclaimMutex;
+
+    // Release the references held by dead processes, and the references
+    // sent that were not received in time.
+    size_t reclaim()
+    {
+        std::lock_guard<std::mutex> lock(reclaimMutex);
+        std::int64_t now = monotonicNow();
+        auto self = static_cast<std::int32_t>(getpid());
+        size_t reclaimed = 0;
+        for (size_t i = 0; i < segment->header->slotCount; ++i) {
+            SlotState& slot = segment->slots[i];
+            if (slot.isFree()) {
+                continue;
+            }
+            // The references sent meanwhile are not dropped
+            std::uint32_t pending = slot.pending.load(std::memory_order_acquire);
+            if (pending != 0 && now > slot.pendingDeadline.load(std::memory_order_acquire)) {
+                slot.pending.compare_exchange_strong(pending, 0, std::memory_order_acq_rel);
+            }
+            for (auto& lease : slot.leases) {
+                std::int32_t pid = lease.pid.load(std::memory_order_acquire);
+                if (pid != 0 && pid != self && isProcessDead(pid)) {
+                    lease.count.store(0, std::memory_order_release);
+                    lease.pid.store(0, std::memory_order_release);
+                }
+            }
+            if (slot.isFree()) {
+                ++reclaimed;
+            }
+        }
+        return reclaimed;
+    }
+};
+
+
+SharedImagePool::SharedImagePool(size_t slotSize, size_t slotCount) :
+        mPriv(new Private)
+{
+    if (slotSize == 0 || slotCount == 0) {
+        yCError(SHAREDIMAGEPOOL, "Invalid pool size");
+        return;
+    }
+    slotSize = (slotSize + slot_alignment - 1) / slot_alignment * slot_alignment;
+
+    auto segment = std::make_shared<Segment>();
+    char name[sizeof(Handle::pool)];
+    snprintf(name, sizeof(name), "%s%d-%d", pool_prefix, static_cast<int>(getpid()), segment_counter++);
+    segment->name = name;
+
+    int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, S_IRUSR | S_IWUSR);
+    if (fd < 0) {
+        yCError(SHAREDIMAGEPOOL, "Cannot create %s: %s", name, strerror(errno));
+        return;
+    }
+    segment->creator = true;
+
+    size_t dataOffset = sizeof(PoolHeader) + slotCount * sizeof(SlotState);
+    dataOffset = (dataOffset + slot_alignment - 1) / slot_alignment * slot_alignment;
+    size_t total = dataOffset + slotSize * slotCount;
+    bool ok = (ftruncate(fd, static_cast<off_t>(total)) == 0);
+    if (!ok) {
+        yCError(SHAREDIMAGEPOOL, "Cannot resize %s: %s", name, strerror(errno));
+    }
+    ok = ok && segment->map(fd, total);
+    ::close(fd);
+    if (!ok) {
+        return;
+    }
+
+    PoolHeader* header = new (segment->base) PoolHeader;
+    header->magic = pool_magic;
+    header->creatorPid = static_cast<std::int32_t>(getpid());
+    header->destroyed = 0;
+    header->reserved = 0;
+    header->slotSize = slotSize;
+    header->slotCount = slotCount;
+    header->dataOffset = dataOffset;
+    for (size_t i = 0; i < slotCount; ++i) {
+        SlotState* slot = new (&segment->slots[i]) SlotState;
+        slot->owned = 0;
+        slot->generation = 0;
+        slot->pending = 0;
+        slot->reserved = 0;
+        slot->pendingDeadline = 0;
+        for (auto& lease : slot->leases) {
+            lease.pid = 0;
+            lease.count = 0;
+        }
+    }
+    segment->data = static_cast<char*>(segment->base) + dataOffset;
+
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    created_segments[segment->name] = segment;
+    mPriv->segment = std::move(segment);
+}
+
+SharedImagePool::~SharedImagePool()
+{
+    if (mPriv->segment) {
+        std::lock_guard<std::mutex> lock(registry_mutex);
+        created_segments.erase(mPriv->segment->name);
+    }
+    delete mPriv;
+}
+
+bool SharedImagePool::isValid() const
+{
+    return mPriv->segment != nullptr;
+}
+
+size_t SharedImagePool::getSlotSize() const
+{
+    return mPriv->segment ? static_cast<size_t>(mPriv->segment->header->slotSize) : 0;
+}
+
+size_t SharedImagePool::getSlotCount() const
+{
+    return mPriv->segment ? static_cast<size_t>(mPriv->segment->header->slotCount) : 0;
+}
+
+size_t SharedImagePool::getFreeSlots() const
+{
+    size_t count = 0;
+    for (size_t i = 0; i < getSlotCount(); ++i) {
+        if (mPriv->segment->slots[i].isFree()) {
+            ++count;
+        }
+    }
+    return count;
+}
+
+bool SharedImagePool::allocate(Image& image, size_t width, size_t height)
+{
+    if (!mPriv->segment) {
+        return false;
+    }
+
+    size_t quantum = (image.getQuantum() == 0) ? 1 : image.getQuantum();
+    size_t line = width * image.getPixelSize();
+    size_t required = (line + yarp::sig::PAD_BYTES(line, quantum)) * height;
+    if (required == 0 || required > getSlotSize()) {
+        yCError(SHAREDIMAGEPOOL, "Cannot allocate a %zu bytes image in %zu bytes slots", required, getSlotSize());
+        return false;
+    }
+
+    const std::shared_ptr<Segment>& segment = mPriv->segment;
+    size_t count = getSlotCount();
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        for (size_t n = 0; n < count; ++n) {
+            size_t index = (mPriv->next + n) % count;
+            SlotState& slot = segment->slots[index];
+            if (!slot.isFree()) {
+                continue;
+            }
+            std::uint32_t expected = 0;
+            if (!slot.owned.compare_exchange_strong(expected, 1, std::memory_order_acq_rel)) {
+                continue;
+            }
+            // A reference might have been taken after the check
+            if (slot.pending.load(std::memory_order_acquire) != 0 || !std::all_of(std::begin(slot.leases), std::end(slot.leases), [](const SlotLease& lease) { return lease.count.load(std::memory_order_acquire) == 0; })) {
+                slot.owned.store(0, std::memory_order_release);
+                continue;
+            }
+            slot.generation.fetch_add(1, std::memory_order_acq_rel);
+            mPriv->next = index + 1;
+            char* ptr = segment->slot(index);
+            image.setQuantum(quantum);
+            image.setExternal(ptr, width, height, Segment::makeOwner(segment, static_cast<std::uint32_t>(index), ptr));
+            return true;
+        }
+
+        // The slots used by the receivers that died are not released
+        // otherwise
+        if (attempt == 0 && mPriv->reclaim() == 0) {
+            break;
+        }
+    }
+    return false;
+}
+
+bool SharedImagePool::acquire(const void* data, size_t length, Handle& handle)
+{
+    const char* ptr = static_cast<const char*>(data);
+
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    for (const auto& it : created_segments) {
+        std::shared_ptr<Segment> segment = it.second.lock();
+        if (!segment) {
+            continue;
+        }
+        const PoolHeader* header = segment->header;
+        const char* begin = segment->data;
+        const char* end = segment->data + header->slotSize * header->slotCount;
+        if (ptr < begin || ptr >= end) {
+            continue;
+        }
+
+        auto index = static_cast<std::uint32_t>(static_cast<size_t>(ptr - begin) / header->slotSize);
+        auto offset = static_cast<size_t>(ptr - segment->slot(index));
+        if (offset + length > header->slotSize) {
+            return false;
+        }
+
+        // Only slots in use by an image can be shared
+        SlotState& slot = segment->slots[index];
+        if (slot.owned.load(std::memory_order_acquire) == 0) {
+            return false;
+        }
+        slot.pendingDeadline.store(monotonicNow() + pending_lease_ns, std::memory_order_release);
+        slot.pending.fetch_add(1, std::memory_order_acq_rel);
+
+        memset(&handle, 0, sizeof(handle));
+        strncpy(handle.pool, segment->name.c_str(), sizeof(handle.pool) - 1);
+        handle.slot = index;
+        handle.generation = slot.generation.load(std::memory_order_acquire);
+        handle.offset = offset;
+        handle.length = length;
+        return true;
+    }
+    return false;
+}
+
+const char* SharedImagePool::attach(const Handle& handle, std::shared_ptr<void>& owner)
+{
+    std::string name(handle.pool, strnlen(handle.pool, sizeof(handle.pool)));
+
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    std::shared_ptr<Segment> segment = findSegment(name);
+    if (!segment) {
+        return nullptr;
+    }
+    const PoolHeader* header = segment->header;
+    if (handle.slot >= header->slotCount || handle.offset + handle.length > header->slotSize) {
+        yCError(SHAREDIMAGEPOOL, "Invalid reference to %s", name.c_str());
+        return nullptr;
+    }
+
+    // The reference is counted in the lease of this process before the
+    // pending one is released, so that the slot is never seen as free
+    SlotState& slot = segment->slots[handle.slot];
+    SlotLease* lease = Segment::findLease(slot);
+    if (lease == nullptr) {
+        yCError(SHAREDIMAGEPOOL, "Too many processes are using a slot of %s", name.c_str());
+        slot.takePending(handle.generation);
+        return nullptr;
+    }
+    lease->count.fetch_add(1, std::memory_order_acq_rel);
+    if (!slot.takePending(handle.generation)) {
+        lease->count.fetch_sub(1, std::memory_order_acq_rel);
+        yCError(SHAREDIMAGEPOOL, "The reference to %s expired", name.c_str());
+        return nullptr;
+    }
+
+    char* ptr = segment->slot(handle.slot) + handle.offset;
+    owner = Segment::makeLeaseOwner(segment, lease, ptr);
+    return ptr;
+}
+
+void SharedImagePool::release(const Handle& handle)
+{
+    std::string name(handle.pool, strnlen(handle.pool, sizeof(handle.pool)));
+
+    std::lock_guard<std::mutex> lock(registry_mutex);
+    std::shared_ptr<Segment> segment = findSegment(name);
+    if (!segment || handle.slot >= segment->header->slotCount) {
+        return;
+    }
+    segment->slots[handle.slot].takePending(handle.generation);
+}
+
+#else // defined(__linux__)
+
+class SharedImagePool::Private
+{
+};
+
+SharedImagePool::SharedImagePool(size_t slotSize, size_t slotCount) :
+        mPriv(new Private)
+{
+    YARP_UNUSED(slotSize);
+    YARP_UNUSED(slotCount);
+    yCError(SHAREDIMAGEPOOL, "Shared memory pools are not supported on this platform");
+}
+
+SharedImagePool::~SharedImagePool()
+{
+    delete mPriv;
+}
+
+bool SharedImagePool::isValid() const
+{
+    return false;
+}
+
+size_t SharedImagePool::getSlotSize() const
+{
+    return 0;
+}
+
+size_t SharedImagePool::getSlotCount() const
+{
+    return 0;
+}
+
+size_t SharedImagePool::getFreeSlots() const
+{
+    return 0;
+}
+
+bool SharedImagePool::allocate(Image& image, size_t width, size_t height)
+{
+    YARP_UNUSED(image);
+    YARP_UNUSED(width);
+    YARP_UNUSED(height);
+    return false;
+}
+
+bool SharedImagePool::acquire(const void* data, size_t length, Handle& handle)
+{
+    YARP_UNUSED(data);
+    YARP_UNUSED(length);
+    YARP_UNUSED(handle);
+    return false;
+}
+
+const char* SharedImagePool::attach(const Handle& handle, std::shared_ptr<void>& owner)
+{
+    YARP_UNUSED(handle);
+    YARP_UNUSED(owner);
+    return nullptr;
+}
+
+void SharedImagePool::release(const Handle& handle)
+{
+    YARP_UNUSED(handle);
+}
+
+#endif // defined(__linux__)
@@ -0,0 +1,152 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef YARP_SIG_SHAREDIMAGEPOOL_H
+#define YARP_SIG_SHAREDIMAGEPOOL_H
+
+#include <yarp/sig/api.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+namespace yarp {
+namespace sig {
+
+class Image;
+
+/**
+ * \ingroup sig_class
+ *
+ * A pool of image buffers allocated in a shared memory segment.
+ *
+ * Images whose buffer is allocated from the pool can be sent to other
+ * processes on the same host without copying the pixels: carriers that
+ * support it (e.g. "shmem+ring.1+zerocopy.1") send only a reference to the
+ * slot, and the receiving image wraps the same memory.
+ * Each slot is reference counted, and it is recycled when the sender and all
+ * the receivers stop using it.
+ *
+ * The references held by a receiver that dies without releasing them, and
+ * the references sent but not received within one second, are released by
+ * the pool when it runs out of free slots.  A receiver that tries to use a
+ * reference released this way gets an error.  Up to 13 processes can use the
+ * same slot at the same time.
+ *
+ * A new slot should be allocated for each frame: writing to an image after it
+ * was sent modifies the frame seen by the receivers.  For the same reason,
+ * images received this way should be considered read only.
+ *
+ * Shared memory pools are currently supported on Linux only.
+ */
+class YARP_sig_API SharedImagePool
+{
+public:
+    /**
+     * A reference to a block of memory inside a slot of a pool, that can be
+     * sent to another process on the same host.
+     */
+    struct Handle
+    {
+        char pool[32];
+        std::uint32_t slot;
+        std::uint32_t generation;
+        std::uint64_t offset;
+        std::uint64_t length;
+    };
+
+    /**
+     * Constructor.
+     *
+     * @param slotSize the size of each slot, in bytes
+     * @param slotCount the number of slots
+     */
+    SharedImagePool(size_t slotSize, size_t slotCount);
+
+    SharedImagePool(const SharedImagePool&) = delete;
+    SharedImagePool& operator=(const SharedImagePool&) = delete;
+
+    /**
+     * Destructor.
+     *
+     * The shared memory is released when all the images using it are
+     * destroyed.
+     */
+    virtual ~SharedImagePool();
+
+    /**
+     * @return true if the shared memory segment was created successfully
+     */
+    bool isValid() const;
+
+    size_t getSlotSize() const;
+    size_t getSlotCount() const;
+
+    /**
+     * @return the number of slots not used by any image
+     */
+    size_t getFreeSlots() const;
+
+    /**
+     * Allocate the buffer of an image from a free slot of the pool.
+     *
+     * The pixel code and the quantum of the image must be set before calling
+     * this method.  The previous buffer of the image is released.
+     *
+     * @param image the image
+     * @param width the width of the image
+     * @param height the height of the image
+     * @return true on success, false if the image does not fit in a slot or
+     *         if there are no free slots (the image is left unchanged).
+     */
+    bool allocate(Image& image, size_t width, size_t height);
+
+    /**
+     * Take a new reference to a block of memory allocated from a pool of
+     * this process.
+     *
+     * This method is meant to be used by carriers.
+     *
+     * @param data the beginning of the block
+     * @param length the length of the block
+     * @param[out] handle the reference to the block
+     * @return false if the block does not belong to a slot of a pool
+     */
+    static bool acquire(const void* data, size_t length, Handle& handle);
+
+    /**
+     * Map a block of memory referenced by a handle, taking ownership of the
+     * reference taken by acquire().
+     *
+     * This method is meant to be used by carriers.
+     *
+     * @param handle the reference to the block
+     * @param[out] owner keeps the block valid, the reference is released
+     *             when it is destroyed
+     * @return a pointer to the block, or nullptr if the handle is not valid
+     */
+    static const char* attach(const Handle& handle, std::shared_ptr<void>& owner);
+
+    /**
+     * Release a reference taken by acquire(), without using the block.
+     *
+     * This method is meant to be used by carriers.
+     */
+    static void release(const Handle& handle);
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
+private:
+    class Private;
+    Private* mPriv;
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+};
+
+} // namespace sig
+} // namespace yarp
+
+#endif // YARP_SIG_SHAREDIMAGEPOOL_H
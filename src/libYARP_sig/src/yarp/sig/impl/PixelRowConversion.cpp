@@ -0,0 +1,433 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/sig/impl/PixelRowConversion.h>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#  define YARP_PIXEL_X86 1
+#  include <immintrin.h>
+#  if defined(_MSC_VER) && !defined(__clang__)
+#    include <intrin.h>
+#    define YARP_TARGET_SSE2
+#    define YARP_TARGET_SSSE3
+#    define YARP_TARGET_AVX2
+#  else
+#    define YARP_TARGET_SSE2 __attribute__((target("sse2")))
+#    define YARP_TARGET_SSSE3 __attribute__((target("ssse3")))
+#    define YARP_TARGET_AVX2 __attribute__((target("avx2")))
+#  endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#  define YARP_PIXEL_NEON 1
+#  include <arm_neon.h>
+#endif
+
+namespace {
+
+// Exact integer division by 3 for values up to 765 (i.e. 3 * 255):
+// (s * 21846) >> 16 == s / 3
+constexpr unsigned int divide_by_3_multiplier = 21846;
+
+/******************************************************************************/
+// Scalar implementations
+
+void swapRowRgbScalar(const unsigned char* src, unsigned char* dest, size_t n)
+{
+    for (size_t i = 0; i < n; i++) {
+        dest[0] = src[2];
+        dest[1] = src[1];
+        dest[2] = src[0];
+        src += 3;
+        dest += 3;
+    }
+}
+
+void convertRowRgbToMonoScalar(const unsigned char* src, unsigned char* dest, size_t n)
+{
+    for (size_t i = 0; i < n; i++) {
+        dest[i] = static_cast<unsigned char>((src[0] + src[1] + src[2]) / 3);
+        src += 3;
+    }
+}
+
+void convertRowMonoToRgbScalar(const unsigned char* src, unsigned char* dest, size_t n)
+{
+    for (size_t i = 0; i < n; i++) {
+        dest[0] = src[i];
+        dest[1] = src[i];
+        dest[2] = src[i];
+        dest += 3;
+    }
+}
+
+void convertRowRgbToRgbaScalar(const unsigned char* src, unsigned char* dest, size_t n, bool swap)
+{
+    const int first = swap ? 2 : 0;
+    const int third = swap ? 0 : 2;
+    for (size_t i = 0; i < n; i++) {
+        dest[0] = src[first];
+        dest[1] = src[1];
+        dest[2] = src[third];
+        dest[3] = 255;
+        src += 3;
+        dest += 4;
+    }
+}
+
+void convertRowRgbaToRgbScalar(const unsigned char* src, unsigned char* dest, size_t n, bool swap)
+{
+    const int first = swap ? 2 : 0;
+    const int third = swap ? 0 : 2;
+    for (size_t i = 0; i < n; i++) {
+        dest[0] = src[first];
+        dest[1] = src[1];
+        dest[2] = src[third];
+        src += 4;
+        dest += 3;
+    }
+}
+
+void convertRowMono16ToFloatScalar(const std::uint16_t* src, float* dest, size_t n)
+{
+    for (size_t i = 0; i < n; i++) {
+        dest[i] = static_cast<float>(src[i]);
+    }
+}
+
+
+#if defined(YARP_PIXEL_X86)
+/******************************************************************************/
+// x86 implementations.
+//
+// Loads and stores of 3 channel rows can touch up to 4 bytes after the last
+// pixel processed in the loop, therefore the loops stop early enough to keep
+// them inside the row, and the remaining pixels are converted by the scalar
+// implementations.
+
+YARP_TARGET_SSSE3
+void swapRowRgbSsse3(const unsigned char* src, unsigned char* dest, size_t n)
+{
+    // 5 pixels per iteration, the 16th byte is rewritten by the next one
+    const __m128i mask = _mm_setr_epi8(2, 1, 0, 5, 4, 3, 8, 7, 6, 11, 10, 9, 14, 13, 12, 15);
+    size_t i = 0;
+    for (; i + 6 <= n; i += 5) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 3 * i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + 3 * i), _mm_shuffle_epi8(v, mask));
+    }
+    swapRowRgbScalar(src + 3 * i, dest + 3 * i, n - i);
+}
+
+YARP_TARGET_SSSE3
+void convertRowRgbToMonoSsse3(const unsigned char* src, unsigned char* dest, size_t n)
+{
+    // Gather each channel of 16 pixels from 3 registers
+    const __m128i a0 = _mm_setr_epi8(0, 3, 6, 9, 12, 15, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m128i b0 = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, 2, 5, 8, 11, 14, -1, -1, -1, -1, -1);
+    const __m128i c0 = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 1, 4, 7, 10, 13);
+    const __m128i a1 = _mm_setr_epi8(1, 4, 7, 10, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m128i b1 = _mm_setr_epi8(-1, -1, -1, -1, -1, 0, 3, 6, 9, 12, 15, -1, -1, -1, -1, -1);
+    const __m128i c1 = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 2, 5, 8, 11, 14);
+    const __m128i a2 = _mm_setr_epi8(2, 5, 8, 11, 14, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+    const __m128i b2 = _mm_setr_epi8(-1, -1, -1, -1, -1, 1, 4, 7, 10, 13, -1, -1, -1, -1, -1, -1);
+    const __m128i c2 = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 0, 3, 6, 9, 12, 15);
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i k = _mm_set1_epi16(static_cast<short>(divide_by_3_multiplier));
+
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const __m128i* p = reinterpret_cast<const __m128i*>(src + 3 * i);
+        __m128i a = _mm_loadu_si128(p);
+        __m128i b = _mm_loadu_si128(p + 1);
+        __m128i c = _mm_loadu_si128(p + 2);
+        __m128i ch0 = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(a, a0), _mm_shuffle_epi8(b, b0)), _mm_shuffle_epi8(c, c0));
+        __m128i ch1 = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(a, a1), _mm_shuffle_epi8(b, b1)), _mm_shuffle_epi8(c, c1));
+        __m128i ch2 = _mm_or_si128(_mm_or_si128(_mm_shuffle_epi8(a, a2), _mm_shuffle_epi8(b, b2)), _mm_shuffle_epi8(c, c2));
+        __m128i lo = _mm_add_epi16(_mm_add_epi16(_mm_unpacklo_epi8(ch0, zero), _mm_unpacklo_epi8(ch1, zero)), _mm_unpacklo_epi8(ch2, zero));
+        __m128i hi = _mm_add_epi16(_mm_add_epi16(_mm_unpackhi_epi8(ch0, zero), _mm_unpackhi_epi8(ch1, zero)), _mm_unpackhi_epi8(ch2, zero));
+        lo = _mm_mulhi_epu16(lo, k);
+        hi = _mm_mulhi_epu16(hi, k);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + i), _mm_packus_epi16(lo, hi));
+    }
+    convertRowRgbToMonoScalar(src + 3 * i, dest + i, n - i);
+}
+
+YARP_TARGET_SSSE3
+void convertRowMonoToRgbSsse3(const unsigned char* src, unsigned char* dest, size_t n)
+{
+    const __m128i m0 = _mm_setr_epi8(0, 0, 0, 1, 1, 1, 2, 2, 2, 3, 3, 3, 4, 4, 4, 5);
+    const __m128i m1 = _mm_setr_epi8(5, 5, 6, 6, 6, 7, 7, 7, 8, 8, 8, 9, 9, 9, 10, 10);
+    const __m128i m2 = _mm_setr_epi8(10, 11, 11, 11, 12, 12, 12, 13, 13, 13, 14, 14, 14, 15, 15, 15);
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m128i* p = reinterpret_cast<__m128i*>(dest + 3 * i);
+        _mm_storeu_si128(p, _mm_shuffle_epi8(v, m0));
+        _mm_storeu_si128(p + 1, _mm_shuffle_epi8(v, m1));
+        _mm_storeu_si128(p + 2, _mm_shuffle_epi8(v, m2));
+    }
+    convertRowMonoToRgbScalar(src + i, dest + 3 * i, n - i);
+}
+
+YARP_TARGET_SSSE3
+void convertRowRgbToRgbaSsse3(const unsigned char* src, unsigned char* dest, size_t n, bool swap)
+{
+    const __m128i mask = swap ? _mm_setr_epi8(2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1)
+                              : _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+    const __m128i alpha = _mm_set1_epi32(static_cast<int>(0xFF000000));
+    size_t i = 0;
+    for (; i + 6 <= n; i += 4) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 3 * i));
+        v = _mm_or_si128(_mm_shuffle_epi8(v, mask), alpha);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + 4 * i), v);
+    }
+    convertRowRgbToRgbaScalar(src + 3 * i, dest + 4 * i, n - i, swap);
+}
+
+YARP_TARGET_SSSE3
+void convertRowRgbaToRgbSsse3(const unsigned char* src, unsigned char* dest, size_t n, bool swap)
+{
+    // 4 pixels per iteration, the last 4 bytes are rewritten by the next one
+    const __m128i mask = swap ? _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1)
+                              : _mm_setr_epi8(0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1);
+    size_t i = 0;
+    for (; i + 6 <= n; i += 4) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + 4 * i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dest + 3 * i), _mm_shuffle_epi8(v, mask));
+    }
+    convertRowRgbaToRgbScalar(src + 4 * i, dest + 3 * i, n - i, swap);
+}
+
+YARP_TARGET_SSE2
+void convertRowMono16ToFloatSse2(const std::uint16_t* src, float* dest, size_t n)
+{
+    const __m128i zero = _mm_setzero_si128();
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        _mm_storeu_ps(dest + i, _mm_cvtepi32_ps(_mm_unpacklo_epi16(v, zero)));
+        _mm_storeu_ps(dest + i + 4, _mm_cvtepi32_ps(_mm_unpackhi_epi16(v, zero)));
+    }
+    convertRowMono16ToFloatScalar(src + i, dest + i, n - i);
+}
+
+YARP_TARGET_AVX2
+void convertRowMono16ToFloatAvx2(const std::uint16_t* src, float* dest, size_t n)
+{
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const __m128i* p = reinterpret_cast<const __m128i*>(src + i);
+        __m256i lo = _mm256_cvtepu16_epi32(_mm_loadu_si128(p));
+        __m256i hi = _mm256_cvtepu16_epi32(_mm_loadu_si128(p + 1));
+        _mm256_storeu_ps(dest + i, _mm256_cvtepi32_ps(lo));
+        _mm256_storeu_ps(dest + i + 8, _mm256_cvtepi32_ps(hi));
+    }
+    convertRowMono16ToFloatSse2(src + i, dest + i, n - i);
+}
+
+struct CpuFeatures
+{
+    bool sse2 {false};
+    bool ssse3 {false};
+    bool avx2 {false};
+};
+
+CpuFeatures detectCpuFeatures()
+{
+    CpuFeatures features;
+#  if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    const int max_leaf = info[0];
+    __cpuid(info, 1);
+    features.sse2 = (info[3] & (1 << 26)) != 0;
+    features.ssse3 = (info[2] & (1 << 9)) != 0;
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    if (max_leaf >= 7 && osxsave && (_xgetbv(0) & 0x6) == 0x6) {
+        __cpuidex(info, 7, 0);
+        features.avx2 = (info[1] & (1 << 5)) != 0;
+    }
+#  else
+    __builtin_cpu_init();
+    features.sse2 = __builtin_cpu_supports("sse2");
+    features.ssse3 = __builtin_cpu_supports("ssse3");
+    features.avx2 = __builtin_cpu_supports("avx2");
+#  endif
+    return features;
+}
+
+#elif defined(YARP_PIXEL_NEON)
+/******************************************************************************/
+// NEON implementations
+
+void swapRowRgbNeon(const unsigned char* src, unsigned char* dest, size_t n)
+{
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        uint8x16x3_t v = vld3q_u8(src + 3 * i);
+        uint8x16_t t = v.val[0];
+        v.val[0] = v.val[2];
+        v.val[2] = t;
+        vst3q_u8(dest + 3 * i, v);
+    }
+    swapRowRgbScalar(src + 3 * i, dest + 3 * i, n - i);
+}
+
+inline uint8x8_t divideBy3(uint16x8_t s)
+{
+    const uint16x4_t k = vdup_n_u16(static_cast<uint16_t>(divide_by_3_multiplier));
+    uint16x4_t lo = vshrn_n_u32(vmull_u16(vget_low_u16(s), k), 16);
+    uint16x4_t hi = vshrn_n_u32(vmull_u16(vget_high_u16(s), k), 16);
+    return vmovn_u16(vcombine_u16(lo, hi));
+}
+
+void convertRowRgbToMonoNeon(const unsigned char* src, unsigned char* dest, size_t n)
+{
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        uint8x16x3_t v = vld3q_u8(src + 3 * i);
+        uint16x8_t lo = vaddw_u8(vaddl_u8(vget_low_u8(v.val[0]), vget_low_u8(v.val[1])), vget_low_u8(v.val[2]));
+        uint16x8_t hi = vaddw_u8(vaddl_u8(vget_high_u8(v.val[0]), vget_high_u8(v.val[1])), vget_high_u8(v.val[2]));
+        vst1q_u8(dest + i, vcombine_u8(divideBy3(lo), divideBy3(hi)));
+    }
+    convertRowRgbToMonoScalar(src + 3 * i, dest + i, n - i);
+}
+
+void convertRowMonoToRgbNeon(const unsigned char* src, unsigned char* dest, size_t n)
+{
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        uint8x16x3_t v;
+        v.val[0] = vld1q_u8(src + i);
+        v.val[1] = v.val[0];
+        v.val[2] = v.val[0];
+        vst3q_u8(dest + 3 * i, v);
+    }
+    convertRowMonoToRgbScalar(src + i, dest + 3 * i, n - i);
+}
+
+void convertRowRgbToRgbaNeon(const unsigned char* src, unsigned char* dest, size_t n, bool swap)
+{
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        uint8x16x3_t v = vld3q_u8(src + 3 * i);
+        uint8x16x4_t out;
+        out.val[0] = swap ? v.val[2] : v.val[0];
+        out.val[1] = v.val[1];
+        out.val[2] = swap ? v.val[0] : v.val[2];
+        out.val[3] = vdupq_n_u8(255);
+        vst4q_u8(dest + 4 * i, out);
+    }
+    convertRowRgbToRgbaScalar(src + 3 * i, dest + 4 * i, n - i, swap);
+}
+
+void convertRowRgbaToRgbNeon(const unsigned char* src, unsigned char* dest, size_t n, bool swap)
+{
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        uint8x16x4_t v = vld4q_u8(src + 4 * i);
+        uint8x16x3_t out;
+        out.val[0] = swap ? v.val[2] : v.val[0];
+        out.val[1] = v.val[1];
+        out.val[2] = swap ? v.val[0] : v.val[2];
+        vst3q_u8(dest + 3 * i, out);
+    }
+    convertRowRgbaToRgbScalar(src + 4 * i, dest + 3 * i, n - i, swap);
+}
+
+void convertRowMono16ToFloatNeon(const std::uint16_t* src, float* dest, size_t n)
+{
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        uint16x8_t v = vld1q_u16(src + i);
+        vst1q_f32(dest + i, vcvtq_f32_u32(vmovl_u16(vget_low_u16(v))));
+        vst1q_f32(dest + i + 4, vcvtq_f32_u32(vmovl_u16(vget_high_u16(v))));
+    }
+    convertRowMono16ToFloatScalar(src + i, dest + i, n - i);
+}
+#endif
+
+
+/******************************************************************************/
+// Runtime dispatch
+
+struct Kernels
+{
+    void (*swapRowRgb)(const unsigned char*, unsigned char*, size_t) {swapRowRgbScalar};
+    void (*convertRowRgbToMono)(const unsigned char*, unsigned char*, size_t) {convertRowRgbToMonoScalar};
+    void (*convertRowMonoToRgb)(const unsigned char*, unsigned char*, size_t) {convertRowMonoToRgbScalar};
+    void (*convertRowRgbToRgba)(const unsigned char*, unsigned char*, size_t, bool) {convertRowRgbToRgbaScalar};
+    void (*convertRowRgbaToRgb)(const unsigned char*, unsigned char*, size_t, bool) {convertRowRgbaToRgbScalar};
+    void (*convertRowMono16ToFloat)(const std::uint16_t*, float*, size_t) {convertRowMono16ToFloatScalar};
+};
+
+Kernels selectKernels()
+{
+    Kernels k;
+#if defined(YARP_PIXEL_X86)
+    const CpuFeatures features = detectCpuFeatures();
+    if (features.sse2) {
+        k.convertRowMono16ToFloat = convertRowMono16ToFloatSse2;
+    }
+    if (features.ssse3) {
+        k.swapRowRgb = swapRowRgbSsse3;
+        k.convertRowRgbToMono = convertRowRgbToMonoSsse3;
+        k.convertRowMonoToRgb = convertRowMonoToRgbSsse3;
+        k.convertRowRgbToRgba = convertRowRgbToRgbaSsse3;
+        k.convertRowRgbaToRgb = convertRowRgbaToRgbSsse3;
+    }
+    if (features.avx2) {
+        k.convertRowMono16ToFloat = convertRowMono16ToFloatAvx2;
+    }
+#elif defined(YARP_PIXEL_NEON)
+    k.swapRowRgb = swapRowRgbNeon;
+    k.convertRowRgbToMono = convertRowRgbToMonoNeon;
+    k.convertRowMonoToRgb = convertRowMonoToRgbNeon;
+    k.convertRowRgbToRgba = convertRowRgbToRgbaNeon;
+    k.convertRowRgbaToRgb = convertRowRgbaToRgbNeon;
+    k.convertRowMono16ToFloat = convertRowMono16ToFloatNeon;
+#endif
+    return k;
+}
+
+const Kernels& kernels()
+{
+    static const Kernels k = selectKernels();
+    return k;
+}
+
+} // namespace
+
+
+void yarp::sig::impl::swapRowRgb(const unsigned char* src, unsigned char* dest, size_t n)
+{
+    kernels().swapRowRgb(src, dest, n);
+}
+
+void yarp::sig::impl::convertRowRgbToMono(const unsigned char* src, unsigned char* dest, size_t n)
+{
+    kernels().convertRowRgbToMono(src, dest, n);
+}
+
+void yarp::sig::impl::convertRowMonoToRgb(const unsigned char* src, unsigned char* dest, size_t n)
+{
+    kernels().convertRowMonoToRgb(src, dest, n);
+}
+
+void yarp::sig::impl::convertRowRgbToRgba(const unsigned char* src, unsigned char* dest, size_t n, bool swap)
+{
+    kernels().convertRowRgbToRgba(src, dest, n, swap);
+}
+
+void yarp::sig::impl::convertRowRgbaToRgb(const unsigned char* src, unsigned char* dest, size_t n, bool swap)
+{
+    kernels().convertRowRgbaToRgb(src, dest, n, swap);
+}
+
+void yarp::sig::impl::convertRowMono16ToFloat(const std::uint16_t* src, float* dest, size_t n)
+{
+    kernels().convertRowMono16ToFloat(src, dest, n);
+}
@@ -0,0 +1,70 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+/**
+ * Vectorized conversions of a row of pixels, used by Image::copyPixels() for
+ * the most common pixel formats.
+ *
+ * Each function converts \c n consecutive pixels from \c src to \c dest (that
+ * must not overlap). The implementation is chosen at runtime according to the
+ * instruction sets supported by the CPU (SSSE3/AVX2 on x86, NEON on ARM), with
+ * a scalar fallback. All of them produce exactly the same output as the scalar
+ * CopyPixel() functions.
+ */
+
+#ifndef YARP_SIG_IMPL_PIXELROWCONVERSION_H
+#define YARP_SIG_IMPL_PIXELROWCONVERSION_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace yarp {
+namespace sig {
+namespace impl {
+
+/**
+ * Swap the first and the third channel of 3 channel pixels
+ * (rgb -> bgr, bgr -> rgb).
+ */
+void swapRowRgb(const unsigned char* src, unsigned char* dest, size_t n);
+
+/**
+ * Convert 3 channel pixels to mono, averaging the channels
+ * (rgb -> mono, bgr -> mono).
+ */
+void convertRowRgbToMono(const unsigned char* src, unsigned char* dest, size_t n);
+
+/**
+ * Convert mono pixels to 3 channel pixels (mono -> rgb, mono -> bgr).
+ */
+void convertRowMonoToRgb(const unsigned char* src, unsigned char* dest, size_t n);
+
+/**
+ * Add an opaque alpha channel to 3 channel pixels, optionally swapping the
+ * first and the third channel (rgb -> rgba, rgb -> bgra, bgr -> bgra,
+ * bgr -> rgba).
+ */
+void convertRowRgbToRgba(const unsigned char* src, unsigned char* dest, size_t n, bool swap);
+
+/**
+ * Remove the alpha channel of 4 channel pixels, optionally swapping the
+ * first and the third channel (rgba -> rgb, rgba -> bgr, bgra -> bgr,
+ * bgra -> rgb).
+ */
+void convertRowRgbaToRgb(const unsigned char* src, unsigned char* dest, size_t n, bool swap);
+
+/**
+ * Convert 16 bit mono pixels to float (mono16 -> mono float).
+ */
+void convertRowMono16ToFloat(const std::uint16_t* src, float* dest, size_t n);
+
+} // namespace impl
+} // namespace sig
+} // namespace yarp
+
+#endif // YARP_SIG_IMPL_PIXELROWCONVERSION_H
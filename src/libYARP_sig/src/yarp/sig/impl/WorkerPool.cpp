@@ -0,0 +1,218 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/sig/impl/WorkerPool.h>
+
+#include <yarp/os/Network.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using yarp::sig::impl::WorkerPool;
+
+namespace {
+
+// Smaller images are processed faster by the calling thread alone
+constexpr size_t default_threshold = 640 * 480;
+
+struct Job
+{
+    Job(size_t count, const std::function<void(size_t)>& task) :
+            count(count),
+            task(task)
+    {
+    }
+
+    const size_t count;
+    const std::function<void(size_t)>& task;
+    std::atomic<size_t> next {0};
+
+    std::mutex mutex;
+    std::condition_variable finished;
+    size_t done {0};
+
+    bool exhausted() const
+    {
+        return next.load() >= count;
+    }
+
+    // Run the tasks not started yet
+    void process()
+    {
+        size_t n = 0;
+        for (size_t i = next++; i < count; i = next++) {
+            task(i);
+            n++;
+        }
+        if (n > 0) {
+            std::lock_guard<std::mutex> lock(mutex);
+            done += n;
+            if (done == count) {
+                finished.notify_all();
+            }
+        }
+    }
+
+    void wait()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        finished.wait(lock, [this]() { return done == count; });
+    }
+};
+
+} // namespace
+
+
+class WorkerPool::Private
+{
+public:
+    std::mutex configMutex;
+    std::vector<std::thread> workers;
+    std::atomic<size_t> threads {1};
+    std::atomic<size_t> threshold {default_threshold};
+
+    std::mutex mutex;
+    std::condition_variable available;
+    std::deque<std::shared_ptr<Job>> queue;
+    bool stopping {false};
+
+    void work()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            while (!queue.empty() && queue.front()->exhausted()) {
+                queue.pop_front();
+            }
+            if (stopping) {
+                return;
+            }
+            if (queue.empty()) {
+                available.wait(lock);
+                continue;
+            }
+            std::shared_ptr<Job> job = queue.front();
+            lock.unlock();
+            job->process();
+            lock.lock();
+        }
+    }
+
+    void start(size_t count)
+    {
+        threads = std::max<size_t>(count, 1);
+        for (size_t i = 1; i < count; i++) {
+            workers.emplace_back(&Private::work, this);
+        }
+    }
+
+    void stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        available.notify_all();
+        for (auto& worker : workers) {
+            worker.join();
+        }
+        workers.clear();
+        threads = 1;
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = false;
+    }
+};
+
+
+WorkerPool& WorkerPool::instance()
+{
+    static WorkerPool pool;
+    return pool;
+}
+
+WorkerPool::WorkerPool() :
+        mPriv(new Private)
+{
+    std::string threads = yarp::os::NetworkBase::getEnvironment("YARP_IMAGE_THREADS");
+    if (!threads.empty()) {
+        mPriv->start(std::strtoul(threads.c_str(), nullptr, 10));
+    }
+}
+
+WorkerPool::~WorkerPool()
+{
+    mPriv->stop();
+    delete mPriv;
+}
+
+void WorkerPool::setThreads(size_t threads)
+{
+    std::lock_guard<std::mutex> lock(mPriv->configMutex);
+    mPriv->stop();
+    mPriv->start(threads);
+}
+
+size_t WorkerPool::getThreads() const
+{
+    return mPriv->threads;
+}
+
+void WorkerPool::setThreshold(size_t pixels)
+{
+    mPriv->threshold = pixels;
+}
+
+size_t WorkerPool::getThreshold() const
+{
+    return mPriv->threshold;
+}
+
+void WorkerPool::run(size_t count, const std::function<void(size_t)>& task)
+{
+    if (count == 0) {
+        return;
+    }
+    if (count == 1 || mPriv->threads <= 1) {
+        for (size_t i = 0; i < count; i++) {
+            task(i);
+        }
+        return;
+    }
+
+    auto job = std::make_shared<Job>(count, task);
+    {
+        std::lock_guard<std::mutex> lock(mPriv->mutex);
+        mPriv->queue.push_back(job);
+    }
+    mPriv->available.notify_all();
+
+    // The workers may be busy with other jobs
+    job->process();
+    job->wait();
+}
+
+void WorkerPool::forEachBand(size_t width, size_t height, const std::function<void(size_t, size_t)>& process)
+{
+    const size_t threads = mPriv->threads;
+    if (threads <= 1 || height < 2 || width * height < mPriv->threshold) {
+        process(0, height);
+        return;
+    }
+
+    const size_t bands = std::min(threads, height);
+    run(bands, [&](size_t band) {
+        process(height * band / bands, height * (band + 1) / bands);
+    });
+}
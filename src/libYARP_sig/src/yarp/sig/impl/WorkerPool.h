@@ -0,0 +1,73 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef YARP_SIG_IMPL_WORKERPOOL_H
+#define YARP_SIG_IMPL_WORKERPOOL_H
+
+#include <cstddef>
+#include <functional>
+
+namespace yarp {
+namespace sig {
+namespace impl {
+
+/**
+ * A process-wide pool of threads, used to process large images in bands of
+ * rows.
+ *
+ * The pool is disabled by default (i.e. everything runs in the calling
+ * thread), unless the YARP_IMAGE_THREADS environment variable is set.
+ */
+class WorkerPool
+{
+public:
+    static WorkerPool& instance();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    /**
+     * Set the number of threads processing an image, including the calling
+     * thread. 0 and 1 disable the pool.
+     */
+    void setThreads(size_t threads);
+    size_t getThreads() const;
+
+    /**
+     * Set the minimum number of pixels of an image processed in parallel.
+     */
+    void setThreshold(size_t pixels);
+    size_t getThreshold() const;
+
+    /**
+     * Run task(0) ... task(count - 1) and wait for all of them to finish.
+     *
+     * The tasks are shared between the threads of the pool and the calling
+     * thread, that never waits for a worker to be available.
+     */
+    void run(size_t count, const std::function<void(size_t)>& task);
+
+    /**
+     * Split the rows of an image in bands, and call process(begin, end) for
+     * each of them, in parallel if the image is large enough.
+     */
+    void forEachBand(size_t width, size_t height, const std::function<void(size_t, size_t)>& process);
+
+private:
+    WorkerPool();
+    ~WorkerPool();
+
+    class Private;
+    Private* mPriv;
+};
+
+} // namespace impl
+} // namespace sig
+} // namespace yarp
+
+#endif // YARP_SIG_IMPL_WORKERPOOL_H
@@ -0,0 +1,521 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include "DumpBinaryFile.h"
+
+#include <yarp/os/NetFloat64.h>
+#include <yarp/os/NetInt32.h>
+#include <yarp/os/NetUint32.h>
+#include <yarp/os/NetUint64.h>
+
+#include <cstring>
+#include <stdexcept>
+
+using namespace std;
+using namespace yarp::os;
+using namespace yarp::sig;
+
+namespace {
+
+constexpr uint32_t compression_none{0};
+constexpr size_t   header_size{8};
+constexpr size_t   section_header_size{8};
+constexpr size_t   chunk_header_size{32};
+constexpr size_t   index_entry_size{28};
+constexpr size_t   trailer_size{24};
+constexpr size_t   record_header_size{32};
+constexpr size_t   image_header_size{20};
+
+
+// Append a value to a binary buffer using the network representation
+/**************************************************************************/
+template <class NetT, class T>
+void binaryAppend(string &buf, const T val)
+{
+    NetT net=static_cast<NetT>(val);
+    buf.append(reinterpret_cast<const char*>(&net),sizeof(net));
+}
+
+
+// Extract a value from a binary buffer, the caller checks the bounds
+/**************************************************************************/
+template <class NetT, class T>
+void binaryExtract(const string &buf, size_t &pos, T &val)
+{
+    NetT net;
+    memcpy(&net,buf.data()+pos,sizeof(net));
+    val=static_cast<T>(net);
+    pos+=sizeof(net);
+}
+
+} // namespace
+
+
+/**************************************************************************/
+double DumpBinaryRecord::getStamp() const
+{
+    if (flags&dump_binary_tx_stamp)
+        return txStamp;
+    else if (flags&dump_binary_rx_stamp)
+        return rxStamp;
+    else
+        return -1.0;
+}
+
+
+/**************************************************************************/
+void dumpBinarySerialize(Bottle &obj, string &payload)
+{
+    size_t size=0;
+    const char *data=obj.toBinary(&size);
+    payload.assign(data,size);
+}
+
+
+/**************************************************************************/
+void dumpBinarySerialize(const Image &obj, string &payload)
+{
+    payload.clear();
+    payload.reserve(image_header_size+obj.getRawImageSize());
+    binaryAppend<NetUint32>(payload,obj.width());
+    binaryAppend<NetUint32>(payload,obj.height());
+    binaryAppend<NetUint32>(payload,obj.getPixelCode());
+    binaryAppend<NetUint32>(payload,obj.getQuantum());
+    binaryAppend<NetUint32>(payload,obj.topIsLowIndex()?1:0);
+    payload.append(reinterpret_cast<const char*>(obj.getRawImage()),obj.getRawImageSize());
+}
+
+
+/**************************************************************************/
+bool dumpBinaryDeserialize(const string &payload, Bottle &obj)
+{
+    obj.fromBinary(payload.data(),payload.size());
+    return !payload.empty();
+}
+
+
+/**************************************************************************/
+bool dumpBinaryDeserialize(const string &payload, FlexImage &obj)
+{
+    if (payload.size()<image_header_size)
+        return false;
+
+    size_t pos=0;
+    uint32_t width,height,quantum,topIsLow;
+    int32_t pixelCode;
+    binaryExtract<NetUint32>(payload,pos,width);
+    binaryExtract<NetUint32>(payload,pos,height);
+    binaryExtract<NetInt32>(payload,pos,pixelCode);
+    binaryExtract<NetUint32>(payload,pos,quantum);
+    binaryExtract<NetUint32>(payload,pos,topIsLow);
+
+    try
+    {
+        obj.setPixelCode(pixelCode);
+    }
+    catch (const out_of_range&)
+    {
+        return false;
+    }
+
+    // the pixels without the padding must fit in the payload
+    // before allocating the image
+    size_t size=payload.size()-pos;
+    if ((quantum==0) || (obj.getPixelSize()==0) ||
+        (static_cast<uint64_t>(width)*height*obj.getPixelSize()>size))
+        return false;
+
+    obj.setQuantum(quantum);
+    obj.setTopIsLowIndex(topIsLow!=0);
+    obj.resize(width,height);
+    if (obj.getRawImageSize()!=size)
+        return false;
+
+    memcpy(obj.getRawImage(),payload.data()+pos,size);
+    return true;
+}
+
+
+/**************************************************************************/
+DumpBinaryWriter::~DumpBinaryWriter()
+{
+    close();
+}
+
+
+/**************************************************************************/
+void DumpBinaryWriter::writeSection(const char *tag, const string &body)
+{
+    string header(tag,4);
+    binaryAppend<NetUint32>(header,body.size());
+    fdata.write(header.data(),header.size());
+    fdata.write(body.data(),body.size());
+    offset+=header.size()+body.size();
+}
+
+
+/**************************************************************************/
+void DumpBinaryWriter::writeIndex()
+{
+    if (index.empty())
+        return;
+
+    string body;
+    binaryAppend<NetUint64>(body,lastIndex);
+    binaryAppend<NetUint32>(body,index.size());
+    for (const auto &entry : index)
+    {
+        binaryAppend<NetUint64>(body,entry.offset);
+        binaryAppend<NetUint32>(body,entry.items);
+        binaryAppend<NetFloat64>(body,entry.firstStamp);
+        binaryAppend<NetFloat64>(body,entry.lastStamp);
+    }
+
+    lastIndex=offset;
+    writeSection("INDX",body);
+    fdata.flush();
+    index.clear();
+}
+
+
+/**************************************************************************/
+bool DumpBinaryWriter::open(const string &fileName, const DumpBinaryStream &stream)
+{
+    fdata.open(fileName.c_str(),ios::out|ios::binary);
+    if (!fdata.is_open())
+        return false;
+
+    string header("YDMP");
+    binaryAppend<NetUint32>(header,dump_binary_version);
+    fdata.write(header.data(),header.size());
+    offset=header.size();
+
+    string body;
+    binaryAppend<NetUint32>(body,stream.stream);
+    binaryAppend<NetUint32>(body,stream.type);
+    body.append(stream.name);
+    writeSection("STRM",body);
+
+    return fdata.good();
+}
+
+
+/**************************************************************************/
+void DumpBinaryWriter::append(const DumpBinaryRecord &record)
+{
+    if (chunkItems==0)
+        chunkFirstStamp=record.getStamp();
+    chunkLastStamp=record.getStamp();
+
+    binaryAppend<NetUint32>(chunk,record.stream);
+    binaryAppend<NetInt32>(chunk,record.seqNumber);
+    binaryAppend<NetUint32>(chunk,record.flags);
+    binaryAppend<NetFloat64>(chunk,record.txStamp);
+    binaryAppend<NetFloat64>(chunk,record.rxStamp);
+    binaryAppend<NetUint32>(chunk,record.payload.size());
+    chunk.append(record.payload);
+    chunkItems++;
+}
+
+
+/**************************************************************************/
+bool DumpBinaryWriter::writeChunk(const uint64_t dropped)
+{
+    if ((chunkItems==0) && (dropped==0))
+        return true;
+
+    string body;
+    binaryAppend<NetUint32>(body,compression_none);
+    binaryAppend<NetUint32>(body,chunkItems);
+    binaryAppend<NetUint64>(body,dropped);
+    binaryAppend<NetFloat64>(body,chunkFirstStamp);
+    binaryAppend<NetFloat64>(body,chunkLastStamp);
+    body.append(chunk);
+
+    index.push_back({offset,chunkItems,chunkFirstStamp,chunkLastStamp});
+    writeSection("CHNK",body);
+    fdata.flush();
+
+    cumulItems+=chunkItems;
+    cumulDropped+=dropped;
+
+    chunk.clear();
+    chunkItems=0;
+
+    if (index.size()>=indexPeriod)
+        writeIndex();
+
+    return fdata.good();
+}
+
+
+/**************************************************************************/
+bool DumpBinaryWriter::close()
+{
+    if (!fdata.is_open())
+        return true;
+
+    writeChunk();
+    writeIndex();
+
+    string body;
+    binaryAppend<NetUint64>(body,lastIndex);
+    binaryAppend<NetUint64>(body,cumulItems);
+    binaryAppend<NetUint64>(body,cumulDropped);
+    writeSection("TRLR",body);
+
+    bool ret=fdata.good();
+    fdata.close();
+    return ret;
+}
+
+
+/**************************************************************************/
+bool DumpBinaryReader::readSectionHeader(const uint64_t pos, string &tag, uint32_t &size)
+{
+    if (pos+section_header_size>fileSize)
+        return false;
+
+    string header(section_header_size,'\0');
+    fdata.clear();
+    fdata.seekg(pos);
+    if (!fdata.read(&header[0],header.size()))
+        return false;
+
+    size_t p=4;
+    tag=header.substr(0,4);
+    binaryExtract<NetUint32>(header,p,size);
+    return (pos+section_header_size+size<=fileSize);
+}
+
+
+/**************************************************************************/
+bool DumpBinaryReader::readBody(const uint64_t pos, const uint32_t size, string &body)
+{
+    body.resize(size);
+    fdata.clear();
+    fdata.seekg(pos+section_header_size);
+    return static_cast<bool>(fdata.read(&body[0],size));
+}
+
+
+// Follow the chain of the indices backwards, starting from the last one
+/**************************************************************************/
+bool DumpBinaryReader::readIndices(const uint64_t last)
+{
+    vector<vector<DumpBinaryChunk>> indices;
+    uint64_t pos=last;
+    while (pos!=0)
+    {
+        string tag,body;
+        uint32_t size;
+        if (!readSectionHeader(pos,tag,size) || (tag!="INDX") ||
+            (size<12) || !readBody(pos,size,body))
+            return false;
+
+        size_t p=0;
+        uint64_t previous;
+        uint32_t entries;
+        binaryExtract<NetUint64>(body,p,previous);
+        binaryExtract<NetUint32>(body,p,entries);
+        if ((previous>=pos) || (size!=12+entries*index_entry_size))
+            return false;
+
+        vector<DumpBinaryChunk> index(entries);
+        for (auto &entry : index)
+        {
+            binaryExtract<NetUint64>(body,p,entry.offset);
+            binaryExtract<NetUint32>(body,p,entry.items);
+            binaryExtract<NetFloat64>(body,p,entry.firstStamp);
+            binaryExtract<NetFloat64>(body,p,entry.lastStamp);
+            if (entry.offset>=pos)
+                return false;
+        }
+        indices.push_back(move(index));
+        pos=previous;
+    }
+
+    chunks.clear();
+    for (auto it=indices.rbegin(); it!=indices.rend(); it++)
+        chunks.insert(chunks.end(),it->begin(),it->end());
+    return true;
+}
+
+
+// Locate the chunks reading the sections one after the other
+/**************************************************************************/
+bool DumpBinaryReader::scan(uint64_t pos)
+{
+    chunks.clear();
+    items=0;
+    dropped=0;
+
+    string tag,header;
+    uint32_t size;
+    while (readSectionHeader(pos,tag,size))
+    {
+        if (tag=="CHNK")
+        {
+            if ((size<chunk_header_size) || !readBody(pos,chunk_header_size,header))
+                break;
+
+            size_t p=4;
+            DumpBinaryChunk chunk;
+            uint64_t chunkDropped;
+            chunk.offset=pos;
+            binaryExtract<NetUint32>(header,p,chunk.items);
+            binaryExtract<NetUint64>(header,p,chunkDropped);
+            binaryExtract<NetFloat64>(header,p,chunk.firstStamp);
+            binaryExtract<NetFloat64>(header,p,chunk.lastStamp);
+            chunks.push_back(chunk);
+            items+=chunk.items;
+            dropped+=chunkDropped;
+        }
+        pos+=section_header_size+size;
+    }
+
+    return true;
+}
+
+
+/**************************************************************************/
+bool DumpBinaryReader::open(const string &fileName)
+{
+    close();
+
+    fdata.open(fileName.c_str(),ios::in|ios::binary);
+    if (!fdata.is_open())
+        return false;
+
+    fdata.seekg(0,ios::end);
+    fileSize=static_cast<uint64_t>(fdata.tellg());
+    fdata.seekg(0);
+
+    string header(header_size,'\0');
+    if ((fileSize<header_size) || !fdata.read(&header[0],header.size()) ||
+        (header.compare(0,4,"YDMP")!=0))
+    {
+        close();
+        return false;
+    }
+
+    size_t p=4;
+    uint32_t version;
+    binaryExtract<NetUint32>(header,p,version);
+    if (version!=dump_binary_version)
+    {
+        close();
+        return false;
+    }
+
+    // the streams are declared at the beginning of the file
+    uint64_t pos=header_size;
+    string tag,body;
+    uint32_t size;
+    while (readSectionHeader(pos,tag,size) && (tag=="STRM"))
+    {
+        if ((size<8) || !readBody(pos,size,body))
+            break;
+
+        p=0;
+        DumpBinaryStream stream;
+        binaryExtract<NetUint32>(body,p,stream.stream);
+        binaryExtract<NetUint32>(body,p,stream.type);
+        stream.name=body.substr(p);
+        streams.push_back(stream);
+        pos+=section_header_size+size;
+    }
+
+    if (streams.empty())
+    {
+        close();
+        return false;
+    }
+
+    // the trailer is the last section of the file
+    uint64_t trailer=fileSize-section_header_size-trailer_size;
+    if ((fileSize>=pos+section_header_size+trailer_size) &&
+        readSectionHeader(trailer,tag,size) && (tag=="TRLR") &&
+        (size==trailer_size) && readBody(trailer,size,body))
+    {
+        p=0;
+        uint64_t last;
+        binaryExtract<NetUint64>(body,p,last);
+        binaryExtract<NetUint64>(body,p,items);
+        binaryExtract<NetUint64>(body,p,dropped);
+        complete=(last<trailer) && readIndices(last);
+    }
+
+    if (!complete)
+        return scan(pos);
+
+    return true;
+}
+
+
+/**************************************************************************/
+void DumpBinaryReader::close()
+{
+    if (fdata.is_open())
+        fdata.close();
+    fileSize=0;
+    streams.clear();
+    chunks.clear();
+    complete=false;
+    items=0;
+    dropped=0;
+}
+
+
+/**************************************************************************/
+bool DumpBinaryReader::readChunk(const size_t i, vector<DumpBinaryRecord> &records,
+                                 uint64_t *chunkDropped)
+{
+    records.clear();
+    if (i>=chunks.size())
+        return false;
+
+    string tag,body;
+    uint32_t size;
+    if (!readSectionHeader(chunks[i].offset,tag,size) || (tag!="CHNK") ||
+        (size<chunk_header_size) || !readBody(chunks[i].offset,size,body))
+        return false;
+
+    size_t p=0;
+    uint32_t compression,n;
+    uint64_t d;
+    binaryExtract<NetUint32>(body,p,compression);
+    binaryExtract<NetUint32>(body,p,n);
+    binaryExtract<NetUint64>(body,p,d);
+    p=chunk_header_size;
+    if ((compression!=compression_none) ||
+        (static_cast<uint64_t>(n)*record_header_size>body.size()-p))
+        return false;
+
+    records.resize(n);
+    for (auto &record : records)
+    {
+        uint32_t payloadSize;
+        if (p+record_header_size>body.size())
+            return false;
+        binaryExtract<NetUint32>(body,p,record.stream);
+        binaryExtract<NetInt32>(body,p,record.seqNumber);
+        binaryExtract<NetUint32>(body,p,record.flags);
+        binaryExtract<NetFloat64>(body,p,record.txStamp);
+        binaryExtract<NetFloat64>(body,p,record.rxStamp);
+        binaryExtract<NetUint32>(body,p,payloadSize);
+        if (payloadSize>body.size()-p)
+            return false;
+        record.payload.assign(body,p,payloadSize);
+        p+=payloadSize;
+    }
+
+    if (chunkDropped!=nullptr)
+        *chunkDropped=d;
+    return true;
+}
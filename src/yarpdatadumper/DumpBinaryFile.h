@@ -0,0 +1,169 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#ifndef YARPDATADUMPER_DUMPBINARYFILE_H
+#define YARPDATADUMPER_DUMPBINARYFILE_H
+
+#include <yarp/os/Bottle.h>
+#include <yarp/sig/Image.h>
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// The binary container written by yarpdatadumper --binary (data.bin).
+// It is laid out as follows (all the fields use the YARP network
+// representation):
+//
+//   header  : "YDMP" version(u32)
+//   section : tag(4 chars) size(u32) body[size]
+//
+// where the sections are:
+//
+//   "STRM"  : stream(u32) type(u32) name
+//   "CHNK"  : compression(u32) items(u32) dropped(u64)
+//             firstStamp(f64) lastStamp(f64) record...
+//   "INDX"  : previous(u64) entries(u32)
+//             [offset(u64) items(u32) firstStamp(f64) lastStamp(f64)]...
+//   "TRLR"  : index(u64) items(u64) dropped(u64)
+//
+//   record  : stream(u32) seq(i32) flags(u32) txStamp(f64) rxStamp(f64)
+//             size(u32) payload[size]
+//
+// "dropped" counts the items lost before the chunk because the queue was
+// full; the index sections refer to the chunks written after the previous
+// one and the trailer points to the last index.
+// The payload of a Bottle is its binary representation, the payload of an
+// image is width(u32) height(u32) pixelCode(u32) quantum(u32)
+// topIsLow(u32) followed by the pixels.
+
+constexpr uint32_t dump_binary_version{1};
+constexpr uint32_t dump_binary_bottle{0};
+constexpr uint32_t dump_binary_image{1};
+constexpr uint32_t dump_binary_tx_stamp{0x1};
+constexpr uint32_t dump_binary_rx_stamp{0x2};
+
+
+/**************************************************************************/
+struct DumpBinaryRecord
+{
+    uint32_t     stream{0};
+    int32_t      seqNumber{0};
+    uint32_t     flags{0};
+    double       txStamp{0.0};
+    double       rxStamp{0.0};
+    std::string  payload;
+
+    // the sender time if available, otherwise the receiver time
+    double getStamp() const;
+};
+
+
+/**************************************************************************/
+struct DumpBinaryStream
+{
+    uint32_t     stream{0};
+    uint32_t     type{dump_binary_bottle};
+    std::string  name;
+};
+
+
+/**************************************************************************/
+struct DumpBinaryChunk
+{
+    uint64_t     offset{0};
+    uint32_t     items{0};
+    double       firstStamp{0.0};
+    double       lastStamp{0.0};
+};
+
+
+// Payload conversions
+/**************************************************************************/
+void dumpBinarySerialize(yarp::os::Bottle &obj, std::string &payload);
+void dumpBinarySerialize(const yarp::sig::Image &obj, std::string &payload);
+bool dumpBinaryDeserialize(const std::string &payload, yarp::os::Bottle &obj);
+bool dumpBinaryDeserialize(const std::string &payload, yarp::sig::FlexImage &obj);
+
+
+// Writer of the container
+// The records are accumulated in the current chunk, which is appended to the
+// file by writeChunk(); an index is written every indexPeriod chunks and by
+// close(), which also writes the trailer.
+/**************************************************************************/
+class DumpBinaryWriter
+{
+private:
+    static constexpr size_t indexPeriod{64};
+
+    std::ofstream                 fdata;
+    std::string                   chunk;
+    uint32_t                      chunkItems{0};
+    double                        chunkFirstStamp{0.0};
+    double                        chunkLastStamp{0.0};
+    std::vector<DumpBinaryChunk>  index;
+    uint64_t                      lastIndex{0};
+    uint64_t                      offset{0};
+    uint64_t                      cumulItems{0};
+    uint64_t                      cumulDropped{0};
+
+    void writeSection(const char *tag, const std::string &body);
+    void writeIndex();
+
+public:
+    DumpBinaryWriter() = default;
+    ~DumpBinaryWriter();
+
+    bool open(const std::string &fileName, const DumpBinaryStream &stream);
+    bool isOpen() const { return fdata.is_open(); }
+    void append(const DumpBinaryRecord &record);
+    size_t getChunkSize() const { return chunk.size(); }
+    uint32_t getChunkItems() const { return chunkItems; }
+    // write the current chunk, accounting for the items dropped before it
+    bool writeChunk(const uint64_t dropped=0);
+    bool close();
+    uint64_t getItems() const { return cumulItems; }
+    uint64_t getDropped() const { return cumulDropped; }
+};
+
+
+// Reader of the container
+// The chunks are located through the indices; if the trailer is missing,
+// e.g. because the recording was interrupted, the file is scanned instead.
+/**************************************************************************/
+class DumpBinaryReader
+{
+private:
+    std::ifstream                  fdata;
+    uint64_t                       fileSize{0};
+    std::vector<DumpBinaryStream>  streams;
+    std::vector<DumpBinaryChunk>   chunks;
+    bool                           complete{false};
+    uint64_t                       items{0};
+    uint64_t                       dropped{0};
+
+    bool readSectionHeader(const uint64_t pos, std::string &tag, uint32_t &size);
+    bool readBody(const uint64_t pos, const uint32_t size, std::string &body);
+    bool readIndices(const uint64_t last);
+    bool scan(uint64_t pos);
+
+public:
+    bool open(const std::string &fileName);
+    void close();
+    // true if the trailer was found
+    bool isComplete() const { return complete; }
+    const std::vector<DumpBinaryStream> &getStreams() const { return streams; }
+    const std::vector<DumpBinaryChunk> &getChunks() const { return chunks; }
+    uint64_t getItems() const { return items; }
+    uint64_t getDropped() const { return dropped; }
+    bool readChunk(const size_t i, std::vector<DumpBinaryRecord> &records,
+                   uint64_t *chunkDropped=nullptr);
+};
+
+#endif
@@ -13,6 +13,8 @@
 #include <yarp/os/ResourceFinder.h>
 #include <yarp/os/RFModule.h>
 #include <yarp/os/Stamp.h>
+#include <yarp/os/SystemClock.h>
+#include <yarp/os/Thread.h>
 #include <yarp/sig/all.h>
 
 #include <iostream>
@@ -24,8 +26,12 @@
 #include <deque>
 #include <utility>
 #include <mutex>
+#include <atomic>
+#include <vector>
 #include <algorithm>
 
+#include "DumpBinaryFile.h"
+
 #ifdef ADD_VIDEO
 #    include <opencv2/opencv.hpp>
 #    include <yarp/cv/Cv.h>
@@ -48,6 +54,9 @@ using namespace yarp::sig;
 enum class DumpType { bottle, image };
 enum class DumpFormat { plain, image_jpg, image_png } dump_format;
 
+// largest memory budget in MB accepted for the queue in binary mode
+constexpr int maxQueueLimit=16384;
+
 // Abstract object definition for queueing
 /**************************************************************************/
 class DumpObj
@@ -218,6 +227,12 @@ public:
         }
         return ret.str();
     }
+    void toRecord(DumpBinaryRecord &record) const
+    {
+        record.flags=(txOk?dump_binary_tx_stamp:0x0)|(rxOk?dump_binary_rx_stamp:0x0);
+        record.txStamp=txStamp;
+        record.rxStamp=rxStamp;
+    }
 };
 
 
@@ -247,13 +262,93 @@ public:
 };
 
 
+// Definition of the handoff queue of the binary recording mode
+// It is a bounded single-producer single-consumer ring: the port callback
+// never waits for the writer and the items which exceed either the number
+// of slots or the memory budget are dropped and accounted for.
+/**************************************************************************/
+class DumpRing
+{
+private:
+    vector<DumpBinaryRecord*> slots;
+    atomic<size_t>      head{0};
+    atomic<size_t>      tail{0};
+    atomic<size_t>      bytes{0};
+    atomic<uint64_t>    dropped{0};
+    size_t              maxBytes;
+
+public:
+    DumpRing(const size_t capacity, const size_t _maxBytes) :
+        slots(capacity+1,nullptr),
+        maxBytes(_maxBytes)
+    {
+    }
+
+    ~DumpRing()
+    {
+        while (DumpBinaryRecord *item=pop())
+            delete item;
+    }
+
+    // producer side: the ring takes the ownership of the item
+    bool push(DumpBinaryRecord *item)
+    {
+        size_t sz=item->payload.size();
+        size_t h=head.load(memory_order_relaxed);
+        size_t next=(h+1)%slots.size();
+        if ((next==tail.load(memory_order_acquire)) ||
+            (bytes.load(memory_order_relaxed)+sz>maxBytes))
+        {
+            dropped.fetch_add(1,memory_order_relaxed);
+            delete item;
+            return false;
+        }
+
+        bytes.fetch_add(sz,memory_order_relaxed);
+        slots[h]=item;
+        head.store(next,memory_order_release);
+        return true;
+    }
+
+    // consumer side: the caller takes the ownership of the item
+    DumpBinaryRecord *pop()
+    {
+        size_t t=tail.load(memory_order_relaxed);
+        if (t==head.load(memory_order_acquire))
+            return nullptr;
+
+        DumpBinaryRecord *item=slots[t];
+        tail.store((t+1)%slots.size(),memory_order_release);
+        bytes.fetch_sub(item->payload.size(),memory_order_relaxed);
+        return item;
+    }
+
+    // number of items dropped since the last call
+    uint64_t takeDropped()
+    {
+        return dropped.exchange(0,memory_order_relaxed);
+    }
+};
+
+
 /**************************************************************************/
 template <class T>
 class DumpPort : public BufferedPort<T>
 {
 public:
     DumpPort(DumpQueue &Q, unsigned int _dwnsample=1,
-             bool _rxTime=true, bool _txTime=false) : buf(Q)
+             bool _rxTime=true, bool _txTime=false) : buf(&Q), ring(nullptr)
+    {
+        rxTime=_rxTime;
+        txTime=_txTime;
+        dwnsample=_dwnsample>0?_dwnsample:1;
+        cnt=0;
+
+        firstIncomingData=true;
+    }
+
+    DumpPort(DumpRing &R, unsigned int _dwnsample=1,
+             bool _rxTime=true, bool _txTime=false) : buf(nullptr), ring(&R)
     {
         rxTime=_rxTime;
         txTime=_txTime;
@@ -264,7 +359,8 @@ public:
     }
 
 private:
-    DumpQueue &buf;
+    DumpQueue *buf;
+    DumpRing  *ring;
     unsigned int dwnsample;
     unsigned int cnt;
     bool firstIncomingData;
@@ -282,24 +378,37 @@ private:
                 firstIncomingData=false;
             }
 
-            DumpItem item;
             Stamp info;
+            DumpTimeStamp timeStamp;
 
             BufferedPort<T>::getEnvelope(info);
-            item.seqNumber=info.getCount();
 
             if (txTime || (info.isValid() && !rxTime))
-                item.timeStamp.setTxStamp(info.getTime());
+                timeStamp.setTxStamp(info.getTime());
 
             if (rxTime || !info.isValid())
-                item.timeStamp.setRxStamp(Time::now());
-
-            item.obj=factory(obj);
-            item.obj->attachFormat(dump_format);
+                timeStamp.setRxStamp(Time::now());
 
-            buf.lock();
-            buf.push_back(item);
-            buf.unlock();
+            if (ring!=nullptr)
+            {
+                auto* record=new DumpBinaryRecord;
+                record->seqNumber=info.getCount();
+                timeStamp.toRecord(*record);
+                dumpBinarySerialize(obj,record->payload);
+                ring->push(record);
+            }
+            else
+            {
+                DumpItem item;
+                item.seqNumber=info.getCount();
+                item.timeStamp=timeStamp;
+                item.obj=factory(obj);
+                item.obj->attachFormat(dump_format);
+
+                buf->lock();
+                buf->push_back(item);
+                buf->unlock();
+            }
 
             cnt=0;
         }
@@ -307,8 +416,18 @@ private:
 };
 
 
+// Interface of the threads which log the connections to the port
 /**************************************************************************/
-class DumpThread : public PeriodicThread
+class DumpSourceLogger
+{
+public:
+    virtual ~DumpSourceLogger() = default;
+    virtual void writeSource(const string &sourceName, const bool connected) = 0;
+};
+
+
+/**************************************************************************/
+class DumpThread : public PeriodicThread, public DumpSourceLogger
 {
 private:
     DumpQueue      &buf;
@@ -387,7 +506,7 @@ public:
     #endif
     }
 
-    void writeSource(const string &sourceName, const bool connected)
+    void writeSource(const string &sourceName, const bool connected) override
     {
         finfo << "[" << fixed << Time::now() << "] ";
         finfo << sourceName << " ";
@@ -548,15 +667,154 @@ public:
 };
 
 
+// Writer of the binary recording mode
+// The items are grouped in chunks appended to data.bin; the layout of the
+// file is described in DumpBinaryFile.h.
+/**************************************************************************/
+class DumpBinaryThread : public Thread, public DumpSourceLogger
+{
+private:
+    static constexpr size_t   chunkSize{1<<20};
+    static constexpr double   chunkPeriod{1.0};
+
+    DumpRing          &ring;
+    DumpType           type;
+    string             sourceName;
+    ofstream           finfo;
+    DumpBinaryWriter   writer;
+    string             infoFile;
+    string             dataFile;
+    bool               rxTime;
+    bool               txTime;
+    double             chunkTime{0.0};
+
+    void writeChunk()
+    {
+        uint64_t dropped=ring.takeDropped();
+        uint32_t items=writer.getChunkItems();
+        if ((items==0) && (dropped==0))
+            return;
+
+        if (!writer.writeChunk(dropped))
+            yError() << "unable to write to file: " << dataFile;
+
+        if (dropped>0)
+            yWarning() << dropped << " items dropped: the queue is full";
+
+        yInfo() << items << " items stored [cumul #: " << writer.getItems() << "]";
+    }
+
+    // move the available items into the current chunk
+    bool drain()
+    {
+        bool ret=false;
+        while (DumpBinaryRecord *item=ring.pop())
+        {
+            if (writer.getChunkItems()==0)
+                chunkTime=SystemClock::nowSystem();
+            writer.append(*item);
+            delete item;
+            ret=true;
+
+            if (writer.getChunkSize()>=chunkSize)
+                writeChunk();
+        }
+
+        if ((writer.getChunkItems()>0) && (SystemClock::nowSystem()-chunkTime>=chunkPeriod))
+            writeChunk();
+
+        return ret;
+    }
+
+public:
+    DumpBinaryThread(DumpType _type, DumpRing &R, const string &dirName,
+                     const string &_sourceName, const bool _rxTime, const bool _txTime) :
+        ring(R),
+        type(_type),
+        sourceName(_sourceName),
+        rxTime(_rxTime),
+        txTime(_txTime)
+    {
+        infoFile=dirName;
+        infoFile+="/info.log";
+
+        dataFile=dirName;
+        dataFile+="/data.bin";
+    }
+
+    void writeSource(const string &sourceName, const bool connected) override
+    {
+        finfo << "[" << fixed << Time::now() << "] ";
+        finfo << sourceName << " ";
+        finfo << (connected?"[connected]":"[disconnected]") << endl;
+    }
+
+    bool threadInit() override
+    {
+        finfo.open(infoFile.c_str());
+        if (!finfo.is_open())
+        {
+            yError() << "unable to open file: " << infoFile;
+            return false;
+        }
+
+        finfo<<"Type: "<<((type==DumpType::bottle)?"Bottle;":"Image;")<<" Format: binary;"<<endl;
+
+        finfo<<"Stamp: ";
+        if (txTime && rxTime)
+            finfo<<"tx+rx;";
+        else if (txTime)
+            finfo<<"tx;";
+        else
+            finfo<<"rx;";
+        finfo<<endl;
+
+        DumpBinaryStream stream;
+        stream.type=(type==DumpType::bottle)?dump_binary_bottle:dump_binary_image;
+        stream.name=sourceName;
+        if (!writer.open(dataFile,stream))
+        {
+            yError() << "unable to open file: " << dataFile;
+            return false;
+        }
+
+        return true;
+    }
+
+    void run() override
+    {
+        while (!isStopping())
+        {
+            if (!drain())
+                SystemClock::delaySystem(0.005);
+        }
+
+        // flush what is left and close the container
+        drain();
+        writeChunk();
+        if (!writer.close())
+            yError() << "unable to write to file: " << dataFile;
+    }
+
+    void threadRelease() override
+    {
+        finfo << "Stored: " << writer.getItems() << " items; Dropped: " << writer.getDropped() << " items;" << endl;
+
+        finfo.close();
+        writer.close();
+    }
+};
+
+
 /**************************************************************************/
 class DumpReporter : public PortReport
 {
 private:
-    DumpThread *thread{nullptr};
+    DumpSourceLogger *thread{nullptr};
 
 public:
     DumpReporter() = default;
-    void setThread(DumpThread *thread) { this->thread=thread; }
+    void setThread(DumpSourceLogger *thread) { this->thread=thread; }
     void report(const PortInfo &info) override
     {
         if ((thread!=nullptr) && info.incoming)
@@ -570,9 +828,11 @@ class DumpModule: public RFModule
 {
 private:
     DumpQueue        *q{nullptr};
+    DumpRing         *r{nullptr};
     DumpPort<Bottle> *p_bottle{nullptr};
     DumpPort<Image>  *p_image{nullptr};
     DumpThread       *t{nullptr};
+    DumpBinaryThread *bt{nullptr};
     DumpReporter      reporter;
     Port              rpcPort;
     DumpType          type{DumpType::bottle};
@@ -650,6 +910,24 @@ public:
         dwnsample=rf.check("downsample",Value(1)).asInt32();
         rxTime=rf.check("rxTime");
         txTime=rf.check("txTime");
+
+        bool binary=rf.check("binary");
+        if (binary)
+        {
+            if (videoOn)
+            {
+                yError() << "Error: video cannot be produced in binary mode";
+                return false;
+            }
+            if (dump_format!=DumpFormat::plain)
+                yWarning() << "images are stored raw in binary mode";
+        }
+        int maxQueue=rf.check("maxQueue",Value(256)).asInt32();
+        if (binary && ((maxQueue<=0) || (maxQueue>maxQueueLimit)))
+        {
+            yError() << "Error: maxQueue must be in [1," << maxQueueLimit << "] MB";
+            return false;
+        }
         string templateDirName=rf.check("dir")?rf.find("dir").asString():portName;
         polish_filename(templateDirName);
         if (templateDirName[0]!='/')
@@ -677,22 +955,41 @@ public:
         }
         yarp::os::mkdir_p(dirName.c_str());
 
-        q=new DumpQueue();
-        t=new DumpThread(type,*q,dirName,100,saveData,videoOn,videoType,rxTime,txTime);
-
-        if (!t->start())
+        if (binary)
         {
-            delete t;
-            delete q;
+            r=new DumpRing(1<<16,static_cast<size_t>(maxQueue)<<20);
+            bt=new DumpBinaryThread(type,*r,dirName,portName,rxTime,txTime);
 
-            return false;
+            if (!bt->start())
+            {
+                delete bt;
+                delete r;
+
+                return false;
+            }
+
+            reporter.setThread(bt);
         }
+        else
+        {
+            q=new DumpQueue();
+            t=new DumpThread(type,*q,dirName,100,saveData,videoOn,videoType,rxTime,txTime);
 
-        reporter.setThread(t);
+            if (!t->start())
+            {
+                delete t;
+                delete q;
+
+                return false;
+            }
+
+            reporter.setThread(t);
+        }
 
         if (type==DumpType::bottle)
         {
-            p_bottle=new DumpPort<Bottle>(*q,dwnsample,rxTime,txTime);
+            p_bottle=binary?new DumpPort<Bottle>(*r,dwnsample,rxTime,txTime):
+                            new DumpPort<Bottle>(*q,dwnsample,rxTime,txTime);
             p_bottle->useCallback();
             p_bottle->open(portName);
             p_bottle->setStrict();
@@ -700,7 +997,8 @@ public:
         }
         else
         {
-            p_image=new DumpPort<Image>(*q,dwnsample,rxTime,txTime);
+            p_image=binary?new DumpPort<Image>(*r,dwnsample,rxTime,txTime):
+                           new DumpPort<Image>(*q,dwnsample,rxTime,txTime);
             p_image->useCallback();
             p_image->open(portName);
             p_image->setStrict();
@@ -735,7 +1033,8 @@ public:
 
     bool close() override
     {
-        t->stop();
+        if (t!=nullptr)
+            t->stop();
 
         if (type==DumpType::bottle)
         {
@@ -753,8 +1052,15 @@ public:
         rpcPort.interrupt();
         rpcPort.close();
 
+        // the binary writer is stopped once the port is closed, so that
+        // all the items received are stored
+        if (bt!=nullptr)
+            bt->stop();
+
         delete t;
         delete q;
+        delete bt;
+        delete r;
 
         return true;
     }
@@ -789,6 +1095,8 @@ int main(int argc, char *argv[])
         yInfo() << "\t--downsample    n: downsample rate (default: 1 => downsample disabled)";
         yInfo() << "\t--rxTime         : dump the receiver time instead of the sender time";
         yInfo() << "\t--txTime         : dump the sender time straightaway";
+        yInfo() << "\t--binary         : record to the binary chunked container data.bin";
+        yInfo() << "\t--maxQueue     MB: memory available to the queue in binary mode (default: 256, max: 16384)";
         yInfo();
 
         return 0;
@@ -31,6 +31,7 @@
 #include <yarp/os/Network.h>
 #include <yarp/os/RpcClient.h>
 #include "include/worker.h"
+#include <DumpBinaryFile.h>
 
 class WorkerClass;
 class MasterThread;
@@ -47,14 +48,21 @@ struct partsData
     std::string             type;                               //string containing the type of the data
     int                     currFrame;                          //integer containing the current frame
     int                     maxFrame;                           //integer containing the maxFrame
-    yarp::os::Bottle        bot;                                //yarp Bottle containing all the data
+    std::ifstream           logStream;                          //stream of the logFile, entries are decoded on demand
+    std::vector<std::streamoff> offset;                         //offsets of all the entries in the logFile
+    bool                    binary;                             //true if the logFile is the binary container of yarpdatadumper
+    DumpBinaryReader        binaryReader;                       //reader of the binary logFile
+    std::vector<int>        chunkStart;                         //index of the first entry of each chunk of the binary logFile
+    std::vector<yarp::os::Bottle> window;                       //entries decoded ahead of the current one
+    int                     windowStart;                        //index of the first entry in the window
+    bool                    stringData;                         //true if the entries contain strings
     yarp::sig::Vector       timestamp;                          //yarp Vector containing all the timestamps
     yarp::os::Contactable*  outputPort;                         //yarp port for sending out data
     std::string             portName;                           //the name of the port
     int                     sent;                               //integer used for step from command
     bool                    hasNotified;                        //boolean used for individual part notification that it has reached eof
 
-    partsData() { outputPort = nullptr; worker = nullptr;}
+    partsData() { outputPort = nullptr; worker = nullptr; windowStart = 0; stringData = false; binary = false;}
 };
 
 struct RowInfo {
@@ -120,6 +128,14 @@ public:
     */
     bool setupDataFromParts(partsData &part);
     /**
+    * function that loads the data of a part recorded by yarpdatadumper --binary
+    */
+    bool setupBinaryData(partsData &part);
+    /**
+    * function that returns an entry of a part, reading it and the following ones from the logFile if needed
+    */
+    yarp::os::Bottle getFrame(partsData &part, int frame);
+    /**
     * function that configures and opens all the ports required
     */
     bool configurePorts(partsData &part);
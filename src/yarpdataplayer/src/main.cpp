@@ -25,6 +25,7 @@
     #pragma warning (disable : 4520)
 #endif
 
+#include <cstring>
 #include <iostream>
 #include <yarp/os/ResourceFinder.h>
 #include <yarp/os/Network.h>
@@ -51,6 +52,14 @@ int main(int argc, char *argv[])
     qputenv("QT_DEVICE_PIXEL_RATIO", QByteArray("auto"));
 #endif
     setEnergySavingModeState(false);
+
+    // without GUI there is no need for a display, e.g. for replaying in CI
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--hidden") == 0 && !qEnvironmentVariableIsSet("QT_QPA_PLATFORM")) {
+            qputenv("QT_QPA_PLATFORM", QByteArray("offscreen"));
+        }
+    }
+
     QApplication a(argc, argv);
 
     Network yarp;
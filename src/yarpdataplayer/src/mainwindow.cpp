@@ -999,7 +999,7 @@ void MainWindow::onUpdateGuiRateThread()
         //TODO SIGNAL
 
         if (getPartActivation(utilities->partDetails[i].name.c_str()) ){
-            if ( utilities->partDetails[i].bot.get(1).asList()->get(2).isString() && utilities->partDetails[i].type == "Bottle"){
+            if ( utilities->partDetails[i].stringData && utilities->partDetails[i].type == "Bottle"){
                 //avoid checking frame rate for string data
                 setFrameRate(utilities->partDetails[i].name.c_str(), 0);
             } else {
@@ -39,6 +39,8 @@
 #include <cstdio>              /* defines FILENAME_MAX */
 #include "include/utils.h"
 
+#include <algorithm>
+#include <cstdlib>
 #include <iostream>
 #include <utility>
 #include "include/mainwindow.h"
@@ -56,6 +58,60 @@ using namespace yarp::os;
 using namespace yarp::sig;
 using namespace std;
 
+namespace {
+// number of entries decoded at once when playing a part
+constexpr int readAhead = 64;
+
+// parse a column of a line of the logFile without decoding the whole entry
+double parseColumn(const string &line, int column)
+{
+    const char *p = line.c_str();
+    for (int i = 0; i < column; i++){
+        while (*p == ' ' || *p == '\t') { p++; }
+        while (*p != '\0' && *p != ' ' && *p != '\t') { p++; }
+    }
+    return strtod(p, nullptr);
+}
+
+// a column of a record of the binary logFile, laid out as a line of data.log
+double binaryColumn(const DumpBinaryRecord &record, int column)
+{
+    vector<double> stamps;
+    if (record.flags & dump_binary_tx_stamp){
+        stamps.push_back(record.txStamp);
+    }
+    if (record.flags & dump_binary_rx_stamp){
+        stamps.push_back(record.rxStamp);
+    }
+    if (column < 1 || column > (int)stamps.size()){
+        return 0.0;
+    }
+    return stamps[column - 1];
+}
+
+// the entry of a record of the binary logFile, laid out as a line of
+// data.log: the images are kept in a blob instead of being read from a file
+Bottle binaryEntry(const DumpBinaryRecord &record, bool image)
+{
+    Bottle entry;
+    entry.addInt32(record.seqNumber);
+    if (record.flags & dump_binary_tx_stamp){
+        entry.addFloat64(record.txStamp);
+    }
+    if (record.flags & dump_binary_rx_stamp){
+        entry.addFloat64(record.rxStamp);
+    }
+    if (image){
+        entry.add(Value(const_cast<char*>(record.payload.data()), (int)record.payload.size()));
+    } else {
+        Bottle data;
+        dumpBinaryDeserialize(record.payload, data);
+        entry.append(data);
+    }
+    return entry;
+}
+} // namespace
+
 /**********************************************************/
 Utilities::~Utilities()
 {
@@ -170,9 +226,22 @@ int Utilities::getRecSubDirList(const string& dir, vector<RowInfo>& rowInfoVec,
             const char * filename = fullName.c_str();
             if(stat(filename,&st) == 0) {
                 string dataFileName = string(dir + "/" + direntp->d_name + "/data.log");
+                string binaryFileName = string(dir + "/" + direntp->d_name + "/data.bin");
+
+                // the parts recorded by yarpdatadumper --binary have data.bin instead of data.log
+                bool binary = (stat(dataFileName.c_str(), &st) != 0) && (stat(binaryFileName.c_str(), &st) == 0);
+                if (binary){
+                    dataFileName = binaryFileName;
+                }
 
                 bool checkLog = checkLogValidity( filename );
-                bool checkData = checkLogValidity( dataFileName.c_str() );
+                bool checkData = false;
+                if (binary){
+                    DumpBinaryReader reader;
+                    checkData = reader.open( dataFileName );
+                } else {
+                    checkData = checkLogValidity( dataFileName.c_str() );
+                }
                 //check log file validity before proceeding
                 if ( checkLog && checkData && (stat(dataFileName.c_str(), &st) == 0)) {
                     LOG(" %s IS present adding it to the gui\n",filename);
@@ -185,7 +254,7 @@ int Utilities::getRecSubDirList(const string& dir, vector<RowInfo>& rowInfoVec,
                     }
 
                     row.info  = dir + "/" + direntp->d_name + "/info.log";
-                    row.log   = dir + "/" + direntp->d_name + "/data.log";
+                    row.log   = dataFileName;
                     row.path = dir + "/" + direntp->d_name + "/"; //pass full path
                     rowInfoVec.emplace_back(row);
                     dir_count++;
@@ -288,28 +357,37 @@ bool Utilities::setupDataFromParts(partsData &part)
     }
 
     // data part
+    // only the offsets and the timestamps of the entries are stored, the
+    // entries themselves are decoded while playing
     LOG("opening file %s\n", part.logFile.c_str() );
-    str.open (part.logFile.c_str(), ios_base::in);//, ios::binary);
+    if (part.logFile.size() > 4 && part.logFile.compare(part.logFile.size() - 4, 4, ".bin") == 0){
+        return setupBinaryData(part);
+    }
+    part.logStream.open (part.logFile.c_str(), ios_base::in | ios_base::binary);
 
-    //read throughout
-    if (str.is_open()){
+    //index throughout
+    if (part.logStream.is_open()){
         string line;
-        int itr = 0;
-        while( getline( str, line ) ){
-            Bottle b( line );
-            part.bot.addList() = b;
-            int timeStampCol = 1;
-            if (withExtraColumn){
-                timeStampCol = column;
-            }
+        streamoff offset = 0;
+        int timeStampCol = 1;
+        if (withExtraColumn){
+            timeStampCol = column;
+        }
 
-            part.timestamp.push_back( b.get(timeStampCol).asFloat64() );
-            itr++;
+        while( getline( part.logStream, line ) ){
+            part.offset.push_back( offset );
+            part.timestamp.push_back( parseColumn( line, timeStampCol ) );
+            offset += line.size() + 1;
+        }
+        if (part.offset.empty()){
+            return false;
         }
+        part.window.clear();
+        part.windowStart = 0;
         allTimeStamps.push_back( part.timestamp[0] );   //save all first timeStamps dumped for later ease of use
-        part.maxFrame= itr-1;                           //set max frame to the total iteration minus first line type;
+        part.maxFrame= (int)part.offset.size()-1;       //set max frame to the total iteration minus first line type;
         part.currFrame = 0;                             //initialize current frame to 0
-        str.close();                                    //close the file
+        part.stringData = getFrame(part, 1).get(2).isString();
     } else {
         return false;
     }
@@ -317,6 +395,90 @@ bool Utilities::setupDataFromParts(partsData &part)
     return true;
 }
 /**********************************************************/
+bool Utilities::setupBinaryData(partsData &part)
+{
+    // the offset of an entry is the chunk containing it
+    part.binary = true;
+    if (!part.binaryReader.open( part.logFile )){
+        return false;
+    }
+    if (!part.binaryReader.isComplete()){
+        LOG("%s has no trailer, the recording was interrupted\n", part.logFile.c_str());
+    }
+
+    int timeStampCol = 1;
+    if (withExtraColumn){
+        timeStampCol = column;
+    }
+
+    vector<DumpBinaryRecord> records;
+    for (size_t i = 0; i < part.binaryReader.getChunks().size(); i++){
+        if (!part.binaryReader.readChunk( i, records )){
+            LOG_ERROR("Cannot read chunk %d of %s\n", (int)i, part.logFile.c_str());
+            break;
+        }
+        part.chunkStart.push_back( (int)part.offset.size() );
+        for (const auto &record : records){
+            part.offset.push_back( (streamoff)i );
+            part.timestamp.push_back( binaryColumn( record, timeStampCol ) );
+        }
+    }
+    if (part.offset.empty()){
+        return false;
+    }
+    part.window.clear();
+    part.windowStart = 0;
+    allTimeStamps.push_back( part.timestamp[0] );   //save all first timeStamps dumped for later ease of use
+    part.maxFrame= (int)part.offset.size()-1;       //set max frame to the total iteration minus first line type;
+    part.currFrame = 0;                             //initialize current frame to 0
+    part.stringData = getFrame(part, 1).get(2).isString();
+
+    return true;
+}
+/**********************************************************/
+Bottle Utilities::getFrame(partsData &part, int frame)
+{
+    lock_guard<mutex> lock(part.mutex);
+
+    if (frame < 0 || frame >= (int)part.offset.size()){
+        return Bottle();
+    }
+
+    if (frame < part.windowStart || frame >= part.windowStart + (int)part.window.size()){
+        part.window.clear();
+        part.windowStart = frame;
+        if (part.binary){
+            // the window is the chunk containing the entry
+            size_t chunk = (size_t)part.offset[frame];
+            vector<DumpBinaryRecord> records;
+            if (part.binaryReader.readChunk( chunk, records )){
+                part.windowStart = part.chunkStart[chunk];
+                for (const auto &record : records){
+                    part.window.emplace_back( binaryEntry( record, part.type == "Image" ) );
+                }
+            }
+        } else {
+            part.logStream.clear();
+            part.logStream.seekg( part.offset[frame] );
+
+            string line;
+            int last = std::min( frame + readAhead, (int)part.offset.size() );
+            for (int i = frame; i < last && getline( part.logStream, line ); i++){
+                part.window.emplace_back( line );
+            }
+        }
+        if (frame >= part.windowStart + (int)part.window.size()){
+            part.window.clear();
+        }
+        if (part.window.empty()){
+            LOG_ERROR("Cannot read entry %d of %s\n", frame, part.logFile.c_str());
+            return Bottle();
+        }
+    }
+
+    return part.window[frame - part.windowStart];
+}
+/**********************************************************/
 void Utilities::getMaxTimeStamp()
 {
     maxTimeStamp = 0.0;
@@ -349,9 +511,10 @@ void Utilities::getMinTimeStamp()
 /**********************************************************/
 int Utilities::amendPartFrames(partsData &part)
 {
-    while (part.timestamp[part.currFrame] < maxTimeStamp){
-        part.currFrame++;
-    }
+    const double *begin = part.timestamp.data();
+    const double *end = begin + part.timestamp.size();
+    const double *first = std::lower_bound(begin + part.currFrame, end, maxTimeStamp);
+    part.currFrame = std::min( (int)(first - begin), part.maxFrame );
     LOG("the first frame of part %s is %d\n",part.name.c_str(), part.currFrame);
     return part.currFrame;
 }
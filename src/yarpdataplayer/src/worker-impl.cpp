@@ -34,11 +34,12 @@ template <class T>
 int WorkerClass::sendGenericData(int part, int id)
 {
     yarp::os::Bottle tmp;
+    yarp::os::Bottle entry = utilities->getFrame(utilities->partDetails[part], id);
     if (utilities->withExtraColumn) {
-        tmp = utilities->partDetails[part].bot.get(id).asList()->tail().tail().tail();
+        tmp = entry.tail().tail().tail();
     }
     else {
-        tmp = utilities->partDetails[part].bot.get(id).asList()->tail().tail();
+        tmp = entry.tail().tail();
     }
 
     yarp::os::BufferedPort<T>* the_port = dynamic_cast<yarp::os::BufferedPort<T>*> (utilities->partDetails[part].outputPort);
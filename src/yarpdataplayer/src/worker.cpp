@@ -174,11 +174,12 @@ double WorkerClass::getTimeTaken()
 int WorkerClass::sendBottle(int part, int frame)
 {
     Bottle tmp;
+    Bottle entry = utilities->getFrame(utilities->partDetails[part], frame);
     if (utilities->withExtraColumn) {
-        tmp = utilities->partDetails[part].bot.get(frame).asList()->tail().tail().tail();
+        tmp = entry.tail().tail().tail();
     }
     else {
-        tmp = utilities->partDetails[part].bot.get(frame).asList()->tail().tail();
+        tmp = entry.tail().tail();
     }
 
     yarp::os::BufferedPort<Bottle>* the_port = dynamic_cast<yarp::os::BufferedPort<yarp::os::Bottle>*> (utilities->partDetails[part].outputPort);
@@ -207,85 +208,97 @@ int WorkerClass::sendImages(int part, int frame)
     string tmpPath = utilities->partDetails[part].path;
     string tmpName, tmp;
     bool fileValid = false;
-    if (utilities->withExtraColumn) {
-        tmpName = utilities->partDetails[part].bot.get(frame).asList()->tail().tail().get(1).asString();
-        tmp = utilities->partDetails[part].bot.get(frame).asList()->tail().tail().tail().tail().toString();
+    Bottle entry = utilities->getFrame(utilities->partDetails[part], frame);
+    unique_ptr<Image> img_yarp = nullptr;
+
+    if (utilities->partDetails[part].binary) {
+        // the image is stored in the entry of the binary logFile
+        auto* img = new FlexImage;
+        img_yarp = unique_ptr<Image>(img);
+        const Value& blob = entry.get(entry.size() - 1);
+        fileValid = blob.isBlob() &&
+                    dumpBinaryDeserialize(string(blob.asBlob(), blob.asBlobLength()), *img);
+        tmpPath = utilities->partDetails[part].logFile;
     } else {
-        tmpName = utilities->partDetails[part].bot.get(frame).asList()->tail().tail().get(0).asString();
-        tmp = utilities->partDetails[part].bot.get(frame).asList()->tail().tail().tail().toString();
-    }
+        if (utilities->withExtraColumn) {
+            tmpName = entry.tail().tail().get(1).asString();
+            tmp = entry.tail().tail().tail().tail().toString();
+        } else {
+            tmpName = entry.tail().tail().get(0).asString();
+            tmp = entry.tail().tail().tail().toString();
+        }
 
-    int code = 0;
-    if (tmp.size()>0) {
-        tmp.erase(tmp.begin());
-        tmp.erase(tmp.end()-1);
-        code = Vocab::encode(tmp);
-    }
+        int code = 0;
+        if (tmp.size()>0) {
+            tmp.erase(tmp.begin());
+            tmp.erase(tmp.end()-1);
+            code = Vocab::encode(tmp);
+        }
 
-    tmpPath = tmpPath + tmpName;
-    unique_ptr<Image> img_yarp = nullptr;
+        tmpPath = tmpPath + tmpName;
 
 #ifdef HAS_OPENCV
-    cv::Mat cv_img;
-    if (code==VOCAB_PIXEL_MONO_FLOAT) {
-        img_yarp = unique_ptr<Image>(new ImageOf<PixelFloat>);
-        fileValid = read(*static_cast<ImageOf<PixelFloat>*>(img_yarp.get()),tmpPath);
-    }
-    else {
+        cv::Mat cv_img;
+        if (code==VOCAB_PIXEL_MONO_FLOAT) {
+            img_yarp = unique_ptr<Image>(new ImageOf<PixelFloat>);
+            fileValid = read(*static_cast<ImageOf<PixelFloat>*>(img_yarp.get()),tmpPath);
+        }
+        else {
 #if CV_MAJOR_VERSION >= 3
-        cv_img = cv::imread(tmpPath, cv::ImreadModes::IMREAD_UNCHANGED);
+            cv_img = cv::imread(tmpPath, cv::ImreadModes::IMREAD_UNCHANGED);
 #else
-        cv_img = cv::imread(tmpPath, CV_LOAD_IMAGE_UNCHANGED);
+            cv_img = cv::imread(tmpPath, CV_LOAD_IMAGE_UNCHANGED);
 #endif
-        if ( cv_img.data != nullptr ) {
-            if (code==VOCAB_PIXEL_RGB)
-            {
-                img_yarp = unique_ptr<Image>(new ImageOf<PixelRgb>);
-                *img_yarp = yarp::cv::fromCvMat<PixelRgb>(cv_img);
-            }
-            else if (code==VOCAB_PIXEL_BGR)
-            {
-                img_yarp = unique_ptr<Image>(new ImageOf<PixelBgr>);
-                *img_yarp = yarp::cv::fromCvMat<PixelBgr>(cv_img);
-            }
-            else if (code==VOCAB_PIXEL_RGBA)
-            {
-                img_yarp = unique_ptr<Image>(new ImageOf<PixelRgba>);
-                *img_yarp = yarp::cv::fromCvMat<PixelRgba>(cv_img);
-            }
-            else if (code==VOCAB_PIXEL_MONO){
-                img_yarp = unique_ptr<Image>(new ImageOf<PixelMono>);
-                *img_yarp = yarp::cv::fromCvMat<PixelMono>(cv_img);
-            }
-            else
-            {
-                img_yarp = unique_ptr<Image>(new ImageOf<PixelRgb>);
-                *img_yarp = yarp::cv::fromCvMat<PixelRgb>(cv_img);
+            if ( cv_img.data != nullptr ) {
+                if (code==VOCAB_PIXEL_RGB)
+                {
+                    img_yarp = unique_ptr<Image>(new ImageOf<PixelRgb>);
+                    *img_yarp = yarp::cv::fromCvMat<PixelRgb>(cv_img);
+                }
+                else if (code==VOCAB_PIXEL_BGR)
+                {
+                    img_yarp = unique_ptr<Image>(new ImageOf<PixelBgr>);
+                    *img_yarp = yarp::cv::fromCvMat<PixelBgr>(cv_img);
+                }
+                else if (code==VOCAB_PIXEL_RGBA)
+                {
+                    img_yarp = unique_ptr<Image>(new ImageOf<PixelRgba>);
+                    *img_yarp = yarp::cv::fromCvMat<PixelRgba>(cv_img);
+                }
+                else if (code==VOCAB_PIXEL_MONO){
+                    img_yarp = unique_ptr<Image>(new ImageOf<PixelMono>);
+                    *img_yarp = yarp::cv::fromCvMat<PixelMono>(cv_img);
+                }
+                else
+                {
+                    img_yarp = unique_ptr<Image>(new ImageOf<PixelRgb>);
+                    *img_yarp = yarp::cv::fromCvMat<PixelRgb>(cv_img);
+                }
+                fileValid = true;
             }
-            fileValid = true;
         }
-    }
 #else
-    if (code==VOCAB_PIXEL_RGB) {
-        img_yarp = unique_ptr<Image>(new ImageOf<PixelRgb>);
-        fileValid = read(*static_cast<ImageOf<PixelRgb>*>(img_yarp.get()),tmpPath.c_str());
-    } else if (code==VOCAB_PIXEL_BGR) {
-        img_yarp = unique_ptr<Image>(new ImageOf<PixelBgr>);
-        fileValid = read(*static_cast<ImageOf<PixelBgr>*>(img_yarp.get()),tmpPath.c_str());
-    } else if (code==VOCAB_PIXEL_RGBA) {
-        img_yarp = unique_ptr<Image>(new ImageOf<PixelRgba>);
-        fileValid = read(*static_cast<ImageOf<PixelRgba>*>(img_yarp.get()),tmpPath.c_str());
-    } else if (code==VOCAB_PIXEL_MONO_FLOAT) {
-        img_yarp = unique_ptr<Image>(new ImageOf<PixelFloat>);
-        fileValid = read(*static_cast<ImageOf<PixelFloat>*>(img_yarp.get()),tmpPath.c_str());
-    } else if (code==VOCAB_PIXEL_MONO) {
-        img_yarp = unique_ptr<Image>(new ImageOf<PixelMono>);
-        fileValid = read(*static_cast<ImageOf<PixelMono>*>(img_yarp.get()),tmpPath.c_str());
-    } else {
-        img_yarp = unique_ptr<Image>(new ImageOf<PixelRgb>);
-        fileValid = read(*static_cast<ImageOf<PixelRgb>*>(img_yarp.get()),tmpPath.c_str());
-    }
+        if (code==VOCAB_PIXEL_RGB) {
+            img_yarp = unique_ptr<Image>(new ImageOf<PixelRgb>);
+            fileValid = read(*static_cast<ImageOf<PixelRgb>*>(img_yarp.get()),tmpPath.c_str());
+        } else if (code==VOCAB_PIXEL_BGR) {
+            img_yarp = unique_ptr<Image>(new ImageOf<PixelBgr>);
+            fileValid = read(*static_cast<ImageOf<PixelBgr>*>(img_yarp.get()),tmpPath.c_str());
+        } else if (code==VOCAB_PIXEL_RGBA) {
+            img_yarp = unique_ptr<Image>(new ImageOf<PixelRgba>);
+            fileValid = read(*static_cast<ImageOf<PixelRgba>*>(img_yarp.get()),tmpPath.c_str());
+        } else if (code==VOCAB_PIXEL_MONO_FLOAT) {
+            img_yarp = unique_ptr<Image>(new ImageOf<PixelFloat>);
+            fileValid = read(*static_cast<ImageOf<PixelFloat>*>(img_yarp.get()),tmpPath.c_str());
+        } else if (code==VOCAB_PIXEL_MONO) {
+            img_yarp = unique_ptr<Image>(new ImageOf<PixelMono>);
+            fileValid = read(*static_cast<ImageOf<PixelMono>*>(img_yarp.get()),tmpPath.c_str());
+        } else {
+            img_yarp = unique_ptr<Image>(new ImageOf<PixelRgb>);
+            fileValid = read(*static_cast<ImageOf<PixelRgb>*>(img_yarp.get()),tmpPath.c_str());
+        }
 #endif
+    }
     if (!fileValid) {
         LOG_ERROR("Cannot load file %s !\n", tmpPath.c_str() );
         return 1;
@@ -0,0 +1,187 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <ShmemRingStream.h>
+
+#include <yarp/os/Bytes.h>
+#include <yarp/os/Time.h>
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <catch.hpp>
+#include <harness.h>
+
+using namespace yarp::os;
+
+namespace {
+
+void writeString(ShmemRingStream& stream, std::string data)
+{
+    Bytes b(&data[0], data.size());
+    stream.write(b);
+}
+
+// Read len bytes, or less if the stream is closed
+std::string readString(ShmemRingStream& stream, size_t len)
+{
+    std::string data(len, '\0');
+    size_t done = 0;
+    while (done < len) {
+        Bytes b(&data[done], len - done);
+        yarp::conf::ssize_t ret = stream.read(b);
+        if (ret <= 0) {
+            break;
+        }
+        done += static_cast<size_t>(ret);
+    }
+    data.resize(done);
+    return data;
+}
+
+std::string pattern(size_t len, size_t seed)
+{
+    std::string data(len, '\0');
+    for (size_t i = 0; i < len; i++) {
+        data[i] = static_cast<char>('a' + (seed + i) % 26);
+    }
+    return data;
+}
+
+} // namespace
+
+TEST_CASE("carriers::ShmemRingStreamTest", "[carriers]")
+{
+    // The receiver creates the segment, the sender attaches to it
+    ShmemRingStream receiver;
+    ShmemRingStream sender;
+    REQUIRE(receiver.create(16));
+    REQUIRE(sender.attach(receiver.getName()));
+    receiver.unlink();
+    CHECK(receiver.isOk());
+    CHECK(sender.isOk());
+
+    SECTION("test the empty and the full ring")
+    {
+        // Reading from the empty ring waits for the data
+        std::atomic<bool> done {false};
+        std::string received;
+        std::thread reader([&]() {
+            received = readString(receiver, 4);
+            done = true;
+        });
+        Time::delay(0.2);
+        CHECK_FALSE(done);
+        writeString(sender, "abcd");
+        reader.join();
+        CHECK(received == "abcd");
+
+        // The ring can be filled completely without waiting
+        writeString(sender, pattern(16, 0));
+
+        // Writing to the full ring waits for the reader
+        done = false;
+        std::thread writer([&]() {
+            writeString(sender, "XYZ");
+            done = true;
+        });
+        Time::delay(0.2);
+        CHECK_FALSE(done);
+        CHECK(readString(receiver, 8) == pattern(8, 0));
+        writer.join();
+        CHECK(done);
+        CHECK(readString(receiver, 8) == pattern(8, 8));
+        CHECK(readString(receiver, 3) == "XYZ");
+    }
+
+    SECTION("test the wraparound")
+    {
+        // The sizes are not divisors of the ring size, therefore the
+        // messages are split at every offset of the ring
+        size_t sizes[] = {7, 11, 13, 16, 1, 5};
+        for (size_t i = 0; i < 60; i++) {
+            size_t len = sizes[i % 6];
+            std::string data = pattern(len, i);
+            writeString(sender, data);
+            CHECK(readString(receiver, len) == data);
+        }
+        CHECK(sender.isOk());
+        CHECK(receiver.isOk());
+    }
+
+    SECTION("test a message larger than the ring and a slow reader")
+    {
+        std::string data = pattern(1000, 3);
+        std::atomic<bool> done {false};
+        std::thread writer([&]() {
+            writeString(sender, data);
+            done = true;
+        });
+
+        std::string received;
+        while (received.size() < data.size()) {
+            received += readString(receiver, std::min<size_t>(10, data.size() - received.size()));
+            if (received.size() < 900) {
+                // The writer cannot be ahead of the reader by more than
+                // the size of the ring
+                CHECK_FALSE(done);
+            }
+            Time::delay(0.001);
+        }
+        writer.join();
+        CHECK(done);
+        CHECK(received == data);
+    }
+
+    SECTION("test closing the sender")
+    {
+        // The data written before closing is still delivered
+        writeString(sender, "last");
+        sender.close();
+        CHECK_FALSE(sender.isOk());
+        CHECK_FALSE(receiver.isOk());
+        CHECK(readString(receiver, 4) == "last");
+        char c;
+        Bytes b(&c, 1);
+        CHECK(receiver.read(b) == -1);
+    }
+
+    SECTION("test interrupting a blocked reader")
+    {
+        yarp::conf::ssize_t ret = 0;
+        std::thread reader([&]() {
+            char c;
+            Bytes b(&c, 1);
+            ret = receiver.read(b);
+        });
+        Time::delay(0.2);
+        receiver.interrupt();
+        reader.join();
+        CHECK(ret == -1);
+        CHECK_FALSE(receiver.isOk());
+        CHECK_FALSE(sender.isOk());
+    }
+
+    SECTION("test closing the receiver while the sender is blocked")
+    {
+        writeString(sender, pattern(16, 0));
+        std::atomic<bool> done {false};
+        std::thread writer([&]() {
+            writeString(sender, "more");
+            done = true;
+        });
+        Time::delay(0.2);
+        CHECK_FALSE(done);
+        receiver.close();
+        writer.join();
+        CHECK(done);
+        CHECK_FALSE(sender.isOk());
+    }
+}
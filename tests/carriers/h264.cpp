@@ -0,0 +1,100 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/os/all.h>
+#include <yarp/os/Network.h>
+#include <yarp/sig/all.h>
+
+#include <cstdlib>
+
+#include <catch.hpp>
+#include <harness.h>
+
+using namespace yarp::os;
+using namespace yarp::sig;
+
+TEST_CASE("carriers::h264", "[carriers]")
+{
+    YARP_REQUIRE_PLUGIN("h264", "carrier");
+
+    Network::setLocalMode(true);
+
+    SECTION("test encoding-decoding between two ports")
+    {
+        std::string inName {"/h264/in"};
+        std::string outName {"/h264/out"};
+
+        BufferedPort<ImageOf<PixelRgb>> in;
+        BufferedPort<ImageOf<PixelRgb>> out;
+
+        REQUIRE(in.open(inName));
+        REQUIRE(out.open(outName));
+        REQUIRE(Network::connect(out.getName(), in.getName(), "h264+bitrate.1000+keyint.10"));
+
+        // The row size is not a multiple of 4 bytes
+        size_t width {322};
+        size_t height {242};
+        ImageOf<PixelRgb>* inImg = nullptr;
+        for (int i = 0; i < 50 && inImg == nullptr; i++) {
+            ImageOf<PixelRgb>& outImg = out.prepare();
+            outImg.resize(width, height);
+            for (size_t y = 0; y < height; y++) {
+                for (size_t x = 0; x < width; x++) {
+                    outImg.pixel(x, y) = PixelRgb(100, 150, 200);
+                }
+            }
+            out.write();
+            yarp::os::Time::delay(0.1);
+            inImg = in.read(false);
+        }
+
+        REQUIRE(inImg != nullptr);
+        CHECK(inImg->width() == width);
+        CHECK(inImg->height() == height);
+        PixelRgb& pix = inImg->pixel(width - 1, height / 2);
+        CHECK(std::abs(pix.r - 100) <= 8);
+        CHECK(std::abs(pix.g - 150) <= 8);
+        CHECK(std::abs(pix.b - 200) <= 8);
+
+        in.interrupt();
+        in.close();
+        out.interrupt();
+        out.close();
+    }
+
+    SECTION("test images with an odd size are not sent")
+    {
+        std::string inName {"/h264/in"};
+        std::string outName {"/h264/out"};
+
+        BufferedPort<ImageOf<PixelRgb>> in;
+        BufferedPort<ImageOf<PixelRgb>> out;
+
+        REQUIRE(in.open(inName));
+        REQUIRE(out.open(outName));
+        REQUIRE(Network::connect(out.getName(), in.getName(), "h264"));
+
+        ImageOf<PixelRgb>* inImg = nullptr;
+        for (int i = 0; i < 10 && inImg == nullptr; i++) {
+            ImageOf<PixelRgb>& outImg = out.prepare();
+            outImg.resize(321, 241);
+            outImg.zero();
+            out.write();
+            yarp::os::Time::delay(0.1);
+            inImg = in.read(false);
+        }
+        CHECK(inImg == nullptr);
+
+        in.interrupt();
+        in.close();
+        out.interrupt();
+        out.close();
+    }
+
+    Network::setLocalMode(false);
+}
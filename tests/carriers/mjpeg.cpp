@@ -10,6 +10,8 @@
 #include <yarp/os/Network.h>
 #include <yarp/sig/all.h>
 
+#include <cstdlib>
+
 #include <catch.hpp>
 #include <harness.h>
 
@@ -53,5 +55,45 @@ TEST_CASE("carriers::mjpeg", "[carriers]")
         out.close();
     }
 
+    SECTION("test compression parameters and scaled decompression")
+    {
+        std::string inName {"/mjpeg/in"};
+        std::string outName {"/mjpeg/out"};
+
+        BufferedPort<ImageOf<PixelRgb>> in;
+        BufferedPort<ImageOf<PixelRgb>> out;
+
+        REQUIRE(in.open(inName));
+        REQUIRE(out.open(outName));
+        REQUIRE(Network::connect(out.getName(), in.getName(), "mjpeg+quality.90+subsampling.444+scale.2"));
+
+        size_t width {320};
+        size_t height {240};
+        ImageOf<PixelRgb>& outImg = out.prepare();
+        outImg.resize(width, height);
+        for (size_t y = 0; y < height; y++) {
+            for (size_t x = 0; x < width; x++) {
+                outImg.pixel(x, y) = PixelRgb(100, 150, 200);
+            }
+        }
+
+        out.write();
+        yarp::os::Time::delay(0.4);
+
+        ImageOf<PixelRgb>* inImg = in.read();
+        REQUIRE(inImg != nullptr);
+        CHECK(inImg->width() == width / 2);
+        CHECK(inImg->height() == height / 2);
+        PixelRgb& pix = inImg->pixel(width / 4, height / 4);
+        CHECK(std::abs(pix.r - 100) <= 2);
+        CHECK(std::abs(pix.g - 150) <= 2);
+        CHECK(std::abs(pix.b - 200) <= 2);
+
+        in.interrupt();
+        in.close();
+        out.interrupt();
+        out.close();
+    }
+
     Network::setLocalMode(false);
 }
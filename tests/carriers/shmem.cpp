@@ -0,0 +1,110 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/os/all.h>
+#include <yarp/os/Network.h>
+#include <yarp/sig/all.h>
+#include <yarp/sig/SharedImagePool.h>
+
+#include <catch.hpp>
+#include <harness.h>
+
+using namespace yarp::os;
+using namespace yarp::sig;
+
+TEST_CASE("carriers::shmem", "[carriers]")
+{
+#if !defined(__linux__)
+    YARP_SKIP_TEST("The shmem ring mode is supported on Linux only")
+#endif
+    YARP_REQUIRE_PLUGIN("shmem", "carrier");
+
+    Network::setLocalMode(true);
+
+    SECTION("test sending messages larger than the ring between two ports")
+    {
+        BufferedPort<ImageOf<PixelRgb>> in;
+        BufferedPort<ImageOf<PixelRgb>> out;
+
+        REQUIRE(in.open("/shmem/in"));
+        REQUIRE(out.open("/shmem/out"));
+        REQUIRE(Network::connect(out.getName(), in.getName(), "shmem+ring.1+size.4096"));
+
+        // Each image is larger than the ring
+        size_t width {64};
+        size_t height {48};
+        for (int i = 0; i < 10; i++) {
+            ImageOf<PixelRgb>& outImg = out.prepare();
+            outImg.resize(width, height);
+            outImg.zero();
+            outImg.pixel(i, height - 1) = PixelRgb(i, 2 * i, 3 * i);
+            out.write(true);
+
+            ImageOf<PixelRgb>* inImg = in.read();
+            REQUIRE(inImg != nullptr);
+            CHECK(inImg->width() == width);
+            CHECK(inImg->height() == height);
+            CHECK(inImg->pixel(i, height - 1).r == i);
+            CHECK(inImg->pixel(i, height - 1).g == 2 * i);
+            CHECK(inImg->pixel(i, height - 1).b == 3 * i);
+            CHECK(inImg->pixel(width - 1, 0).r == 0);
+        }
+
+        out.close();
+        in.close();
+    }
+
+    SECTION("test sending an image without copying it")
+    {
+        size_t width {64};
+        size_t height {48};
+        SharedImagePool pool(width * height * 3, 4);
+        REQUIRE(pool.isValid());
+
+        {
+            BufferedPort<ImageOf<PixelRgb>> in;
+            BufferedPort<ImageOf<PixelRgb>> out;
+
+            REQUIRE(in.open("/shmem/in"));
+            REQUIRE(out.open("/shmem/out"));
+            REQUIRE(Network::connect(out.getName(), in.getName(), "shmem+ring.1+zerocopy.1"));
+
+            ImageOf<PixelRgb>& outImg = out.prepare();
+            REQUIRE(pool.allocate(outImg, width, height));
+            CHECK(pool.getFreeSlots() == 3);
+            outImg.zero();
+            outImg.pixel(width - 1, height / 2) = PixelRgb(100, 150, 200);
+            const unsigned char* sent = outImg.getRawImage();
+            out.write(true);
+
+            ImageOf<PixelRgb>* inImg = in.read();
+            REQUIRE(inImg != nullptr);
+            CHECK(inImg->width() == width);
+            CHECK(inImg->height() == height);
+            // Both ports are in this process, so the receiver maps the slot
+            // at the same address as the sender
+            CHECK(inImg->getRawImage() == sent);
+            PixelRgb& pix = inImg->pixel(width - 1, height / 2);
+            CHECK(pix.r == 100);
+            CHECK(pix.g == 150);
+            CHECK(pix.b == 200);
+            CHECK(inImg->pixel(0, 0).r == 0);
+
+            // The sender still owns the slot, the receiver holds a reference
+            CHECK(pool.getFreeSlots() == 3);
+
+            out.close();
+            in.close();
+        }
+
+        // Both images are gone, the slot is free again
+        CHECK(pool.getFreeSlots() == 4);
+    }
+
+    Network::setLocalMode(false);
+}
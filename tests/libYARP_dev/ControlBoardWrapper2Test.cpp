@@ -9,7 +9,11 @@
 
 #include <yarp/dev/PolyDriver.h>
 
+#include <yarp/os/Bottle.h>
+#include <yarp/os/BufferedPort.h>
 #include <yarp/os/Network.h>
+#include <yarp/os/Stamp.h>
+#include <yarp/os/Time.h>
 #include <yarp/dev/FrameGrabberInterfaces.h>
 #include <yarp/dev/ControlBoardInterfaces.h>
 #include <yarp/dev/IMultipleWrapper.h>
@@ -68,4 +72,170 @@ TEST_CASE("dev::ControlBoardWrapper2", "[yarp::dev]")
         CHECK(dd.close()); // close dd reported successful
         CHECK(dd2.close()); // close dd2 reported successful
     }
+
+    SECTION("test the streaming commands between the remote and the wrapper")
+    {
+        PolyDriver dd;
+        Property p;
+        p.put("device","controlboardwrapper2");
+        p.put("subdevice","test_motor");
+        p.put("name","/motor");
+        p.put("axes",4);
+        REQUIRE(dd.open(p)); // controlboardwrapper open reported successful
+
+        // The protocol is checked, so that the binary commands are used,
+        // and none of the commands is dropped
+        PolyDriver dd2;
+        Property p2;
+        p2.put("device","remote_controlboard");
+        p2.put("remote","/motor");
+        p2.put("local","/motor/client");
+        p2.put("carrier","tcp");
+        p2.put("writeStrict","on");
+        REQUIRE(dd2.open(p2)); // remote_controlboard open reported successful
+
+        IVelocityControl *vel = nullptr;
+        IEncoders *enc = nullptr;
+        REQUIRE(dd2.view(vel)); // interface reported
+        REQUIRE(dd.view(enc)); // interface reported
+
+        // The test_motor integrates the velocities, so the positions
+        // keep the ratios of the references received
+        const double refs[4] = {10.0, -10.0, 20.0, 0.0};
+        CHECK(vel->velocityMove(refs));
+        double encs[4] = {0.0, 0.0, 0.0, 0.0};
+        for (int i = 0; i < 100 && encs[0] < 1.0; i++) {
+            Time::delay(0.02);
+            CHECK(enc->getEncoders(encs));
+        }
+        CHECK(encs[0] >= 1.0);
+        CHECK(encs[1] == Approx(-encs[0]));
+        CHECK(encs[2] == Approx(2 * encs[0]));
+        CHECK(encs[3] == 0.0);
+
+        // A group of joints and a single joint
+        const int joints[2] = {3, 0};
+        const double group_refs[2] = {-5.0, 0.0};
+        CHECK(vel->velocityMove(2, joints, group_refs));
+        CHECK(vel->velocityMove(1, 0.0));
+        CHECK(vel->velocityMove(2, 0.0));
+        for (int i = 0; i < 100 && encs[3] > -1.0; i++) {
+            Time::delay(0.02);
+            CHECK(enc->getEncoders(encs));
+        }
+        CHECK(encs[3] <= -1.0);
+        Time::delay(0.1);
+        double encs2[4];
+        CHECK(enc->getEncoders(encs2));
+        CHECK(encs2[0] == encs[0]);
+        CHECK(encs2[1] == encs[1]);
+        CHECK(encs2[2] == encs[2]);
+        CHECK(encs2[3] < encs[3]);
+
+        CHECK(dd2.close()); // close dd2 reported successful
+        CHECK(dd.close()); // close dd reported successful
+    }
+
+    SECTION("test the controlboard wrapper 2 with batched state")
+    {
+        PolyDriver dd;
+        Property p;
+        p.put("device","controlboardwrapper2");
+        p.put("subdevice","test_motor");
+        p.put("name","/motor");
+        p.put("axes",4);
+        p.put("period",10);
+        p.put("batched_state",true);
+        REQUIRE(dd.open(p)); // controlboardwrapper open reported successful
+
+        PolyDriver dd2;
+        Property p2;
+        p2.put("device","remote_controlboard");
+        p2.put("remote","/motor");
+        p2.put("local","/motor/client");
+        p2.put("carrier","tcp");
+        p2.put("ignoreProtocolCheck","true");
+        REQUIRE(dd2.open(p2)); // remote_controlboard open reported successful
+
+        IEncodersTimed *enc = nullptr;
+        REQUIRE(dd2.view(enc)); // interface reported
+
+        // Wait for the state to be broadcast
+        double encs[4];
+        bool ok = false;
+        for (int i = 0; i < 100 && !ok; i++) {
+            Time::delay(0.02);
+            ok = enc->getEncoders(encs);
+        }
+        CHECK(ok); // state received through the batched snapshots
+
+        // The snapshots follow the subdevice while it is moving
+        IVelocityControl *vel = nullptr;
+        REQUIRE(dd.view(vel)); // interface reported
+        const double refs[4] = {10.0, 20.0, -10.0, 0.0};
+        CHECK(vel->velocityMove(refs));
+        double times[4] = {0.0, 0.0, 0.0, 0.0};
+        double lastTime = 0.0;
+        for (int i = 0; i < 100 && encs[0] < 1.0; i++) {
+            Time::delay(0.02);
+            CHECK(enc->getEncodersTimed(encs, times));
+            CHECK(times[0] >= lastTime);
+            lastTime = times[0];
+        }
+        CHECK(encs[0] >= 1.0);
+        CHECK(encs[1] > encs[0]);
+        CHECK(encs[2] < 0.0);
+        CHECK(encs[3] == 0.0);
+        CHECK(lastTime > 0.0);
+
+        // The diagnostics report the read time of each subdevice, that is
+        // measured only when reading the snapshots
+        BufferedPort<Bottle> diagnostics;
+        REQUIRE(diagnostics.open("/motor/diagnostics:i"));
+        REQUIRE(Network::connect("/motor/diagnostics:o", "/motor/diagnostics:i"));
+        Bottle* b = nullptr;
+        Stamp stamp;
+        double lastStamp = 0.0;
+        int lastCount = -1;
+        for (int k = 0; k < 3; k++) {
+            b = diagnostics.read();
+            REQUIRE(b != nullptr);
+            REQUIRE(diagnostics.getEnvelope(stamp));
+            CHECK(stamp.getTime() >= lastStamp); // the state timestamp
+            CHECK(stamp.getCount() > lastCount);
+            lastStamp = stamp.getTime();
+            lastCount = stamp.getCount();
+        }
+        CHECK(b->find("period").asFloat64() == Approx(0.01));
+        CHECK(b->find("total").isFloat64());
+        CHECK(b->find("read").asFloat64() >= 0.0);
+        CHECK(b->find("read").asFloat64() <= b->find("total").asFloat64());
+        CHECK(b->find("yarp").isFloat64());
+        CHECK(b->find("ros").isFloat64());
+        CHECK(b->find("overruns").isInt64());
+        Bottle& subdevices = b->findGroup("subdevices");
+        REQUIRE(subdevices.size() == 2);
+        Bottle* subdevice = subdevices.get(1).asList();
+        REQUIRE(subdevice != nullptr);
+        CHECK(subdevice->get(0).asString() == "/motor_test_motor");
+        CHECK(subdevice->get(1).asFloat64() >= 0.0);
+        CHECK(subdevice->get(1).asFloat64() <= b->find("read").asFloat64());
+        diagnostics.close();
+
+        CHECK(dd2.close()); // close dd2 reported successful
+        CHECK(dd.close()); // close dd reported successful
+
+        // Without batched_state there are no subdevice read times
+        p.put("batched_state",false);
+        REQUIRE(dd.open(p)); // controlboardwrapper open reported successful
+        REQUIRE(diagnostics.open("/motor/diagnostics:i"));
+        REQUIRE(Network::connect("/motor/diagnostics:o", "/motor/diagnostics:i"));
+        b = diagnostics.read();
+        REQUIRE(b != nullptr);
+        CHECK(b->find("period").asFloat64() == Approx(0.01));
+        CHECK(b->find("read").isFloat64());
+        CHECK_FALSE(b->check("subdevices"));
+        diagnostics.close();
+        CHECK(dd.close()); // close dd reported successful
+    }
 }
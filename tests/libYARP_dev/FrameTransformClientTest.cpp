@@ -17,6 +17,7 @@
 #include <yarp/os/Time.h>
 #include <yarp/math/Math.h>
 
+#include <algorithm>
 #include <cmath>
 #include <vector>
 
@@ -103,6 +104,7 @@ TEST_CASE("dev::FrameTransformClientTest", "[yarp::dev]")
         ros_prop.put("enable_ros_publisher", "0");
         ros_prop.put("enable_ros_subscriber", "0");
         pTransformserver_cfg.put("transforms_lifetime", 0.500);
+        pTransformserver_cfg.put("streaming_format", "delta");
         bool ok_server = ddtransformserver.open(pTransformserver_cfg);
         CHECK(ok_server); // ddtransformserver open reported successful
 
@@ -412,6 +414,86 @@ TEST_CASE("dev::FrameTransformClientTest", "[yarp::dev]")
             CHECK(isEqual(mt1, eyemat, precision));
         }
 
+        //test 14 (frame handles)
+        {
+            itf->clear();
+            IFrameTransform::frame_handle h1 = itf->getFrameHandle("frame1");
+            IFrameTransform::frame_handle h2 = itf->getFrameHandle("frame2");
+            IFrameTransform::frame_handle h3 = itf->getFrameHandle("frame3");
+            CHECK(h1 != IFrameTransform::invalid_frame_handle);
+            CHECK(h2 != IFrameTransform::invalid_frame_handle);
+            CHECK(h3 != IFrameTransform::invalid_frame_handle);
+            CHECK(itf->getFrameHandle("frame1") == h1);
+            CHECK(itf->getFrameHandle("") == IFrameTransform::invalid_frame_handle);
+            CHECK_FALSE(itf->canTransform(h3, h1));
+
+            CHECK(itf->setTransform("frame2", "frame1", m1));
+            CHECK(itf->setTransform("frame3", "frame2", m2));
+            yarp::os::Time::delay(0.050);
+
+            yarp::sig::Matrix mt;
+            CHECK(itf->canTransform(h3, h1));
+
+            // A frame is transformed to itself only if its handle is valid
+            const IFrameTransform::frame_handle invalid = IFrameTransform::invalid_frame_handle;
+            yarp::sig::Matrix eyemat(4, 4); eyemat.eye();
+            CHECK(itf->canTransform(h1, h1));
+            CHECK(itf->getTransform(h1, h1, mt));
+            CHECK(isEqual(mt, eyemat, precision));
+            CHECK_FALSE(itf->canTransform(invalid, invalid));
+            CHECK_FALSE(itf->getTransform(invalid, invalid, mt));
+            CHECK_FALSE(itf->getTransformAtTime(invalid, invalid, yarp::os::Time::now(), mt));
+            CHECK_FALSE(itf->canTransform(h3 + 1000, h3 + 1000));
+            CHECK_FALSE(itf->getTransform(h3 + 1000, h3 + 1000, mt));
+
+            CHECK(itf->getTransform(h3, h1, mt));
+            CHECK(isEqual(mt, m1 * m2, precision));
+            CHECK(itf->getTransform(h1, h3, mt));
+            CHECK(isEqual(mt, SE3inv(m1 * m2), precision));
+
+            yarp::sig::Vector in_point(3), out_point(3), ver_point(4);
+            in_point[0] = 10; in_point[1] = 15; in_point[2] = 5;
+            in_point.push_back(1);
+            ver_point = m1 * m2 * in_point;
+            ver_point.pop_back();
+            in_point.pop_back();
+            CHECK(itf->transformPoint(h3, h1, in_point, out_point));
+            CHECK(isEqual(out_point, ver_point, precision));
+
+            // The cached transform is updated when an edge of the chain changes
+            CHECK(itf->setTransform("frame2", "frame1", m2));
+            yarp::os::Time::delay(0.050);
+            CHECK(itf->getTransform(h3, h1, mt));
+            CHECK(isEqual(mt, m2 * m2, precision));
+        }
+
+        //test 15 (transforms at a given time)
+        {
+            itf->clear();
+            double before = yarp::os::Time::now();
+            yarp::os::Time::delay(0.010);
+            CHECK(itf->setTransform("frame2", "frame1", m1));
+            yarp::os::Time::delay(0.100);
+            CHECK(itf->setTransform("frame2", "frame1", m2));
+            yarp::os::Time::delay(0.050);
+
+            yarp::sig::Matrix mt;
+            CHECK_FALSE(itf->getTransformAtTime("frame2", "frame1", before, mt));
+            CHECK(itf->getTransformAtTime("frame2", "frame1", yarp::os::Time::now(), mt));
+            CHECK(isEqual(mt, m2, precision));
+            CHECK(itf->getTransformAtTime("frame1", "frame2", yarp::os::Time::now(), mt));
+            CHECK(isEqual(mt, SE3inv(m2), precision));
+            CHECK(itf->getTransformAtTime("frame1", "frame1", before, mt));
+
+            // Between the two values, the translation is interpolated
+            CHECK(itf->getTransformAtTime("frame2", "frame1", before + 0.060, mt));
+            for (size_t i = 0; i < 3; i++)
+            {
+                CHECK(mt[i][3] >= std::min(m1[i][3], m2[i][3]) - precision);
+                CHECK(mt[i][3] <= std::max(m1[i][3], m2[i][3]) + precision);
+            }
+        }
+
         // Close devices
         CHECK(ddtransformclient.close()); // ddtransformclient successfully closed
         CHECK(ddtransformserver.close()); // ddtransformserver successfully closed
@@ -0,0 +1,99 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/dev/impl/FrameTransformDelta.h>
+
+#include <yarp/os/Bottle.h>
+#include <yarp/os/Portable.h>
+#include <yarp/math/FrameTransform.h>
+
+#include <catch.hpp>
+#include <harness.h>
+
+using namespace yarp::os;
+using namespace yarp::math;
+using namespace yarp::dev::impl;
+
+TEST_CASE("dev::FrameTransformDeltaTest", "[yarp::dev]")
+{
+    FrameTransform t1;
+    t1.src_frame_id = "base";
+    t1.dst_frame_id = "head";
+    t1.timestamp = 12.5;
+    t1.translation.set(1.0, 2.0, 3.0);
+    t1.rotation = Quaternion(0.0, 0.0, 0.6, 0.8);
+
+    FrameTransform t2 = t1;
+    t2.dst_frame_id = "arm";
+    t2.timestamp = 13.0;
+    t2.translation.set(-1.0, 0.5, 0.25);
+
+    SECTION("Test the records")
+    {
+        FrameTransformDelta delta;
+        CHECK(delta.empty());
+        delta.addDefine(7, t1);
+        delta.addUpdate(8, t2);
+        delta.addRemove(9);
+        CHECK_FALSE(delta.empty());
+
+        // Through a Bottle, as the transformServer sends it
+        Bottle b;
+        b.addVocab(FrameTransformDelta::delta_tag);
+        b.addInt32(1);
+        b.add(Value(const_cast<char*>(delta.data()), static_cast<int>(delta.size())));
+        Bottle b2;
+        REQUIRE(Portable::copyPortable(b, b2));
+        REQUIRE(b2.get(0).asVocab() == FrameTransformDelta::delta_tag);
+        REQUIRE(b2.get(2).isBlob());
+
+        FrameTransformDelta::Reader reader(b2.get(2).asBlob(), b2.get(2).asBlobLength());
+        FrameTransformDelta::Record type;
+        std::uint32_t id;
+        FrameTransform t;
+
+        REQUIRE(reader.next(type, id, t));
+        CHECK(type == FrameTransformDelta::Record::Define);
+        CHECK(id == 7);
+        CHECK(t.src_frame_id == "base");
+        CHECK(t.dst_frame_id == "head");
+        CHECK(t.timestamp == 12.5);
+        CHECK(t.translation.tX == 1.0);
+        CHECK(t.translation.tY == 2.0);
+        CHECK(t.translation.tZ == 3.0);
+        CHECK(t.rotation.w() == 0.8);
+        CHECK(t.rotation.z() == 0.6);
+
+        REQUIRE(reader.next(type, id, t));
+        CHECK(type == FrameTransformDelta::Record::Update);
+        CHECK(id == 8);
+        CHECK(t.dst_frame_id == "head"); // not changed by an update
+        CHECK(t.timestamp == 13.0);
+        CHECK(t.translation.tX == -1.0);
+
+        REQUIRE(reader.next(type, id, t));
+        CHECK(type == FrameTransformDelta::Record::Remove);
+        CHECK(id == 9);
+
+        CHECK_FALSE(reader.next(type, id, t));
+        CHECK_FALSE(reader.isError());
+    }
+
+    SECTION("Test a truncated message")
+    {
+        FrameTransformDelta delta;
+        delta.addDefine(1, t1);
+
+        FrameTransformDelta::Reader reader(delta.data(), delta.size() - 1);
+        FrameTransformDelta::Record type;
+        std::uint32_t id;
+        FrameTransform t;
+        CHECK_FALSE(reader.next(type, id, t));
+        CHECK(reader.isError());
+    }
+}
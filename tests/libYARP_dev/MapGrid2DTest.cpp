@@ -11,6 +11,8 @@
 #include <yarp/dev/Map2DLocation.h>
 #include <yarp/dev/Map2DArea.h>
 #include <yarp/os/Network.h>
+#include <yarp/os/Bottle.h>
+#include <yarp/os/DummyConnector.h>
 #include <yarp/dev/PolyDriver.h>
 
 #include <catch.hpp>
@@ -106,6 +108,163 @@ TEST_CASE("dev::MapGrid2DTest", "[yarp::dev]")
         // IMap2D isInsideMap() test successful
     }
 
+    SECTION("Test obstacle enlargement")
+    {
+        Nav2D::MapGrid2D test_map;
+        test_map.setResolution(0.1);
+        test_map.setSize_in_cells(9, 9);
+        std::string mapstring(
+            ".........\n"\
+            ".........\n"\
+            ".........\n"\
+            ".........\n"\
+            "....#....\n"\
+            ".........\n"\
+            ".........\n"\
+            ".........\n"\
+            ".........\n");
+        ReadMapfromString(test_map, mapstring);
+        Nav2D::MapGrid2D original_map = test_map;
+
+        // The enlargement is circular
+        MapGrid2D::map_flags flag;
+        CHECK(test_map.enlargeObstacles(0.2));
+        test_map.getMapFlag(XYCell(4, 2), flag); CHECK(flag == MapGrid2D::map_flags::MAP_CELL_ENLARGED_OBSTACLE);
+        test_map.getMapFlag(XYCell(5, 3), flag); CHECK(flag == MapGrid2D::map_flags::MAP_CELL_ENLARGED_OBSTACLE);
+        test_map.getMapFlag(XYCell(6, 3), flag); CHECK(flag == MapGrid2D::map_flags::MAP_CELL_FREE);
+        test_map.getMapFlag(XYCell(6, 2), flag); CHECK(flag == MapGrid2D::map_flags::MAP_CELL_FREE);
+        test_map.getMapFlag(XYCell(4, 4), flag); CHECK(flag == MapGrid2D::map_flags::MAP_CELL_WALL);
+
+        // The distances ignore the enlarged obstacles
+        double distance = 0;
+        CHECK(test_map.computeObstacleDistance());
+        CHECK(test_map.getObstacleDistance(XYCell(4, 4), distance)); CHECK(distance == Approx(0.0));
+        CHECK(test_map.getObstacleDistance(XYCell(7, 8), distance)); CHECK(distance == Approx(0.5));
+        CHECK(test_map.setMapFlag(XYCell(1, 1), MapGrid2D::map_flags::MAP_CELL_TEMPORARY_OBSTACLE));
+        CHECK_FALSE(test_map.getObstacleDistance(XYCell(7, 8), distance));
+
+        // The incremental update gives the same result of a full enlargement
+        CHECK(test_map.updateEnlargedObstacles(XYCell(1, 1), XYCell(1, 1)));
+        Nav2D::MapGrid2D full_map = original_map;
+        full_map.setMapFlag(XYCell(1, 1), MapGrid2D::map_flags::MAP_CELL_TEMPORARY_OBSTACLE);
+        full_map.enlargeObstacles(0.2);
+        CHECK(test_map.isIdenticalTo(full_map));
+
+        CHECK(test_map.setMapFlag(XYCell(1, 1), MapGrid2D::map_flags::MAP_CELL_FREE));
+        CHECK(test_map.updateEnlargedObstacles(XYCell(1, 1), XYCell(1, 1)));
+        full_map = original_map;
+        full_map.enlargeObstacles(0.2);
+        CHECK(test_map.isIdenticalTo(full_map));
+
+        // The enlargement is cleaned up
+        CHECK(test_map.enlargeObstacles(0));
+        CHECK(test_map.isIdenticalTo(original_map));
+    }
+
+    SECTION("Test MapGrid2D compression and regions")
+    {
+        Nav2D::MapGrid2D test_map;
+        test_map.setResolution(1.0);
+        test_map.setSize_in_cells(11, 11);
+        test_map.setOrigin(-3, -7, 0);
+        test_map.setMapName("test_map");
+        std::string mapstring(
+            "***********\n"\
+            "#########**\n"\
+            "#.......#**\n"\
+            "#....######\n"\
+            "#....#....#\n"\
+            "#....#....#\n"\
+            "#....###..#\n"\
+            "##...#....#\n"\
+            "*#...#....#\n"\
+            "*#........#\n"\
+            "*##########\n");
+        ReadMapfromString(test_map, mapstring);
+
+        // Both formats are read back, the raw one is the default
+        Nav2D::MapGrid2D raw_map;
+        Bottle raw_bot;
+        CHECK(Property::copyPortable(test_map, raw_bot));
+        CHECK(raw_bot.size() == 9);
+        CHECK(Property::copyPortable(raw_bot, raw_map));
+        CHECK(raw_map.isIdenticalTo(test_map));
+
+        Nav2D::MapGrid2D compressed_map;
+        Bottle compressed_bot;
+        CHECK(test_map.enable_map_compression_over_network(true));
+        CHECK(Property::copyPortable(test_map, compressed_bot));
+        CHECK(compressed_bot.size() == 10);
+        CHECK(Property::copyPortable(compressed_bot, compressed_map));
+        CHECK(compressed_map.isIdenticalTo(test_map));
+
+        // The lengths of the compressed layers come from the network
+        for (std::int32_t len : {-1, 1 << 30})
+        {
+            DummyConnector dummy;
+            ConnectionWriter& writer = dummy.getWriter();
+            writer.appendInt32(BOTTLE_TAG_LIST);
+            writer.appendInt32(10);
+            writer.appendInt32(BOTTLE_TAG_INT32);
+            writer.appendInt32(11);
+            writer.appendInt32(BOTTLE_TAG_INT32);
+            writer.appendInt32(11);
+            for (int i = 0; i < 4; i++)
+            {
+                writer.appendInt32(BOTTLE_TAG_FLOAT64);
+                writer.appendFloat64(1.0);
+            }
+            writer.appendInt32(BOTTLE_TAG_STRING);
+            writer.appendString("bad_map");
+            writer.appendInt32(BOTTLE_TAG_INT32);
+            writer.appendInt32(1);
+            writer.appendInt32(BOTTLE_TAG_BLOB);
+            writer.appendInt32(len);
+            writer.appendBlock("abcd", 4);
+            Nav2D::MapGrid2D bad_map;
+            CHECK_FALSE(bad_map.read(dummy.getReader()));
+        }
+
+        // A region keeps the world coordinates of its cells
+        Nav2D::MapGrid2D region;
+        CHECK(test_map.getMapRegion(XYCell(5, 3), XYCell(9, 6), region));
+        size_t w = 0;
+        size_t h = 0;
+        region.getSize_in_cells(w, h);
+        CHECK(w == 5);
+        CHECK(h == 4);
+        CHECK(region.cell2World(XYCell(1, 1)) == test_map.cell2World(XYCell(6, 4)));
+        CHECK(region.isWall(XYCell(0, 0)));
+        CHECK(region.isFree(XYCell(1, 1)));
+        CHECK_FALSE(test_map.getMapRegion(XYCell(5, 3), XYCell(11, 6), region));
+
+        // The hashes find the tiles which differ
+        Nav2D::MapGrid2D changed_map = test_map;
+        changed_map.setMapFlag(XYCell(7, 8), MapGrid2D::map_flags::MAP_CELL_KEEP_OUT);
+        std::vector<std::uint64_t> hashes;
+        std::vector<std::uint64_t> changed_hashes;
+        CHECK(test_map.getTileHashes(4, hashes));
+        CHECK(changed_map.getTileHashes(4, changed_hashes));
+        REQUIRE(hashes.size() == 9);
+        REQUIRE(changed_hashes.size() == 9);
+        for (size_t i = 0; i < hashes.size(); i++)
+        {
+            CHECK((hashes[i] != changed_hashes[i]) == (i == 7));
+        }
+
+        // Tiles bigger than the map give a single tile
+        CHECK(test_map.getTileHashes(static_cast<size_t>(-1), hashes));
+        CHECK(hashes.size() == 1);
+        CHECK_FALSE(test_map.getTileHashes(0, hashes));
+
+        // Copying the tile which differs gives the same map
+        Nav2D::MapGrid2D tile;
+        CHECK(changed_map.getMapRegion(XYCell(4, 8), XYCell(7, 10), tile));
+        CHECK(test_map.setMapRegion(XYCell(4, 8), tile));
+        CHECK(test_map.isIdenticalTo(changed_map));
+        CHECK_FALSE(test_map.setMapRegion(XYCell(8, 8), tile));
+    }
+
     SECTION("Test data type Map2DArea, Map2DLocation")
     {
         bool b;
@@ -437,6 +596,20 @@ TEST_CASE("dev::MapGrid2DTest", "[yarp::dev]")
             imap->get_map("test_map1", test_get_map);
             CHECK(test_store_map1.isIdenticalTo(test_get_map)); // IMap2D store/get operation successful
 
+            Nav2D::MapGrid2D test_region;
+            CHECK(imap->get_map_region("test_map1", XYCell(1, 0), XYCell(1, 1), test_region));
+            size_t w = 0;
+            size_t h = 0;
+            test_region.getSize_in_cells(w, h);
+            CHECK(w == 1);
+            CHECK(h == 2);
+            CHECK_FALSE(imap->get_map_region("test_map1", XYCell(1, 0), XYCell(2, 1), test_region));
+
+            test_store_map1.setMapFlag(XYCell(1, 1), MapGrid2D::map_flags::MAP_CELL_WALL);
+            imap->store_map(test_store_map1);
+            CHECK(imap->update_map("test_map1", test_get_map));
+            CHECK(test_store_map1.isIdenticalTo(test_get_map)); // IMap2D update_map operation successful
+
             imap->get_map_names(map_names);
             bool b1 = (map_names.size() == 2);
             bool b2 = false;
@@ -0,0 +1,114 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/dev/impl/StreamingCommand.h>
+
+#include <yarp/os/Bottle.h>
+#include <yarp/os/DummyConnector.h>
+#include <yarp/os/Portable.h>
+#include <yarp/dev/IPositionDirect.h>
+#include <yarp/dev/ITorqueControl.h>
+
+#include <catch.hpp>
+#include <harness.h>
+
+using namespace yarp::os;
+using namespace yarp::dev;
+using namespace yarp::dev::impl;
+
+TEST_CASE("dev::StreamingCommandTest", "[yarp::dev]")
+{
+    SECTION("Test a command on all the joints")
+    {
+        const double refs[5] = {1.0, 2.0, 3.0, 4.0, 5.0};
+        StreamingCommand cmd;
+        cmd.setAll(VOCAB_POSITION_DIRECTS, 5, refs, 42.0);
+
+        StreamingCommand cmd2;
+        REQUIRE(Portable::copyPortable(cmd, cmd2));
+        CHECK(cmd2.getCommand() == VOCAB_POSITION_DIRECTS);
+        CHECK(cmd2.getAxes() == 5);
+        CHECK(cmd2.getTimestamp() == 42.0);
+        REQUIRE(cmd2.getCount() == 5);
+        for (size_t j = 0; j < 5; j++) {
+            CHECK(cmd2.isSelected(j));
+            CHECK(cmd2.getReferences()[j] == refs[j]);
+        }
+    }
+
+    SECTION("Test a command on a single joint")
+    {
+        StreamingCommand cmd;
+        CHECK_FALSE(cmd.setSingle(VOCAB_TORQUES_DIRECTS, 40, 40, 1.0, 0.0));
+        CHECK(cmd.setSingle(VOCAB_TORQUES_DIRECTS, 40, 35, 1.5, 0.0));
+
+        StreamingCommand cmd2;
+        REQUIRE(Portable::copyPortable(cmd, cmd2));
+        CHECK(cmd2.getAxes() == 40);
+        REQUIRE(cmd2.getCount() == 1);
+        CHECK(cmd2.getReferences()[0] == 1.5);
+        for (size_t j = 0; j < 40; j++) {
+            CHECK(cmd2.isSelected(j) == (j == 35));
+        }
+    }
+
+    SECTION("Test a command on a group of joints")
+    {
+        // Unsorted, with joint 3 listed twice
+        const int joints[4] = {33, 3, 0, 3};
+        const double refs[4] = {33.0, 1.0, 0.0, 3.0};
+        StreamingCommand cmd;
+        CHECK(cmd.setGroup(VOCAB_POSITION_DIRECTS, 34, 4, joints, refs, 0.0));
+
+        StreamingCommand cmd2;
+        REQUIRE(Portable::copyPortable(cmd, cmd2));
+        REQUIRE(cmd2.getCount() == 3);
+        CHECK(cmd2.getReferences()[0] == 0.0);
+        CHECK(cmd2.getReferences()[1] == 3.0);
+        CHECK(cmd2.getReferences()[2] == 33.0);
+        CHECK(cmd2.isSelected(0));
+        CHECK(cmd2.isSelected(3));
+        CHECK(cmd2.isSelected(33));
+        CHECK_FALSE(cmd2.isSelected(1));
+
+        const int wrong[2] = {1, 34};
+        CHECK_FALSE(cmd.setGroup(VOCAB_POSITION_DIRECTS, 34, 2, wrong, refs, 0.0));
+    }
+
+    SECTION("Test the layout on the wire")
+    {
+        // Each word is written as a single value, in the network byte order
+        const int joints[3] = {33, 3, 0};
+        const double refs[3] = {33.0, 3.0, 0.5};
+        StreamingCommand cmd;
+        CHECK(cmd.setGroup(VOCAB_POSITION_DIRECTS, 34, 3, joints, refs, 42.0));
+
+        DummyConnector dummy;
+        REQUIRE(cmd.write(dummy.getWriter()));
+        ConnectionReader& reader = dummy.getReader();
+        CHECK(reader.expectInt32() == StreamingCommand::tag);
+        CHECK(reader.expectInt32() == VOCAB_POSITION_DIRECTS);
+        CHECK(reader.expectInt32() == 34);
+        CHECK(reader.expectInt32() == 3);
+        CHECK(reader.expectFloat64() == 42.0);
+        CHECK(reader.expectInt32() == 0x9);
+        CHECK(reader.expectInt32() == 0x2);
+        CHECK(reader.expectFloat64() == 0.5);
+        CHECK(reader.expectFloat64() == 3.0);
+        CHECK(reader.expectFloat64() == 33.0);
+        CHECK_FALSE(reader.isError());
+    }
+
+    SECTION("Test reading other messages")
+    {
+        Bottle b;
+        b.addList().addVocab(VOCAB_POSITION_DIRECTS);
+        StreamingCommand cmd;
+        CHECK_FALSE(Portable::copyPortable(b, cmd));
+    }
+}
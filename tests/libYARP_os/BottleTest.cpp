@@ -11,6 +11,7 @@
 #include <yarp/os/Bottle.h>
 
 #include <yarp/os/DummyConnector.h>
+#include <yarp/os/NetInt32.h>
 #include <yarp/os/Stamp.h>
 #include <yarp/os/Vocab.h>
 
@@ -20,6 +21,8 @@
 #include <catch.hpp>
 #include <harness.h>
 
+#include <vector>
+
 using namespace yarp::os::impl;
 using namespace yarp::os;
 
@@ -429,6 +432,19 @@ TEST_CASE("os::BottleTest", "[yarp::os]")
         CHECK(b2.get(0).asFloat64() == Approx(3.14)); // copy from bottle succeeded
     }
 
+    SECTION("test deeply nested lists with wrong lengths")
+    {
+        // Each list announces many more items than the message contains
+        std::vector<NetInt32> nested {BOTTLE_TAG_LIST, 1};
+        for (int i = 0; i < 16000; i++) {
+            nested.push_back(BOTTLE_TAG_LIST);
+            nested.push_back(16000);
+        }
+        Bottle b;
+        b.fromBinary(reinterpret_cast<const char*>(nested.data()), nested.size() * sizeof(NetInt32));
+        CHECK(b.size() <= 1);
+    }
+
     SECTION("test string with null")
     {
         char buf1[] = "hello world";
@@ -0,0 +1,234 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/os/BottleView.h>
+#include <yarp/os/Bottle.h>
+#include <yarp/os/DummyConnector.h>
+#include <yarp/os/NetInt32.h>
+#include <yarp/os/Vocab.h>
+
+#include <catch.hpp>
+#include <harness.h>
+
+#include <vector>
+
+using namespace yarp::os;
+
+TEST_CASE("os::BottleViewTest", "[yarp::os]")
+{
+    SECTION("an empty view is invalid")
+    {
+        BottleView view;
+        CHECK_FALSE(view.isValid());
+        CHECK(view.size() == (size_t) 0);
+        CHECK(view.getCode(0) == 0);
+        CHECK(view.asInt32(0) == 0);
+        CHECK(view.asString(0).empty());
+        CHECK(view.get(0).isNull());
+    }
+
+    SECTION("items are accessed with their type")
+    {
+        Bottle bot("10 2.5 hello [set] {1 2 3} (nested (5 world))");
+        bot.addInt64(1234567890123LL);
+        bot.addInt8(-3);
+        size_t len = 0;
+        const char* buf = bot.toBinary(&len);
+
+        BottleView view;
+        REQUIRE(view.fromBinary(buf, len));
+        CHECK(view.isValid());
+        REQUIRE(view.size() == bot.size());
+
+        CHECK(view.isInt32(0));
+        CHECK(view.asInt32(0) == 10);
+        CHECK(view.asFloat64(0) == 10.0);
+        CHECK(view.isFloat64(1));
+        CHECK(view.asFloat64(1) == 2.5);
+        CHECK(view.asInt32(1) == 2);
+        CHECK(view.isString(2));
+        CHECK(view.asString(2) == "hello");
+        CHECK(view.asBlobLength(2) == (size_t) 5);
+        CHECK(std::string(view.asBlob(2), view.asBlobLength(2)) == "hello");
+        CHECK(view.isVocab(3));
+        CHECK(view.asVocab(3) == yarp::os::createVocab('s', 'e', 't'));
+        CHECK(view.asString(3) == "set");
+        CHECK(view.isBlob(4));
+        REQUIRE(view.asBlobLength(4) == (size_t) 3);
+        CHECK(view.asBlob(4)[2] == 3);
+        CHECK(view.isList(5));
+        CHECK(view.isInt64(6));
+        CHECK(view.asInt64(6) == 1234567890123LL);
+        CHECK(view.isInt8(7));
+        CHECK(view.asInt8(7) == -3);
+
+        // Wrong types and out of range indexes
+        CHECK(view.asInt32(2) == 0);
+        CHECK(view.asString(0).empty());
+        CHECK(view.asBlob(0) == nullptr);
+        CHECK_FALSE(view.asList(0).isValid());
+        CHECK(view.getCode(100) == 0);
+        CHECK_FALSE(view.isInt32(100));
+    }
+
+    SECTION("nested lists share the data of the view")
+    {
+        BottleView sub;
+        {
+            Bottle bot("1 (2 (3 three) 4) 5");
+            DummyConnector con;
+            con.setTextMode(false);
+            bot.write(con.getWriter());
+
+            BottleView view;
+            REQUIRE(view.read(con.getReader()));
+            REQUIRE(view.size() == (size_t) 3);
+            CHECK(view.asInt32(2) == 5);
+            sub = view.asList(1);
+        }
+        // The original view is gone, the nested one is still valid
+        REQUIRE(sub.isValid());
+        REQUIRE(sub.size() == (size_t) 3);
+        CHECK(sub.asInt32(0) == 2);
+        CHECK(sub.asInt32(2) == 4);
+        BottleView inner = sub.asList(1);
+        REQUIRE(inner.size() == (size_t) 2);
+        CHECK(inner.asInt32(0) == 3);
+        CHECK(inner.asString(1) == "three");
+        CHECK(sub.toString() == "2 (3 three) 4");
+    }
+
+    SECTION("specialized lists are indexed")
+    {
+        Bottle bot;
+        Bottle& ints = bot.addList();
+        Bottle& floats = bot.addList();
+        for (int i = 0; i < 10; i++) {
+            ints.addInt32(i * 10);
+            floats.addFloat64(i * 0.5);
+        }
+        size_t len = 0;
+        const char* buf = bot.toBinary(&len);
+
+        BottleView view;
+        REQUIRE(view.fromBinary(buf, len));
+        BottleView vi = view.asList(0);
+        BottleView vf = view.asList(1);
+        REQUIRE(vi.size() == (size_t) 10);
+        REQUIRE(vf.size() == (size_t) 10);
+        CHECK(vi.isInt32(7));
+        CHECK(vi.asInt32(7) == 70);
+        CHECK(vf.isFloat64(3));
+        CHECK(vf.asFloat64(3) == 1.5);
+    }
+
+    SECTION("items are decoded on demand")
+    {
+        Bottle bot("cmd 42 (a b (c)) \"with space\" 3.25");
+        size_t len = 0;
+        const char* buf = bot.toBinary(&len);
+
+        BottleView view;
+        REQUIRE(view.fromBinary(buf, len));
+        CHECK(view.get(1).asInt32() == 42);
+        Value v = view.get(2);
+        REQUIRE(v.isList());
+        CHECK(v.asList()->toString() == "a b (c)");
+        CHECK(view.get(3).asString() == "with space");
+
+        Bottle copy = view.toBottle();
+        CHECK(copy.toString() == bot.toString());
+        CHECK(view.toString() == bot.toString());
+
+        Bottle copy2("something else");
+        CHECK(view.asList(2).toBottle(copy2));
+        CHECK(copy2.toString() == "a b (c)");
+    }
+
+    SECTION("a view can be reused for several messages")
+    {
+        DummyConnector con;
+        con.setTextMode(false);
+        BottleView view;
+
+        Bottle first("1 2 3 (4 5)");
+        first.write(con.getWriter());
+        REQUIRE(view.read(con.getReader()));
+        BottleView kept = view.asList(3);
+
+        con.reset();
+        Bottle second("hello");
+        second.write(con.getWriter());
+        REQUIRE(view.read(con.getReader()));
+        REQUIRE(view.size() == (size_t) 1);
+        CHECK(view.asString(0) == "hello");
+
+        // The view obtained before is not affected by the new read
+        REQUIRE(kept.size() == (size_t) 2);
+        CHECK(kept.asInt32(1) == 5);
+    }
+
+    SECTION("text mode messages are read")
+    {
+        DummyConnector con;
+        con.setTextMode(true);
+        Bottle bot("[set] speed 2.5 (1 2)");
+        bot.write(con.getWriter());
+
+        BottleView view;
+        REQUIRE(view.read(con.getReader()));
+        REQUIRE(view.size() == (size_t) 4);
+        CHECK(view.asVocab(0) == yarp::os::createVocab('s', 'e', 't'));
+        CHECK(view.asString(1) == "speed");
+        CHECK(view.asFloat64(2) == 2.5);
+        CHECK(view.asList(3).asInt32(1) == 2);
+    }
+
+    SECTION("invalid data is rejected")
+    {
+        Bottle bot("1 (2 (3 three) 4) \"a string\" 5.5");
+        size_t len = 0;
+        const char* buf = bot.toBinary(&len);
+        std::vector<char> data(buf, buf + len);
+
+        BottleView view;
+        for (size_t i = 0; i < len; i++) {
+            INFO("truncated at " << i);
+            CHECK_FALSE(view.fromBinary(data.data(), i));
+            CHECK_FALSE(view.isValid());
+            CHECK(view.size() == (size_t) 0);
+        }
+
+        // Item count larger than the data
+        std::vector<char> broken = data;
+        broken[4] = 100;
+        CHECK_FALSE(view.fromBinary(broken.data(), broken.size()));
+
+        // Unknown item code
+        broken = data;
+        broken[8] = 0x7f;
+        CHECK_FALSE(view.fromBinary(broken.data(), broken.size()));
+
+        CHECK(view.fromBinary(data.data(), data.size()));
+        CHECK(view.isValid());
+
+        // Nested lists announcing many more items than the message contains
+        std::vector<NetInt32> nested {BOTTLE_TAG_LIST, 1};
+        for (int i = 0; i < 8000; i++) {
+            nested.push_back(BOTTLE_TAG_LIST);
+            nested.push_back(8000);
+        }
+        CHECK_FALSE(view.fromBinary(reinterpret_cast<const char*>(nested.data()), nested.size() * sizeof(NetInt32)));
+
+        // Items without a type code take at least 4 bytes each
+        std::vector<NetInt32> header {BOTTLE_TAG_LIST, 100, BOTTLE_TAG_INT32, 1};
+        std::vector<char> padded(reinterpret_cast<const char*>(header.data()), reinterpret_cast<const char*>(header.data()) + header.size() * sizeof(NetInt32));
+        padded.resize(padded.size() + 100);
+        CHECK_FALSE(view.fromBinary(padded.data(), padded.size()));
+    }
+}
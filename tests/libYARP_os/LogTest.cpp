@@ -6,8 +6,10 @@
  * BSD-3-Clause license. See the accompanying LICENSE file for details.
  */
 
+#include <yarp/os/Bottle.h>
 #include <yarp/os/Log.h>
 #include <yarp/os/LogComponent.h>
+#include <yarp/os/Property.h>
 #include <yarp/os/SystemClock.h>
 #include <yarp/os/Thread.h>
 #include <yarp/os/NetType.h>
@@ -15,7 +17,10 @@
 #include <yarp/os/impl/LogForwarder.h>
 
 #include <array>
+#include <atomic>
+#include <set>
 #include <thread>
+#include <vector>
 
 #include <catch.hpp>
 #include <harness.h>
@@ -869,4 +874,164 @@ TEST_CASE("os::LogTest", "[yarp::os]")
 
         CNT yInfo("This is text contains special characters that could cause issues like 1-\", 2-(, 3-), 4-[, 5-], 6-{, 7-}, 8-\t, 9-%%");
     }
+
+    SECTION("Test the LogForwarder queue")
+    {
+        using yarp::os::impl::LogForwarder;
+
+        LogForwarder::Queue queue(8);
+        LogForwarder::Record record;
+        CHECK_FALSE(queue.pop(record));
+
+        // Fill the queue, the following messages are dropped
+        for (int j = 0; j < 11; ++j) {
+            LogForwarder::Record r;
+            r.level = "INFO";
+            r.message = std::to_string(j);
+            CHECK(queue.push(std::move(r)) == (j < 8));
+        }
+        CHECK(queue.getDroppedCount() == 3);
+        CHECK(queue.takeDropped() == 3);
+        CHECK(queue.takeDropped() == 0);
+
+        // The messages are popped in order, and the space is reused
+        for (int j = 0; j < 4; ++j) {
+            REQUIRE(queue.pop(record));
+            CHECK(record.message == std::to_string(j));
+        }
+        for (int j = 8; j < 13; ++j) {
+            LogForwarder::Record r;
+            r.level = "INFO";
+            r.message = std::to_string(j);
+            CHECK(queue.push(std::move(r)) == (j < 12));
+        }
+        CHECK(queue.getDroppedCount() == 4);
+        CHECK(queue.takeDropped() == 1);
+        for (int j = 4; j < 12; ++j) {
+            REQUIRE(queue.pop(record));
+            CHECK(record.message == std::to_string(j));
+        }
+        CHECK_FALSE(queue.pop(record));
+
+        // Multiple producers and multiple consumers, each message is
+        // received once, or accounted as dropped
+        constexpr int producers = 4;
+        constexpr int consumers = 2;
+        constexpr int messages = 10000;
+        LogForwarder::Queue mpmc(64);
+        std::atomic<int> running {producers};
+        std::array<std::vector<int>, consumers> received;
+        std::vector<std::thread> threads;
+        for (int p = 0; p < producers; ++p) {
+            threads.emplace_back([&, p]() {
+                for (int j = 0; j < messages; ++j) {
+                    LogForwarder::Record r;
+                    r.line = static_cast<unsigned int>(p * messages + j);
+                    mpmc.push(std::move(r));
+                }
+                --running;
+            });
+        }
+        for (int c = 0; c < consumers; ++c) {
+            threads.emplace_back([&, c]() {
+                LogForwarder::Record r;
+                bool done = false;
+                while (!done) {
+                    done = (running == 0);
+                    while (mpmc.pop(r)) {
+                        received[c].push_back(static_cast<int>(r.line));
+                    }
+                }
+            });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+        std::set<int> all;
+        size_t total = 0;
+        for (const auto& v : received) {
+            all.insert(v.begin(), v.end());
+            total += v.size();
+        }
+        CHECK(all.size() == total);
+        CHECK(total + mpmc.getDroppedCount() == producers * messages);
+    }
+
+    SECTION("Test parsing a batch of forwarded messages")
+    {
+        using yarp::os::impl::LogForwarder;
+
+        std::vector<LogForwarder::Record> records(3);
+        records[0].level = "INFO";
+        records[0].message = "This is a message with \"special\" characters (1) [2] {3}";
+        records[0].systemtime = 1234.5;
+        records[0].networktime = 1234.25;
+        records[1].level = "ERROR";
+        records[1].message = "Message with code info";
+        records[1].codeinfo = true;
+        records[1].filename = "file name.cpp";
+        records[1].line = 42;
+        records[1].function = "void f()";
+        records[1].component = "yarp.test.os.LogTest";
+        records[2].level = "WARNING";
+        records[2].customtime = 10.5;
+        records[2].processinfo = true;
+        records[2].thread_id = 0x1234;
+
+        // The batch is sent as the name of the port followed by one list
+        // per message
+        yarp::os::Bottle batch;
+        batch.addString("[/log/host/cmd/1]");
+        for (const auto& r : records) {
+            LogForwarder::toBottle(r, batch.addList());
+        }
+        size_t size = 0;
+        const char* data = batch.toBinary(&size);
+        yarp::os::Bottle received;
+        received.fromBinary(data, size);
+
+        REQUIRE(received.size() == 4);
+        CHECK(received.get(0).asString() == "[/log/host/cmd/1]");
+        for (size_t j = 0; j < records.size(); ++j) {
+            const auto& r = records[j];
+            yarp::os::Bottle* b = received.get(j + 1).asList();
+            REQUIRE(b != nullptr);
+
+            // The single message format is parsed in the same way
+            yarp::os::Property p(LogForwarder::toString(r).c_str());
+
+            std::vector<const yarp::os::Searchable*> parsed {b, &p};
+            for (const auto* s : parsed) {
+                CHECK(s->find("level").asString() == r.level);
+                CHECK(s->find("systemtime").asFloat64() == r.systemtime);
+                CHECK(s->find("networktime").asFloat64() == r.networktime);
+                CHECK(s->check("message") == !r.message.empty());
+                CHECK(s->find("message").toString() == r.message);
+                CHECK(s->check("customtime") == (r.customtime != 0.0));
+                CHECK(s->check("filename") == r.codeinfo);
+                CHECK(s->check("pid") == r.processinfo);
+                CHECK(s->check("component") == !r.component.empty());
+            }
+
+            // The values in the batch are typed
+            CHECK(b->find("level").isString());
+            CHECK(b->find("systemtime").isFloat64());
+            if (r.codeinfo) {
+                CHECK(b->find("filename").asString() == r.filename);
+                CHECK(p.find("filename").asString() == r.filename);
+                CHECK(b->find("line").isInt32());
+                CHECK(b->find("line").asInt32() == 42);
+                CHECK(p.find("line").asInt32() == 42);
+                CHECK(b->find("function").asString() == r.function);
+                CHECK(b->find("component").asString() == r.component);
+            }
+            if (r.processinfo) {
+                CHECK(b->find("thread_id").isInt64());
+                CHECK(b->find("thread_id").asInt64() == 0x1234);
+                CHECK(b->find("pid").asInt32() == p.find("pid").asInt32());
+                CHECK(b->find("cmd").asString() == p.find("cmd").asString());
+                CHECK(b->find("customtime").asFloat64() == 10.5);
+            }
+        }
+    }
 }
@@ -12,14 +12,30 @@
 #include <yarp/os/NetInt32.h>
 #include <yarp/os/NetFloat64.h>
 
+#include <cstdint>
 #include <cstdlib>
 #include <cstring>
+#include <initializer_list>
+#include <vector>
 
 #include <catch.hpp>
 #include <harness.h>
 
 using namespace yarp::os;
 
+// Bit by bit crc-32, as a reference for the optimized one
+static unsigned long referenceCrc(const char* buf, size_t len)
+{
+    std::uint32_t crc = 0xffffffff;
+    for (size_t i = 0; i < len; i++) {
+        crc ^= static_cast<unsigned char>(buf[i]);
+        for (int k = 0; k < 8; k++) {
+            crc = (crc & 1) ? ((crc >> 1) ^ 0xedb88320) : (crc >> 1);
+        }
+    }
+    return crc ^ 0xffffffff;
+}
+
 TEST_CASE("os::NetTypeTest", "[yarp::os]")
 {
 
@@ -43,6 +59,30 @@ TEST_CASE("os::NetTypeTest", "[yarp::os]")
         CHECK(ct1==ct2); // two identical sequences again
     }
 
+    SECTION("checking cyclic redundancy check is the standard crc-32")
+    {
+        char check[] = "123456789";
+        CHECK(NetType::getCrc(check, 9) == 0xcbf43926UL);
+        CHECK(NetType::getCrc(check, 0) == 0UL);
+
+        // All the alignments and the lengths around the blocks used by
+        // the optimized implementations
+        std::vector<char> data(70000);
+        for (size_t i = 0; i < data.size(); i++) {
+            data[i] = static_cast<char>((i * 2654435761U) >> 13);
+        }
+        for (size_t offset = 0; offset < 16; offset++) {
+            for (size_t len = 0; len < 300; len++) {
+                INFO("offset " << offset << " length " << len);
+                CHECK(NetType::getCrc(data.data() + offset, len) == referenceCrc(data.data() + offset, len));
+            }
+        }
+        for (size_t len : {1464, 65499, 69000}) {
+            INFO("length " << len);
+            CHECK(NetType::getCrc(data.data() + 3, len) == referenceCrc(data.data() + 3, len));
+        }
+    }
+
     SECTION("checking integer representation")
     {
         union {
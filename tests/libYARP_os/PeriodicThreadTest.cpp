@@ -230,6 +230,32 @@ public:
     }
 };
 
+class AbsoluteThread : public PeriodicThread
+{
+public:
+    int count;
+    double busy;
+    int busyIterations;
+
+    // busy is the duration of the first busyIterations iterations, or of
+    // all of them if busyIterations is negative
+    AbsoluteThread(double r, double busy = 0.0, int busyIterations = -1) :
+            PeriodicThread(r, ShouldUseSystemClock::Yes, PeriodicThreadClock::Absolute),
+            count(0),
+            busy(busy),
+            busyIterations(busyIterations)
+    {
+    }
+
+    void run() override
+    {
+        count++;
+        if (busy > 0 && (busyIterations < 0 || count <= busyIterations)) {
+            SystemClock::delaySystem(busy);
+        }
+    }
+};
+
 class AskForStopThread : public PeriodicThread {
 public:
     bool done;
@@ -407,6 +433,88 @@ TEST_CASE("os::PeriodicThreadTest", "[yarp::os]")
         CHECK(Time::getClockType() == YARP_CLOCK_SYSTEM); // getClockType is YARP_CLOCK_SYSTEM
     }
 
+    SECTION("testing absolute clock")
+    {
+        AbsoluteThread thread(0.010, 0.002);
+        thread.start();
+        SystemClock::delaySystem(1.0);
+        thread.stop();
+
+        // With absolute deadlines the number of iterations does not drift
+        // with the time spent in run() and with the wake-up latency
+        INFO("Iterations: " << thread.count);
+        CHECK(thread.count >= 90);
+        CHECK(thread.count <= 102);
+
+        double p50;
+        double p99;
+        double max;
+        thread.getEstimatedLateness(p50, p99, max);
+        INFO("Lateness p50: " << p50 << " p99: " << p99 << " max: " << max);
+        CHECK(p50 >= 0.0);
+        CHECK(p50 <= p99);
+        CHECK(p99 <= max);
+        CHECK(max > 0.0);
+
+        thread.resetStat();
+        thread.step();
+        CHECK(thread.getIterations() == 1);
+    }
+
+    SECTION("testing absolute clock overrun policies")
+    {
+        // The first iteration takes 200 ms, and misses 20 deadlines of 10 ms,
+        // the next ones are fast. In 500 ms there are 50 deadlines.
+        AbsoluteThread skip(0.010, 0.200, 1);
+        skip.setOverrunPolicy(PeriodicThreadOverrun::Skip);
+        skip.start();
+        SystemClock::delaySystem(0.5);
+        skip.stop();
+
+        // Missed deadlines are dropped, so about 30 iterations are run
+        INFO("Skip iterations: " << skip.count << " overruns: " << skip.getOverruns());
+        CHECK(skip.getOverruns() > 0);
+        CHECK(skip.count <= 38);
+
+        AbsoluteThread catchUp(0.010, 0.200, 1);
+        catchUp.setOverrunPolicy(PeriodicThreadOverrun::CatchUp);
+        catchUp.start();
+        SystemClock::delaySystem(0.5);
+        catchUp.stop();
+
+        // Missed deadlines are recovered by running the next iterations
+        // back to back, so about 50 iterations are run
+        INFO("CatchUp iterations: " << catchUp.count << " overruns: " << catchUp.getOverruns());
+        CHECK(catchUp.getOverruns() > 0);
+        CHECK(catchUp.count >= 44);
+    }
+
+    SECTION("testing cpu affinity")
+    {
+        PeriodicThread5 thread(0.010);
+        CHECK(thread.getCpuAffinity() == -1);
+#if defined(__linux__)
+        CHECK(thread.setCpuAffinity(0));
+        CHECK(thread.getCpuAffinity() == 0);
+        thread.start();
+        SystemClock::delaySystem(0.1);
+        CHECK(thread.isRunning());
+        thread.stop();
+        CHECK(thread.count > 0);
+        CHECK(thread.setCpuAffinity(-1));
+
+        // A CPU that does not exist is reported when the thread starts
+        PeriodicThread5 unpinned(0.010);
+        CHECK(unpinned.setCpuAffinity(1000));
+        unpinned.start();
+        SystemClock::delaySystem(0.1);
+        CHECK(unpinned.isRunning());
+        unpinned.stop();
+        CHECK(unpinned.getCpuAffinity() == -1);
+#endif
+        CHECK(thread.getCpuAffinity() == -1);
+    }
+
     SECTION("testing start() askForStop() start() sequence...")
     {
         AskForStopThread test;
@@ -26,6 +26,7 @@
 #include <yarp/os/RpcServer.h>
 #include <yarp/os/PortInfo.h>
 #include <yarp/os/Log.h>
+#include <yarp/os/Vocab.h>
 
 #include <yarp/dev/PolyDriver.h>
 #include <yarp/dev/Drivers.h>
@@ -1095,6 +1096,73 @@ TEST_CASE("os::PortTest", "[yarp::os]")
         p2.close();
     }
 
+    SECTION("check the statistics of the connections")
+    {
+        BufferedPort<Bottle> pin;
+        Port pout;
+        Port padmin;
+        pin.open("/in");
+        pout.open("/out");
+        padmin.setAdminMode();
+        padmin.open("/admin");
+        Network::connect("/out", "/in");
+        Network::connect("/admin", "/out");
+        Network::sync("/in");
+        Network::sync("/out");
+
+        Bottle cmd("stats on"), reply;
+        padmin.write(cmd, reply);
+        CHECK(reply.get(0).asVocab() == yarp::os::createVocab('o', 'k'));
+
+        Bottle msg("1 2 3");
+        for (int i = 0; i < 5; i++) {
+            pout.write(msg);
+        }
+
+        auto findOutput = [](const Bottle& stats) -> Bottle* {
+            for (size_t i = 0; i < stats.size(); i++) {
+                Bottle* b = stats.get(i).asList();
+                if (b != nullptr && b->get(0).asString() == "out") {
+                    return b;
+                }
+            }
+            return nullptr;
+        };
+
+        cmd.fromString("stats");
+        padmin.write(cmd, reply);
+        CHECK(reply.find("enabled").asInt32() == 1);
+        Bottle* out = findOutput(reply);
+        REQUIRE(out != nullptr);
+        CHECK(out->find("to").asString() == "/in");
+        CHECK(out->find("messages").asInt64() == 5);
+        CHECK(out->find("bytes").asInt64() > 0);
+        CHECK(out->findGroup("write").find("count").asInt64() == 5);
+        CHECK(out->findGroup("serialize").find("count").asInt64() == 5);
+
+        cmd.fromString("stats reset");
+        padmin.write(cmd, reply);
+        cmd.fromString("stats");
+        padmin.write(cmd, reply);
+        out = findOutput(reply);
+        REQUIRE(out != nullptr);
+        CHECK(out->find("messages").asInt64() == 0);
+
+        cmd.fromString("stats off");
+        padmin.write(cmd, reply);
+        pout.write(msg);
+        cmd.fromString("stats");
+        padmin.write(cmd, reply);
+        CHECK(reply.find("enabled").asInt32() == 0);
+        out = findOutput(reply);
+        REQUIRE(out != nullptr);
+        CHECK(out->find("messages").asInt64() == 0);
+
+        padmin.close();
+        pout.close();
+        pin.close();
+    }
+
     SECTION("checking acquire/release")
     {
         BufferedPort<Bottle> in;
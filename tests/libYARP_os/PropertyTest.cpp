@@ -16,6 +16,7 @@
 #include <cstdlib>
 #include <cstdio>
 #include <cfloat>
+#include <string>
 
 #include <catch.hpp>
 #include <harness.h>
@@ -614,4 +615,69 @@ check $x $y\n\
         CHECK(p.find("two").asFloat64() == 2.0);
         CHECK(p.find("string").asString() == "foo");
     }
+
+    SECTION("checking many keys")
+    {
+        const int n = 1000;
+        Property p;
+        for (int i = 0; i < n; i++) {
+            p.put("key" + std::to_string(i), i);
+        }
+        Value& first = p.find("key0");
+        for (int i = 0; i < n; i++) {
+            p.put("other" + std::to_string(i), -i);
+        }
+        // values are not moved when the table grows
+        CHECK(&first == &p.find("key0"));
+        for (int i = 0; i < n; i++) {
+            CHECK(p.find("key" + std::to_string(i)).asInt32() == i);
+        }
+
+        // remove every other key, the remaining ones must be still found
+        for (int i = 0; i < n; i += 2) {
+            p.unput("key" + std::to_string(i));
+        }
+        for (int i = 0; i < n; i++) {
+            CHECK(p.check("key" + std::to_string(i)) == (i % 2 == 1));
+            CHECK(p.find("other" + std::to_string(i)).asInt32() == -i);
+        }
+
+        // the output is sorted by key, as before
+        Property small;
+        small.put("b", 2);
+        small.put("c", 3);
+        small.put("a", 1);
+        CHECK(small.toString() == "(a 1) (b 2) (c 3)");
+
+        p.clear();
+        CHECK_FALSE(p.check("key1"));
+        p.put("key1", 5);
+        CHECK(p.find("key1").asInt32() == 5);
+    }
+
+    SECTION("checking lookups with a Property::Key")
+    {
+        const Property::Key x("x");
+        const Property::Key sub("sub");
+        const Property::Key missing(std::string("missing"));
+        CHECK(x.name() == "x");
+
+        Property p("(x 10) (sub (y 20) (z 30))");
+        CHECK(p.check(x));
+        CHECK(p.find(x).asInt32() == 10);
+        CHECK_FALSE(p.check(missing));
+        CHECK(p.find(missing).isNull());
+        CHECK(p.findGroup(sub).find("z").asInt32() == 30);
+        CHECK(p.findGroup(missing).isNull());
+
+        p.put(x, Value(11));
+        CHECK(p.find("x").asInt32() == 11);
+        p.put(missing, Value("found"));
+        CHECK(p.find("missing").asString() == "found");
+
+        // the same key can be used with another Property
+        Property p2;
+        p2.put("x", 3);
+        CHECK(p2.find(x).asInt32() == 3);
+    }
 }
@@ -9,6 +9,7 @@
  */
 
 #include <yarp/os/impl/BottleImpl.h>
+#include <yarp/os/impl/StorableArena.h>
 
 #include <yarp/os/ManagedBytes.h>
 #include <yarp/os/Vocab.h>
@@ -101,4 +102,129 @@ TEST_CASE("os::BottleImplTest", "[yarp::os::impl]")
         CHECK(!BottleImpl::isComplete("(1 2 3"));
         CHECK(BottleImpl::isComplete("(1 2 3)"));
     }
+
+    SECTION("testing arena")
+    {
+        StorableArena arena;
+        CHECK(arena.capacity() == 0);
+        std::vector<Storable*> items;
+        for (int i = 0; i < 100; i++) {
+            items.push_back(arena.make<StoreString>("a string that does not fit in the small string buffer"));
+        }
+        for (auto* item : items) {
+            CHECK(arena.owns(item));
+            CHECK(item->asString() == "a string that does not fit in the small string buffer");
+        }
+        Storable* heap = new StoreInt32(3);
+        CHECK(!arena.owns(heap));
+        arena.destroy(heap);
+
+        size_t capacity = arena.capacity();
+        for (auto* item : items) {
+            arena.destroy(item);
+        }
+        items.clear();
+        arena.rewind();
+        CHECK(arena.capacity() == capacity); // "the chunks are merged"
+
+        // After the rewind everything fits in the merged chunk
+        for (int i = 0; i < 100; i++) {
+            items.push_back(arena.make<StoreString>("x"));
+        }
+        CHECK(arena.capacity() == capacity);
+        for (auto* item : items) {
+            arena.destroy(item);
+        }
+    }
+
+    SECTION("testing arena storage")
+    {
+        Bottle bot;
+        for (int k = 0; k < 3; k++) {
+            bot.clear();
+            for (int i = 0; i < 50; i++) {
+                bot.addInt32(i);
+                bot.addString("hello");
+            }
+            Bottle& lst = bot.addList();
+            lst.addFloat64(2.5);
+            lst.addString("world");
+            bot.add(Value(42)); // cloned in the heap from the proxy
+            CHECK(bot.size() == (size_t) 102);
+            CHECK(bot.get(98).asInt32() == 49);
+            CHECK(bot.get(100).asList()->get(1).asString() == "world");
+            CHECK(bot.get(101).asInt32() == 42);
+        }
+
+        // Copies and binary round trips
+        Bottle bot2(bot);
+        CHECK(bot2.toString() == bot.toString());
+        size_t size;
+        const char* buf = bot.toBinary(&size);
+        Bottle bot3;
+        bot3.fromBinary(buf, size);
+        CHECK(bot3.toString() == bot.toString());
+        bot3.fromBinary(buf, size);
+        CHECK(bot3.toString() == bot.toString());
+
+        // Popped items must survive the Bottle
+        auto* bot4 = new Bottle("1 (2 3) \"four\"");
+        Value last = bot4->pop();
+        Value list = bot4->pop();
+        delete bot4;
+        CHECK(last.asString() == "four");
+        CHECK(list.asList()->toString() == "2 3");
+    }
+
+    SECTION("testing arena reuse after pop")
+    {
+        // The memory of the most recent item is reused
+        StorableArena arena;
+        Storable* first = arena.make<StoreInt64>(1);
+        Storable* second = arena.make<StoreInt64>(2);
+        arena.destroy(second);
+        Storable* third = arena.make<StoreInt32>(3);
+        CHECK(third == second);
+        arena.destroy(first); // not the most recent, not reused
+        Storable* fourth = arena.make<StoreInt32>(4);
+        CHECK(fourth != first);
+        arena.destroy(fourth);
+        arena.destroy(third);
+
+        BottleImpl bot;
+        bot.addInt32(0);
+        size_t capacity = 0;
+        for (int i = 0; i < 10000; i++) {
+            if (i == 1) {
+                capacity = bot.arenaCapacity();
+            }
+            bot.addInt32(i);
+            delete bot.pop();
+            bot.addString("hello");
+            delete bot.pop();
+            // Converted from int64 to int32, and from string to vocab
+            bot.addBit("42");
+            CHECK(bot.get(1).asInt32() == 42);
+            delete bot.pop();
+            bot.addBit("true");
+            CHECK(bot.get(1).isVocab());
+            delete bot.pop();
+        }
+        CHECK(bot.size() == (size_t) 1);
+        CHECK(bot.arenaCapacity() == capacity);
+
+        // Popping all the items reclaims their memory
+        for (int k = 0; k < 3; k++) {
+            for (int i = 0; i < 1000; i++) {
+                bot.addInt32(i);
+            }
+            if (k == 0) {
+                capacity = bot.arenaCapacity();
+            }
+            CHECK(bot.arenaCapacity() == capacity);
+            while (bot.size() != 0) {
+                delete bot.pop();
+            }
+        }
+    }
 }
@@ -145,4 +145,32 @@ TEST_CASE("os::impl::BufferedConnectionWriterTest", "[yarp::os][yarp::os::impl]"
             INFO("pool size of " << Bottle::toString(pool_sizes[i]) << " had " << Bottle::toString(bbr.bufferCount()) << " buffers");
         }
     }
+
+    SECTION("test writing all the buffers at once")
+    {
+        class VectoredOutputStream : public StringOutputStream
+        {
+        public:
+            size_t calls {0};
+            size_t blocks {0};
+
+            void writev(const Bytes* b, size_t count) override
+            {
+                calls++;
+                blocks += count;
+                StringOutputStream::writev(b, count);
+            }
+        };
+
+        VectoredOutputStream vos;
+        BufferedConnectionWriter bbr;
+        ImageOf<PixelRgb> img;
+        img.resize(32, 24);
+        img.zero();
+        img.write(bbr);
+        bbr.write(vos);
+        CHECK(vos.calls == 1); // one vectored write per message
+        CHECK(vos.blocks == bbr.length()); // all buffers passed together
+        CHECK(vos.toString().length() == bbr.dataSize()); // all data written
+    }
 }
@@ -0,0 +1,107 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/os/impl/PortCorePackets.h>
+
+#include <yarp/os/ConnectionWriter.h>
+#include <yarp/os/PortWriter.h>
+
+#include <catch.hpp>
+#include <harness.h>
+
+using namespace yarp::os;
+using namespace yarp::os::impl;
+
+namespace {
+class CompletionCounter : public PortWriter
+{
+public:
+    mutable int completions {0};
+
+    bool write(ConnectionWriter& writer) const override
+    {
+        return true;
+    }
+
+    void onCompletion() const override
+    {
+        completions++;
+    }
+};
+} // namespace
+
+TEST_CASE("os::impl::PortCorePacketsTest", "[yarp::os][yarp::os::impl]")
+{
+    SECTION("test packet recycling")
+    {
+        PortCorePackets packets;
+        CHECK(packets.getCapacity() == 0);
+        packets.reserve(2);
+        CHECK(packets.getCapacity() == 2);
+        CHECK(packets.getGrowCount() == 0);
+
+        PortCorePacket* p1 = packets.getFreePacket();
+        PortCorePacket* p2 = packets.getFreePacket();
+        REQUIRE(p1 != nullptr);
+        REQUIRE(p2 != nullptr);
+        CHECK(p1 != p2);
+        CHECK(packets.getCount() == 2);
+        CHECK(packets.getGrowCount() == 0);
+
+        // The pool grows when all the packets are active
+        PortCorePacket* p3 = packets.getFreePacket();
+        REQUIRE(p3 != nullptr);
+        CHECK(packets.getCount() == 3);
+        CHECK(packets.getGrowCount() == 1);
+        CHECK(packets.getCapacity() == 4);
+
+        // Free a packet in the middle of the active list
+        packets.freePacket(p2);
+        CHECK(packets.getCount() == 2);
+        packets.freePacket(p2); // already inactive
+        CHECK(packets.getCount() == 2);
+        packets.freePacket(p1);
+        packets.freePacket(p3);
+        CHECK(packets.getCount() == 0);
+
+        // Steady state, packets are reused without growing the pool
+        for (int i = 0; i < 100; i++) {
+            PortCorePacket* a = packets.getFreePacket();
+            PortCorePacket* b = packets.getFreePacket();
+            packets.freePacket(a);
+            packets.freePacket(b);
+        }
+        CHECK(packets.getCount() == 0);
+        CHECK(packets.getCapacity() == 4);
+        CHECK(packets.getGrowCount() == 1);
+
+        packets.reserve(3); // already large enough
+        CHECK(packets.getCapacity() == 4);
+    }
+
+    SECTION("test packet completion")
+    {
+        PortCorePackets packets;
+        CompletionCounter writer;
+
+        PortCorePacket* packet = packets.getFreePacket();
+        packet->setContent(&writer);
+        packet->inc();
+        CHECK(packet->getCount() == 2);
+
+        packet->dec();
+        CHECK_FALSE(packets.checkPacket(packet));
+        CHECK(writer.completions == 0);
+        CHECK(packets.getCount() == 1);
+
+        packet->dec();
+        CHECK(packets.checkPacket(packet));
+        CHECK(writer.completions == 1);
+        CHECK(packets.getCount() == 0);
+    }
+}
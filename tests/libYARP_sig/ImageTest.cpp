@@ -23,6 +23,8 @@
 #include <catch.hpp>
 #include <harness.h>
 
+#include <cstring>
+
 using namespace yarp::os::impl;
 using namespace yarp::sig;
 using namespace yarp::sig::draw;
@@ -67,6 +69,40 @@ void passImage(ImageOf<PixelRgb> img)
     yInfo("passed a blank image ok");
 }
 
+// Convert an image with all the combinations of padding and origin, and check
+// each pixel of the result
+template <class T1, class T2, class Check>
+void checkConversion(size_t w, size_t h, Check check)
+{
+    for (size_t q1 : {1, 8}) {
+        ImageOf<T1> src;
+        src.setQuantum(q1);
+        src.resize(w, h);
+        for (size_t y = 0; y < h; y++) {
+            unsigned char* row = src.getRow(y);
+            for (size_t i = 0; i < w * sizeof(T1); i++) {
+                row[i] = static_cast<unsigned char>(i * 37 + y * 101);
+            }
+        }
+        for (size_t q2 : {1, 8}) {
+            for (bool topIsLow : {true, false}) {
+                ImageOf<T2> dest;
+                dest.setQuantum(q2);
+                dest.setTopIsLowIndex(topIsLow);
+                dest.copy(src);
+                bool ok = true;
+                for (size_t y = 0; y < h; y++) {
+                    for (size_t x = 0; x < w; x++) {
+                        ok &= check(src.pixel(x, y), dest.pixel(x, y));
+                    }
+                }
+                INFO("quantum " << q1 << " -> " << q2 << ", topIsLow " << topIsLow);
+                CHECK(ok);
+            }
+        }
+    }
+}
+
 TEST_CASE("sig::ImageTest", "[yarp::sig]")
 {
     NetworkBase::setLocalMode(true);
@@ -501,6 +537,107 @@ TEST_CASE("sig::ImageTest", "[yarp::sig]")
         CHECK(img2(4,2).r == 10); // r level copied
     }
 
+    SECTION("check pixel conversions.")
+    {
+        // Widths that are not multiple of the vector sizes, to check the end
+        // of the rows
+        for (size_t w : {1, 5, 6, 7, 16, 17, 33, 67}) {
+            INFO("width " << w);
+            checkConversion<PixelRgb, PixelRgb>(w, 5, [](const PixelRgb& s, const PixelRgb& d) {
+                return d.r == s.r && d.g == s.g && d.b == s.b;
+            });
+            checkConversion<PixelRgb, PixelBgr>(w, 5, [](const PixelRgb& s, const PixelBgr& d) {
+                return d.r == s.r && d.g == s.g && d.b == s.b;
+            });
+            checkConversion<PixelBgr, PixelRgb>(w, 5, [](const PixelBgr& s, const PixelRgb& d) {
+                return d.r == s.r && d.g == s.g && d.b == s.b;
+            });
+            checkConversion<PixelRgb, PixelMono>(w, 5, [](const PixelRgb& s, const PixelMono& d) {
+                return d == (s.r + s.g + s.b) / 3;
+            });
+            checkConversion<PixelBgr, PixelMono>(w, 5, [](const PixelBgr& s, const PixelMono& d) {
+                return d == (s.r + s.g + s.b) / 3;
+            });
+            checkConversion<PixelMono, PixelRgb>(w, 5, [](const PixelMono& s, const PixelRgb& d) {
+                return d.r == s && d.g == s && d.b == s;
+            });
+            checkConversion<PixelMono, PixelBgr>(w, 5, [](const PixelMono& s, const PixelBgr& d) {
+                return d.r == s && d.g == s && d.b == s;
+            });
+            checkConversion<PixelRgb, PixelRgba>(w, 5, [](const PixelRgb& s, const PixelRgba& d) {
+                return d.r == s.r && d.g == s.g && d.b == s.b && d.a == 255;
+            });
+            checkConversion<PixelRgb, PixelBgra>(w, 5, [](const PixelRgb& s, const PixelBgra& d) {
+                return d.r == s.r && d.g == s.g && d.b == s.b && d.a == 255;
+            });
+            checkConversion<PixelBgr, PixelBgra>(w, 5, [](const PixelBgr& s, const PixelBgra& d) {
+                return d.r == s.r && d.g == s.g && d.b == s.b && d.a == 255;
+            });
+            checkConversion<PixelBgr, PixelRgba>(w, 5, [](const PixelBgr& s, const PixelRgba& d) {
+                return d.r == s.r && d.g == s.g && d.b == s.b && d.a == 255;
+            });
+            checkConversion<PixelRgba, PixelRgb>(w, 5, [](const PixelRgba& s, const PixelRgb& d) {
+                return d.r == s.r && d.g == s.g && d.b == s.b;
+            });
+            checkConversion<PixelRgba, PixelBgr>(w, 5, [](const PixelRgba& s, const PixelBgr& d) {
+                return d.r == s.r && d.g == s.g && d.b == s.b;
+            });
+            checkConversion<PixelBgra, PixelBgr>(w, 5, [](const PixelBgra& s, const PixelBgr& d) {
+                return d.r == s.r && d.g == s.g && d.b == s.b;
+            });
+            checkConversion<PixelBgra, PixelRgb>(w, 5, [](const PixelBgra& s, const PixelRgb& d) {
+                return d.r == s.r && d.g == s.g && d.b == s.b;
+            });
+            checkConversion<PixelMono16, PixelFloat>(w, 5, [](const PixelMono16& s, const PixelFloat& d) {
+                return d == static_cast<float>(s);
+            });
+        }
+    }
+
+    SECTION("check parallel processing.")
+    {
+        const size_t threads = Image::getProcessingThreads();
+        const size_t threshold = Image::getParallelThreshold();
+        Image::setProcessingThreads(4);
+        Image::setParallelThreshold(0);
+        CHECK(Image::getProcessingThreads() == 4);
+        CHECK(Image::getParallelThreshold() == 0);
+
+        for (size_t h : {1, 2, 3, 5, 31}) {
+            INFO("height " << h);
+            checkConversion<PixelRgb, PixelRgb>(37, h, [](const PixelRgb& s, const PixelRgb& d) {
+                return d.r == s.r && d.g == s.g && d.b == s.b;
+            });
+            checkConversion<PixelRgb, PixelMono>(37, h, [](const PixelRgb& s, const PixelMono& d) {
+                return d == (s.r + s.g + s.b) / 3;
+            });
+            checkConversion<PixelRgb, PixelRgbFloat>(37, h, [](const PixelRgb& s, const PixelRgbFloat& d) {
+                return d.r == s.r && d.g == s.g && d.b == s.b;
+            });
+        }
+
+        ImageOf<PixelRgb> img;
+        img.resize(64, 48);
+        for (size_t y = 0; y < img.height(); y++) {
+            for (size_t x = 0; x < img.width(); x++) {
+                img(x, y) = PixelRgb(x, y, x + y);
+            }
+        }
+        ImageOf<PixelRgb> scaled;
+        scaled.copy(img, 101, 77);
+        Image::setProcessingThreads(1);
+        ImageOf<PixelRgb> expected;
+        expected.copy(img, 101, 77);
+        bool ok = true;
+        for (size_t y = 0; y < expected.height(); y++) {
+            ok &= memcmp(scaled.getRow(y), expected.getRow(y), expected.width() * expected.getPixelSize()) == 0;
+        }
+        CHECK(ok);
+
+        Image::setProcessingThreads(threads);
+        Image::setParallelThreshold(threshold);
+    }
+
     SECTION("check origin.")
     {
 
@@ -0,0 +1,171 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <yarp/os/Time.h>
+#include <yarp/sig/Image.h>
+#include <yarp/sig/SharedImagePool.h>
+
+#include <cstring>
+
+#if defined(__linux__)
+#    include <signal.h>
+#    include <sys/wait.h>
+#    include <unistd.h>
+#endif
+
+#include <catch.hpp>
+#include <harness.h>
+
+using namespace yarp::sig;
+
+TEST_CASE("sig::SharedImagePoolTest", "[yarp::sig]")
+{
+#if !defined(__linux__)
+    YARP_SKIP_TEST("Shared memory pools are supported on Linux only")
+#endif
+
+    SECTION("test slot allocation and recycling")
+    {
+        SharedImagePool pool(64 * 48 * 3, 2);
+        REQUIRE(pool.isValid());
+        CHECK(pool.getSlotCount() == 2);
+        CHECK(pool.getSlotSize() >= 64 * 48 * 3);
+        CHECK(pool.getFreeSlots() == 2);
+
+        {
+            ImageOf<PixelRgb> img1;
+            ImageOf<PixelRgb> img2;
+            ImageOf<PixelRgb> img3;
+            REQUIRE(pool.allocate(img1, 64, 48));
+            CHECK(img1.width() == 64);
+            CHECK(img1.height() == 48);
+            CHECK(pool.getFreeSlots() == 1);
+            REQUIRE(pool.allocate(img2, 32, 24));
+            CHECK(pool.getFreeSlots() == 0);
+            CHECK_FALSE(pool.allocate(img3, 32, 24)); // no free slots
+            CHECK(img3.width() == 0);
+
+            img1.zero();
+            img1.pixel(63, 47).b = 42;
+            CHECK(img1.pixel(63, 47).b == 42);
+
+            img1.resize(64, 48); // same size, keeps the slot
+            CHECK(pool.getFreeSlots() == 0);
+            img1.resize(10, 10); // releases the slot
+            CHECK(pool.getFreeSlots() == 1);
+        }
+        CHECK(pool.getFreeSlots() == 2);
+
+        ImageOf<PixelRgb> big;
+        CHECK_FALSE(pool.allocate(big, 640, 480)); // does not fit in a slot
+        CHECK(pool.getFreeSlots() == 2);
+    }
+
+    SECTION("test sharing a slot")
+    {
+        SharedImagePool pool(64 * 48, 1);
+        REQUIRE(pool.isValid());
+
+        ImageOf<PixelMono> img;
+        REQUIRE(pool.allocate(img, 64, 48));
+        img.zero();
+        img.pixel(1, 1) = 7;
+
+        SharedImagePool::Handle handle;
+        CHECK_FALSE(SharedImagePool::acquire(&handle, sizeof(handle), handle)); // not in a pool
+        REQUIRE(SharedImagePool::acquire(img.getRawImage(), img.getRawImageSize(), handle));
+        CHECK(handle.length == img.getRawImageSize());
+
+        std::shared_ptr<void> owner;
+        const char* data = SharedImagePool::attach(handle, owner);
+        REQUIRE(data != nullptr);
+        CHECK(data == reinterpret_cast<const char*>(img.getRawImage()));
+
+        // The receiving image wraps the same memory
+        ImageOf<PixelMono> received;
+        received.setExternal(data, 64, 48, std::move(owner));
+        CHECK(received.pixel(1, 1) == 7);
+
+        // The slot is released when both images stop using it
+        img.resize(0, 0);
+        CHECK(pool.getFreeSlots() == 0);
+        received.resize(0, 0);
+        CHECK(pool.getFreeSlots() == 1);
+
+        // Releasing a reference without attaching it
+        REQUIRE(pool.allocate(img, 64, 48));
+        REQUIRE(SharedImagePool::acquire(img.getRawImage(), img.getRawImageSize(), handle));
+        SharedImagePool::release(handle);
+        img.resize(0, 0);
+        CHECK(pool.getFreeSlots() == 1);
+    }
+
+#if defined(__linux__)
+    SECTION("test reclaiming the slot of a dead receiver")
+    {
+        SharedImagePool pool(64 * 48, 1);
+        REQUIRE(pool.isValid());
+
+        ImageOf<PixelMono> img;
+        REQUIRE(pool.allocate(img, 64, 48));
+        SharedImagePool::Handle handle;
+        REQUIRE(SharedImagePool::acquire(img.getRawImage(), img.getRawImageSize(), handle));
+
+        // The receiver exits without releasing the slot, as if it crashed.
+        // The ports install a SIGCHLD handler that would reap it.
+        struct sigaction sa;
+        struct sigaction old_sa;
+        memset(&sa, 0, sizeof(sa));
+        sa.sa_handler = SIG_DFL;
+        sigaction(SIGCHLD, &sa, &old_sa);
+        pid_t pid = fork();
+        if (pid == 0) {
+            std::shared_ptr<void> owner;
+            const char* data = SharedImagePool::attach(handle, owner);
+            _exit(data != nullptr ? 0 : 1);
+        }
+        int status = 0;
+        pid_t waited = (pid > 0) ? waitpid(pid, &status, 0) : -1;
+        sigaction(SIGCHLD, &old_sa, nullptr);
+        REQUIRE(pid > 0);
+        REQUIRE(waited == pid);
+        REQUIRE(WIFEXITED(status));
+        CHECK(WEXITSTATUS(status) == 0);
+
+        img.resize(0, 0);
+        CHECK(pool.getFreeSlots() == 0);
+        CHECK(pool.allocate(img, 64, 48));
+        CHECK(pool.getFreeSlots() == 0);
+        img.resize(0, 0);
+        CHECK(pool.getFreeSlots() == 1);
+    }
+
+    SECTION("test reclaiming a reference never received")
+    {
+        SharedImagePool pool(64 * 48, 1);
+        REQUIRE(pool.isValid());
+
+        ImageOf<PixelMono> img;
+        REQUIRE(pool.allocate(img, 64, 48));
+        SharedImagePool::Handle handle;
+        REQUIRE(SharedImagePool::acquire(img.getRawImage(), img.getRawImageSize(), handle));
+        img.resize(0, 0);
+
+        // The reference is still valid for a while
+        CHECK_FALSE(pool.allocate(img, 64, 48));
+        yarp::os::Time::delay(1.2);
+        REQUIRE(pool.allocate(img, 64, 48));
+
+        // The reference expired, and it cannot be used for the new image
+        std::shared_ptr<void> owner;
+        CHECK(SharedImagePool::attach(handle, owner) == nullptr);
+        img.resize(0, 0);
+        CHECK(pool.getFreeSlots() == 1);
+    }
+#endif
+}
@@ -0,0 +1,218 @@
+/*
+ * Copyright (C) 2006-2020 Istituto Italiano di Tecnologia (IIT)
+ * All rights reserved.
+ *
+ * This software may be modified and distributed under the terms of the
+ * BSD-3-Clause license. See the accompanying LICENSE file for details.
+ */
+
+#include <DumpBinaryFile.h>
+
+#include <yarp/os/Bottle.h>
+#include <yarp/sig/Image.h>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include <catch.hpp>
+#include <harness.h>
+
+using namespace yarp::os;
+using namespace yarp::sig;
+
+namespace {
+
+const char* fileName = "_yarp_regression_dump.bin";
+
+DumpBinaryRecord makeRecord(int32_t seq)
+{
+    DumpBinaryRecord record;
+    record.seqNumber = seq;
+    record.flags = dump_binary_tx_stamp | dump_binary_rx_stamp;
+    record.txStamp = 100.0 + seq;
+    record.rxStamp = 100.5 + seq;
+    Bottle b;
+    b.addInt32(seq);
+    b.addString("item");
+    b.addFloat64(seq * 0.5);
+    dumpBinarySerialize(b, record.payload);
+    return record;
+}
+
+// Write chunks of 2 records each, 3 items are dropped before the first one
+void writeFile(size_t chunks)
+{
+    DumpBinaryWriter writer;
+    DumpBinaryStream stream;
+    stream.type = dump_binary_bottle;
+    stream.name = "/dumper";
+    REQUIRE(writer.open(fileName, stream));
+    for (size_t i = 0; i < chunks; i++) {
+        writer.append(makeRecord(2 * i));
+        writer.append(makeRecord(2 * i + 1));
+        CHECK(writer.getChunkItems() == 2);
+        REQUIRE(writer.writeChunk(i == 0 ? 3 : 0));
+        CHECK(writer.getChunkItems() == 0);
+    }
+    CHECK(writer.getItems() == 2 * chunks);
+    CHECK(writer.getDropped() == 3);
+    REQUIRE(writer.close());
+}
+
+void checkRecords(DumpBinaryReader& reader)
+{
+    int32_t seq = 0;
+    for (size_t i = 0; i < reader.getChunks().size(); i++) {
+        std::vector<DumpBinaryRecord> records;
+        uint64_t dropped = 0;
+        REQUIRE(reader.readChunk(i, records, &dropped));
+        CHECK(dropped == (i == 0 ? 3 : 0));
+        REQUIRE(records.size() == 2);
+        CHECK(reader.getChunks()[i].items == 2);
+        CHECK(reader.getChunks()[i].firstStamp == 100.0 + seq);
+        CHECK(reader.getChunks()[i].lastStamp == 101.0 + seq);
+        for (const auto& record : records) {
+            CHECK(record.seqNumber == seq);
+            CHECK(record.flags == (dump_binary_tx_stamp | dump_binary_rx_stamp));
+            CHECK(record.txStamp == 100.0 + seq);
+            CHECK(record.rxStamp == 100.5 + seq);
+            Bottle b;
+            REQUIRE(dumpBinaryDeserialize(record.payload, b));
+            CHECK(b.size() == 3);
+            CHECK(b.get(0).asInt32() == seq);
+            CHECK(b.get(1).asString() == "item");
+            CHECK(b.get(2).asFloat64() == seq * 0.5);
+            seq++;
+        }
+    }
+    CHECK(seq == 2 * reader.getChunks().size());
+}
+
+std::string readAll()
+{
+    std::ifstream f(fileName, std::ios::in | std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+}
+
+void writeAll(const std::string& data)
+{
+    std::ofstream f(fileName, std::ios::out | std::ios::binary | std::ios::trunc);
+    f.write(data.data(), data.size());
+}
+
+} // namespace
+
+TEST_CASE("yarpdatadumper::DumpBinaryFileTest", "[yarpdatadumper]")
+{
+    SECTION("test writing and reading back a container")
+    {
+        // 70 chunks: the first index is written after 64 chunks,
+        // the second one by close()
+        writeFile(70);
+
+        DumpBinaryReader reader;
+        REQUIRE(reader.open(fileName));
+        CHECK(reader.isComplete());
+        REQUIRE(reader.getStreams().size() == 1);
+        CHECK(reader.getStreams()[0].stream == 0);
+        CHECK(reader.getStreams()[0].type == dump_binary_bottle);
+        CHECK(reader.getStreams()[0].name == "/dumper");
+        CHECK(reader.getChunks().size() == 70);
+        CHECK(reader.getItems() == 140);
+        CHECK(reader.getDropped() == 3);
+        checkRecords(reader);
+
+        std::vector<DumpBinaryRecord> records;
+        CHECK_FALSE(reader.readChunk(70, records));
+        reader.close();
+
+        std::remove(fileName);
+    }
+
+    SECTION("test reading a container without the trailer")
+    {
+        writeFile(3);
+        std::string data = readAll();
+        REQUIRE(data.substr(data.size() - 32, 4) == "TRLR");
+        // the recording was interrupted in the middle of the last index
+        writeAll(data.substr(0, data.size() - 40));
+
+        DumpBinaryReader reader;
+        REQUIRE(reader.open(fileName));
+        CHECK_FALSE(reader.isComplete());
+        REQUIRE(reader.getStreams().size() == 1);
+        CHECK(reader.getChunks().size() == 3);
+        CHECK(reader.getItems() == 6);
+        CHECK(reader.getDropped() == 3);
+        checkRecords(reader);
+        reader.close();
+
+        std::remove(fileName);
+    }
+
+    SECTION("test reading corrupted containers")
+    {
+        writeFile(2);
+        std::string data = readAll();
+
+        DumpBinaryReader reader;
+
+        std::string bad = data;
+        bad[0] = 'X';
+        writeAll(bad);
+        CHECK_FALSE(reader.open(fileName));
+
+        // the length of the stream section exceeds the file
+        bad = data;
+        bad[15] = '\x7f';
+        writeAll(bad);
+        CHECK_FALSE(reader.open(fileName));
+
+        // the length of the payload of the first record exceeds the chunk
+        size_t chunk = data.find("CHNK");
+        REQUIRE(chunk != std::string::npos);
+        bad = data;
+        bad[chunk + 8 + 32 + 28 + 3] = '\x7f';
+        writeAll(bad);
+        REQUIRE(reader.open(fileName));
+        CHECK(reader.isComplete());
+        std::vector<DumpBinaryRecord> records;
+        CHECK_FALSE(reader.readChunk(0, records));
+        CHECK(reader.readChunk(1, records));
+        reader.close();
+
+        std::remove(fileName);
+    }
+
+    SECTION("test the image payload")
+    {
+        ImageOf<PixelRgb> img;
+        img.setQuantum(8);
+        img.resize(5, 3);
+        for (size_t y = 0; y < img.height(); y++) {
+            for (size_t x = 0; x < img.width(); x++) {
+                img.pixel(x, y) = PixelRgb(x, y, x + y);
+            }
+        }
+
+        std::string payload;
+        dumpBinarySerialize(img, payload);
+
+        FlexImage out;
+        REQUIRE(dumpBinaryDeserialize(payload, out));
+        CHECK(out.width() == 5);
+        CHECK(out.height() == 3);
+        CHECK(out.getPixelCode() == VOCAB_PIXEL_RGB);
+        CHECK(out.getQuantum() == 8);
+        CHECK(out.getRawImageSize() == img.getRawImageSize());
+        auto* pix = reinterpret_cast<PixelRgb*>(out.getPixelAddress(4, 2));
+        CHECK(pix->r == 4);
+        CHECK(pix->g == 2);
+        CHECK(pix->b == 6);
+
+        CHECK_FALSE(dumpBinaryDeserialize(payload.substr(0, payload.size() - 1), out));
+        CHECK_FALSE(dumpBinaryDeserialize(payload.substr(0, 10), out));
+    }
+}